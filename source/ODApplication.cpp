@@ -21,6 +21,10 @@
 
 #include "ODApplication.h"
 
+#include "gamemap/BinaryLevel.h"
+#include "gamemap/GameMap.h"
+#include "gamemap/LevelInfoIndex.h"
+#include "gamemap/MapHandler.h"
 #include "network/ODServer.h"
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
@@ -39,6 +43,7 @@
 
 #include <OgreRenderWindow.h>
 #include <OgreRoot.h>
+#include <OgreTimer.h>
 #include <Overlay/OgreOverlaySystem.h>
 #include <RTShaderSystem/OgreShaderGenerator.h>
 
@@ -56,9 +61,11 @@
 
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <iostream>
 
 void ODApplication::startGame(boost::program_options::variables_map& options)
 {
@@ -70,7 +77,11 @@ void ODApplication::startGame(boost::program_options::variables_map& options)
     logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
     logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkFile(resMgr.getLogFile())));
 
-    if(resMgr.isServerMode())
+    if(resMgr.isLevelConversionMode())
+        startLevelConversion();
+    else if(resMgr.isSimulationMode())
+        startSimulation();
+    else if(resMgr.isServerMode())
         startServer();
     else
         startClient();
@@ -105,6 +116,95 @@ void ODApplication::startServer()
     server.stopServer();
 }
 
+void ODApplication::startSimulation()
+{
+    ResourceManager& resMgr = ResourceManager::getSingleton();
+
+    OD_LOG_INF("Initializing");
+
+    Random::initialize(resMgr.getSimulationSeed());
+    ConfigManager configManager(resMgr.getConfigPath(), "", resMgr.getSoundPath());
+    if(resMgr.getSimulationSensingThreads() >= 0)
+        configManager.setSensingThreads(static_cast<uint32_t>(resMgr.getSimulationSensingThreads()));
+
+    OD_LOG_INF("Launching simulation");
+
+    ODServer server;
+    if(!server.startSimulation(resMgr.getSimulationLevel()))
+    {
+        OD_LOG_ERR("Could not start simulation !!!");
+        return;
+    }
+
+    // Every turn has the same length so that 2 simulations with the same seed compute the same game
+    const double turnLength = 1.0 / ODApplication::turnsPerSecond;
+    const uint32_t nbTurns = resMgr.getSimulationNbTurns();
+    GameMap* gameMap = server.getGameMap();
+    GameMap::TurnPhaseTimes totalPhaseTimes;
+    uint64_t totalTurnTime = 0;
+    uint64_t maxTurnTime = 0;
+    Ogre::Timer stopwatch;
+
+    std::cout << "turn;totalUs;visionUs;sensingUs;entitiesUpkeepUs;seatsUpkeepUs;aiUs;pathCalls;allocations" << std::endl;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        stopwatch.reset();
+        server.doSimulationTurn(turnLength);
+        uint64_t turnTime = stopwatch.getMicroseconds();
+
+        const GameMap::TurnPhaseTimes& phaseTimes = gameMap->getLastTurnPhaseTimes();
+        std::cout << gameMap->getTurnNumber() << ";" << turnTime << ";" << phaseTimes.mVision
+            << ";" << phaseTimes.mSensing << ";" << phaseTimes.mEntitiesUpkeep << ";" << phaseTimes.mSeatsUpkeep
+            << ";" << phaseTimes.mAI << ";" << phaseTimes.mNbPathCalls
+            << ";" << phaseTimes.mNbAllocations << std::endl;
+
+        totalTurnTime += turnTime;
+        maxTurnTime = std::max(maxTurnTime, turnTime);
+        totalPhaseTimes.mVision += phaseTimes.mVision;
+        totalPhaseTimes.mSensing += phaseTimes.mSensing;
+        totalPhaseTimes.mEntitiesUpkeep += phaseTimes.mEntitiesUpkeep;
+        totalPhaseTimes.mSeatsUpkeep += phaseTimes.mSeatsUpkeep;
+        totalPhaseTimes.mAI += phaseTimes.mAI;
+        totalPhaseTimes.mNbPathCalls += phaseTimes.mNbPathCalls;
+        totalPhaseTimes.mNbAllocations += phaseTimes.mNbAllocations;
+    }
+
+    if(nbTurns > 0)
+    {
+        std::cout << "Simulated " << nbTurns << " turns on " << resMgr.getSimulationLevel()
+            << " with " << gameMap->getNbSensingThreads() << " sensing threads"
+            << " in " << totalTurnTime << "us (max turn " << maxTurnTime << "us), average per turn: total="
+            << (totalTurnTime / nbTurns) << "us, vision=" << (totalPhaseTimes.mVision / nbTurns)
+            << "us, sensing=" << (totalPhaseTimes.mSensing / nbTurns)
+            << "us, entitiesUpkeep=" << (totalPhaseTimes.mEntitiesUpkeep / nbTurns)
+            << "us, seatsUpkeep=" << (totalPhaseTimes.mSeatsUpkeep / nbTurns)
+            << "us, ai=" << (totalPhaseTimes.mAI / nbTurns)
+            << "us, pathCalls=" << (totalPhaseTimes.mNbPathCalls / nbTurns)
+            << ", allocations=" << (totalPhaseTimes.mNbAllocations / nbTurns) << std::endl;
+    }
+
+    OD_LOG_INF("Stopping simulation...");
+    server.stopServer();
+}
+
+void ODApplication::startLevelConversion()
+{
+    ResourceManager& resMgr = ResourceManager::getSingleton();
+    const std::string& input = resMgr.getConvertLevelInput();
+    const std::string& output = resMgr.getConvertLevelOutput();
+
+    std::string error;
+    if(!BinaryLevel::convertLevelFile(input, output, error))
+    {
+        OD_LOG_ERR("Could not convert level file=" + input + ", error=" + error);
+        std::cerr << "Could not convert " << input << ": " << error << std::endl;
+        return;
+    }
+
+    std::cout << "Converted " << input << " to the "
+        << (BinaryLevel::isBinaryLevelFile(output) ? "binary" : "text") << " format in " << output << std::endl;
+}
+
 void ODApplication::startClient()
 {
     ResourceManager& resMgr = ResourceManager::getSingleton();
@@ -214,6 +314,13 @@ void ODApplication::startClient()
 
     Ogre::ResourceGroupManager::getSingletonPtr()->initialiseAllResourceGroups();
 
+    // The level menus get the levels info from the index. It is refreshed in the background
+    // so that the menus do not have to read every level when they open
+    LevelInfoIndex levelInfoIndex(resMgr.getUserDataPath() + LevelInfoIndex::INDEX_FILENAME, &MapHandler::getMapInfo);
+    levelInfoIndex.refreshAsync({ resMgr.getGameLevelPathSkirmish(), resMgr.getGameLevelPathMultiplayer(),
+        resMgr.getUserLevelPathSkirmish(), resMgr.getUserLevelPathMultiplayer(), resMgr.getSaveGamePath() },
+        MapHandler::LEVEL_EXTENSION);
+
     MusicPlayer musicPlayer(resMgr.getMusicPath(), resMgr.listAllMusicFiles());
     SoundEffectsManager soundEffectsManager;
 
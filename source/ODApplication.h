@@ -64,6 +64,11 @@ private:
     void startClient();
     //! \brief Server mode. Creates only the needed to launch a level. Note that this is to be used without gui
     void startServer();
+    //! \brief Simulation mode. Runs a level with Keeper AIs only, without network nor rendering, as fast as
+    //! possible and reports the time spent in each turn. Used to benchmark the server side of the game
+    void startSimulation();
+    //! \brief Converts a level file between the text and the binary formats (depending on the input format)
+    void startLevelConversion();
 };
 
 #endif // ODAPPLICATION_H
@@ -20,6 +20,8 @@
 #include "ai/AIFactory.h"
 #include "ai/BaseAI.h"
 
+#include "utils/Random.h"
+
 AIManager::AIManager(GameMap& gameMap)
     : mGameMap(gameMap)
 {
@@ -44,6 +46,7 @@ bool AIManager::doTurn(double timeSinceLastTurn)
 {
     for(BaseAI* ai : mAiList)
     {
+        Random::StreamScope randomScope(ai->getRandomStream(), RandomStreamContext::ai, ai->getSeatId());
         ai->doTurn(timeSinceLastTurn);
     }
     return true;
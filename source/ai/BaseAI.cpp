@@ -23,6 +23,7 @@
 #include "entities/Tile.h"
 
 #include "game/Player.h"
+#include "game/Seat.h"
 
 #include "gamemap/GameMap.h"
 
@@ -42,6 +43,17 @@ BaseAI::BaseAI(GameMap& gameMap, Player& player):
 {
 }
 
+uint32_t BaseAI::getSeatId() const
+{
+    if(mPlayer.getSeat() == nullptr)
+    {
+        OD_LOG_ERR("AI player without seat nick=" + mPlayer.getNick());
+        return 0;
+    }
+
+    return static_cast<uint32_t>(mPlayer.getSeat()->getId());
+}
+
 Room* BaseAI::getDungeonTemple()
 {
     std::vector<Room*> dt = mGameMap.getRoomsByTypeAndSeat(RoomType::dungeonTemple, mPlayer.getSeat());
@@ -18,6 +18,8 @@
 #ifndef BASEAI_H
 #define BASEAI_H
 
+#include "utils/Random.h"
+
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -44,6 +46,13 @@ public:
      */
     virtual bool doTurn(double timeSinceLastTurn) = 0;
 
+    //! \brief Stream used for the random numbers drawn by this AI during the turn
+    inline RandomStream& getRandomStream()
+    { return mRandomStream; }
+
+    //! \brief Id of the seat played by this AI. Used to seed the random stream
+    uint32_t getSeatId() const;
+
 protected:
     BaseAI(GameMap& gameMap, Player& player);
 
@@ -64,6 +73,8 @@ protected:
     Player& mPlayer;
 
 private:
+    RandomStream mRandomStream;
+
     bool shouldGroundTileBeConsideredForBestPlaceForRoom(Tile* tile, Seat* playerSeat);
     bool shouldWallTileBeConsideredForBestPlaceForRoom(Tile* tile, Seat* playerSeat);
 };
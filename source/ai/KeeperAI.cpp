@@ -32,6 +32,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
+#include "utils/ScratchVector.h"
 
 #include <vector>
 
@@ -617,8 +618,9 @@ void KeeperAI::saveWoundedCreatures()
     }
 
     Seat* seat = mPlayer.getSeat();
-    std::vector<Creature*> creatures = mGameMap.getCreaturesBySeat(seat);
-    for(Creature* creature : creatures)
+    ScratchVector<Creature*> creatures;
+    mGameMap.getCreaturesBySeat(seat, *creatures);
+    for(Creature* creature : *creatures)
     {
         // We take away fleeing creatures not too near our dungeon heart
         if(!creature->isActionInList(CreatureActionType::flee))
@@ -667,7 +669,9 @@ void KeeperAI::handleDefense()
 
         // We look for a healthy creature not already fighting
         Creature* creatureToDrop = nullptr;
-        for(Creature* creature2 : mGameMap.getCreaturesBySeat(seat))
+        ScratchVector<Creature*> creatures2;
+        mGameMap.getCreaturesBySeat(seat, *creatures2);
+        for(Creature* creature2 : *creatures2)
         {
             if(creature2->getDefinition()->isWorker())
                 continue;
@@ -772,8 +776,9 @@ bool KeeperAI::handleTiredCreatures()
     if(mPlayer.getSeat()->getNbRooms(RoomType::dormitory) <= 0)
         return false;
 
-    std::vector<Creature*> creatures = mGameMap.getCreaturesBySeat(mPlayer.getSeat());
-    for(Creature* creature : creatures)
+    ScratchVector<Creature*> creatures;
+    mGameMap.getCreaturesBySeat(mPlayer.getSeat(), *creatures);
+    for(Creature* creature : *creatures)
     {
         // We do not take creatures fighting
         if(creature->isActionInList(CreatureActionType::fight))
@@ -842,8 +847,9 @@ bool KeeperAI::handleHungryCreatures()
     if(mPlayer.getSeat()->getNbRooms(RoomType::hatchery) <= 0)
         return false;
 
-    std::vector<Creature*> creatures = mGameMap.getCreaturesBySeat(mPlayer.getSeat());
-    for(Creature* creature : creatures)
+    ScratchVector<Creature*> creatures;
+    mGameMap.getCreaturesBySeat(mPlayer.getSeat(), *creatures);
+    for(Creature* creature : *creatures)
     {
         // We do not take creatures fighting
         if(creature->isActionInList(CreatureActionType::fight))
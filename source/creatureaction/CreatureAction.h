@@ -19,9 +19,10 @@
 #define CREATUREACTION_H
 
 #include "entities/CreatureMoodValues.h"
+#include "utils/BlockPool.h"
 
+#include <cstddef>
 #include <cstdint>
-#include <functional>
 #include <istream>
 
 class Creature;
@@ -80,11 +81,11 @@ public:
     inline int32_t getNbTurnsActive() const
     { return mNbTurnsActive; }
 
-    //! Returns a pointer to the given action from CreatureAction class. Note that
-    //! we don't want to do stuff in the child classes because many actions will
-    //! pop themselves which might result in errors. Instead, we expect every action
-    //! to call the expected action from CreatureAction with the good parameters.
-    virtual std::function<bool()> action() = 0;
+    //! Executes the action and returns true if the creature should try the next action
+    //! in its queue during this turn. Note that many actions will pop themselves (and
+    //! thus be deleted) while executing. That's why every action calls a static function
+    //! with copies of the needed parameters and must not use its members after that.
+    virtual bool action() = 0;
 
     //! \brief Returns the mood value modifier that should be applied to the creature
     //! when this action is in its list. The value should be used as defined
@@ -94,6 +95,14 @@ public:
 
     static std::string toString(CreatureActionType actionType);
 
+    //! \brief Actions are pushed and popped all the time. They are allocated from a
+    //! BlockPool so that no allocation is needed once the pool has enough blocks
+    static void* operator new(std::size_t size)
+    { return BlockPool::allocate(size); }
+
+    static void operator delete(void* ptr, std::size_t size)
+    { BlockPool::release(ptr, size); }
+
 protected:
     Creature& mCreature;
 
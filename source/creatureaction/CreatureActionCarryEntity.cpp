@@ -58,10 +58,9 @@ CreatureActionCarryEntity::~CreatureActionCarryEntity()
     }
 }
 
-std::function<bool()> CreatureActionCarryEntity::action()
+bool CreatureActionCarryEntity::action()
 {
-    return std::bind(&CreatureActionCarryEntity::handleCarryEntity,
-        std::ref(mCreature), mEntityToCarry, mTileDest);
+    return CreatureActionCarryEntity::handleCarryEntity(mCreature, mEntityToCarry, mTileDest);
 }
 
 bool CreatureActionCarryEntity::handleCarryEntity(Creature& creature, GameEntity* entityToCarry, Tile* tileDest)
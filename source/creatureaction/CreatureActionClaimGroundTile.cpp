@@ -34,10 +34,9 @@ CreatureActionClaimGroundTile::~CreatureActionClaimGroundTile()
     mTileClaim.removeWorkerClaiming(mCreature);
 }
 
-std::function<bool()> CreatureActionClaimGroundTile::action()
+bool CreatureActionClaimGroundTile::action()
 {
-    return std::bind(&CreatureActionClaimGroundTile::handleCreatureActionClaimGroundTile,
-        std::ref(mCreature), std::ref(mTileClaim));
+    return CreatureActionClaimGroundTile::handleCreatureActionClaimGroundTile(mCreature, mTileClaim);
 }
 
 bool CreatureActionClaimGroundTile::handleCreatureActionClaimGroundTile(Creature& creature, Tile& tileClaim)
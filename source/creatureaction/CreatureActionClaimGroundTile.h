@@ -31,7 +31,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::claimGroundTile; }
 
-    std::function<bool()> action() override;
+    bool action() override;
 
     static bool handleCreatureActionClaimGroundTile(Creature& creature, Tile& tileClaim);
 
@@ -36,10 +36,9 @@ CreatureActionClaimWallTile::~CreatureActionClaimWallTile()
     mTileClaim.removeWorkerClaiming(mCreature);
 }
 
-std::function<bool()> CreatureActionClaimWallTile::action()
+bool CreatureActionClaimWallTile::action()
 {
-    return std::bind(&CreatureActionClaimWallTile::handleClaimWallTile,
-        std::ref(mCreature), std::ref(mTileClaim));
+    return CreatureActionClaimWallTile::handleClaimWallTile(mCreature, mTileClaim);
 }
 
 bool CreatureActionClaimWallTile::handleClaimWallTile(Creature& creature, Tile& tileClaim)
@@ -45,10 +45,9 @@ CreatureActionDigTile::~CreatureActionDigTile()
     mTileDig.removeWorkerDigging(mCreature, mTilePos);
 }
 
-std::function<bool()> CreatureActionDigTile::action()
+bool CreatureActionDigTile::action()
 {
-    return std::bind(&CreatureActionDigTile::handleDigTile,
-        std::ref(mCreature), std::ref(mTileDig), std::ref(mTilePos));
+    return CreatureActionDigTile::handleDigTile(mCreature, mTileDig, mTilePos);
 }
 
 bool CreatureActionDigTile::handleDigTile(Creature& creature, Tile& tileDig, Tile& tilePos)
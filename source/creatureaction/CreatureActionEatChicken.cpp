@@ -46,10 +46,9 @@ CreatureActionEatChicken::~CreatureActionEatChicken()
     }
 }
 
-std::function<bool()> CreatureActionEatChicken::action()
+bool CreatureActionEatChicken::action()
 {
-    return std::bind(&CreatureActionEatChicken::handleEatChicken,
-        std::ref(mCreature), mChicken);
+    return CreatureActionEatChicken::handleEatChicken(mCreature, mChicken);
 }
 
 bool CreatureActionEatChicken::handleEatChicken(Creature& creature, ChickenEntity* chicken)
@@ -108,10 +107,10 @@ bool CreatureActionEatChicken::handleEatChicken(Creature& creature, ChickenEntit
 
     // We can eat the chicken
     chicken->eatChicken(&creature);
-    creature.foodEaten(ConfigManager::getSingleton().getRoomConfigDouble("HatcheryHungerPerChicken"));
-    creature.setJobCooldown(Random::Int(ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryCooldownChickenMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryCooldownChickenMax")));
-    creature.setHP(creature.getHP() + ConfigManager::getSingleton().getRoomConfigDouble("HatcheryHpRecoveredPerChicken"));
+    creature.foodEaten(ConfigManager::getSingleton().getRoomConfigDouble(RoomConfigParam::hatcheryHungerPerChicken));
+    creature.setJobCooldown(Random::Int(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfigParam::hatcheryCooldownChickenMin),
+        ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfigParam::hatcheryCooldownChickenMax)));
+    creature.setHP(creature.getHP() + ConfigManager::getSingleton().getRoomConfigDouble(RoomConfigParam::hatcheryHpRecoveredPerChicken));
     creature.computeCreatureOverlayHealthValue();
     Ogre::Vector3 walkDirection = Ogre::Vector3(chickenTile->getX(), chickenTile->getY(), 0) - creature.getPosition();
     walkDirection.normalise();
@@ -44,10 +44,9 @@ CreatureActionFight::~CreatureActionFight()
         mEntityAttack->removeGameEntityListener(this);
 }
 
-std::function<bool()> CreatureActionFight::action()
+bool CreatureActionFight::action()
 {
-    return std::bind(&CreatureActionFight::handleFight,
-        std::ref(mCreature), mEntityAttack, mKoOpponent, mNotifyPlayerIfHit);
+    return CreatureActionFight::handleFight(mCreature, mEntityAttack, mKoOpponent, mNotifyPlayerIfHit);
 }
 
 bool CreatureActionFight::handleFight(Creature& creature, GameEntity* entityAttack, bool koOpponent, bool notifyPlayerIfHit)
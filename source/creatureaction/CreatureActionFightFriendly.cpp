@@ -27,6 +27,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
+#include "utils/ScratchVector.h"
 
 CreatureActionFightFriendly::CreatureActionFightFriendly(Creature& creature, GameEntity* entityAttack, bool koOpponent, const std::vector<Tile*>& tilesFilter, bool notifyPlayerIfHit) :
     CreatureAction(creature),
@@ -45,10 +46,12 @@ CreatureActionFightFriendly::~CreatureActionFightFriendly()
         mEntityAttack->removeGameEntityListener(this);
 }
 
-std::function<bool()> CreatureActionFightFriendly::action()
+bool CreatureActionFightFriendly::action()
 {
-    return std::bind(&CreatureActionFightFriendly::handleFight,
-        std::ref(mCreature), mEntityAttack, mKoOpponent, mTilesFilter, mNotifyPlayerIfHit);
+    // The action may be popped while fighting so we cannot give a reference on mTilesFilter
+    ScratchVector<Tile*> tilesFilter;
+    tilesFilter->assign(mTilesFilter.begin(), mTilesFilter.end());
+    return CreatureActionFightFriendly::handleFight(mCreature, mEntityAttack, mKoOpponent, *tilesFilter, mNotifyPlayerIfHit);
 }
 
 bool CreatureActionFightFriendly::handleFight(Creature& creature, GameEntity* entityAttack, bool koOpponent, const std::vector<Tile*>& tilesFilter, bool notifyPlayerIfHit)
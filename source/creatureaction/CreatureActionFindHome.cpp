@@ -28,13 +28,11 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
+#include "utils/ScratchVector.h"
 
-#include <functional>
-
-std::function<bool()> CreatureActionFindHome::action()
+bool CreatureActionFindHome::action()
 {
-    return std::bind(&CreatureActionFindHome::handleFindHome,
-        std::ref(mCreature), mForced);
+    return CreatureActionFindHome::handleFindHome(mCreature, mForced);
 }
 
 bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
@@ -99,9 +97,10 @@ bool CreatureActionFindHome::handleFindHome(Creature& creature, bool forced)
     }
 
     // Check to see if we can walk to a dormitory that does have an open tile.
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dormitory, creature.getSeat());
+    ScratchVector<Room*> tempRooms;
+    creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dormitory, creature.getSeat(), *tempRooms);
     std::vector<Tile*> availableDormitories;
-    for (Room* room : tempRooms)
+    for (Room* room : *tempRooms)
     {
         if(room->getType() != RoomType::dormitory)
         {
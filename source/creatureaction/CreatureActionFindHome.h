@@ -34,7 +34,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::findHome; }
 
-    std::function<bool()> action() override;
+    bool action() override;
 
     static bool handleFindHome(Creature& creature, bool forced);
 
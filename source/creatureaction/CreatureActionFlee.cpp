@@ -26,13 +26,13 @@
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
+#include "utils/ScratchVector.h"
 
 static const int NB_TURN_FLEE_MAX = 5;
 
-std::function<bool()> CreatureActionFlee::action()
+bool CreatureActionFlee::action()
 {
-    return std::bind(&CreatureActionFlee::handleFlee,
-        std::ref(mCreature), getNbTurns());
+    return CreatureActionFlee::handleFlee(mCreature, getNbTurns());
 }
 
 bool CreatureActionFlee::handleFlee(Creature& creature, int32_t nbTurns)
@@ -54,12 +54,14 @@ bool CreatureActionFlee::handleFlee(Creature& creature, int32_t nbTurns)
     }
 
     // We try to go closer to the dungeon temple. If we are too near or if we cannot go there, we will flee randomly
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dungeonTemple, creature.getSeat());
-    tempRooms = creature.getGameMap()->getReachableRooms(tempRooms, myTile, &creature);
-    if(!tempRooms.empty())
+    ScratchVector<Room*> temples;
+    ScratchVector<Room*> tempRooms;
+    creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::dungeonTemple, creature.getSeat(), *temples);
+    creature.getGameMap()->getReachableRooms(*temples, myTile, &creature, *tempRooms);
+    if(!tempRooms->empty())
     {
         // We can go to one dungeon temple
-        Room* room = tempRooms[Random::Int(0, tempRooms.size() - 1)];
+        Room* room = (*tempRooms)[Random::Int(0, tempRooms->size() - 1)];
         Tile* tile = room->getCoveredTile(0);
         std::list<Tile*> result = creature.getGameMap()->path(&creature, tile);
         // If we are not too near from the dungeon temple, we go there
@@ -19,12 +19,9 @@
 
 #include "entities/Creature.h"
 
-#include <functional>
-
-std::function<bool()> CreatureActionGoCallToWar::action()
+bool CreatureActionGoCallToWar::action()
 {
-    return std::bind(&CreatureActionGoCallToWar::handleWalkToTile,
-        std::ref(mCreature));
+    return CreatureActionGoCallToWar::handleWalkToTile(mCreature);
 }
 
 bool CreatureActionGoCallToWar::handleWalkToTile(Creature& creature)
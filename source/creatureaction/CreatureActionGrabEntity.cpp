@@ -43,10 +43,9 @@ CreatureActionGrabEntity::~CreatureActionGrabEntity()
     }
 }
 
-std::function<bool()> CreatureActionGrabEntity::action()
+bool CreatureActionGrabEntity::action()
 {
-    return std::bind(&CreatureActionGrabEntity::handleGrabEntity,
-        std::ref(mCreature), std::ref(mEntityToCarry));
+    return CreatureActionGrabEntity::handleGrabEntity(mCreature, mEntityToCarry);
 }
 
 bool CreatureActionGrabEntity::handleGrabEntity(Creature& creature, GameEntity* entityToCarry)
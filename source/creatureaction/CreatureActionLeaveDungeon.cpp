@@ -29,11 +29,11 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/Random.h"
+#include "utils/ScratchVector.h"
 
-std::function<bool()> CreatureActionLeaveDungeon::action()
+bool CreatureActionLeaveDungeon::action()
 {
-    return std::bind(&CreatureActionLeaveDungeon::handleLeaveDungeon,
-        std::ref(mCreature));
+    return CreatureActionLeaveDungeon::handleLeaveDungeon(mCreature);
 }
 
 bool CreatureActionLeaveDungeon::handleLeaveDungeon(Creature& creature)
@@ -69,9 +69,11 @@ bool CreatureActionLeaveDungeon::handleLeaveDungeon(Creature& creature)
     }
 
     // We try to go to the portal
-    std::vector<Room*> tempRooms = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::portal, creature.getSeat());
-    tempRooms = creature.getGameMap()->getReachableRooms(tempRooms, myTile, &creature);
-    if(tempRooms.empty())
+    ScratchVector<Room*> portals;
+    ScratchVector<Room*> tempRooms;
+    creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::portal, creature.getSeat(), *portals);
+    creature.getGameMap()->getReachableRooms(*portals, myTile, &creature, *tempRooms);
+    if(tempRooms->empty())
     {
         creature.popAction();
         return true;
@@ -79,8 +81,8 @@ bool CreatureActionLeaveDungeon::handleLeaveDungeon(Creature& creature)
 
     creature.fireChatMsgLeavingDungeon();
 
-    int index = Random::Int(0, tempRooms.size() - 1);
-    Room* room = tempRooms[index];
+    int index = Random::Int(0, tempRooms->size() - 1);
+    Room* room = (*tempRooms)[index];
     Tile* tile = room->getCentralTile();
     if(!creature.setDestination(tile))
     {
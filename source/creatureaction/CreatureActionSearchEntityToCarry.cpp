@@ -41,10 +41,9 @@ CreatureActionSearchEntityToCarry::~CreatureActionSearchEntityToCarry()
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
 
-std::function<bool()> CreatureActionSearchEntityToCarry::action()
+bool CreatureActionSearchEntityToCarry::action()
 {
-    return std::bind(&CreatureActionSearchEntityToCarry::handleSearchEntityToCarry,
-        std::ref(mCreature), mForced);
+    return CreatureActionSearchEntityToCarry::handleSearchEntityToCarry(mCreature, mForced);
 }
 
 bool CreatureActionSearchEntityToCarry::handleSearchEntityToCarry(Creature& creature, bool forced)
@@ -33,11 +33,11 @@
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
+#include "utils/ScratchVector.h"
 
-std::function<bool()> CreatureActionSearchFood::action()
+bool CreatureActionSearchFood::action()
 {
-    return std::bind(&CreatureActionSearchFood::handleSearchFood,
-        std::ref(mCreature), mForced);
+    return CreatureActionSearchFood::handleSearchFood(mCreature, mForced);
 }
 
 bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
@@ -95,8 +95,9 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
 
     // We couldn't find a wandering chicken. We look for a room where we can eat
     // Get the list of hatchery controlled by our seat and make sure there is at least one.
-    std::vector<Room*> hatcheries = creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::hatchery, creature.getSeat());
-    if (hatcheries.empty())
+    ScratchVector<Room*> hatcheries;
+    creature.getGameMap()->getRoomsByTypeAndSeat(RoomType::hatchery, creature.getSeat(), *hatcheries);
+    if (hatcheries->empty())
     {
         if((creature.getSeat()->getPlayer() != nullptr) &&
             creature.getSeat()->getPlayer()->getIsHuman() &&
@@ -110,7 +111,7 @@ bool CreatureActionSearchFood::handleSearchFood(Creature& creature, bool forced)
 
     // Pick a hatchery where we can eat and try to walk to it.
     std::vector<Tile*> hatcheriesTiles;
-    for(Room* hatcheryRoom : hatcheries)
+    for(Room* hatcheryRoom : *hatcheries)
     {
         if(hatcheryRoom->numCoveredTiles() <= 0)
             continue;
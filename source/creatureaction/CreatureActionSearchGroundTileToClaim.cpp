@@ -23,7 +23,6 @@
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
-#include "gamemap/Pathfinding.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
@@ -40,10 +39,9 @@ CreatureActionSearchGroundTileToClaim::~CreatureActionSearchGroundTileToClaim()
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
 
-std::function<bool()> CreatureActionSearchGroundTileToClaim::action()
+bool CreatureActionSearchGroundTileToClaim::action()
 {
-    return std::bind(&CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim,
-        std::ref(mCreature), getNbTurns(), mForced);
+    return CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(mCreature, getNbTurns(), mForced);
 }
 
 bool CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(Creature& creature, int32_t nbTurns, bool forced)
@@ -125,9 +123,8 @@ bool CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(Creatu
         }
     }
 
-    // If we still haven't found a tile to claim, we try to take the closest one
-    float distBest = -1;
-    Tile* tileToClaim = nullptr;
+    // If we still haven't found a tile to claim, we try to take the closest one (by walking cost)
+    std::vector<Tile*> tilesToClaim;
     for (Tile* tile : creature.getTilesWithinSightRadius())
     {
         // if this tile is not fully claimed yet or the tile is of another player's color
@@ -137,15 +134,9 @@ bool CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(Creatu
             continue;
         if(!tile->isGroundClaimable(creature.getSeat()))
             continue;
-        if(!creature.getGameMap()->pathExists(&creature, myTile, tile))
-            continue;
         if(!tile->canWorkerClaim(creature))
             continue;
 
-        float dist = Pathfinding::squaredDistanceTile(*myTile, *tile);
-        if((distBest != -1) && (distBest <= dist))
-            continue;
-
         // Check to see if one of the tile's neighbors is claimed for our color
         for (Tile* neigh : tile->getAllNeighbors())
         {
@@ -156,12 +147,16 @@ bool CreatureActionSearchGroundTileToClaim::handleSearchGroundTileToClaim(Creatu
             if(neigh->getClaimedPercentage() < 1.0)
                 continue;
 
-            distBest = dist;
-            tileToClaim = tile;
+            tilesToClaim.push_back(tile);
             break;
         }
     }
 
+    Tile* tileToClaim = nullptr;
+    std::vector<Tile*> nearestTiles;
+    if(creature.getGameMap()->findNearestReachableTiles(&creature, myTile, tilesToClaim, 1, nearestTiles) > 0)
+        tileToClaim = nearestTiles[0];
+
     // Check if we found a tile
     if(tileToClaim != nullptr)
     {
@@ -35,10 +35,9 @@
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
 
-std::function<bool()> CreatureActionSearchJob::action()
+bool CreatureActionSearchJob::action()
 {
-    return std::bind(&CreatureActionSearchJob::handleSearchJob,
-        std::ref(mCreature), mForced);
+    return CreatureActionSearchJob::handleSearchJob(mCreature, mForced);
 }
 
 bool CreatureActionSearchJob::handleSearchJob(Creature& creature, bool forced)
@@ -25,12 +25,13 @@
 #include "game/Player.h"
 #include "game/Seat.h"
 #include "gamemap/GameMap.h"
-#include "gamemap/Pathfinding.h"
 #include "rooms/Room.h"
 #include "utils/Helper.h"
 #include "utils/MakeUnique.h"
 #include "utils/LogManager.h"
 
+#include <algorithm>
+
 CreatureActionSearchTileToDig::CreatureActionSearchTileToDig(Creature& creature, bool forced) :
     CreatureAction(creature),
     mForced(forced)
@@ -43,10 +44,9 @@ CreatureActionSearchTileToDig::~CreatureActionSearchTileToDig()
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
 
-std::function<bool()> CreatureActionSearchTileToDig::action()
+bool CreatureActionSearchTileToDig::action()
 {
-    return std::bind(&CreatureActionSearchTileToDig::handleSearchTileToDig,
-        std::ref(mCreature), getNbTurns(), mForced);
+    return CreatureActionSearchTileToDig::handleSearchTileToDig(mCreature, getNbTurns(), mForced);
 }
 
 bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, int32_t nbTurns, bool forced)
@@ -108,10 +108,10 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
         return true;
     }
 
-    // Find the closest tile to dig
-    float distBest = -1;
-    Tile* tileToDig = nullptr;
-    Tile* tilePos = nullptr;
+    // Find the closest tile to dig. We gather the tiles where the worker could stand to dig and
+    // search the nearest one by walking cost
+    std::vector<Tile*> tilesPos;
+    std::vector<Tile*> tilesToDig;
     for (Tile* tile : creature.getTilesWithinSightRadius())
     {
         // Check to see whether the tile is marked for digging
@@ -121,25 +121,24 @@ bool CreatureActionSearchTileToDig::handleSearchTileToDig(Creature& creature, in
         // and there is still room to work on it
         std::vector<Tile*> tiles;
         tile->canWorkerDig(creature, tiles);
-        if(tiles.empty())
-            continue;
-
-        // We search for the closest neighbor tile
         for (Tile* neighborTile : tiles)
         {
-            if (!creature.getGameMap()->pathExists(&creature, myTile, neighborTile))
-                continue;
-
-            float dist = Pathfinding::squaredDistanceTile(*myTile, *neighborTile);
-            if((distBest != -1) && (distBest <= dist))
-                continue;
-
-            distBest = dist;
-            tileToDig = tile;
-            tilePos = neighborTile;
+            tilesPos.push_back(neighborTile);
+            tilesToDig.push_back(tile);
         }
     }
 
+    Tile* tileToDig = nullptr;
+    Tile* tilePos = nullptr;
+    std::vector<Tile*> nearestTiles;
+    if(creature.getGameMap()->findNearestReachableTiles(&creature, myTile, tilesPos, 1, nearestTiles) > 0)
+    {
+        tilePos = nearestTiles[0];
+        // If a tile can be used to dig several tiles, we take the first one
+        auto it = std::find(tilesPos.begin(), tilesPos.end(), tilePos);
+        tileToDig = tilesToDig[it - tilesPos.begin()];
+    }
+
     if((tileToDig != nullptr) && (tilePos != nullptr))
     {
         // We also push the dig action to lock the tile to make sure not every worker will try to go to the same tile
@@ -39,10 +39,9 @@ CreatureActionSearchWallTileToClaim::~CreatureActionSearchWallTileToClaim()
 {
     mCreature.getSeat()->getPlayer()->notifyWorkerStopsAction(mCreature, getType());
 }
-std::function<bool()> CreatureActionSearchWallTileToClaim::action()
+bool CreatureActionSearchWallTileToClaim::action()
 {
-    return std::bind(&CreatureActionSearchWallTileToClaim::handleSearchWallTileToClaim,
-        std::ref(mCreature), getNbTurns(), mForced);
+    return CreatureActionSearchWallTileToClaim::handleSearchWallTileToClaim(mCreature, getNbTurns(), mForced);
 }
 
 bool CreatureActionSearchWallTileToClaim::handleSearchWallTileToClaim(Creature& creature, int32_t nbTurns, bool forced)
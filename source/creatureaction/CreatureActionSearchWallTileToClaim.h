@@ -29,7 +29,7 @@ public:
     CreatureActionType getType() const override
     { return CreatureActionType::searchWallTileToClaim; }
 
-    std::function<bool()> action() override;
+    bool action() override;
 
     static bool handleSearchWallTileToClaim(Creature& creature, int32_t nbTurns, bool forced);
 
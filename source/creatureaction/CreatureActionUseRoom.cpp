@@ -56,10 +56,9 @@ CreatureActionUseRoom::~CreatureActionUseRoom()
     }
 }
 
-std::function<bool()> CreatureActionUseRoom::action()
+bool CreatureActionUseRoom::action()
 {
-    return std::bind(&CreatureActionUseRoom::handleJob,
-        std::ref(mCreature), mRoom, mForced);
+    return CreatureActionUseRoom::handleJob(mCreature, mRoom, mForced);
 }
 
 bool CreatureActionUseRoom::handleJob(Creature& creature, Room* room, bool forced)
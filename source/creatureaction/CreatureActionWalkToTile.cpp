@@ -19,12 +19,9 @@
 
 #include "entities/Creature.h"
 
-#include <functional>
-
-std::function<bool()> CreatureActionWalkToTile::action()
+bool CreatureActionWalkToTile::action()
 {
-    return std::bind(&CreatureActionWalkToTile::handleWalkToTile,
-        std::ref(mCreature));
+    return CreatureActionWalkToTile::handleWalkToTile(mCreature);
 }
 
 bool CreatureActionWalkToTile::handleWalkToTile(Creature& creature)
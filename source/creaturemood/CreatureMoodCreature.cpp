@@ -23,6 +23,7 @@
 #include "entities/GameEntityType.h"
 #include "gamemap/GameMap.h"
 #include "utils/LogManager.h"
+#include "utils/ScratchVector.h"
 
 static const std::string CreatureMoodCreatureName = "Creature";
 
@@ -50,10 +51,10 @@ const std::string& CreatureMoodCreature::getModifierName() const
 
 int32_t CreatureMoodCreature::computeMood(const Creature& creature) const
 {
-    std::vector<GameEntity*> alliedCreatures = creature.getGameMap()->getVisibleCreatures(creature.getVisibleTiles(),
-        creature.getSeat(), false);
+    ScratchVector<GameEntity*> alliedCreatures;
+    creature.getGameMap()->getVisibleCreatures(creature, creature.getSeat(), false, *alliedCreatures);
     int nbCreatures = 0;
-    for(GameEntity* entity : alliedCreatures)
+    for(GameEntity* entity : *alliedCreatures)
     {
         if(entity->getObjectType() != GameEntityType::creature)
             continue;
@@ -74,6 +74,7 @@
 #include "utils/LogManager.h"
 #include "utils/MakeUnique.h"
 #include "utils/Random.h"
+#include "utils/TurnProfiler.h"
 
 #include <CEGUI/Event.h>
 #include <CEGUI/System.h>
@@ -97,6 +98,46 @@
 
 static const Ogre::Real CANNON_MISSILE_HEIGHT = 0.3;
 
+//! \brief Fields sent by Creature::exportRefreshStateToPacket
+namespace CreatureRefreshFields
+{
+    const uint32_t Level = 0x0001;
+    const uint32_t SeatId = 0x0002;
+    const uint32_t OverlayHealth = 0x0004;
+    const uint32_t OverlayMood = 0x0008;
+    const uint32_t GroundSpeed = 0x0010;
+    const uint32_t WaterSpeed = 0x0020;
+    const uint32_t LavaSpeed = 0x0040;
+    const uint32_t SpeedModifier = 0x0080;
+    const uint32_t SeatPrisonId = 0x0100;
+    const uint32_t Effects = 0x0200;
+}
+
+//! \brief Speeds are sent in entitiesRefresh as variable length integers in thousandths. The
+//! client moves the creatures to the destinations sent by the server so the rounding does not
+//! make them drift
+static const double SPEED_QUANTIZATION = 1000.0;
+
+static uint32_t quantizeSpeed(double speed)
+{
+    return static_cast<uint32_t>(std::max(0.0, speed) * SPEED_QUANTIZATION + 0.5);
+}
+
+//! \brief Removes the entities that were removed from the map or killed since they were sensed
+static void removeStaleEntities(std::vector<GameEntity*>& entities)
+{
+    entities.erase(std::remove_if(entities.begin(), entities.end(), [](GameEntity* entity)
+    {
+        if(!entity->getIsOnMap())
+            return true;
+
+        if(entity->getObjectType() != GameEntityType::creature)
+            return false;
+
+        return !static_cast<Creature*>(entity)->isAlive();
+    }), entities.end());
+}
+
 const int32_t Creature::NB_TURNS_BEFORE_CHECKING_TASK = 15;
 const uint32_t Creature::NB_OVERLAY_HEALTH_VALUES = 8;
 
@@ -156,6 +197,10 @@ Creature::Creature(GameMap* gameMap, const CreatureDefinition* definition, Seat*
     mWeaponDropDeath         ("none"),
     mStatsWindow             (nullptr),
     mNbTurnsWithoutBattle    (0),
+    mSightTile               (nullptr),
+    mSightRadius             (0),
+    mVisionTile              (nullptr),
+    mSensingTurn             (-1),
     mCarriedEntity           (nullptr),
     mMoodCooldownTurns       (0),
     mMoodValue               (CreatureMoodLevel::Neutral),
@@ -234,6 +279,10 @@ Creature::Creature(GameMap* gameMap) :
     mWeaponDropDeath         ("none"),
     mStatsWindow             (nullptr),
     mNbTurnsWithoutBattle    (0),
+    mSightTile               (nullptr),
+    mSightRadius             (0),
+    mVisionTile              (nullptr),
+    mSensingTurn             (-1),
     mCarriedEntity           (nullptr),
     mMoodCooldownTurns       (0),
     mMoodValue               (CreatureMoodLevel::Neutral),
@@ -677,25 +726,36 @@ void Creature::update(Ogre::Real timeSinceLastFrame)
 
 void Creature::computeVisibleTiles()
 {
-    // dead Creatures do not give vision
-    if (getHP() <= 0.0)
-        return;
-
-    // KO Creatures do not give vision
-    if (isKo())
-        return;
+    // dead Creatures do not give vision. Neither do KO creatures
+    // nor creatures in jail
+    Tile* posTile = nullptr;
+    if((getHP() > 0.0) &&
+       !isKo() &&
+       (mSeatPrison == nullptr) &&
+       getIsOnMap())
+    {
+        posTile = getPositionTile();
+    }
 
-    // creatures in jail do not give vision
-    if (mSeatPrison != nullptr)
+    if(posTile == nullptr)
+    {
+        removeVisionGiven();
+        mVisionTile = nullptr;
         return;
+    }
 
-    if (!getIsOnMap())
+    // If the creature did not move and nothing changed around, the vision is the same
+    if((posTile == mVisionTile) &&
+       (getVisionGivenSeat() == getSeat()) &&
+       !getGameMap()->isPermitsVisionChangedAround(posTile->getX(), posTile->getY(), mDefinition->getSightRadius()))
+    {
         return;
+    }
 
     // Look at the surrounding area
+    mVisionTile = posTile;
     updateTilesInSight();
-    for(Tile* tile : mVisibleTiles)
-        tile->notifyVision(getSeat());
+    setVisionGiven(getSeat(), mVisibleTiles);
 }
 
 void Creature::setLevel(unsigned int level)
@@ -749,6 +809,20 @@ void Creature::dropCarriedEquipment()
     // TODO: drop weapon when available
 }
 
+//! \brief Profiler section used for the given action type. The profiler needs names that are
+//! never freed so they are built once
+static const char* getActionProfilerSection(CreatureActionType type)
+{
+    static const std::vector<std::string> sections = []()
+    {
+        std::vector<std::string> names;
+        for(uint32_t i = 0; i < static_cast<uint32_t>(CreatureActionType::nb); ++i)
+            names.push_back(CreatureAction::toString(static_cast<CreatureActionType>(i)));
+        return names;
+    }();
+    return sections[static_cast<uint32_t>(type)].c_str();
+}
+
 void Creature::doUpkeep()
 {
     // If the creature is in jail, we check if it is still standing on it (if not picked up). If
@@ -896,9 +970,19 @@ void Creature::doUpkeep()
         increaseHunger(mDefinition->getHungerGrowthPerTurn());
     }
 
-    mVisibleEnemyObjects         = getVisibleEnemyObjects();
-    mVisibleAlliedObjects        = getVisibleAlliedObjects();
-    mReachableAlliedObjects      = getReachableAttackableObjects(mVisibleAlliedObjects);
+    // The objects are usually sensed in parallel for every creature before the upkeep. If this creature
+    // was not (for example if it was freed from jail this turn), we do it now. Otherwise, we forget the
+    // objects that died or were removed from the map by the creatures that acted before
+    if(mSensingTurn != getGameMap()->getTurnNumber())
+    {
+        senseSurroundings();
+    }
+    else
+    {
+        removeStaleEntities(mVisibleEnemyObjects);
+        removeStaleEntities(mVisibleAlliedObjects);
+        removeStaleEntities(mReachableAlliedObjects);
+    }
 
     // Check if we should compute mood
     if(mMoodCooldownTurns > 0)
@@ -986,8 +1070,8 @@ void Creature::doUpkeep()
 
         if (mActions.empty())
         {
+            OD_PROFILE_SCOPE("idle");
             loopBack = handleIdleAction();
-            OD_LOG_DBG("creature=" + getName() + " action queue empty, defaulting to idle, result=" + (loopBack?"1":"0"));
         }
         else
         {
@@ -995,9 +1079,8 @@ void Creature::doUpkeep()
             // We save the action type here because the action may be removed after calling
             // the action function
             CreatureActionType actType = act->getType();
-            std::function<bool()> func = act->action();
-            loopBack = func();
-            OD_LOG_DBG("creature=" + getName() + " trying action=" + CreatureAction::toString(actType) + ", result=" + std::string(loopBack?"1":"0"));
+            OD_PROFILE_SCOPE(getActionProfilerSection(actType));
+            loopBack = act->action();
         }
     } while (loopBack && loops < 20);
 
@@ -1274,7 +1357,7 @@ bool Creature::searchBestTargetInList(const std::vector<GameEntity*>& listObject
         std::vector<Tile*> coveredTiles = entity->getCoveredTiles();
         for(Tile* tile : coveredTiles)
         {
-            if(std::find(mVisibleTiles.begin(), mVisibleTiles.end(), tile) == mVisibleTiles.end())
+            if(!isTileVisible(tile))
                 continue;
 
             int dist = Pathfinding::squaredDistanceTile(*tile, *myTile);
@@ -1560,12 +1643,16 @@ void Creature::checkLevelUp()
 
 void Creature::exportToPacketForUpdate(ODPacket& os, const Seat* seat) const
 {
-    MovableGameEntity::exportToPacketForUpdate(os, seat);
+    RefreshState state;
+    computeRefreshState(seat, state);
+    exportRefreshStateToPacket(os, state, nullptr);
+}
 
-    int seatId = getSeat()->getId();
-    os << mLevel;
-    os << seatId;
-    os << mOverlayHealthValue;
+void Creature::computeRefreshState(const Seat* seat, RefreshState& state) const
+{
+    state.mLevel = mLevel;
+    state.mSeatId = getSeat()->getId();
+    state.mOverlayHealthValue = mOverlayHealthValue;
 
     // Only allied players should see creature mood (except some states)
     uint32_t moodValue = 0;
@@ -1578,63 +1665,198 @@ void Creature::exportToPacketForUpdate(ODPacket& os, const Seat* seat) const
         else
             moodValue = mOverlayMoodValue & CreatureMoodValues::MoodPrisonFiltersAllPlayers;
     }
+    state.mOverlayMoodValue = moodValue;
 
-    os << moodValue;
-    os << mGroundSpeed;
-    os << mWaterSpeed;
-    os << mLavaSpeed;
-    os << mSpeedModifier;
+    state.mGroundSpeed = quantizeSpeed(mGroundSpeed);
+    state.mWaterSpeed = quantizeSpeed(mWaterSpeed);
+    state.mLavaSpeed = quantizeSpeed(mLavaSpeed);
+    state.mSpeedModifier = quantizeSpeed(mSpeedModifier);
+    state.mSeatPrisonId = (mSeatPrison != nullptr) ? mSeatPrison->getId() : -1;
 
-    int seatPrisonId = -1;
-    if(mSeatPrison != nullptr)
-        seatPrisonId = mSeatPrison->getId();
+    state.mEffectNames.clear();
+    for(EntityParticleEffect* effect : mEntityParticleEffects)
+        state.mEffectNames.push_back(effect->mName);
+}
+
+bool Creature::exportRefreshStateToPacket(ODPacket& os, const RefreshState& state, const RefreshState* lastSent) const
+{
+    // The client only adds the effects it does not have yet (it removes them by itself when they end).
+    // So we only send the ones not sent yet
+    std::vector<const EntityParticleEffect*> newEffects;
+    for(EntityParticleEffect* effect : mEntityParticleEffects)
+    {
+        if((lastSent != nullptr) &&
+           (std::find(lastSent->mEffectNames.begin(), lastSent->mEffectNames.end(), effect->mName) != lastSent->mEffectNames.end()))
+        {
+            continue;
+        }
+        newEffects.push_back(effect);
+    }
+
+    uint32_t fields = 0;
+    if((lastSent == nullptr) || (lastSent->mLevel != state.mLevel))
+        fields |= CreatureRefreshFields::Level;
+    if((lastSent == nullptr) || (lastSent->mSeatId != state.mSeatId))
+        fields |= CreatureRefreshFields::SeatId;
+    if((lastSent == nullptr) || (lastSent->mOverlayHealthValue != state.mOverlayHealthValue))
+        fields |= CreatureRefreshFields::OverlayHealth;
+    if((lastSent == nullptr) || (lastSent->mOverlayMoodValue != state.mOverlayMoodValue))
+        fields |= CreatureRefreshFields::OverlayMood;
+    if((lastSent == nullptr) || (lastSent->mGroundSpeed != state.mGroundSpeed))
+        fields |= CreatureRefreshFields::GroundSpeed;
+    if((lastSent == nullptr) || (lastSent->mWaterSpeed != state.mWaterSpeed))
+        fields |= CreatureRefreshFields::WaterSpeed;
+    if((lastSent == nullptr) || (lastSent->mLavaSpeed != state.mLavaSpeed))
+        fields |= CreatureRefreshFields::LavaSpeed;
+    if((lastSent == nullptr) || (lastSent->mSpeedModifier != state.mSpeedModifier))
+        fields |= CreatureRefreshFields::SpeedModifier;
+    if((lastSent == nullptr) || (lastSent->mSeatPrisonId != state.mSeatPrisonId))
+        fields |= CreatureRefreshFields::SeatPrisonId;
+    if((lastSent == nullptr) || !newEffects.empty())
+        fields |= CreatureRefreshFields::Effects;
+
+    if(fields == 0)
+        return false;
 
-    os << seatPrisonId;
+    os.writeVarUInt32(fields);
+    if((fields & CreatureRefreshFields::Level) != 0)
+        os.writeVarUInt32(state.mLevel);
+    // Seat ids can be -1 (no seat) so we shift them to send them as unsigned
+    if((fields & CreatureRefreshFields::SeatId) != 0)
+        os.writeVarUInt32(static_cast<uint32_t>(state.mSeatId + 1));
+    if((fields & CreatureRefreshFields::OverlayHealth) != 0)
+        os.writeVarUInt32(state.mOverlayHealthValue);
+    if((fields & CreatureRefreshFields::OverlayMood) != 0)
+        os.writeVarUInt32(state.mOverlayMoodValue);
+    if((fields & CreatureRefreshFields::GroundSpeed) != 0)
+        os.writeVarUInt32(state.mGroundSpeed);
+    if((fields & CreatureRefreshFields::WaterSpeed) != 0)
+        os.writeVarUInt32(state.mWaterSpeed);
+    if((fields & CreatureRefreshFields::LavaSpeed) != 0)
+        os.writeVarUInt32(state.mLavaSpeed);
+    if((fields & CreatureRefreshFields::SpeedModifier) != 0)
+        os.writeVarUInt32(state.mSpeedModifier);
+    if((fields & CreatureRefreshFields::SeatPrisonId) != 0)
+        os.writeVarUInt32(static_cast<uint32_t>(state.mSeatPrisonId + 1));
+    if((fields & CreatureRefreshFields::Effects) != 0)
+    {
+        // Same format as GameEntity::exportToPacketForUpdate
+        uint32_t nbEffects = newEffects.size();
+        os << nbEffects;
+        for(const EntityParticleEffect* effect : newEffects)
+            EntityParticleEffect::exportParticleEffectToPacket(*effect, os);
+    }
+
+    return true;
 }
 
 void Creature::updateFromPacket(ODPacket& is)
 {
-    MovableGameEntity::updateFromPacket(is);
-
-    int seatId;
-    OD_ASSERT_TRUE(is >> mLevel);
-    OD_ASSERT_TRUE(is >> seatId);
-    OD_ASSERT_TRUE(is >> mOverlayHealthValue);
-    OD_ASSERT_TRUE(is >> mOverlayMoodValue);
-    OD_ASSERT_TRUE(is >> mGroundSpeed);
-    OD_ASSERT_TRUE(is >> mWaterSpeed);
-    OD_ASSERT_TRUE(is >> mLavaSpeed);
-    OD_ASSERT_TRUE(is >> mSpeedModifier);
+    // This function should read parameters as sent by Creature::exportRefreshStateToPacket
+    uint32_t fields;
+    OD_ASSERT_TRUE(is.readVarUInt32(fields));
 
-    // We do not scale the creature if it is picked up (because it is already not at its normal size). It will be
-    // resized anyway when dropped
-    if(getIsOnMap())
-        RenderManager::getSingleton().rrScaleCreature(*this);
+    if((fields & CreatureRefreshFields::Level) != 0)
+    {
+        uint32_t level;
+        OD_ASSERT_TRUE(is.readVarUInt32(level));
+        mLevel = level;
+    }
 
-    if(getSeat()->getId() != seatId)
+    if((fields & CreatureRefreshFields::SeatId) != 0)
     {
-        Seat* seat = getGameMap()->getSeatById(seatId);
-        if(seat == nullptr)
+        uint32_t value;
+        OD_ASSERT_TRUE(is.readVarUInt32(value));
+        int seatId = static_cast<int>(value) - 1;
+        if(getSeat()->getId() != seatId)
         {
-            OD_LOG_ERR("Creature " + getName() + ", wrong seatId=" + Helper::toString(seatId));
+            Seat* seat = getGameMap()->getSeatById(seatId);
+            if(seat == nullptr)
+            {
+                OD_LOG_ERR("Creature " + getName() + ", wrong seatId=" + Helper::toString(seatId));
+            }
+            else
+            {
+                setSeat(seat);
+            }
         }
+    }
+
+    if((fields & CreatureRefreshFields::OverlayHealth) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(mOverlayHealthValue));
+    }
+
+    if((fields & CreatureRefreshFields::OverlayMood) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(mOverlayMoodValue));
+    }
+
+    uint32_t speed;
+    if((fields & CreatureRefreshFields::GroundSpeed) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(speed));
+        mGroundSpeed = speed / SPEED_QUANTIZATION;
+    }
+    if((fields & CreatureRefreshFields::WaterSpeed) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(speed));
+        mWaterSpeed = speed / SPEED_QUANTIZATION;
+    }
+    if((fields & CreatureRefreshFields::LavaSpeed) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(speed));
+        mLavaSpeed = speed / SPEED_QUANTIZATION;
+    }
+    if((fields & CreatureRefreshFields::SpeedModifier) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(speed));
+        mSpeedModifier = speed / SPEED_QUANTIZATION;
+    }
+
+    if((fields & CreatureRefreshFields::SeatPrisonId) != 0)
+    {
+        uint32_t value;
+        OD_ASSERT_TRUE(is.readVarUInt32(value));
+        int seatId = static_cast<int>(value) - 1;
+        if(seatId == -1)
+            mSeatPrison = nullptr;
         else
         {
-            setSeat(seat);
+            mSeatPrison = getGameMap()->getSeatById(seatId);
+            if(mSeatPrison == nullptr)
+            {
+                OD_LOG_ERR("Creature " + getName() + ", wrong seatId=" + Helper::toString(seatId));
+            }
         }
     }
 
-    OD_ASSERT_TRUE(is >> seatId);
-    if(seatId == -1)
-        mSeatPrison = nullptr;
-    else
+    if((fields & CreatureRefreshFields::Effects) != 0)
+        MovableGameEntity::updateFromPacket(is);
+
+    // We do not scale the creature if it is picked up (because it is already not at its normal size). It will be
+    // resized anyway when dropped
+    if(getIsOnMap() && ((fields & CreatureRefreshFields::Level) != 0))
+        RenderManager::getSingleton().rrScaleCreature(*this);
+}
+
+void Creature::senseSurroundings()
+{
+    // Only creatures that will act during their upkeep need to sense
+    if(!getIsOnMap() ||
+       !isAlive() ||
+       (mKoTurnCounter != 0) ||
+       (mSeatPrison != nullptr) ||
+       (getPositionTile() == nullptr))
     {
-        mSeatPrison = getGameMap()->getSeatById(seatId);
-        if(mSeatPrison == nullptr)
-        {
-            OD_LOG_ERR("Creature " + getName() + ", wrong seatId=" + Helper::toString(seatId));
-        }
+        return;
     }
+
+    // The lists are filled in place to reuse their memory from one turn to the other
+    getGameMap()->getVisibleForce(*this, getSeat(), true, mVisibleEnemyObjects);
+    getGameMap()->getVisibleForce(*this, getSeat(), false, mVisibleAlliedObjects);
+    getReachableAttackableObjects(mVisibleAlliedObjects, mReachableAlliedObjects);
+    mSensingTurn = getGameMap()->getTurnNumber();
 }
 
 void Creature::updateTilesInSight()
@@ -1644,10 +1866,35 @@ void Creature::updateTilesInSight()
         return;
 
     // The tiles with sight radius without constraints
-    mTilesWithinSightRadius = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    getGameMap()->circularRegion(posTile->getX(), posTile->getY(), mDefinition->getSightRadius(), mTilesWithinSightRadius);
 
     // Only the tiles the creature can "see".
-    mVisibleTiles = getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius());
+    getGameMap()->visibleTiles(posTile->getX(), posTile->getY(), mDefinition->getSightRadius(), mVisibleTiles);
+
+    mSightTile = posTile;
+    mSightRadius = mDefinition->getSightRadius();
+    int side = 2 * mSightRadius + 1;
+    mVisibleTilesMask.assign(side * side, false);
+    for(Tile* tile : mVisibleTiles)
+    {
+        int x = tile->getX() - posTile->getX() + mSightRadius;
+        int y = tile->getY() - posTile->getY() + mSightRadius;
+        mVisibleTilesMask[y * side + x] = true;
+    }
+}
+
+bool Creature::isTileVisible(const Tile* tile) const
+{
+    if(mSightTile == nullptr)
+        return false;
+
+    int x = tile->getX() - mSightTile->getX() + mSightRadius;
+    int y = tile->getY() - mSightTile->getY() + mSightRadius;
+    int side = 2 * mSightRadius + 1;
+    if((x < 0) || (x >= side) || (y < 0) || (y >= side))
+        return false;
+
+    return mVisibleTilesMask[y * side + x];
 }
 
 std::vector<GameEntity*> Creature::getVisibleEnemyObjects()
@@ -1658,6 +1905,13 @@ std::vector<GameEntity*> Creature::getVisibleEnemyObjects()
 std::vector<GameEntity*> Creature::getReachableAttackableObjects(const std::vector<GameEntity*>& objectsToCheck)
 {
     std::vector<GameEntity*> tempVector;
+    getReachableAttackableObjects(objectsToCheck, tempVector);
+    return tempVector;
+}
+
+void Creature::getReachableAttackableObjects(const std::vector<GameEntity*>& objectsToCheck, std::vector<GameEntity*>& tempVector)
+{
+    tempVector.clear();
     Tile* myTile = getPositionTile();
 
     // Loop over the vector of objects we are supposed to check.
@@ -1673,8 +1927,6 @@ std::vector<GameEntity*> Creature::getReachableAttackableObjects(const std::vect
         if (getGameMap()->pathExists(this, myTile, objectTile))
             tempVector.push_back(objectsToCheck[i]);
     }
-
-    return tempVector;
 }
 
 std::vector<GameEntity*> Creature::getCreaturesFromList(const std::vector<GameEntity*> &objectsToCheck, bool workersOnly)
@@ -1706,7 +1958,9 @@ std::vector<GameEntity*> Creature::getVisibleAlliedObjects()
 
 std::vector<GameEntity*> Creature::getVisibleForce(Seat* seat, bool invert)
 {
-    return getGameMap()->getVisibleForce(mVisibleTiles, seat, invert);
+    std::vector<GameEntity*> entities;
+    getGameMap()->getVisibleForce(*this, seat, invert, entities);
+    return entities;
 }
 
 void Creature::computeVisualDebugEntities()
@@ -2461,8 +2715,7 @@ void Creature::releaseCarriedEntity()
 
         ServerNotification* serverNotification = new ServerNotification(
             ServerNotificationType::releaseCarriedEntity, seat->getPlayer());
-        serverNotification->mPacket << getName() << carriedEntity->getObjectType();
-        serverNotification->mPacket << carriedEntity->getName();
+        serverNotification->mPacket << getId() << carriedEntity->getId();
         serverNotification->mPacket << mPosition;
         ODServer::getSingleton().queueServerNotification(serverNotification);
     }
@@ -2521,6 +2774,9 @@ void Creature::slap()
 
 void Creature::fireAddEntity(Seat* seat, bool async)
 {
+    // The client will get the full state. Next refresh will send every field
+    mRefreshStatesSent.erase(seat);
+
     if(async)
     {
         ServerNotification serverNotification(
@@ -2548,33 +2804,30 @@ void Creature::fireAddEntity(Seat* seat, bool async)
 
         serverNotification = new ServerNotification(
             ServerNotificationType::carryEntity, seat->getPlayer());
-        serverNotification->mPacket << getName() << mCarriedEntity->getObjectType();
-        serverNotification->mPacket << mCarriedEntity->getName();
+        serverNotification->mPacket << getId() << mCarriedEntity->getId();
         ODServer::getSingleton().queueServerNotification(serverNotification);
     }
 }
 
 void Creature::fireRemoveEntity(Seat* seat)
 {
+    mRefreshStatesSent.erase(seat);
+
     // If we are carrying an entity, we release it first, then we can remove it and us
     if(mCarriedEntity != nullptr)
     {
         ServerNotification* serverNotification = new ServerNotification(
             ServerNotificationType::releaseCarriedEntity, seat->getPlayer());
-        serverNotification->mPacket << getName() << mCarriedEntity->getObjectType();
-        serverNotification->mPacket << mCarriedEntity->getName();
+        serverNotification->mPacket << getId() << mCarriedEntity->getId();
         serverNotification->mPacket << mPosition;
         ODServer::getSingleton().queueServerNotification(serverNotification);
 
         mCarriedEntity->removeSeatWithVision(seat);
     }
 
-    const std::string& name = getName();
     ServerNotification *serverNotification = new ServerNotification(
         ServerNotificationType::removeEntity, seat->getPlayer());
-    GameEntityType type = getObjectType();
-    serverNotification->mPacket << type;
-    serverNotification->mPacket << name;
+    serverNotification->mPacket << getId();
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
@@ -2591,15 +2844,32 @@ void Creature::fireCreatureRefreshIfNeeded()
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        const std::string& name = getName();
+        // A late client will get what changed since the last state sent when it catches up
+        if(ODServer::getSingleton().isPlayerCatchingUp(seat->getPlayer()))
+        {
+            mNeedFireRefresh = true;
+            continue;
+        }
+
+        RefreshState state;
+        computeRefreshState(seat, state);
+        auto it = mRefreshStatesSent.find(seat);
+        const RefreshState* lastSent = (it == mRefreshStatesSent.end()) ? nullptr : &it->second;
+
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::entitiesRefresh, seat->getPlayer());
         uint32_t nbCreature = 1;
-        serverNotification->mPacket << nbCreature;
-        serverNotification->mPacket << GameEntityType::creature;
-        serverNotification->mPacket << name;
-        exportToPacketForUpdate(serverNotification->mPacket, seat);
+        serverNotification->mPacket.writeVarUInt32(nbCreature);
+        serverNotification->mPacket.writeVarUInt32(getId());
+        // If nothing visible by this seat changed, there is no need to send anything
+        if(!exportRefreshStateToPacket(serverNotification->mPacket, state, lastSent))
+        {
+            delete serverNotification;
+            continue;
+        }
+
         ODServer::getSingleton().queueServerNotification(serverNotification);
+        mRefreshStatesSent[seat] = std::move(state);
     }
 }
 
@@ -27,6 +27,7 @@
 #include <OgreVector3.h>
 #include <CEGUI/EventArgs.h>
 
+#include <map>
 #include <memory>
 #include <string>
 
@@ -249,7 +250,13 @@ public:
      */
     void doUpkeep() override;
 
-    //! \brief Computes the visible tiles and tags them to know which are visible
+    //! \brief Computes the visible and reachable objects used by the next doUpkeep. It does not modify the
+    //! game map (the floodfill regions are read with the const FloodFillRegions::find) so that it can be
+    //! called in parallel for different creatures before the upkeep
+    void senseSurroundings();
+
+    //! \brief Computes the visible tiles and gives vision on them. The tiles are computed again only if the
+    //! creature moved or if a tile around started or stopped blocking vision
     void computeVisibleTiles();
 
     virtual bool isAttackable(Tile* tile, Seat* seat) const override;
@@ -271,6 +278,9 @@ public:
     //! \brief Loops over objectsToCheck and returns a vector containing all the ones which can be reached via a valid path.
     std::vector<GameEntity*> getReachableAttackableObjects(const std::vector<GameEntity*> &objectsToCheck);
 
+    //! \brief Same as above but fills reachableObjects (that is cleared first). It should not be objectsToCheck
+    void getReachableAttackableObjects(const std::vector<GameEntity*>& objectsToCheck, std::vector<GameEntity*>& reachableObjects);
+
     //! \brief Loops over objectsToCheck and returns a vector containing all the creatures in the list.
     std::vector<GameEntity*> getCreaturesFromList(const std::vector<GameEntity*> &objectsToCheck, bool workersOnly);
 
@@ -398,6 +408,16 @@ public:
     inline const std::vector<Tile*>& getVisibleTiles() const
     { return mVisibleTiles; }
 
+    //! \brief Tells if the given tile is in the visible tiles. Constant time
+    bool isTileVisible(const Tile* tile) const;
+
+    //! \brief Tile from which the visible tiles were computed and sight radius used (see updateTilesInSight)
+    inline Tile* getSightTile() const
+    { return mSightTile; }
+
+    inline int getSightRadius() const
+    { return mSightRadius; }
+
     inline const std::vector<Tile*>& getTilesWithinSightRadius() const
     { return mTilesWithinSightRadius; }
 
@@ -550,6 +570,8 @@ public:
 
     virtual void clientUpkeep() override;
 
+    //! \brief Exports every refreshed field. fireCreatureRefreshIfNeeded only exports the
+    //! fields that changed since the last refresh sent to the seat
     virtual void exportToPacketForUpdate(ODPacket& os, const Seat* seat) const override;
     virtual void updateFromPacket(ODPacket& is) override;
 
@@ -684,9 +706,20 @@ private:
     //! used for actions linked to enemies.
     std::vector<Tile*>              mVisibleTiles;
 
+    //! \brief Visible tiles as a bitset over the square of side 2 * mSightRadius + 1 centered
+    //! on mSightTile. Used to know in constant time if a tile is visible
+    std::vector<bool>               mVisibleTilesMask;
+    Tile*                           mSightTile;
+    int                             mSightRadius;
+
+    //! \brief Tile where the creature was when its vision was last computed (see computeVisibleTiles)
+    Tile*                           mVisionTile;
+
     std::vector<GameEntity*>        mVisibleEnemyObjects;
     std::vector<GameEntity*>        mVisibleAlliedObjects;
     std::vector<GameEntity*>        mReachableAlliedObjects;
+    //! \brief Turn when senseSurroundings last computed the visible and reachable objects
+    int64_t                         mSensingTurn;
     std::vector<std::unique_ptr<CreatureAction>>    mActions;
     std::vector<Tile*>              mVisualDebugEntityTiles;
 
@@ -761,6 +794,32 @@ private:
     //! \brief Skills the creature can use
     std::vector<CreatureSkillData> mSkillData;
 
+    //! \brief Creature fields as seen by a given seat in entitiesRefresh. Speeds are sent in thousandths
+    struct RefreshState
+    {
+        uint32_t mLevel;
+        int32_t mSeatId;
+        uint32_t mOverlayHealthValue;
+        uint32_t mOverlayMoodValue;
+        uint32_t mGroundSpeed;
+        uint32_t mWaterSpeed;
+        uint32_t mLavaSpeed;
+        uint32_t mSpeedModifier;
+        int32_t mSeatPrisonId;
+        std::vector<std::string> mEffectNames;
+    };
+
+    //! \brief Used on server side. Last refresh state sent to each seat with vision. As TCP delivers
+    //! everything in order, it is also the state the client has. It is forgotten when the seat is
+    //! notified of the creature again (addEntity sends the full state)
+    std::map<const Seat*, RefreshState> mRefreshStatesSent;
+
+    void computeRefreshState(const Seat* seat, RefreshState& state) const;
+
+    //! \brief Exports a bitmask of the fields of state that differ from lastSent followed by these fields.
+    //! If lastSent is nullptr, every field is exported. Returns false (and exports nothing) if nothing changed
+    bool exportRefreshStateToPacket(ODPacket& os, const RefreshState& state, const RefreshState* lastSent) const;
+
     //! \brief A sub-function called by doTurn()
     //! This one checks if there is something prioritary to do (like fighting). If it is the case,
     //! it should empty the action list before adding what to do.
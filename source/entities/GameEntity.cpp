@@ -36,6 +36,8 @@
 
 #include <cassert>
 
+const uint32_t GameEntity::NO_ID = 0;
+
 void EntityParticleEffect::exportParticleEffectToPacket(const EntityParticleEffect& effect, ODPacket& os)
 {
     os << effect.mName;
@@ -88,6 +90,7 @@ GameEntity::GameEntity(
           ) :
     mPosition          (Ogre::Vector3::ZERO),
     mName              (name),
+    mId                (NO_ID),
     mMeshName          (meshName),
     mMeshExists        (false),
     mSeat              (seat),
@@ -98,7 +101,8 @@ GameEntity::GameEntity(
     mIsOnMap           (false),
     mParticleSystemsNumber   (0),
     mCarryLock         (false),
-    mEntityParentNodeAttach     (EntityParentNodeAttach::ATTACHED)
+    mEntityParentNodeAttach     (EntityParentNodeAttach::ATTACHED),
+    mVisionGivenSeat   (nullptr)
 {
     assert(mGameMap != nullptr);
 }
@@ -164,8 +168,7 @@ void GameEntity::removeEntityFromPositionTile()
 void GameEntity::firePickupEntity(Player* playerPicking)
 {
     int seatId = playerPicking->getSeat()->getId();
-    GameEntityType entityType = getObjectType();
-    const std::string& entityName = getName();
+    uint32_t entityId = getId();
     for(std::vector<Seat*>::iterator it = mSeatsWithVisionNotified.begin(); it != mSeatsWithVisionNotified.end();)
     {
         Seat* seat = *it;
@@ -195,14 +198,14 @@ void GameEntity::firePickupEntity(Player* playerPicking)
         {
             ServerNotification serverNotification(
                 ServerNotificationType::entityPickedUp, seat->getPlayer());
-            serverNotification.mPacket << seatId << entityType << entityName;
+            serverNotification.mPacket << seatId << entityId;
             ODServer::getSingleton().sendAsyncMsg(serverNotification);
         }
         else
         {
             ServerNotification* serverNotification = new ServerNotification(
                 ServerNotificationType::entityPickedUp, seat->getPlayer());
-            serverNotification->mPacket << seatId << entityType << entityName;
+            serverNotification->mPacket << seatId << entityId;
             ODServer::getSingleton().queueServerNotification(serverNotification);
         }
     }
@@ -352,6 +355,47 @@ void GameEntity::fireRemoveEntityToSeatsWithVision()
     mSeatsWithVisionNotified.clear();
 }
 
+void GameEntity::setVisionGiven(Seat* seat, const std::vector<Tile*>& tiles)
+{
+    // We add the new vision before removing the old one. That way, the tiles that
+    // were already seen are not notified as lost and gained again
+    if(seat != nullptr)
+    {
+        for(Tile* tile : tiles)
+            tile->addVision(seat);
+    }
+
+    if(mVisionGivenSeat != nullptr)
+    {
+        for(Tile* tile : mVisionGivenTiles)
+            tile->removeVision(mVisionGivenSeat);
+    }
+
+    mVisionGivenSeat = seat;
+    if(seat != nullptr)
+        mVisionGivenTiles = tiles;
+    else
+        mVisionGivenTiles.clear();
+}
+
+void GameEntity::removeVisionGiven()
+{
+    if(mVisionGivenSeat == nullptr)
+        return;
+
+    for(Tile* tile : mVisionGivenTiles)
+        tile->removeVision(mVisionGivenSeat);
+
+    mVisionGivenSeat = nullptr;
+    mVisionGivenTiles.clear();
+}
+
+void GameEntity::forgetVisionGiven()
+{
+    mVisionGivenSeat = nullptr;
+    mVisionGivenTiles.clear();
+}
+
 std::string GameEntity::getGameEntityStreamFormat()
 {
     return "SeatId\tName\tMeshName\tPosX\tPosY\tPosZ";
@@ -375,6 +419,7 @@ void GameEntity::exportToPacket(ODPacket& os, const Seat* seat) const
     if(mSeat != nullptr)
         seatId = mSeat->getId();
 
+    os << mId;
     os << seatId;
     os << mName;
     os << mMeshName;
@@ -389,6 +434,7 @@ void GameEntity::exportToPacket(ODPacket& os, const Seat* seat) const
 void GameEntity::importFromPacket(ODPacket& is)
 {
     int seatId;
+    OD_ASSERT_TRUE(is >> mId);
     OD_ASSERT_TRUE(is >> seatId);
     if(seatId != -1)
         mSeat = mGameMap->getSeatById(seatId);
@@ -23,6 +23,8 @@
 #ifndef GAMEENTITY_H
 #define GAMEENTITY_H
 
+#include "utils/Random.h"
+
 #include <OgreVector3.h>
 #include <string>
 #include <vector>
@@ -162,8 +164,16 @@ class GameEntity
 
     virtual ~GameEntity();
 
+    //! \brief Id of an entity that has not been registered on the server gamemap yet
+    static const uint32_t NO_ID;
+
     std::string getOgreNamePrefix() const;
 
+    //! \brief Get the id of the object. It is given by the server gamemap when the entity is added and is
+    //! used to identify the entity in the messages between the server and the clients
+    inline uint32_t getId() const
+    { return mId; }
+
     //! \brief Get the name of the object
     inline const std::string& getName() const
     { return mName; }
@@ -193,6 +203,9 @@ class GameEntity
     inline void setName(const std::string& name)
     { mName = name; }
 
+    inline void setId(uint32_t id)
+    { mId = id; }
+
     //! \brief Set the name of the mesh file
     inline void setMeshName(const std::string& meshName)
     { mMeshName = meshName; }
@@ -285,6 +298,11 @@ class GameEntity
     //! \brief defines what happens on each turn with this object on server side
     virtual void doUpkeep() = 0;
 
+    //! \brief Server side only. Stream used for the random numbers drawn by this entity during
+    //! the turn. It is seeded from the entity id when first used (see Random::StreamScope)
+    inline RandomStream& getRandomStream()
+    { return mRandomStream; }
+
     //! \brief defines what happens on each turn with this object on client side. Note
     //! that they need to register to GameMap::addClientUpkeepEntity
     virtual void clientUpkeep();
@@ -333,6 +351,22 @@ class GameEntity
     //! \brief Fires remove event to every seat with vision
     virtual void fireRemoveEntityToSeatsWithVision();
 
+    //! \brief Gives vision on the given tiles to the given seat (and its allies). The vision previously
+    //! given by this entity is removed. Tiles seen before and after keep their vision (it is given before
+    //! the old one is removed)
+    void setVisionGiven(Seat* seat, const std::vector<Tile*>& tiles);
+
+    //! \brief Removes the vision given by this entity (if any)
+    void removeVisionGiven();
+
+    //! \brief Forgets the vision given by this entity without notifying the tiles. Used when the
+    //! vision is computed again for the whole map
+    void forgetVisionGiven();
+
+    //! \brief Returns the seat this entity gives vision to (nullptr if it does not give vision)
+    inline Seat* getVisionGivenSeat() const
+    { return mVisionGivenSeat; }
+
     //! \brief Returns true if the entity can be carried by a worker. False otherwise.
     virtual EntityCarryType getEntityCarryType(Creature* carrier)
     { return EntityCarryType::notCarryable; }
@@ -426,6 +460,9 @@ class GameEntity
     //! brief The name of the entity
     std::string mName;
 
+    //! \brief The id of the entity (see getId)
+    uint32_t mId;
+
     //! \brief The name of the mesh
     std::string mMeshName;
 
@@ -486,6 +523,12 @@ class GameEntity
 
     //! \brief List of the entity listening for events (removed from gamemap, picked up, ...) on this game entity
     std::vector<GameEntityListener*> mGameEntityListeners;
+
+    //! \brief Server side only. Seat and tiles this entity currently gives vision on (see setVisionGiven)
+    Seat* mVisionGivenSeat;
+    std::vector<Tile*> mVisionGivenTiles;
+
+    RandomStream mRandomStream;
 };
 
 #endif // GAMEENTITY_H
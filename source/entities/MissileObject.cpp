@@ -27,6 +27,7 @@
 #include "network/ODPacket.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/ScratchVector.h"
 
 #include <iostream>
 
@@ -96,15 +97,18 @@ void MissileObject::doUpkeep()
     Ogre::Vector3 position = getPosition();
     double moveDist = getMoveSpeed();
     Ogre::Vector3 destination;
-    std::list<Tile*> tiles;
-    mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
+    ScratchVector<Tile*> tiles;
+    mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, *tiles);
 
     std::vector<Ogre::Vector3> path;
     Tile* lastTile = nullptr;
-    while(!tiles.empty() && mIsMissileAlive)
+    uint32_t tileIndex = 0;
+    ScratchVector<Tile*> tileVector;
+    ScratchVector<GameEntity*> hitCreatures;
+    while((tileIndex < tiles->size()) && mIsMissileAlive)
     {
-        Tile* tmpTile = tiles.front();
-        tiles.pop_front();
+        Tile* tmpTile = (*tiles)[tileIndex];
+        ++tileIndex;
 
         if(tmpTile == nullptr)
         {
@@ -130,7 +134,8 @@ void MissileObject::doUpkeep()
                 path.push_back(position);
                 // We compute next position
                 mDirection = nextDirection;
-                mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, tiles);
+                mIsMissileAlive = computeDestination(position, moveDist, mDirection, destination, *tiles);
+                tileIndex = 0;
                 continue;
             }
         }
@@ -165,10 +170,10 @@ void MissileObject::doUpkeep()
             }
         }
 
-        std::vector<Tile*> tileVector;
-        tileVector.push_back(tmpTile);
-        std::vector<GameEntity*> enemyCreatures = getGameMap()->getVisibleCreatures(tileVector, getSeat(), true);
-        for(std::vector<GameEntity*>::iterator it = enemyCreatures.begin(); it != enemyCreatures.end(); ++it)
+        tileVector->clear();
+        tileVector->push_back(tmpTile);
+        getGameMap()->getVisibleCreatures(*tileVector, getSeat(), true, *hitCreatures);
+        for(std::vector<GameEntity*>::iterator it = hitCreatures->begin(); it != hitCreatures->end(); ++it)
         {
             GameEntity* creature = *it;
             OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tmpTile));
@@ -183,8 +188,8 @@ void MissileObject::doUpkeep()
         if(!mDamageAllies || !mIsMissileAlive)
             continue;
 
-        std::vector<GameEntity*> alliedCreatures = getGameMap()->getVisibleCreatures(tileVector, getSeat(), false);
-        for(std::vector<GameEntity*>::iterator it = alliedCreatures.begin(); it != alliedCreatures.end(); ++it)
+        getGameMap()->getVisibleCreatures(*tileVector, getSeat(), false, *hitCreatures);
+        for(std::vector<GameEntity*>::iterator it = hitCreatures->begin(); it != hitCreatures->end(); ++it)
         {
             GameEntity* creature = *it;
             OD_LOG_INF("missile=" + getName() + " hit creature=" + creature->getName() + ", on tile=" + Tile::displayAsString(tmpTile));
@@ -202,11 +207,11 @@ void MissileObject::doUpkeep()
 }
 
 bool MissileObject::computeDestination(const Ogre::Vector3& position, double moveDist, const Ogre::Vector3& direction,
-        Ogre::Vector3& destination, std::list<Tile*>& tiles)
+        Ogre::Vector3& destination, std::vector<Tile*>& tiles)
 {
     destination = position + (moveDist * direction);
-    tiles = getGameMap()->tilesBetween(Helper::round(position.x),
-        Helper::round(position.y), Helper::round(destination.x), Helper::round(destination.y));
+    getGameMap()->tilesBetween(Helper::round(position.x),
+        Helper::round(position.y), Helper::round(destination.x), Helper::round(destination.y), tiles);
     if(tiles.empty())
     {
         OD_LOG_ERR("missile=" + getName() + " has unexpected empty tiles destination");
@@ -104,7 +104,7 @@ protected:
 
 private:
     bool computeDestination(const Ogre::Vector3& position, double moveDist, const Ogre::Vector3& direction,
-        Ogre::Vector3& destination, std::list<Tile*>& tiles);
+        Ogre::Vector3& destination, std::vector<Tile*>& tiles);
     Ogre::Vector3 mDirection;
     bool mIsMissileAlive;
     GameEntity* mEntityTarget;
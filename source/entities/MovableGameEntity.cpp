@@ -98,11 +98,10 @@ void MovableGameEntity::setWalkPath(const std::string& walkAnim, const std::stri
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        const std::string& name = getName();
         uint32_t nbDest = mWalkQueue.size();
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::animatedObjectSetWalkPath, seat->getPlayer());
-        serverNotification->mPacket << name << walkAnim << endAnim << loopEndAnim << playIdleWhenAnimationEnds << nbDest;
+        serverNotification->mPacket << getId() << walkAnim << endAnim << loopEndAnim << playIdleWhenAnimationEnds << nbDest;
         for(const Ogre::Vector3& v : mWalkQueue)
             serverNotification->mPacket << v;
 
@@ -122,12 +121,11 @@ void MovableGameEntity::clearDestinations(const std::string& animation, bool loo
         if(!seat->getPlayer()->getIsHuman())
             continue;
 
-        const std::string& name = getName();
         const std::string emptyString;
         uint32_t nbDest = 0;
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::animatedObjectSetWalkPath, seat->getPlayer());
-        serverNotification->mPacket << name << emptyString << animation
+        serverNotification->mPacket << getId() << emptyString << animation
             << loopAnim << playIdleWhenAnimationEnds << nbDest;
         ODServer::getSingleton().queueServerNotification(serverNotification);
     }
@@ -309,8 +307,7 @@ void MovableGameEntity::fireObjectAnimationState(const std::string& state, bool
 
         ServerNotification* serverNotification = new ServerNotification(
             ServerNotificationType::setObjectAnimationState, seat->getPlayer());
-        const std::string& name = getName();
-        serverNotification->mPacket << name << state << loop << playIdleWhenAnimationEnds;
+        serverNotification->mPacket << getId() << state << loop << playIdleWhenAnimationEnds;
         if(direction != Ogre::Vector3::ZERO)
             serverNotification->mPacket << true << direction;
         else if(mWalkDirection != Ogre::Vector3::ZERO)
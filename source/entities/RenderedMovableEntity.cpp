@@ -129,8 +129,7 @@ void RenderedMovableEntity::setMeshOpacity(float opacity)
 
             ServerNotification* serverNotification = new ServerNotification(
                 ServerNotificationType::setEntityOpacity, seat->getPlayer());
-            const std::string& name = getName();
-            serverNotification->mPacket << name << opacity;
+            serverNotification->mPacket << getId() << opacity;
             ODServer::getSingleton().queueServerNotification(serverNotification);
         }
         return;
@@ -174,10 +173,7 @@ void RenderedMovableEntity::fireRemoveEntity(Seat* seat)
 {
     ServerNotification *serverNotification = new ServerNotification(
         ServerNotificationType::removeEntity, seat->getPlayer());
-    const std::string& name = getName();
-    GameEntityType type = getObjectType();
-    serverNotification->mPacket << type;
-    serverNotification->mPacket << name;
+    serverNotification->mPacket << getId();
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
 
@@ -34,6 +34,7 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 
+#include <atomic>
 #include <cstddef>
 #include <bitset>
 #include <istream>
@@ -48,14 +49,14 @@ const uint32_t Tile::NO_FLOODFILL = 0;
 const std::string Tile::TILE_PREFIX = "Tile_";
 const std::string Tile::TILE_SCANF = TILE_PREFIX + "%i_%i";
 
-Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
-    GameEntity(gameMap, "", "", nullptr),
+Tile::Tile(GameMap* gameMap, TileContainer* tileContainer, int x, int y) :
+    GameEntity(gameMap, buildName(x, y), "", nullptr),
     mX                  (x),
     mY                  (y),
-    mType               (type),
+    mTileContainer      (tileContainer),
+    mIndex              (tileContainer->getTileIndex(x, y)),
     mTileVisual         (TileVisual::nullTileVisual),
     mSelected           (false),
-    mFullness           (fullness),
     mRefundPriceRoom    (0),
     mRefundPriceTrap    (0),
     mCoveringBuilding   (nullptr),
@@ -69,6 +70,7 @@ Tile::Tile(GameMap* gameMap, int x, int y, TileType type, double fullness) :
     mTileCulling        (CullingType::HIDE),
     mNbWorkersClaiming(0)
 {
+    mPosition = Ogre::Vector3(static_cast<Ogre::Real>(mX), static_cast<Ogre::Real>(mY), 0.0f);
     computeTileVisual();
 }
 
@@ -131,7 +133,8 @@ bool Tile::isWallClaimable(Seat* seat)
     if (getFullness() <= 0.0)
         return false;
 
-    if (mType == TileType::lava || mType == TileType::water || mType == TileType::rock || mType == TileType::gold)
+    TileType type = getType();
+    if (type == TileType::lava || type == TileType::water || type == TileType::rock || type == TileType::gold)
         return false;
 
     // Check whether at least one neighbor is a claimed ground tile of the given seat
@@ -489,12 +492,17 @@ bool Tile::isFloodFillFilled(Seat* seat) const
 }
 
 bool Tile::isFloodFillPossible(Seat* seat, FloodFillType type) const
+{
+    return isFloodFillPossible(getType(), getFullness(), type);
+}
+
+bool Tile::isFloodFillPossible(TileType tileType, double fullness, FloodFillType type)
 {
     // No floodfill can be set on full tiles
-    if(getFullness() > 0.0)
+    if(fullness > 0.0)
         return false;
 
-    switch(getType())
+    switch(tileType)
     {
         case TileType::dirt:
         case TileType::gold:
@@ -551,76 +559,10 @@ bool Tile::isSameFloodFill(Seat* seat, FloodFillType type, Tile* tile) const
     return getFloodFillValue(seat, type) == tile->getFloodFillValue(seat, type);
 }
 
-void Tile::resetFloodFill()
-{
-    for(std::vector<uint32_t>& values : mFloodFillColor)
-    {
-        for(uint32_t& floodFillValue : values)
-        {
-            floodFillValue = NO_FLOODFILL;
-        }
-    }
-}
-
-bool Tile::updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile)
-{
-    if(seat->getTeamIndex() >= mFloodFillColor.size())
-    {
-        static bool logMsg = false;
-        if(!logMsg)
-        {
-            logMsg = true;
-            OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
-                + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size()))
-                + ", fullness=" + Helper::toString(getFullness()));
-        }
-        return false;
-    }
-
-    std::vector<uint32_t>& values = mFloodFillColor[seat->getTeamIndex()];
-    uint32_t intType = static_cast<uint32_t>(type);
-    if(intType >= values.size())
-    {
-        static bool logMsg = false;
-        if(!logMsg)
-        {
-            logMsg = true;
-            OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
-                + ", tile=" + Tile::displayAsString(this)
-                + ", intType=" + Helper::toString(intType) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(values.size())));
-        }
-        return false;
-    }
-
-    if((values[intType] != NO_FLOODFILL) ||
-       (tile->getFloodFillValue(seat, type) == NO_FLOODFILL))
-    {
-        return false;
-    }
-
-    values[intType] = tile->getFloodFillValue(seat, type);
-    return true;
-}
-
 void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
 {
-    if(seat->getTeamIndex() >= mFloodFillColor.size())
-    {
-        static bool logMsg = false;
-        if(!logMsg)
-        {
-            logMsg = true;
-            OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
-                + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size())));
-        }
-        return;
-    }
-
-    std::vector<uint32_t>& values = mFloodFillColor[seat->getTeamIndex()];
-    uint32_t intType = static_cast<uint32_t>(type);
-    if(intType >= values.size())
+    uint32_t* values = getGameMap()->getFloodFillColors(seat->getTeamIndex(), type);
+    if(values == nullptr)
     {
         static bool logMsg = false;
         if(!logMsg)
@@ -628,40 +570,17 @@ void Tile::replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue)
             logMsg = true;
             OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
                 + ", tile=" + Tile::displayAsString(this)
-                + ", intType=" + Helper::toString(intType) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(values.size())));
+                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", intType=" + Helper::toString(static_cast<uint32_t>(type)));
         }
         return;
     }
 
-    values[intType] = newValue;
-}
-
-void Tile::copyFloodFillToOtherSeats(Seat* seatToCopy)
-{
-    if(seatToCopy->getTeamIndex() >= mFloodFillColor.size())
-    {
-        static bool logMsg = false;
-        if(!logMsg)
-        {
-            logMsg = true;
-            OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seatToCopy->getId())
-                + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seatToCopy->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size())));
-        }
-        return;
-    }
-
-    std::vector<uint32_t>& valuesToCopy = mFloodFillColor[seatToCopy->getTeamIndex()];
-    for(uint32_t indexFloodFill = 0; indexFloodFill < mFloodFillColor.size(); ++indexFloodFill)
-    {
-        if(seatToCopy->getTeamIndex() == indexFloodFill)
-            continue;
-
-        std::vector<uint32_t>& values = mFloodFillColor[indexFloodFill];
-        for(uint32_t intType = 0; intType < static_cast<uint32_t>(FloodFillType::nbValues); ++intType)
-            values[intType] = valuesToCopy[intType];
-
-    }
+    uint32_t& value = values[getGameMap()->getTileIndex(mX, mY)];
+    // If the tile becomes reachable or not, the connections around it change
+    bool isChangingReachability = (value == NO_FLOODFILL) != (newValue == NO_FLOODFILL);
+    value = newValue;
+    if(isChangingReachability)
+        getGameMap()->floodFillChanged(this);
 }
 
 void Tile::logFloodFill() const
@@ -670,13 +589,16 @@ void Tile::logFloodFill() const
         + " - type=" + Tile::tileVisualToString(getTileVisual())
         + " - fullness=" + Helper::toString(getFullness())
         + " - seatId=" + std::string(getSeat() == nullptr ? "-1" : Helper::toString(getSeat()->getId()));
-    for(const std::vector<uint32_t>& values : mFloodFillColor)
+    uint32_t index = getGameMap()->getTileIndex(mX, mY);
+    for(uint32_t teamIndex = 0; teamIndex < getGameMap()->getTeamIds().size(); ++teamIndex)
     {
-        int cpt = 0;
-        for(const uint32_t& floodFill : values)
+        for(uint32_t cpt = 0; cpt < static_cast<uint32_t>(FloodFillType::nbValues); ++cpt)
         {
-            str += ", [" + Helper::toString(cpt) + "]=" + Helper::toString(floodFill);
-            ++cpt;
+            const uint32_t* values = getGameMap()->getFloodFillColors(teamIndex, static_cast<FloodFillType>(cpt));
+            if(values == nullptr)
+                continue;
+
+            str += ", [" + Helper::toString(cpt) + "]=" + Helper::toString(values[index]);
         }
     }
     OD_LOG_INF(str);
@@ -719,22 +641,64 @@ bool Tile::isClaimed() const
     return true;
 }
 
-void Tile::clearVision()
+void Tile::addVision(Seat* seat)
+{
+    addVisionForSeat(seat);
+
+    // We also give vision to allied seats
+    for(Seat* alliedSeat : seat->getAlliedSeats())
+        addVisionForSeat(alliedSeat);
+}
+
+void Tile::removeVision(Seat* seat)
+{
+    removeVisionForSeat(seat);
+
+    for(Seat* alliedSeat : seat->getAlliedSeats())
+        removeVisionForSeat(alliedSeat);
+}
+
+void Tile::resetVision()
 {
     mSeatsWithVision.clear();
+    mNbVisionSources.clear();
+    forgetVisionGiven();
 }
 
-void Tile::notifyVision(Seat* seat)
+void Tile::addVisionForSeat(Seat* seat)
 {
-    if(std::find(mSeatsWithVision.begin(), mSeatsWithVision.end(), seat) != mSeatsWithVision.end())
+    for(uint32_t i = 0; i < mSeatsWithVision.size(); ++i)
+    {
+        if(mSeatsWithVision[i] != seat)
+            continue;
+
+        ++mNbVisionSources[i];
         return;
+    }
 
-    seat->notifyVisionOnTile(this);
     mSeatsWithVision.push_back(seat);
+    mNbVisionSources.push_back(1);
+    seat->notifyVisionOnTile(this);
+}
 
-    // We also notify vision for allied seats
-    for(Seat* alliedSeat : seat->getAlliedSeats())
-        notifyVision(alliedSeat);
+void Tile::removeVisionForSeat(Seat* seat)
+{
+    for(uint32_t i = 0; i < mSeatsWithVision.size(); ++i)
+    {
+        if(mSeatsWithVision[i] != seat)
+            continue;
+
+        --mNbVisionSources[i];
+        if(mNbVisionSources[i] > 0)
+            return;
+
+        mSeatsWithVision.erase(mSeatsWithVision.begin() + i);
+        mNbVisionSources.erase(mNbVisionSources.begin() + i);
+        seat->notifyVisionLostOnTile(this);
+        return;
+    }
+
+    OD_LOG_ERR("seatId=" + Helper::toString(seat->getId()) + ", tile=" + displayAsString(this));
 }
 
 void Tile::setSeats(const std::vector<Seat*>& seats)
@@ -778,7 +742,7 @@ void Tile::computeTileVisual()
     switch(getType())
     {
         case TileType::dirt:
-            if(mFullness > 0.0)
+            if(getFullness() > 0.0)
             {
                 if(isClaimed())
                     mTileVisual = TileVisual::claimedFull;
@@ -795,14 +759,14 @@ void Tile::computeTileVisual()
             return;
 
         case TileType::rock:
-            if(mFullness > 0.0)
+            if(getFullness() > 0.0)
                 mTileVisual = TileVisual::rockFull;
             else
                 mTileVisual = TileVisual::rockGround;
             return;
 
         case TileType::gold:
-            if(mFullness > 0.0)
+            if(getFullness() > 0.0)
             {
                 if(isClaimed())
                     mTileVisual = TileVisual::claimedFull;
@@ -827,7 +791,7 @@ void Tile::computeTileVisual()
             return;
 
         case TileType::gem:
-            if(mFullness > 0.0)
+            if(getFullness() > 0.0)
                 mTileVisual = TileVisual::gemFull;
             else
                 mTileVisual = TileVisual::gemGround;
@@ -842,41 +806,23 @@ void Tile::computeTileVisual()
 
 uint32_t Tile::getFloodFillValue(Seat* seat, FloodFillType type) const
 {
-    if(seat->getTeamIndex() >= mFloodFillColor.size())
+    const uint32_t* values = getGameMap()->getFloodFillColors(seat->getTeamIndex(), type);
+    if(values == nullptr)
     {
-        static bool logMsg = false;
-        if(!logMsg)
+        // Logged once. Can be called by several sensing threads
+        static std::atomic<bool> logMsg(false);
+        if(!logMsg.exchange(true))
         {
-            logMsg = true;
             OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
                 + ", tile=" + Tile::displayAsString(this)
-                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(mFloodFillColor.size()))
+                + ", seatIndex=" + Helper::toString(seat->getTeamIndex()) + ", intType=" + Helper::toString(static_cast<uint32_t>(type))
                 + ", fullness=" + Helper::toString(getFullness()));
         }
         return NO_FLOODFILL;
     }
 
-    const std::vector<uint32_t>& values = mFloodFillColor[seat->getTeamIndex()];
-    uint32_t intType = static_cast<uint32_t>(type);
-    if(intType >= values.size())
-    {
-        static bool logMsg = false;
-        if(!logMsg)
-        {
-            logMsg = true;
-            OD_LOG_ERR("Wrong floodfill seat index seatId=" + Helper::toString(seat->getId())
-                + ", tile=" + Tile::displayAsString(this)
-                + ", intType=" + Helper::toString(intType) + ", floodfillsize=" + Helper::toString(static_cast<uint32_t>(values.size())));
-        }
-        return NO_FLOODFILL;
-    }
-
-    return values.at(intType);
-}
-
-void Tile::setTeamsNumber(uint32_t nbTeams)
-{
-    mFloodFillColor = std::vector<std::vector<uint32_t>>(nbTeams, std::vector<uint32_t>(static_cast<uint32_t>(FloodFillType::nbValues), NO_FLOODFILL));
+    // The stored value may have been merged with other ones since it was set
+    return getGameMap()->findFloodFillRegion(seat, type, values[getGameMap()->getTileIndex(mX, mY)]);
 }
 
 bool Tile::shouldColorTileMesh() const
@@ -897,19 +843,28 @@ void Tile::exportToStream(Tile* tile, std::ostream& os)
     tile->exportToStream(os);
 }
 
+void Tile::setType(TileType t)
+{
+    mTileContainer->setTileType(mIndex, t);
+}
+
 void Tile::setFullness(double f)
 {
     double oldFullness = getFullness();
 
-    mFullness = f;
+    setFullnessValue(f);
 
     // If the tile was marked for digging and has been dug out, unmark it and set its fullness to 0.
-    if (mFullness == 0.0 && isMarkedForDiggingByAnySeat())
+    if (f == 0.0 && isMarkedForDiggingByAnySeat())
     {
         setMarkedForDiggingForAllPlayersExcept(false, nullptr);
     }
 
-    if ((oldFullness > 0.0) && (mFullness == 0.0))
+    // A full tile blocks vision
+    if ((oldFullness > 0.0) != (f > 0.0))
+        getGameMap()->tilePermitsVisionChanged(this);
+
+    if ((oldFullness > 0.0) && (f == 0.0))
     {
         fireTileSound(TileSound::Digged);
 
@@ -999,7 +954,11 @@ void Tile::setCoveringBuilding(Building *building)
         // Set the tile as claimed and of the team color of the building
         setSeat(mCoveringBuilding->getSeat());
         mClaimedPercentage = 1.0;
+        getGameMap()->tileClaimChanged(this);
     }
+
+    // The covering building may block vision
+    getGameMap()->tilePermitsVisionChanged(this);
 }
 
 bool Tile::isGroundClaimable(Seat* seat) const
@@ -1010,7 +969,7 @@ bool Tile::isGroundClaimable(Seat* seat) const
     if(getCoveringBuilding() != nullptr)
         return getCoveringBuilding()->isClaimable(seat);
 
-    if(mType != TileType::dirt && mType != TileType::gold)
+    if(getType() != TileType::dirt && getType() != TileType::gold)
         return false;
 
     if(isClaimedForSeat(seat))
@@ -1038,7 +997,6 @@ void Tile::updateFromPacket(ODPacket& is)
     // This function should read parameters as sent by Tile::exportToPacketForUpdate
     int seatId;
     std::string meshName;
-    std::stringstream ss;
 
     // We set the seat if there is one
     OD_ASSERT_TRUE(is >> mIsRoom);
@@ -1055,28 +1013,105 @@ void Tile::updateFromPacket(ODPacket& is)
     OD_ASSERT_TRUE(is >> meshName);
     setMeshName(meshName);
 
-    ss.str(std::string());
-    ss << TILE_PREFIX;
-    ss << getX();
-    ss << "_";
-    ss << getY();
+    OD_ASSERT_TRUE(is >> mTileVisual);
 
-    setName(ss.str());
+    updateSeatFromPacket(seatId);
+    tileUpdatedFromPacket();
+}
 
-    OD_ASSERT_TRUE(is >> mTileVisual);
+uint32_t Tile::getChangedFieldsForSeat(const Seat* seat) const
+{
+    uint32_t fields = seat->getTileChangedFields(this);
+    // The client only adds the effects it does not have yet so we can send them again
+    if(!mEntityParticleEffects.empty())
+        fields |= TileRefreshFields::Effects;
 
-    if(seatId == -1)
+    return fields;
+}
+
+void Tile::exportChangesToPacketForUpdate(ODPacket& os, const Seat* seat, uint32_t fields) const
+{
+    seat->exportTileChangesToPacket(os, this, fields);
+    if((fields & TileRefreshFields::Effects) != 0)
+        GameEntity::exportToPacketForUpdate(os, seat);
+}
+
+void Tile::updateChangesFromPacket(ODPacket& is)
+{
+    // This function should read parameters as sent by Tile::exportChangesToPacketForUpdate
+    uint32_t fields;
+    OD_ASSERT_TRUE(is.readVarUInt32(fields));
+
+    uint32_t value;
+    if((fields & TileRefreshFields::Flags) != 0)
     {
-        setSeat(nullptr);
+        OD_ASSERT_TRUE(is.readVarUInt32(value));
+        mIsRoom = ((value & TileRefreshFlags::IsRoom) != 0);
+        mIsTrap = ((value & TileRefreshFlags::IsTrap) != 0);
+        mDisplayTileMesh = ((value & TileRefreshFlags::DisplayTileMesh) != 0);
+        mColorCustomMesh = ((value & TileRefreshFlags::ColorCustomMesh) != 0);
+        mHasBridge = ((value & TileRefreshFlags::HasBridge) != 0);
     }
-    else
+
+    if((fields & TileRefreshFields::RefundPriceRoom) != 0)
     {
-        Seat* seat = getGameMap()->getSeatById(seatId);
-        if(seat != nullptr)
-            setSeat(seat);
+        OD_ASSERT_TRUE(is.readVarUInt32(mRefundPriceRoom));
+    }
+
+    if((fields & TileRefreshFields::RefundPriceTrap) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(mRefundPriceTrap));
+    }
+
+    // Seat ids can be -1 (no seat) so they are shifted to be sent as unsigned
+    if((fields & TileRefreshFields::SeatId) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(value));
+        updateSeatFromPacket(static_cast<int>(value) - 1);
+    }
+
+    if((fields & TileRefreshFields::MeshName) != 0)
+    {
+        std::string meshName;
+        OD_ASSERT_TRUE(is >> meshName);
+        setMeshName(meshName);
+    }
 
+    if((fields & TileRefreshFields::TileVisual) != 0)
+    {
+        OD_ASSERT_TRUE(is.readVarUInt32(value));
+        mTileVisual = static_cast<TileVisual>(value);
+    }
+
+    if((fields & TileRefreshFields::Effects) != 0)
+        GameEntity::updateFromPacket(is);
+
+    tileUpdatedFromPacket();
+}
+
+void Tile::updateSeatFromPacket(int seatId)
+{
+    if(seatId == -1)
+    {
+        setSeat(nullptr);
+        return;
     }
 
+    Seat* seat = getGameMap()->getSeatById(seatId);
+    if(seat != nullptr)
+        setSeat(seat);
+}
+
+void Tile::tileUpdatedFromPacket()
+{
+    std::stringstream ss;
+    ss << TILE_PREFIX;
+    ss << getX();
+    ss << "_";
+    ss << getY();
+
+    setName(ss.str());
+
     // We need to check if the tile is unmarked after reading the needed information.
     if(getMarkedForDigging(getGameMap()->getLocalPlayer()) &&
         !isDiggable(getGameMap()->getLocalPlayer()->getSeat()))
@@ -1090,29 +1125,44 @@ void Tile::updateFromPacket(ODPacket& is)
     fireTileStateChanged();
 }
 
-void Tile::loadFromLine(const std::string& line, Tile *t)
+Tile* Tile::loadFromLine(const std::string& line, GameMap* gameMap)
 {
     std::vector<std::string> elems = Helper::split(line, '\t');
 
     int xLocation = Helper::toInt(elems[0]);
     int yLocation = Helper::toInt(elems[1]);
+    TileType tileType = static_cast<TileType>(Helper::toInt(elems[2]));
 
-    std::stringstream tileName("");
-    tileName << TILE_PREFIX;
-    tileName << xLocation;
-    tileName << "_";
-    tileName << yLocation;
+    // If the tile type is lava or water, we ignore fullness
+    double fullness = 0.0;
+    switch(tileType)
+    {
+        case TileType::water:
+        case TileType::lava:
+            break;
 
-    t->setName(tileName.str());
-    t->mX = xLocation;
-    t->mY = yLocation;
-    t->mPosition = Ogre::Vector3(static_cast<Ogre::Real>(t->mX), static_cast<Ogre::Real>(t->mY), 0.0f);
+        default:
+            fullness = Helper::toDouble(elems[3]);
+            break;
+    }
 
-    TileType tileType = static_cast<TileType>(Helper::toInt(elems[2]));
+    bool hasSeat = (elems.size() >= 5);
+    int seatId = hasSeat ? Helper::toInt(elems[4]) : 0;
+
+    Tile* t = gameMap->getTile(xLocation, yLocation);
+    if(t == nullptr)
+        return nullptr;
+
+    loadFromValues(t, tileType, fullness, hasSeat, seatId);
+    return t;
+}
+
+void Tile::loadFromValues(Tile* t, TileType tileType, double fullness,
+    bool hasSeat, int seatId)
+{
     t->setType(tileType);
 
     // If the tile type is lava or water, we ignore fullness
-    double fullness;
     switch(tileType)
     {
         case TileType::water:
@@ -1121,14 +1171,13 @@ void Tile::loadFromLine(const std::string& line, Tile *t)
             break;
 
         default:
-            fullness = Helper::toDouble(elems[3]);
             break;
     }
     t->setFullnessValue(fullness);
 
     bool shouldSetSeat = false;
     // We allow to set seat if the tile is dirt (full or not) or if it is gold (ground only)
-    if(elems.size() >= 5)
+    if(hasSeat)
     {
         if(tileType == TileType::dirt)
         {
@@ -1147,7 +1196,6 @@ void Tile::loadFromLine(const std::string& line, Tile *t)
         return;
     }
 
-    int seatId = Helper::toInt(elems[4]);
     Seat* seat = t->getGameMap()->getSeatById(seatId);
     if(seat == nullptr)
         return;
@@ -1195,6 +1243,9 @@ bool Tile::addEntity(GameEntity *entity)
     }
 
     mEntitiesInTile.push_back(entity);
+    if(entity->getObjectType() == GameEntityType::creature)
+        getGameMap()->getCreatureSpatialIndex().addCreature(static_cast<Creature*>(entity), mX, mY);
+
     if(!getGameMap()->isServerGameMap())
     {
         // On client side, we cull any movable entity that walks over a
@@ -1217,6 +1268,9 @@ void Tile::removeEntity(GameEntity *entity)
     }
 
     mEntitiesInTile.erase(it);
+    if(entity->getObjectType() == GameEntityType::creature)
+        getGameMap()->getCreatureSpatialIndex().removeCreature(static_cast<Creature*>(entity), mX, mY);
+
     fireTileStateChanged();
 }
 
@@ -1257,6 +1311,8 @@ void Tile::claimForSeat(Seat* seat, double nDanceRate)
         }
     }
 
+    getGameMap()->tileClaimChanged(this);
+
     if ((getSeat() != nullptr) && (mClaimedPercentage >= 1.0) &&
         (getSeat()->isAlliedSeat(seat)))
     {
@@ -1273,6 +1329,7 @@ void Tile::claimTile(Seat* seat)
     // We need this because if we are a client, the tile may be from a non allied seat
     setSeat(seat);
     mClaimedPercentage = 1.0;
+    getGameMap()->tileClaimChanged(this);
 
     if(isFullTile())
         fireTileSound(TileSound::ClaimWall);
@@ -1308,6 +1365,7 @@ void Tile::unclaimTile()
 
     setSeat(nullptr);
     mClaimedPercentage = 0.0;
+    getGameMap()->tileClaimChanged(this);
 
     computeTileVisual();
     setDirtyForAllSeats();
@@ -1360,15 +1418,16 @@ double Tile::digOut(double digRate)
     if(fullnessLost <= 0.0)
         return digRateScaled;
 
-    if(mFullness <= 0.0)
+    double fullness = getFullness();
+    if(fullness <= 0.0)
     {
-        OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", mFullness=" + Helper::toString(mFullness));
+        OD_LOG_ERR("tile=" + Tile::displayAsString(this) + ", fullness=" + Helper::toString(fullness));
         return 0.0;
     }
 
-    if(fullnessLost >= mFullness)
+    if(fullnessLost >= fullness)
     {
-        digRateScaled = mFullness;
+        digRateScaled = fullness;
         setFullness(0.0);
 
         computeTileVisual();
@@ -1388,7 +1447,7 @@ double Tile::digOut(double digRate)
     }
 
     digRateScaled = fullnessLost;
-    setFullness(mFullness - fullnessLost);
+    setFullness(fullness - fullnessLost);
     return digRateScaled;
 }
 
@@ -1708,24 +1767,20 @@ bool Tile::checkCoveringTrapType(TrapType type) const
 
 void Tile::computeVisibleTiles()
 {
-    if(!getGameMap()->getIsFOWActivated())
-    {
-        // If the FOW is deactivated, we allow vision for every seat
-        for(Seat* seat : getGameMap()->getSeats())
-            notifyVision(seat);
-
+    Seat* seat = isClaimed() ? getSeat() : nullptr;
+    if(seat == getVisionGivenSeat())
         return;
-    }
 
-    if(!isClaimed())
+    if(seat == nullptr)
+    {
+        removeVisionGiven();
         return;
+    }
 
     // A claimed tile can see it self and its neighboors
-    notifyVision(getSeat());
-    for(Tile* tile : mNeighbors)
-    {
-        tile->notifyVision(getSeat());
-    }
+    std::vector<Tile*> tiles = mNeighbors;
+    tiles.push_back(this);
+    setVisionGiven(seat, tiles);
 }
 
 void Tile::setDirtyForAllSeats()
@@ -19,6 +19,7 @@
 #define TILE_H
 
 #include "entities/GameEntity.h"
+#include "gamemap/TileContainer.h"
 
 #include <OgreVector3.h>
 
@@ -60,6 +61,29 @@ enum class TileType
     countTileType
 };
 
+//! \brief Fields sent by Tile::exportChangesToPacketForUpdate. The flags (room, trap, display tile mesh,
+//! color custom mesh and bridge) are sent together as TileRefreshFlags
+namespace TileRefreshFields
+{
+    const uint32_t Flags = 0x01;
+    const uint32_t RefundPriceRoom = 0x02;
+    const uint32_t RefundPriceTrap = 0x04;
+    const uint32_t SeatId = 0x08;
+    const uint32_t MeshName = 0x10;
+    const uint32_t TileVisual = 0x20;
+    const uint32_t Effects = 0x40;
+    const uint32_t All = 0x7F;
+}
+
+namespace TileRefreshFlags
+{
+    const uint32_t IsRoom = 0x01;
+    const uint32_t IsTrap = 0x02;
+    const uint32_t DisplayTileMesh = 0x04;
+    const uint32_t ColorCustomMesh = 0x08;
+    const uint32_t HasBridge = 0x10;
+}
+
 enum class TileSound
 {
     ClaimGround,
@@ -127,7 +151,8 @@ public:
 class Tile : public GameEntity
 {
 public:
-    Tile(GameMap* gameMap, int x = 0, int y = 0, TileType type = TileType::dirt, double fullness = 100.0);
+    //! \brief Tiles are constructed by the TileContainer they belong to (see TileContainer::allocateMapMemory)
+    Tile(GameMap* gameMap, TileContainer* tileContainer, int x, int y);
 
     virtual ~Tile();
 
@@ -172,12 +197,11 @@ public:
      * In addition to setting the tile type this function also reloads the new mesh
      * for the tile.
      */
-    inline void setType(TileType t)
-    { mType = t; }
+    void setType(TileType t);
 
     //! \brief Returns the tile type (rock, claimed, etc.).
     inline TileType getType() const
-    { return mType; }
+    { return mTileContainer->getTileType(mIndex); }
 
     //! \brief Returns the tile type (rock, claimed, etc.).
     inline TileVisual getTileVisual() const
@@ -193,7 +217,7 @@ public:
 
     //! \brief An accessor which returns the tile's fullness which should range from 0 to 100.
     inline double getFullness() const
-    { return mFullness; }
+    { return mTileContainer->getTileFullness(mIndex); }
 
     //! \brief Tells whether a creature can see through a tile
     bool permitsVision();
@@ -327,8 +351,13 @@ public:
 
     static std::string getFormat();
 
-    //! \brief Loads the tile data from a level line.
-    static void loadFromLine(const std::string& line, Tile *t);
+    //! \brief Loads the tile data from a level line into the tile of the given map it describes.
+    //! Returns this tile or nullptr if it is not on the map
+    static Tile* loadFromLine(const std::string& line, GameMap* gameMap);
+
+    //! \brief Loads the tile data from already decoded values (used by the binary level format).
+    static void loadFromValues(Tile* t, TileType tileType, double fullness,
+        bool hasSeat, int seatId);
 
     /*! \brief This is a helper function which just converts the tile type enum into a string.
      *
@@ -366,10 +395,18 @@ public:
     //! Fills the given vector with corresponding entities on this tile.
     void fillWithEntities(std::vector<GameEntity*>& entities, SelectionEntityWanted entityWanted, Player* player);
 
-    //! \brief Computes the visible tiles and tags them to know which are visible
+    //! \brief Computes the vision given by this tile. A claimed tile gives vision on itself and
+    //! its neighbors to its seat. The vision is only updated if the claim changed since the last call
     void computeVisibleTiles();
-    void clearVision();
-    void notifyVision(Seat* seat);
+
+    //! \brief Adds/removes a vision source on this tile for the given seat and its allies. The seats are
+    //! notified when they gain vision (first source added) or lose it (last source removed)
+    void addVision(Seat* seat);
+    void removeVision(Seat* seat);
+
+    //! \brief Clears the vision sources of this tile without notifying the seats. Used when the
+    //! vision is computed again for the whole map
+    void resetVision();
 
     void setSeats(const std::vector<Seat*>& seats);
     bool hasChangedForSeat(Seat* seat) const;
@@ -380,21 +417,14 @@ public:
     const std::vector<Seat*>& getSeatsWithVision()
     { return mSeatsWithVision; }
 
-    void resetFloodFill();
-
     static std::string toString(FloodFillType type);
 
     bool isSameFloodFill(Seat* seat, FloodFillType type, Tile* tile) const;
 
-    //! Updates the floodfill from the given tile if floodfill is not already set.
-    //! returns true if the floodfill has been updated and false otherwise
-    bool updateFloodFillFromTile(Seat* seat, FloodFillType type, Tile* tile);
-
     //! Sets the floodfill value corresponding at type to newValue
     void replaceFloodFill(Seat* seat, FloodFillType type, uint32_t newValue);
 
-    void copyFloodFillToOtherSeats(Seat* seatToCopy);
-
+    //! Returns the floodfill region of the tile. Tiles with the same value are connected
     uint32_t getFloodFillValue(Seat* seat, FloodFillType type) const;
 
     void logFloodFill() const;
@@ -405,6 +435,9 @@ public:
     //! depending on its type/fullness
     bool isFloodFillPossible(Seat* seat, FloodFillType type) const;
 
+    //! \brief Same as above for a tile of the given type and fullness. Used by the whole map floodfill
+    static bool isFloodFillPossible(TileType tileType, double fullness, FloodFillType type);
+
     //! Refresh the tile visual according to the tile parameters (type, claimed, ...).
     //! Used only on server side
     void computeTileVisual();
@@ -413,9 +446,6 @@ public:
     //! server and client
     bool isFullTile() const;
 
-    //! Sets the number of teams in this gamemap (after seat configuration). This number includes the rogue team.
-    void setTeamsNumber(uint32_t nbTeams);
-
     //! \brief returns true if the mesh from the tileset should be displayed and false otherwise
     inline bool shouldDisplayTileMesh() const
     { return mDisplayTileMesh; }
@@ -462,6 +492,15 @@ public:
     virtual void updateFromPacket(ODPacket& is) override;
     void exportToPacketForUpdate(ODPacket& os, const Seat* seat, bool hideSeatId) const;
 
+    //! \brief Used on server side. Returns the TileRefreshFields that changed since the tile was last
+    //! sent to the given seat. The particle effects are always sent if there are some
+    uint32_t getChangedFieldsForSeat(const Seat* seat) const;
+
+    //! \brief Used on server side. Exports the given fields (as returned by getChangedFieldsForSeat)
+    //! for refreshTilesChanges. They should be read with updateChangesFromPacket
+    void exportChangesToPacketForUpdate(ODPacket& os, const Seat* seat, uint32_t fields) const;
+    void updateChangesFromPacket(ODPacket& is);
+
     bool addTileStateListener(TileStateListener& listener);
     bool removeTileStateListener(TileStateListener& listener);
 
@@ -484,8 +523,10 @@ private:
     //! \brief The tile position
     int mX, mY;
 
-    //! \brief The tile type: Dirt, Gold, ...
-    TileType mType;
+    //! \brief The container holding the hot fields of the tile. The tile type (Dirt, Gold, ...)
+    //! and fullness are only stored there, at mIndex
+    TileContainer* mTileContainer;
+    uint32_t mIndex;
 
     //! \brief The tile visual: Claimed, Dirt, Gold, ...
     //! On client side, we should rely on mTileVisual to know the tile type as claimed percentage
@@ -495,11 +536,6 @@ private:
     //! \brief Whether the tile is selected.
     bool mSelected;
 
-    //! \brief The tile fullness (0.0 - 100.0).
-    //! At 0.0, it is a ground tile. Over it is a wall.
-    //! Used on server side only
-    double mFullness;
-
     //! Used on client side to know how much gold can be retrieved if the room/trap
     //! is sold. Note that it is needed because client are not aware of rooms/traps
     uint32_t mRefundPriceRoom;
@@ -509,13 +545,13 @@ private:
     std::vector<const Player*> mPlayersMarkingTile;
     std::vector<std::pair<Seat*, bool>> mTileChangedForSeats;
     std::vector<Seat*> mSeatsWithVision;
+    //! \brief Number of vision sources for each seat in mSeatsWithVision (same index)
+    std::vector<uint32_t> mNbVisionSources;
 
     //! \brief List of the entities actually on this tile. Most of the creatures actions will rely on this list
     std::vector<GameEntity*> mEntitiesInTile;
 
     Building* mCoveringBuilding;
-    //! Floodfill values per seat and per floodfill type
-    std::vector<std::vector<uint32_t>> mFloodFillColor;
 
     //! \brief The tile claiming. Used on server side only
     double mClaimedPercentage;
@@ -541,7 +577,7 @@ private:
      *  before a map object has been set. setFullness is called once a map is assigned.
      */
     inline void setFullnessValue(double f)
-    { mFullness = f; }
+    { mTileContainer->setTileFullness(mIndex, f); }
 
     void setDirtyForAllSeats();
 
@@ -552,6 +588,15 @@ private:
     std::vector<TileStateListener*> mStateListeners;
 
     void fireTileStateChanged();
+
+    //! \brief Used on client side. Sets the seat sent in a tile refresh (-1 if none)
+    void updateSeatFromPacket(int seatId);
+
+    //! \brief Used on client side. Called once a tile refresh is read
+    void tileUpdatedFromPacket();
+
+    void addVisionForSeat(Seat* seat);
+    void removeVisionForSeat(Seat* seat);
 };
 
 #endif // TILE_H
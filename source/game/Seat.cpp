@@ -59,10 +59,7 @@ const int32_t Seat::PLAYER_ID_HUMAN_MIN = static_cast<int32_t>(KeeperAIType::nbA
 TileStateNotified::TileStateNotified():
     mTileVisual(TileVisual::nullTileVisual),
     mSeatIdOwner(-1),
-    mMarkedForDigging(false),
-    mVisionTurnLast(false),
-    mVisionTurnCurrent(false),
-    mBuilding(nullptr)
+    mMarkedForDigging(false)
 {
 }
 
@@ -232,62 +229,88 @@ void Seat::clearTilesWithVision()
     if(!mPlayer->getIsHuman())
         return;
 
-    for(std::vector<TileStateNotified>& vec : mTilesStates)
-    {
-        for(TileStateNotified& p : vec)
-        {
-            p.mVisionTurnLast = p.mVisionTurnCurrent;
-            p.mVisionTurnCurrent = false;
-        }
-    }
+    mTilesStates.clearVisionCurrent();
+    mTilesClaimedByEnemy.clear();
 }
 
-void Seat::notifyVisionOnTile(Tile* tile)
+void Seat::beginVisionUpdate()
 {
     if(mPlayer == nullptr)
         return;
     if(!mPlayer->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
+    // The tiles claimed by an enemy were seen during the last turn. We set them back to
+    // the real vision so that the vision is lost if there is no vision source on them
+    for(Tile* tile : mTilesClaimedByEnemy)
     {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
+        uint32_t index;
+        if(!getTileStateIndex(tile, index))
+            continue;
+
+        const std::vector<Seat*>& seats = tile->getSeatsWithVision();
+        mTilesStates.setVisionLast(index, true);
+        mTilesStates.setVisionCurrent(index, std::find(seats.begin(), seats.end(), this) != seats.end());
     }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
+    mTilesClaimedByEnemy.clear();
+}
+
+bool Seat::getTileStateIndex(const Tile* tile, uint32_t& index) const
+{
+    if(!mTilesStates.isInMap(tile->getX(), tile->getY()))
     {
         OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
+        return false;
     }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    tileState.mVisionTurnCurrent = true;
+    index = mTilesStates.getIndex(tile->getX(), tile->getY());
+    return true;
 }
 
-void Seat::notifyTileClaimedByEnemy(Tile* tile)
+void Seat::notifyVisionOnTile(Tile* tile)
 {
     if(mPlayer == nullptr)
         return;
     if(!mPlayer->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
         return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+
+    mTilesStates.setVisionCurrent(index, true);
+}
+
+void Seat::notifyVisionLostOnTile(Tile* tile)
+{
+    if(mPlayer == nullptr)
         return;
-    }
+    if(!mPlayer->getIsHuman())
+        return;
+
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
+        return;
+
+    mTilesStates.setVisionCurrent(index, false);
+}
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+void Seat::notifyTileClaimedByEnemy(Tile* tile)
+{
+    if(mPlayer == nullptr)
+        return;
+    if(!mPlayer->getIsHuman())
+        return;
+
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
+        return;
 
     // By default, we set the tile like if it was not claimed anymore
-    tileState.mSeatIdOwner = -1;
-    tileState.mTileVisual = TileVisual::dirtGround;
-    tileState.mVisionTurnCurrent = true;
+    mTilesStates.setSeatIdOwner(index, -1);
+    mTilesStates.setTileVisual(index, TileVisual::dirtGround);
+    mTilesStates.setVisionCurrent(index, true);
+    mTilesClaimedByEnemy.push_back(tile);
 }
 
 const std::string Seat::getFactionFromLine(const std::string& line)
@@ -344,20 +367,11 @@ bool Seat::hasVisionOnTile(Tile* tile)
     if(!mPlayer->getIsHuman())
         return true;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
         return false;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return false;
-    }
-
-    TileStateNotified& stateTile = mTilesStates[tile->getX()][tile->getY()];
 
-    return stateTile.mVisionTurnCurrent;
+    return mTilesStates.hasVisionCurrent(index);
 }
 
 void Seat::initSeat()
@@ -450,17 +464,16 @@ void Seat::initSeat()
 
                 // We set the tile visual to make sure the tile state is exported if
                 // game is saved again
-                if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-                {
-                    OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-                    continue;
-                }
-                if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-                {
-                    OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+                uint32_t index;
+                if(!getTileStateIndex(tile, index))
                     continue;
-                }
-                mTilesStates[tile->getX()][tile->getY()] = tileState;
+
+                mTilesStates.setTileVisual(index, tileState.mTileVisual);
+                mTilesStates.setSeatIdOwner(index, tileState.mSeatIdOwner);
+                mTilesStates.setMarkedForDigging(index, tileState.mMarkedForDigging);
+                mTilesStates.setVisionCurrent(index, false);
+                mTilesStates.setVisionLast(index, false);
+                mTilesStates.setBuilding(index, nullptr);
 
                 // Then, we export tile state to the client
                 mGameMap->tileToPacket(serverNotification->mPacket, tile);
@@ -480,7 +493,18 @@ void Seat::setMapSize(int x, int y)
     if(!mPlayer->getIsHuman())
         return;
 
-    mTilesStates = std::vector<std::vector<TileStateNotified>>(x, std::vector<TileStateNotified>(y));
+    mTilesStates.resize(x, y);
+    mTilesClaimedByEnemy.clear();
+    TileRefreshState notSent;
+    notSent.mRefundPriceRoom = 0;
+    notSent.mRefundPriceTrap = 0;
+    notSent.mSeatId = -1;
+    notSent.mMeshNameIndex = 0;
+    notSent.mFlags = 0;
+    notSent.mTileVisual = TileVisual::nullTileVisual;
+    notSent.mSent = false;
+    mTilesRefreshSent.assign(x * y, notSent);
+    mTileMeshNamesSent.assign(1, std::string());
     // By default, we know that rock (ground & full) will be set as rock full tiles,
     // gold (ground & full) will be set as gold full tiles,
     // other tiles will be set as dirt full tiles
@@ -492,19 +516,20 @@ void Seat::setMapSize(int x, int y)
             if(tile == nullptr)
                 continue;
 
+            uint32_t index = mTilesStates.getIndex(xxx, yyy);
             if(tile->getType() == TileType::gold)
             {
-                mTilesStates[xxx][yyy].mTileVisual = TileVisual::goldFull;
+                mTilesStates.setTileVisual(index, TileVisual::goldFull);
                 continue;
             }
 
             if(tile->getType() == TileType::rock)
             {
-                mTilesStates[xxx][yyy].mTileVisual = TileVisual::rockFull;
+                mTilesStates.setTileVisual(index, TileVisual::rockFull);
                 continue;
             }
 
-            mTilesStates[xxx][yyy].mTileVisual = TileVisual::dirtFull;
+            mTilesStates.setTileVisual(index, TileVisual::dirtFull);
         }
     }
 }
@@ -603,36 +628,45 @@ void Seat::notifyChangedVisibleTiles()
         return;
 
     std::vector<Tile*> tilesToNotify;
-    int xMax = static_cast<int>(mTilesStates.size());
-    for(int xxx = 0; xxx < xMax; ++xxx)
+    mTilesStates.forEachVisionCurrent([&](uint32_t index)
     {
-        int yMax = static_cast<int>(mTilesStates[xxx].size());
-        for(int yyy = 0; yyy < yMax; ++yyy)
-        {
-            if(!mTilesStates[xxx][yyy].mVisionTurnCurrent)
-                continue;
-
-            Tile* tile = mGameMap->getTile(xxx, yyy);
-            if(!tile->hasChangedForSeat(this))
-                continue;
+        Tile* tile = mGameMap->getTile(mTilesStates.getX(index), mTilesStates.getY(index));
+        if(!tile->hasChangedForSeat(this))
+            return;
 
-            tilesToNotify.push_back(tile);
-            tile->changeNotifiedForSeat(this);
-        }
-    }
+        tilesToNotify.push_back(tile);
+        tile->changeNotifiedForSeat(this);
+    });
 
     if(tilesToNotify.empty())
         return;
 
-    uint32_t nbTiles = tilesToNotify.size();
-    ServerNotification *serverNotification = new ServerNotification(
-        ServerNotificationType::refreshTiles, getPlayer());
-    serverNotification->mPacket << nbTiles;
+    // We only send the fields that differ from what the client already has. Tiles that
+    // changed back to what the client knows are not sent at all
+    std::vector<std::pair<Tile*, uint32_t>> tilesChanges;
+    tilesChanges.reserve(tilesToNotify.size());
     for(Tile* tile : tilesToNotify)
     {
-        mGameMap->tileToPacket(serverNotification->mPacket, tile);
         updateTileStateForSeat(tile, false);
-        tile->exportToPacketForUpdate(serverNotification->mPacket, this);
+        uint32_t fields = tile->getChangedFieldsForSeat(this);
+        if(fields == 0)
+            continue;
+
+        tilesChanges.emplace_back(tile, fields);
+    }
+
+    if(tilesChanges.empty())
+        return;
+
+    ServerNotification *serverNotification = new ServerNotification(
+        ServerNotificationType::refreshTilesChanges, getPlayer());
+    serverNotification->mPacket.writeVarUInt32(static_cast<uint32_t>(tilesChanges.size()));
+    for(const std::pair<Tile*, uint32_t>& tileChanges : tilesChanges)
+    {
+        Tile* tile = tileChanges.first;
+        serverNotification->mPacket.writeVarUInt32(static_cast<uint32_t>(tile->getX()));
+        serverNotification->mPacket.writeVarUInt32(static_cast<uint32_t>(tile->getY()));
+        tile->exportChangesToPacketForUpdate(serverNotification->mPacket, this, tileChanges.second);
     }
     ODServer::getSingleton().queueServerNotification(serverNotification);
 }
@@ -709,19 +743,11 @@ void Seat::refreshSeatVisualDebug()
     if(mIsDebuggingVision)
     {
         std::vector<Tile*> tiles;
-        int xMax = static_cast<int>(mTilesStates.size());
-        for(int xxx = 0; xxx < xMax; ++xxx)
+        tiles.reserve(mTilesStates.countVisionCurrent());
+        mTilesStates.forEachVisionCurrent([&](uint32_t index)
         {
-            int yMax = static_cast<int>(mTilesStates[xxx].size());
-            for(int yyy = 0; yyy < yMax; ++yyy)
-            {
-                if(!mTilesStates[xxx][yyy].mVisionTurnCurrent)
-                    continue;
-
-                Tile* tile = mGameMap->getTile(xxx, yyy);
-                tiles.push_back(tile);
-            }
-        }
+            tiles.push_back(mGameMap->getTile(mTilesStates.getX(index), mTilesStates.getY(index)));
+        });
         uint32_t nbTiles = tiles.size();
         ServerNotification *serverNotification = new ServerNotification(
             ServerNotificationType::refreshSeatVisDebug, nullptr);
@@ -760,29 +786,25 @@ void Seat::sendVisibleTiles()
         ServerNotificationType::refreshVisibleTiles, getPlayer());
     std::vector<Tile*> tilesVisionGained;
     std::vector<Tile*> tilesVisionLost;
-    // Tiles we gained vision
-    int xMax = static_cast<int>(mTilesStates.size());
-    for(int xxx = 0; xxx < xMax; ++xxx)
-    {
-        int yMax = static_cast<int>(mTilesStates[xxx].size());
-        for(int yyy = 0; yyy < yMax; ++yyy)
+    uint32_t nbTilesGained;
+    uint32_t nbTilesLost;
+    mTilesStates.countVisionChanges(nbTilesGained, nbTilesLost);
+    tilesVisionGained.reserve(nbTilesGained);
+    tilesVisionLost.reserve(nbTilesLost);
+    mTilesStates.applyVisionChanges([&](uint32_t index, bool hasVision)
+    {
+        Tile* tile = mGameMap->getTile(mTilesStates.getX(index), mTilesStates.getY(index));
+        if(hasVision)
         {
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent == mTilesStates[xxx][yyy].mVisionTurnLast)
-                continue;
-
-            Tile* tile = mGameMap->getTile(xxx, yyy);
-            if(mTilesStates[xxx][yyy].mVisionTurnCurrent)
-            {
-                // Vision gained
-                tilesVisionGained.push_back(tile);
-            }
-            else
-            {
-                // Vision lost
-                tilesVisionLost.push_back(tile);
-            }
+            // Vision gained
+            tilesVisionGained.push_back(tile);
         }
-    }
+        else
+        {
+            // Vision lost
+            tilesVisionLost.push_back(tile);
+        }
+    });
 
     // Notify tiles we gained vision
     nbTiles = tilesVisionGained.size();
@@ -1246,12 +1268,11 @@ bool Seat::exportSeatToStream(std::ostream& os) const
     }
 
     os << "[markedTiles]" << std::endl;
-    for(uint32_t xxx = 0; xxx < mTilesStates.size(); ++xxx)
+    for(int xxx = 0; xxx < mTilesStates.getMapSizeX(); ++xxx)
     {
-        for(uint32_t yyy = 0; yyy < mTilesStates[xxx].size(); ++yyy)
+        for(int yyy = 0; yyy < mTilesStates.getMapSizeY(); ++yyy)
         {
-            const TileStateNotified& tileState = mTilesStates[xxx][yyy];
-            if(!tileState.mMarkedForDigging)
+            if(!mTilesStates.isMarkedForDigging(mTilesStates.getIndex(xxx, yyy)))
                 continue;
 
             os << xxx << "\t" << yyy << std::endl;
@@ -1266,15 +1287,15 @@ void Seat::exportTilesVisualInitialStates(TileVisual tileVisual, std::ostream& o
 {
     os << "[" + Tile::tileVisualToString(tileVisual) + "]" << std::endl;
 
-    for(uint32_t xxx = 0; xxx < mTilesStates.size(); ++xxx)
+    for(int xxx = 0; xxx < mTilesStates.getMapSizeX(); ++xxx)
     {
-        for(uint32_t yyy = 0; yyy < mTilesStates[xxx].size(); ++yyy)
+        for(int yyy = 0; yyy < mTilesStates.getMapSizeY(); ++yyy)
         {
-            const TileStateNotified& tileState = mTilesStates[xxx][yyy];
-            if(tileState.mTileVisual != tileVisual)
+            uint32_t index = mTilesStates.getIndex(xxx, yyy);
+            if(mTilesStates.getTileVisual(index) != tileVisual)
                 continue;
 
-            os << xxx << "\t" << yyy << "\t" << tileState.mSeatIdOwner << std::endl;
+            os << xxx << "\t" << yyy << "\t" << mTilesStates.getSeatIdOwner(index) << std::endl;
         }
     }
 
@@ -1537,20 +1558,12 @@ void Seat::setSkillTree(const std::vector<SkillType>& skills)
 
 void Seat::updateTileStateForSeat(Tile* tile, bool hideSeatId)
 {
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
         return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    tileState.mTileVisual = tile->getTileVisual();
-    switch(tileState.mTileVisual)
+    mTilesStates.setTileVisual(index, tile->getTileVisual());
+    switch(tile->getTileVisual())
     {
         case TileVisual::claimedFull:
         case TileVisual::claimedGround:
@@ -1560,7 +1573,7 @@ void Seat::updateTileStateForSeat(Tile* tile, bool hideSeatId)
             }
             else
             {
-                tileState.mSeatIdOwner = tile->getSeat()->getId();
+                mTilesStates.setSeatIdOwner(index, tile->getSeat()->getId());
             }
             break;
         case TileVisual::waterGround:
@@ -1573,33 +1586,35 @@ void Seat::updateTileStateForSeat(Tile* tile, bool hideSeatId)
                 }
                 else
                 {
-                    tileState.mSeatIdOwner = tile->getSeat()->getId();
+                    mTilesStates.setSeatIdOwner(index, tile->getSeat()->getId());
                 }
             }
             break;
         default:
-            tileState.mSeatIdOwner = -1;
+            mTilesStates.setSeatIdOwner(index, -1);
             break;
     }
 
-    if(tile->getCoveringBuilding() == tileState.mBuilding)
+    Building* building = mTilesStates.getBuilding(index);
+    if(tile->getCoveringBuilding() == building)
         return;
 
     // If we are hiding seat id, we do not notify the building about vision
     // so that it doesn't send the building seat id
-    if((tileState.mBuilding != nullptr) && !hideSeatId)
-        tileState.mBuilding->notifySeatVision(tile, this);
+    if((building != nullptr) && !hideSeatId)
+        building->notifySeatVision(tile, this);
 
     if((tile->getCoveringBuilding() != nullptr) &&
         (tile->getCoveringBuilding()->isTileVisibleForSeat(tile, this)))
     {
-        tileState.mBuilding = tile->getCoveringBuilding();
+        building = tile->getCoveringBuilding();
+        mTilesStates.setBuilding(index, building);
         if(!hideSeatId)
-            tileState.mBuilding->notifySeatVision(tile, this);
+            building->notifySeatVision(tile, this);
     }
     else
     {
-        tileState.mBuilding = nullptr;
+        mTilesStates.setBuilding(index, nullptr);
     }
 }
 
@@ -1610,125 +1625,198 @@ void Seat::setVisibleBuildingOnTile(Building* building, Tile* tile)
     if(!getPlayer()->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
         return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
-
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
 
-    if(building == tileState.mBuilding)
+    if(building == mTilesStates.getBuilding(index))
         return;
 
-    tileState.mBuilding = building;
-    tileState.mSeatIdOwner = building->getSeat()->getId();
+    mTilesStates.setBuilding(index, building);
+    mTilesStates.setSeatIdOwner(index, building->getSeat()->getId());
 }
 
 void Seat::exportTileToPacket(ODPacket& os, const Tile* tile,
         bool hideSeatId) const
+{
+    TileRefreshState state;
+    std::string meshName;
+    if(!computeTileRefreshState(tile, hideSeatId, state, meshName))
+        return;
+
+    os << ((state.mFlags & TileRefreshFlags::IsRoom) != 0);
+    os << ((state.mFlags & TileRefreshFlags::IsTrap) != 0);
+    os << state.mRefundPriceRoom;
+    os << state.mRefundPriceTrap;
+    os << ((state.mFlags & TileRefreshFlags::DisplayTileMesh) != 0);
+    os << ((state.mFlags & TileRefreshFlags::ColorCustomMesh) != 0);
+    os << ((state.mFlags & TileRefreshFlags::HasBridge) != 0);
+    os << state.mSeatId;
+    os << meshName;
+    os << state.mTileVisual;
+
+    // The full refresh is also a baseline for the next tile changes
+    uint32_t index = mTilesStates.getIndex(tile->getX(), tile->getY());
+    mTilesRefreshSent[index] = state;
+}
+
+uint32_t Seat::getTileChangedFields(const Tile* tile) const
+{
+    TileRefreshState state;
+    std::string meshName;
+    if(!computeTileRefreshState(tile, false, state, meshName))
+        return 0;
+
+    uint32_t index = mTilesStates.getIndex(tile->getX(), tile->getY());
+    const TileRefreshState& sent = mTilesRefreshSent[index];
+    if(!sent.mSent)
+        return TileRefreshFields::All & ~TileRefreshFields::Effects;
+
+    uint32_t fields = 0;
+    if(state.mFlags != sent.mFlags)
+        fields |= TileRefreshFields::Flags;
+    if(state.mRefundPriceRoom != sent.mRefundPriceRoom)
+        fields |= TileRefreshFields::RefundPriceRoom;
+    if(state.mRefundPriceTrap != sent.mRefundPriceTrap)
+        fields |= TileRefreshFields::RefundPriceTrap;
+    if(state.mSeatId != sent.mSeatId)
+        fields |= TileRefreshFields::SeatId;
+    if(state.mMeshNameIndex != sent.mMeshNameIndex)
+        fields |= TileRefreshFields::MeshName;
+    if(state.mTileVisual != sent.mTileVisual)
+        fields |= TileRefreshFields::TileVisual;
+
+    return fields;
+}
+
+void Seat::exportTileChangesToPacket(ODPacket& os, const Tile* tile, uint32_t fields) const
+{
+    TileRefreshState state;
+    std::string meshName;
+    if(!computeTileRefreshState(tile, false, state, meshName))
+        return;
+
+    os.writeVarUInt32(fields);
+    if((fields & TileRefreshFields::Flags) != 0)
+        os.writeVarUInt32(state.mFlags);
+    if((fields & TileRefreshFields::RefundPriceRoom) != 0)
+        os.writeVarUInt32(state.mRefundPriceRoom);
+    if((fields & TileRefreshFields::RefundPriceTrap) != 0)
+        os.writeVarUInt32(state.mRefundPriceTrap);
+    if((fields & TileRefreshFields::SeatId) != 0)
+        os.writeVarUInt32(static_cast<uint32_t>(state.mSeatId + 1));
+    if((fields & TileRefreshFields::MeshName) != 0)
+        os << meshName;
+    if((fields & TileRefreshFields::TileVisual) != 0)
+        os.writeVarUInt32(static_cast<uint32_t>(state.mTileVisual));
+
+    // The fields that were not exported did not change so the state is what the client knows
+    uint32_t index = mTilesStates.getIndex(tile->getX(), tile->getY());
+    mTilesRefreshSent[index] = state;
+}
+
+bool Seat::computeTileRefreshState(const Tile* tile, bool hideSeatId, TileRefreshState& state,
+        std::string& meshName) const
 {
     if(getPlayer() == nullptr)
     {
         OD_LOG_ERR("SeatId=" + Helper::toString(getId()));
-        return;
+        return false;
     }
     if(!getPlayer()->getIsHuman())
     {
         OD_LOG_ERR("SeatId=" + Helper::toString(getId()));
-        return;
+        return false;
     }
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
+        return false;
 
-    const TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    TileVisual tileVisual = mTilesStates.getTileVisual(index);
+    Building* building = mTilesStates.getBuilding(index);
 
     int tileSeatId = -1;
     // We only pass the tile seat to the client if the tile is fully claimed
     if(!hideSeatId)
     {
-        switch(tileState.mTileVisual)
+        switch(tileVisual)
         {
             case TileVisual::claimedGround:
             case TileVisual::claimedFull:
-                tileSeatId = tileState.mSeatIdOwner;
+                tileSeatId = mTilesStates.getSeatIdOwner(index);
                 break;
             case TileVisual::waterGround:
             case TileVisual::lavaGround:
-                if(tileState.mBuilding != nullptr)
-                    tileSeatId = tileState.mSeatIdOwner;
+                if(building != nullptr)
+                    tileSeatId = mTilesStates.getSeatIdOwner(index);
                 break;
             default:
                 break;
         }
     }
 
-    std::string meshName;
-
-    if((tileState.mBuilding != nullptr) &&
-       !tileState.mBuilding->getMeshName().empty())
+    if((building != nullptr) &&
+       !building->getMeshName().empty())
     {
-        meshName = tileState.mBuilding->getMeshName() + ".mesh";
+        meshName = building->getMeshName() + ".mesh";
     }
     else
     {
         // We set an empty mesh so that the client can compute the tile itself
         meshName.clear();
     }
-    bool isRoom = false;
-    bool isTrap = false;
-    bool displayTileMesh = true;
-    bool colorCustomMesh = false;
-    bool hasBridge = false;
 
+    uint32_t flags = TileRefreshFlags::DisplayTileMesh;
     uint32_t refundPriceRoom = 0;
     uint32_t refundPriceTrap = 0;
-    if(tileState.mBuilding != nullptr)
+    if(building != nullptr)
     {
-        displayTileMesh = tileState.mBuilding->displayTileMesh();
-        colorCustomMesh = tileState.mBuilding->colorCustomMesh();
+        flags = 0;
+        if(building->displayTileMesh())
+            flags |= TileRefreshFlags::DisplayTileMesh;
+        if(building->colorCustomMesh())
+            flags |= TileRefreshFlags::ColorCustomMesh;
 
-        if(tileState.mBuilding->getObjectType() == GameEntityType::room)
+        if(building->getObjectType() == GameEntityType::room)
         {
-            isRoom = true;
-            Room* room = static_cast<Room*>(tileState.mBuilding);
+            flags |= TileRefreshFlags::IsRoom;
+            Room* room = static_cast<Room*>(building);
             if(room->getSeat() == this)
                 refundPriceRoom = (RoomManager::costPerTile(room->getType()) / 2);
 
-            hasBridge = room->isBridge();
+            if(room->isBridge())
+                flags |= TileRefreshFlags::HasBridge;
         }
-        else if(tileState.mBuilding->getObjectType() == GameEntityType::trap)
+        else if(building->getObjectType() == GameEntityType::trap)
         {
-            isTrap = true;
-            Trap* trap = static_cast<Trap*>(tileState.mBuilding);
+            flags |= TileRefreshFlags::IsTrap;
+            Trap* trap = static_cast<Trap*>(building);
             if(trap->getSeat() == this)
                 refundPriceTrap = (TrapManager::costPerTile(trap->getType()) / 2);
         }
     }
-    os << isRoom;
-    os << isTrap;
-    os << refundPriceRoom;
-    os << refundPriceTrap;
-    os << displayTileMesh;
-    os << colorCustomMesh;
-    os << hasBridge;
-    os << tileSeatId;
-    os << meshName;
-    os << tileState.mTileVisual;
+
+    state.mRefundPriceRoom = refundPriceRoom;
+    state.mRefundPriceTrap = refundPriceTrap;
+    state.mSeatId = tileSeatId;
+    state.mMeshNameIndex = getTileMeshNameIndex(meshName);
+    state.mFlags = flags;
+    state.mTileVisual = tileVisual;
+    state.mSent = true;
+    return true;
+}
+
+uint32_t Seat::getTileMeshNameIndex(const std::string& meshName) const
+{
+    for(uint32_t index = 0; index < mTileMeshNamesSent.size(); ++index)
+    {
+        if(mTileMeshNamesSent[index] == meshName)
+            return index;
+    }
+
+    mTileMeshNamesSent.push_back(meshName);
+    return static_cast<uint32_t>(mTileMeshNamesSent.size() - 1);
 }
 
 void Seat::notifyBuildingRemovedFromGameMap(Building* building, Tile* tile)
@@ -1738,20 +1826,12 @@ void Seat::notifyBuildingRemovedFromGameMap(Building* building, Tile* tile)
     if(!getPlayer()->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
         return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    if(tileState.mBuilding == building)
-        tileState.mBuilding = nullptr;
+    if(mTilesStates.getBuilding(index) == building)
+        mTilesStates.setBuilding(index, nullptr);
 }
 
 void Seat::tileMarkedDiggingNotifiedToPlayer(Tile* tile, bool isDigSet)
@@ -1761,39 +1841,24 @@ void Seat::tileMarkedDiggingNotifiedToPlayer(Tile* tile, bool isDigSet)
     if(!getPlayer()->getIsHuman())
         return;
 
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
         return;
-    }
 
-    TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
-    tileState.mMarkedForDigging = isDigSet;
+    mTilesStates.setMarkedForDigging(index, isDigSet);
 }
 
 bool Seat::isTileDiggableForClient(Tile* tile) const
 {
     if(!getPlayer()->getIsHuman())
         return false;
-    if(tile->getX() >= static_cast<int>(mTilesStates.size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
+    uint32_t index;
+    if(!getTileStateIndex(tile, index))
         return false;
-    }
-    if(tile->getY() >= static_cast<int>(mTilesStates[tile->getX()].size()))
-    {
-        OD_LOG_ERR("Tile=" + Tile::displayAsString(tile));
-        return false;
-    }
 
-    const TileStateNotified& tileState = mTilesStates[tile->getX()][tile->getY()];
+    TileVisual tileVisual = mTilesStates.getTileVisual(index);
     // Handle non claimed
-    switch(tileState.mTileVisual)
+    switch(tileVisual)
     {
         case TileVisual::claimedGround:
         case TileVisual::dirtGround:
@@ -1813,14 +1878,14 @@ bool Seat::isTileDiggableForClient(Tile* tile) const
     }
 
     // Should be claimed tile
-    if(tileState.mTileVisual != TileVisual::claimedFull)
+    if(tileVisual != TileVisual::claimedFull)
     {
-        OD_LOG_ERR("mTileVisual=" + Tile::tileVisualToString(tileState.mTileVisual));
+        OD_LOG_ERR("mTileVisual=" + Tile::tileVisualToString(tileVisual));
         return false;
     }
 
     // It is claimed. If it is by the given seat team, it can be dug
-    Seat* seat = mGameMap->getSeatById(tileState.mSeatIdOwner);
+    Seat* seat = mGameMap->getSeatById(mTilesStates.getSeatIdOwner(index));
     if(!canOwnedTileBeClaimedBy(seat))
         return true;
 
@@ -19,6 +19,7 @@
 #define SEAT_H
 
 #include "game/SeatData.h"
+#include "game/TileStatePlanes.h"
 
 #include <OgreVector3.h>
 #include <OgreColourValue.h>
@@ -45,7 +46,7 @@ enum class SpellType;
 enum class TileVisual;
 enum class TrapType;
 
-//! Class used to save the last tile state notified to each seat
+//! Class used to save the tile states read from the level file for each seat
 class TileStateNotified
 {
 public:
@@ -54,9 +55,6 @@ public:
     TileVisual mTileVisual;
     int mSeatIdOwner;
     bool mMarkedForDigging;
-    bool mVisionTurnLast;
-    bool mVisionTurnCurrent;
-    Building* mBuilding;
 };
 
 class Seat : public SeatData
@@ -200,8 +198,13 @@ public:
     bool canOwnedCreatureUseRoomFrom(const Seat* seat) const;
     bool canBuildingBeDestroyedBy(const Seat* seat) const;
 
+    //! \brief Removes vision on every tile. The next call to sendVisibleTiles will check the whole map
     void clearTilesWithVision();
+    //! \brief Called at the beginning of the vision update. Restores the real vision on the tiles
+    //! temporarily seen with notifyTileClaimedByEnemy
+    void beginVisionUpdate();
     void notifyVisionOnTile(Tile* tile);
+    void notifyVisionLostOnTile(Tile* tile);
     void notifyTileClaimedByEnemy(Tile* tile);
 
     //! \brief Returns true if this seat can see the given tile and false otherwise
@@ -215,7 +218,8 @@ public:
     void toggleSeatVisualDebug();
     void refreshSeatVisualDebug();
 
-    //! Sends a message to the player on this seat to refresh the list of tiles he has vision on
+    //! Sends a message to the player on this seat to refresh the list of tiles he has vision on. Only the tiles
+    //! where vision changed since the last call are sent
     void sendVisibleTiles();
 
     //! \brief Client side to display the tile this seat has vision on
@@ -300,6 +304,15 @@ public:
     void exportTileToPacket(ODPacket& os, const Tile* tile,
         bool hideSeatId) const;
 
+    //! \brief Returns the TileRefreshFields (except the particle effects) of the given tile that
+    //! differ from what was last exported to the client. Every field is returned if the tile
+    //! was never exported. Used on server side only
+    uint32_t getTileChangedFields(const Tile* tile) const;
+
+    //! \brief Exports the given TileRefreshFields of the tile. The particle effects are exported
+    //! by the tile itself. Used on server side only
+    void exportTileChangesToPacket(ODPacket& os, const Tile* tile, uint32_t fields) const;
+
     static bool sortForMapSave(Seat* s1, Seat* s2);
 
     static Seat* createRogueSeat(GameMap* gameMap);
@@ -356,13 +369,37 @@ private:
     //! \brief The default workers spawned in temples.
     const CreatureDefinition* mDefaultWorkerClass;
 
-    //! \brief List of all the tiles in the gamemap (used for human players seats only). The first vector stores the X position.
-    //! The second vector stores the Y position. TileStateNotified contains information about the tile
-    //! state (last tile state notified, vision last turn for this seat, vision for current turn, ...
-    std::vector<std::vector<TileStateNotified>> mTilesStates;
+    //! \brief State of all the tiles in the gamemap (used for human players seats only). Contains
+    //! the last tile state notified, vision last turn for this seat, vision for current turn, ...
+    TileStatePlanes mTilesStates;
 
     std::map<std::pair<int, int>, TileStateNotified> mTilesStateLoaded;
 
+    //! \brief Tile fields as last exported to the client of the seat
+    struct TileRefreshState
+    {
+        uint32_t mRefundPriceRoom;
+        uint32_t mRefundPriceTrap;
+        int32_t mSeatId;
+        //! \brief Index in mTileMeshNamesSent
+        uint32_t mMeshNameIndex;
+        //! \brief TileRefreshFlags
+        uint32_t mFlags;
+        TileVisual mTileVisual;
+        bool mSent;
+    };
+
+    //! \brief Last state exported to the client for each tile (used for human players seats only). Indexed
+    //! like mTilesStates. Since the packets are delivered in order, it is what the client knows. It is
+    //! updated when exporting tiles so it is mutable
+    mutable std::vector<TileRefreshState> mTilesRefreshSent;
+
+    //! \brief Mesh names exported in tile refreshes. mTilesRefreshSent only keeps their index
+    mutable std::vector<std::string> mTileMeshNamesSent;
+
+    //! \brief Tiles given temporary vision by notifyTileClaimedByEnemy during the turn
+    std::vector<Tile*> mTilesClaimedByEnemy;
+
     std::vector<Tile*> mVisualDebugEntityTiles;
 
     //! \brief Index of the team in the gamemap (from 0 to N). Must be set when the seat is added to the gamemap
@@ -404,6 +441,18 @@ private:
     //! Returns 0 if the seat end tile has been reached, 1 if the read success and -1 if there is an error
     int readTilesVisualInitialStates(TileVisual tileVisual, std::istream& is);
 
+    //! \brief Sets index to the index of the given tile in mTilesStates. Returns false
+    //! if the tile is not tracked for this seat
+    bool getTileStateIndex(const Tile* tile, uint32_t& index) const;
+
+    //! \brief Computes the tile state to export to the client. Returns false if the tile is not
+    //! tracked for this seat
+    bool computeTileRefreshState(const Tile* tile, bool hideSeatId, TileRefreshState& state,
+        std::string& meshName) const;
+
+    //! \brief Returns the index of the given mesh name in mTileMeshNamesSent (added if needed)
+    uint32_t getTileMeshNameIndex(const std::string& meshName) const;
+
     //! exports the tiles of the corresponding TileVisual this seat have seen
     void exportTilesVisualInitialStates(TileVisual tileVisual, std::ostream& os) const;
 };
@@ -0,0 +1,114 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game/TileStatePlanes.h"
+
+#include "utils/Helper.h"
+#include "utils/LogManager.h"
+
+#include <algorithm>
+
+static inline uint32_t popCount(uint64_t bits)
+{
+#if defined(_MSC_VER)
+    return static_cast<uint32_t>(__popcnt64(bits));
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(bits));
+#endif
+}
+
+TileStatePlanes::TileStatePlanes() :
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mOwnerSeatIds(1, -1)
+{
+}
+
+void TileStatePlanes::resize(int mapSizeX, int mapSizeY)
+{
+    mMapSizeX = mapSizeX;
+    mMapSizeY = mapSizeY;
+    uint32_t nbTiles = static_cast<uint32_t>(mapSizeX * mapSizeY);
+    uint32_t nbWords = (nbTiles + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    mVisionCurrent.assign(nbWords, 0);
+    mVisionLast.assign(nbWords, 0);
+    mMarkedForDigging.assign(nbWords, 0);
+    // nullTileVisual is 0
+    mTileVisuals.assign(nbTiles, 0);
+    mOwners.assign(nbTiles, 0);
+    mOwnerSeatIds.assign(1, -1);
+    mBuildings.clear();
+}
+
+void TileStatePlanes::setSeatIdOwner(uint32_t index, int seatId)
+{
+    std::vector<int>::iterator it = std::find(mOwnerSeatIds.begin(), mOwnerSeatIds.end(), seatId);
+    if(it == mOwnerSeatIds.end())
+    {
+        // There are a lot less seats than that
+        if(mOwnerSeatIds.size() > 0xFF)
+        {
+            OD_LOG_ERR("Too many seat ids, seatId=" + Helper::toString(seatId));
+            return;
+        }
+        it = mOwnerSeatIds.insert(mOwnerSeatIds.end(), seatId);
+    }
+    mOwners[index] = static_cast<uint8_t>(it - mOwnerSeatIds.begin());
+}
+
+Building* TileStatePlanes::getBuilding(uint32_t index) const
+{
+    std::unordered_map<uint32_t, Building*>::const_iterator it = mBuildings.find(index);
+    if(it == mBuildings.end())
+        return nullptr;
+
+    return it->second;
+}
+
+void TileStatePlanes::setBuilding(uint32_t index, Building* building)
+{
+    if(building == nullptr)
+        mBuildings.erase(index);
+    else
+        mBuildings[index] = building;
+}
+
+void TileStatePlanes::clearVisionCurrent()
+{
+    std::fill(mVisionCurrent.begin(), mVisionCurrent.end(), 0);
+}
+
+uint32_t TileStatePlanes::countVisionCurrent() const
+{
+    uint32_t nbTiles = 0;
+    for(uint64_t bits : mVisionCurrent)
+        nbTiles += popCount(bits);
+
+    return nbTiles;
+}
+
+void TileStatePlanes::countVisionChanges(uint32_t& nbGained, uint32_t& nbLost) const
+{
+    nbGained = 0;
+    nbLost = 0;
+    for(uint32_t w = 0; w < mVisionCurrent.size(); ++w)
+    {
+        uint64_t changed = mVisionCurrent[w] ^ mVisionLast[w];
+        nbGained += popCount(changed & mVisionCurrent[w]);
+        nbLost += popCount(changed & mVisionLast[w]);
+    }
+}
@@ -0,0 +1,192 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILESTATEPLANES_H
+#define TILESTATEPLANES_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+class Building;
+
+enum class TileVisual;
+
+/*! \brief What a human seat knows about each tile of the map (what was last notified to
+ * its player and its vision).
+ *
+ * The states are stored in planes indexed by tile (see getIndex):
+ * - vision for the current turn, vision for the last turn and marked for digging are bit
+ *   planes (64 tiles per word)
+ * - the tile visual and the owner are byte planes. The owner byte is an index in a small
+ *   table of seat ids so that any seat id can be stored
+ * - the buildings are in a side table as only a few tiles are covered by a building
+ *
+ * The vision changes are computed a word at a time by comparing the current and last
+ * vision planes.
+ */
+class TileStatePlanes
+{
+public:
+    TileStatePlanes();
+
+    //! \brief Resizes the planes and resets every tile (null visual, no owner, no vision,
+    //! not marked and no building)
+    void resize(int mapSizeX, int mapSizeY);
+
+    inline int getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int getMapSizeY() const
+    { return mMapSizeY; }
+
+    inline bool isInMap(int x, int y) const
+    { return (x >= 0) && (y >= 0) && (x < mMapSizeX) && (y < mMapSizeY); }
+
+    //! \brief Index of the tile in the planes. The tiles are sorted by x then by y
+    inline uint32_t getIndex(int x, int y) const
+    { return static_cast<uint32_t>(x * mMapSizeY + y); }
+
+    inline int getX(uint32_t index) const
+    { return static_cast<int>(index) / mMapSizeY; }
+
+    inline int getY(uint32_t index) const
+    { return static_cast<int>(index) % mMapSizeY; }
+
+    inline bool hasVisionCurrent(uint32_t index) const
+    { return getBit(mVisionCurrent, index); }
+
+    inline void setVisionCurrent(uint32_t index, bool vision)
+    { setBit(mVisionCurrent, index, vision); }
+
+    inline bool hasVisionLast(uint32_t index) const
+    { return getBit(mVisionLast, index); }
+
+    inline void setVisionLast(uint32_t index, bool vision)
+    { setBit(mVisionLast, index, vision); }
+
+    inline bool isMarkedForDigging(uint32_t index) const
+    { return getBit(mMarkedForDigging, index); }
+
+    inline void setMarkedForDigging(uint32_t index, bool marked)
+    { setBit(mMarkedForDigging, index, marked); }
+
+    inline TileVisual getTileVisual(uint32_t index) const
+    { return static_cast<TileVisual>(mTileVisuals[index]); }
+
+    inline void setTileVisual(uint32_t index, TileVisual tileVisual)
+    { mTileVisuals[index] = static_cast<uint8_t>(tileVisual); }
+
+    //! \brief Returns the owner seat id or -1 if there is none
+    inline int getSeatIdOwner(uint32_t index) const
+    { return mOwnerSeatIds[mOwners[index]]; }
+
+    void setSeatIdOwner(uint32_t index, int seatId);
+
+    Building* getBuilding(uint32_t index) const;
+
+    void setBuilding(uint32_t index, Building* building);
+
+    //! \brief Removes the vision for the current turn of every tile
+    void clearVisionCurrent();
+
+    //! \brief Number of tiles with vision for the current turn
+    uint32_t countVisionCurrent() const;
+
+    //! \brief Number of tiles where the vision was gained and lost since the last turn
+    void countVisionChanges(uint32_t& nbGained, uint32_t& nbLost) const;
+
+    //! \brief Calls func(index) for every tile with vision for the current turn, sorted by index
+    template<typename F>
+    void forEachVisionCurrent(F func) const
+    {
+        for(uint32_t w = 0; w < mVisionCurrent.size(); ++w)
+        {
+            for(uint64_t bits = mVisionCurrent[w]; bits != 0; bits &= bits - 1)
+                func(w * BITS_PER_WORD + countTrailingZeros(bits));
+        }
+    }
+
+    //! \brief Calls func(index, hasVision) for every tile where the vision for the current
+    //! turn differs from the last turn (sorted by index) then sets the last turn vision to
+    //! the current one
+    template<typename F>
+    void applyVisionChanges(F func)
+    {
+        for(uint32_t w = 0; w < mVisionCurrent.size(); ++w)
+        {
+            uint64_t current = mVisionCurrent[w];
+            uint64_t changed = current ^ mVisionLast[w];
+            if(changed == 0)
+                continue;
+
+            mVisionLast[w] = current;
+            for(; changed != 0; changed &= changed - 1)
+            {
+                uint32_t bit = countTrailingZeros(changed);
+                func(w * BITS_PER_WORD + bit, ((current >> bit) & 1) != 0);
+            }
+        }
+    }
+
+    static const uint32_t BITS_PER_WORD = 64;
+
+private:
+    static inline bool getBit(const std::vector<uint64_t>& plane, uint32_t index)
+    { return ((plane[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1) != 0; }
+
+    static inline void setBit(std::vector<uint64_t>& plane, uint32_t index, bool value)
+    {
+        uint64_t mask = static_cast<uint64_t>(1) << (index % BITS_PER_WORD);
+        if(value)
+            plane[index / BITS_PER_WORD] |= mask;
+        else
+            plane[index / BITS_PER_WORD] &= ~mask;
+    }
+
+    static inline uint32_t countTrailingZeros(uint64_t bits)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+    }
+
+    int mMapSizeX;
+    int mMapSizeY;
+
+    std::vector<uint64_t> mVisionCurrent;
+    std::vector<uint64_t> mVisionLast;
+    std::vector<uint64_t> mMarkedForDigging;
+
+    std::vector<uint8_t> mTileVisuals;
+    //! \brief Index in mOwnerSeatIds
+    std::vector<uint8_t> mOwners;
+    //! \brief Seat ids used by mOwners. The first one is -1 (no owner)
+    std::vector<int> mOwnerSeatIds;
+
+    std::unordered_map<uint32_t, Building*> mBuildings;
+};
+
+#endif // TILESTATEPLANES_H
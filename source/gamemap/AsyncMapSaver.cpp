@@ -0,0 +1,109 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/AsyncMapSaver.h"
+
+#include <chrono>
+
+AsyncMapSaver::AsyncMapSaver() :
+    mIsWriting(false),
+    mStopping(false)
+{
+}
+
+AsyncMapSaver::~AsyncMapSaver()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mJobAvailable.notify_all();
+    if(mThread.joinable())
+        mThread.join();
+}
+
+void AsyncMapSaver::save(std::unique_ptr<GameMapSnapshot> snapshot, const std::string& fileName,
+    bool makeBackup, bool isAutosave)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Job job;
+        job.mSnapshot = std::move(snapshot);
+        job.mFileName = fileName;
+        job.mMakeBackup = makeBackup;
+        job.mIsAutosave = isAutosave;
+        mJobs.push_back(std::move(job));
+
+        if(!mThread.joinable())
+            mThread = std::thread(&AsyncMapSaver::saverThread, this);
+    }
+    mJobAvailable.notify_one();
+}
+
+bool AsyncMapSaver::isBusy() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mIsWriting || !mJobs.empty();
+}
+
+void AsyncMapSaver::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this]() { return !mIsWriting && mJobs.empty(); });
+}
+
+void AsyncMapSaver::popResults(std::vector<Result>& results)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for(Result& result : mResults)
+        results.push_back(std::move(result));
+
+    mResults.clear();
+}
+
+void AsyncMapSaver::saverThread()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while(true)
+    {
+        // Pending saves are written even when stopping
+        mJobAvailable.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+        if(mJobs.empty())
+            return;
+
+        Job job = std::move(mJobs.front());
+        mJobs.pop_front();
+        mIsWriting = true;
+        lock.unlock();
+
+        Result result;
+        result.mFileName = job.mFileName;
+        result.mIsAutosave = job.mIsAutosave;
+        auto start = std::chrono::steady_clock::now();
+        result.mSuccess = job.mSnapshot->writeToFile(job.mFileName, job.mMakeBackup, result.mError);
+        result.mWriteTimeUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        // The snapshot is freed on this thread as well
+        job.mSnapshot.reset();
+
+        lock.lock();
+        mResults.push_back(std::move(result));
+        mIsWriting = false;
+        if(mJobs.empty())
+            mIdle.notify_all();
+    }
+}
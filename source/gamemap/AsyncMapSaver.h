@@ -0,0 +1,93 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNCMAPSAVER_H
+#define ASYNCMAPSAVER_H
+
+#include "gamemap/GameMapSnapshot.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*! \brief Writes GameMapSnapshot to files on a background thread.
+ *
+ * The saves are written one after the other in the order they were asked. The thread
+ * is started with the first save. The results are kept until popResults is called
+ * (by the thread that asked for the saves).
+ */
+class AsyncMapSaver
+{
+public:
+    struct Result
+    {
+        std::string mFileName;
+        bool mIsAutosave;
+        bool mSuccess;
+        std::string mError;
+        //! \brief Time spent writing the file
+        uint64_t mWriteTimeUs;
+    };
+
+    AsyncMapSaver();
+    //! \brief Writes the pending saves before returning
+    ~AsyncMapSaver();
+
+    AsyncMapSaver(const AsyncMapSaver&) = delete;
+    AsyncMapSaver& operator=(const AsyncMapSaver&) = delete;
+
+    //! \brief Queues the snapshot to be written in fileName. See GameMapSnapshot::writeToFile
+    void save(std::unique_ptr<GameMapSnapshot> snapshot, const std::string& fileName,
+        bool makeBackup, bool isAutosave);
+
+    //! \brief Returns true if a save is queued or being written
+    bool isBusy() const;
+
+    //! \brief Blocks until every queued save is written
+    void waitIdle();
+
+    //! \brief Moves the results of the saves written since last call to results
+    void popResults(std::vector<Result>& results);
+
+private:
+    struct Job
+    {
+        std::unique_ptr<GameMapSnapshot> mSnapshot;
+        std::string mFileName;
+        bool mMakeBackup;
+        bool mIsAutosave;
+    };
+
+    void saverThread();
+
+    std::thread mThread;
+    mutable std::mutex mMutex;
+    std::condition_variable mJobAvailable;
+    std::condition_variable mIdle;
+    std::deque<Job> mJobs;
+    //! \brief True while the saver thread writes a job (that is not in mJobs anymore)
+    bool mIsWriting;
+    bool mStopping;
+    std::vector<Result> mResults;
+};
+
+#endif // ASYNCMAPSAVER_H
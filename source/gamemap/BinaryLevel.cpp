@@ -0,0 +1,526 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/BinaryLevel.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+//! \brief Header: magic, format version, number of sections, reserved
+const uint32_t HEADER_SIZE = 16;
+//! \brief Section table entry: type, reserved, offset, size
+const uint32_t SECTION_ENTRY_SIZE = 16;
+//! \brief Tiles section header: map size X, map size Y, number of tiles, reserved
+const uint32_t TILES_HEADER_SIZE = 16;
+
+static_assert(sizeof(BinaryLevel::TileRecord) == 24, "TileRecord must have the same layout as in the files");
+
+bool isLittleEndian()
+{
+    uint16_t value = 1;
+    char firstByte;
+    std::memcpy(&firstByte, &value, 1);
+    return firstByte == 1;
+}
+
+void appendUInt32(std::vector<char>& data, uint32_t value)
+{
+    for(uint32_t i = 0; i < 4; ++i)
+        data.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void appendUInt16(std::vector<char>& data, uint16_t value)
+{
+    data.push_back(static_cast<char>(value & 0xFF));
+    data.push_back(static_cast<char>((value >> 8) & 0xFF));
+}
+
+void appendDouble(std::vector<char>& data, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for(uint32_t i = 0; i < 8; ++i)
+        data.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+}
+
+void setUInt32(std::vector<char>& data, std::size_t offset, uint32_t value)
+{
+    for(uint32_t i = 0; i < 4; ++i)
+        data[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+uint32_t readUInt32(const char* data)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8)
+        | (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+void alignTo8(std::vector<char>& data)
+{
+    while((data.size() % 8) != 0)
+        data.push_back(0);
+}
+
+//! \brief Removes the comment and the end of line characters. Returns false if nothing remains
+bool cleanLine(std::string& line)
+{
+    std::size_t comment = line.find('#');
+    if(comment != std::string::npos)
+        line.erase(comment);
+
+    while(!line.empty() && ((line.back() == '\r') || (line.back() == '\n')))
+        line.pop_back();
+
+    return line.find_first_not_of(" \t") != std::string::npos;
+}
+
+std::string trim(const std::string& line)
+{
+    std::size_t start = line.find_first_not_of(" \t");
+    if(start == std::string::npos)
+        return std::string();
+
+    std::size_t end = line.find_last_not_of(" \t");
+    return line.substr(start, end - start + 1);
+}
+
+bool parseInt(const std::string& text, int32_t& value)
+{
+    if(text.empty())
+        return false;
+
+    char* end;
+    errno = 0;
+    long result = std::strtol(text.c_str(), &end, 10);
+    if((*end != '\0') || (errno != 0) || (result < INT32_MIN) || (result > INT32_MAX))
+        return false;
+
+    value = static_cast<int32_t>(result);
+    return true;
+}
+
+bool parseDouble(const std::string& text, double& value)
+{
+    if(text.empty())
+        return false;
+
+    char* end;
+    value = std::strtod(text.c_str(), &end);
+    return *end == '\0';
+}
+
+//! \brief Parses the content of the [Tiles] section (map size then one tile per line)
+bool parseTiles(const std::vector<std::string>& lines, std::vector<char>& section, std::string& error)
+{
+    std::vector<std::string> tokens;
+    uint32_t nbLinesSize = 0;
+    // The map size can be on 1 or 2 lines
+    while((tokens.size() < 2) && (nbLinesSize < lines.size()))
+    {
+        std::stringstream ss(lines[nbLinesSize]);
+        std::string token;
+        while(ss >> token)
+            tokens.push_back(token);
+
+        ++nbLinesSize;
+    }
+
+    int32_t mapSizeX;
+    int32_t mapSizeY;
+    if((tokens.size() != 2) || !parseInt(tokens[0], mapSizeX) || !parseInt(tokens[1], mapSizeY))
+    {
+        error = "Invalid map size in [Tiles]";
+        return false;
+    }
+
+    appendUInt32(section, static_cast<uint32_t>(mapSizeX));
+    appendUInt32(section, static_cast<uint32_t>(mapSizeY));
+    appendUInt32(section, static_cast<uint32_t>(lines.size() - nbLinesSize));
+    appendUInt32(section, 0);
+
+    for(uint32_t i = nbLinesSize; i < lines.size(); ++i)
+    {
+        tokens.clear();
+        std::stringstream ss(lines[i]);
+        std::string token;
+        while(ss >> token)
+            tokens.push_back(token);
+
+        int32_t x;
+        int32_t y;
+        int32_t type;
+        double fullness;
+        int32_t seatId = 0;
+        bool isValid = ((tokens.size() == 4) || (tokens.size() == 5))
+            && parseInt(tokens[0], x)
+            && parseInt(tokens[1], y)
+            && parseInt(tokens[2], type)
+            && (type >= 0) && (type <= 0xFFFF)
+            && parseDouble(tokens[3], fullness)
+            && ((tokens.size() == 4) || parseInt(tokens[4], seatId));
+        if(!isValid)
+        {
+            error = "Invalid tile line: " + lines[i];
+            return false;
+        }
+
+        appendUInt32(section, static_cast<uint32_t>(x));
+        appendUInt32(section, static_cast<uint32_t>(y));
+        appendUInt16(section, static_cast<uint16_t>(type));
+        appendUInt16(section, (tokens.size() == 5) ? 1 : 0);
+        appendUInt32(section, static_cast<uint32_t>(seatId));
+        appendDouble(section, fullness);
+    }
+
+    return true;
+}
+
+void appendSection(std::vector<char>& binary, uint32_t sectionIndex, BinaryLevel::SectionType type,
+    const std::vector<char>& section)
+{
+    alignTo8(binary);
+    std::size_t entry = HEADER_SIZE + sectionIndex * SECTION_ENTRY_SIZE;
+    setUInt32(binary, entry, static_cast<uint32_t>(type));
+    setUInt32(binary, entry + 8, static_cast<uint32_t>(binary.size()));
+    setUInt32(binary, entry + 12, static_cast<uint32_t>(section.size()));
+    binary.insert(binary.end(), section.begin(), section.end());
+}
+}
+
+namespace BinaryLevel
+{
+
+bool isBinaryLevelFile(const std::string& fileName)
+{
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    char magic[sizeof(MAGIC)];
+    if(!file.read(magic, sizeof(magic)))
+        return false;
+
+    return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool textToBinary(std::istream& text, std::vector<char>& binary, std::string& error)
+{
+    // We read every meaningful line first to know how many sections there are
+    std::vector<std::string> lines;
+    std::string line;
+    while(std::getline(text, line))
+    {
+        if(cleanLine(line))
+            lines.push_back(line);
+    }
+
+    if(lines.empty())
+    {
+        error = "Empty level";
+        return false;
+    }
+
+    // Each section is a list of lines from its tag to its closing tag. The first "section" is
+    // the version
+    std::vector<std::pair<SectionType, std::vector<char>>> sections;
+    std::vector<char> versionSection;
+    std::string version = trim(lines[0]);
+    versionSection.insert(versionSection.end(), version.begin(), version.end());
+    sections.push_back(std::make_pair(SectionType::version, versionSection));
+
+    uint32_t index = 1;
+    while(index < lines.size())
+    {
+        std::string tag = trim(lines[index]);
+        if((tag.size() < 3) || (tag.front() != '[') || (tag.back() != ']') || (tag[1] == '/'))
+        {
+            error = "Expected a section tag but got: " + lines[index];
+            return false;
+        }
+
+        std::string closingTag = "[/" + tag.substr(1);
+        uint32_t end = index + 1;
+        while((end < lines.size()) && (trim(lines[end]) != closingTag))
+            ++end;
+
+        if(end >= lines.size())
+        {
+            error = "Missing " + closingTag;
+            return false;
+        }
+
+        std::vector<char> section;
+        if(tag == "[Tiles]")
+        {
+            std::vector<std::string> tileLines(lines.begin() + index + 1, lines.begin() + end);
+            if(!parseTiles(tileLines, section, error))
+                return false;
+
+            sections.push_back(std::make_pair(SectionType::tiles, section));
+        }
+        else
+        {
+            appendUInt32(section, end - index + 1);
+            for(uint32_t i = index; i <= end; ++i)
+            {
+                appendUInt32(section, static_cast<uint32_t>(lines[i].size()));
+                section.insert(section.end(), lines[i].begin(), lines[i].end());
+            }
+            sections.push_back(std::make_pair(SectionType::text, section));
+        }
+
+        index = end + 1;
+    }
+
+    binary.assign(MAGIC, MAGIC + sizeof(MAGIC));
+    appendUInt32(binary, FORMAT_VERSION);
+    appendUInt32(binary, static_cast<uint32_t>(sections.size()));
+    appendUInt32(binary, 0);
+    binary.resize(HEADER_SIZE + sections.size() * SECTION_ENTRY_SIZE, 0);
+    for(uint32_t i = 0; i < sections.size(); ++i)
+        appendSection(binary, i, sections[i].first, sections[i].second);
+
+    return true;
+}
+
+bool convertLevelFile(const std::string& inputFileName, const std::string& outputFileName, std::string& error)
+{
+    if(isBinaryLevelFile(inputFileName))
+    {
+        BinaryLevelReader reader;
+        if(!reader.open(inputFileName))
+        {
+            error = reader.getError();
+            return false;
+        }
+
+        std::ofstream output(outputFileName.c_str(), std::ofstream::out);
+        reader.exportText(output, true);
+        if(!output.good())
+        {
+            error = "Could not write " + outputFileName;
+            return false;
+        }
+        return true;
+    }
+
+    std::ifstream input(inputFileName.c_str(), std::ifstream::in);
+    if(!input.good())
+    {
+        error = "Could not open " + inputFileName;
+        return false;
+    }
+
+    std::vector<char> binary;
+    if(!textToBinary(input, binary, error))
+        return false;
+
+    std::ofstream output(outputFileName.c_str(), std::ofstream::out | std::ofstream::binary);
+    output.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+    if(!output.good())
+    {
+        error = "Could not write " + outputFileName;
+        return false;
+    }
+    return true;
+}
+
+}
+
+BinaryLevelReader::BinaryLevelReader() :
+    mData(nullptr),
+    mSize(0),
+    mMapSizeX(0),
+    mMapSizeY(0),
+    mNbTiles(0),
+    mTiles(nullptr)
+{
+}
+
+bool BinaryLevelReader::open(const std::string& fileName)
+{
+    if(!mFile.open(fileName))
+        return setError("Could not open " + fileName);
+
+    return openFromMemory(mFile.getData(), mFile.getSize());
+}
+
+bool BinaryLevelReader::openFromMemory(const char* data, std::size_t size)
+{
+    mData = data;
+    mSize = size;
+    mSections.clear();
+    mMapSizeX = 0;
+    mMapSizeY = 0;
+    mNbTiles = 0;
+    mTiles = nullptr;
+    mError.clear();
+
+    // The tiles are used directly from the file so they need to be in the same byte order
+    if(!isLittleEndian())
+        return setError("Binary levels can only be read on little endian computers");
+
+    return readSections();
+}
+
+bool BinaryLevelReader::setError(const std::string& error)
+{
+    mError = error;
+    mSections.clear();
+    mTiles = nullptr;
+    mNbTiles = 0;
+    return false;
+}
+
+bool BinaryLevelReader::readSections()
+{
+    if((mSize < HEADER_SIZE) || (std::memcmp(mData, BinaryLevel::MAGIC, sizeof(BinaryLevel::MAGIC)) != 0))
+        return setError("Not a binary level");
+
+    uint32_t formatVersion = readUInt32(mData + 4);
+    if(formatVersion != BinaryLevel::FORMAT_VERSION)
+        return setError("Unsupported binary level version " + std::to_string(formatVersion));
+
+    uint32_t nbSections = readUInt32(mData + 8);
+    if((mSize - HEADER_SIZE) / SECTION_ENTRY_SIZE < nbSections)
+        return setError("Truncated section table");
+
+    bool hasTiles = false;
+    for(uint32_t i = 0; i < nbSections; ++i)
+    {
+        const char* entry = mData + HEADER_SIZE + i * SECTION_ENTRY_SIZE;
+        BinaryLevel::Section section;
+        section.mType = static_cast<BinaryLevel::SectionType>(readUInt32(entry));
+        uint32_t offset = readUInt32(entry + 8);
+        section.mSize = readUInt32(entry + 12);
+        if((offset > mSize) || (section.mSize > mSize - offset))
+            return setError("Section " + std::to_string(i) + " is out of the file");
+
+        section.mData = mData + offset;
+        switch(section.mType)
+        {
+            case BinaryLevel::SectionType::version:
+                if(i != 0)
+                    return setError("The version must be the first section");
+                break;
+
+            case BinaryLevel::SectionType::text:
+            {
+                // We check the lines now so that exportText does not have to
+                if(section.mSize < 4)
+                    return setError("Invalid text section " + std::to_string(i));
+
+                uint32_t nbLines = readUInt32(section.mData);
+                uint32_t pos = 4;
+                for(uint32_t line = 0; line < nbLines; ++line)
+                {
+                    if(section.mSize - pos < 4)
+                        return setError("Invalid text section " + std::to_string(i));
+
+                    uint32_t lineSize = readUInt32(section.mData + pos);
+                    pos += 4;
+                    if(section.mSize - pos < lineSize)
+                        return setError("Invalid text section " + std::to_string(i));
+
+                    pos += lineSize;
+                }
+                break;
+            }
+
+            case BinaryLevel::SectionType::tiles:
+            {
+                if(hasTiles || (section.mSize < TILES_HEADER_SIZE))
+                    return setError("Invalid tiles section");
+
+                uint32_t nbTiles = readUInt32(section.mData + 8);
+                if((section.mSize - TILES_HEADER_SIZE) / sizeof(BinaryLevel::TileRecord) != nbTiles)
+                    return setError("Invalid number of tiles");
+
+                const char* tiles = section.mData + TILES_HEADER_SIZE;
+                if((reinterpret_cast<uintptr_t>(tiles) % alignof(BinaryLevel::TileRecord)) != 0)
+                    return setError("Misaligned tiles section");
+
+                hasTiles = true;
+                mMapSizeX = static_cast<int32_t>(readUInt32(section.mData));
+                mMapSizeY = static_cast<int32_t>(readUInt32(section.mData + 4));
+                mNbTiles = nbTiles;
+                mTiles = reinterpret_cast<const BinaryLevel::TileRecord*>(tiles);
+                break;
+            }
+
+            default:
+                return setError("Unknown section type " + std::to_string(static_cast<uint32_t>(section.mType)));
+        }
+
+        mSections.push_back(section);
+    }
+
+    if(mSections.empty() || (mSections[0].mType != BinaryLevel::SectionType::version))
+        return setError("Missing version section");
+
+    return true;
+}
+
+void BinaryLevelReader::exportText(std::ostream& os, bool withTiles) const
+{
+    for(const BinaryLevel::Section& section : mSections)
+    {
+        switch(section.mType)
+        {
+            case BinaryLevel::SectionType::version:
+                os.write(section.mData, section.mSize);
+                os << "\n";
+                break;
+
+            case BinaryLevel::SectionType::text:
+            {
+                os << "\n";
+                uint32_t nbLines = readUInt32(section.mData);
+                const char* pos = section.mData + 4;
+                for(uint32_t line = 0; line < nbLines; ++line)
+                {
+                    uint32_t lineSize = readUInt32(pos);
+                    os.write(pos + 4, lineSize);
+                    os << "\n";
+                    pos += 4 + lineSize;
+                }
+                break;
+            }
+
+            case BinaryLevel::SectionType::tiles:
+            {
+                os << "\n[Tiles]\n" << mMapSizeX << "\n" << mMapSizeY << "\n";
+                if(withTiles)
+                {
+                    for(uint32_t i = 0; i < mNbTiles; ++i)
+                    {
+                        const BinaryLevel::TileRecord& tile = mTiles[i];
+                        os << tile.mX << "\t" << tile.mY << "\t" << tile.mType << "\t" << tile.mFullness;
+                        if(tile.mHasSeat != 0)
+                            os << "\t" << tile.mSeatId;
+                        os << "\n";
+                    }
+                }
+                os << "[/Tiles]\n";
+                break;
+            }
+        }
+    }
+}
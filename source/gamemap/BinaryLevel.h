@@ -0,0 +1,143 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BINARYLEVEL_H
+#define BINARYLEVEL_H
+
+#include "utils/MappedFile.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/*! \brief Binary container for the levels and the saved games.
+ *
+ * Parsing the tiles is what takes most of the time when loading a text level (they are
+ * most of the file). A binary level stores them as an array of fixed size records that is
+ * used directly from the mapped file. The other sections (seats, rooms, creatures, ...) are
+ * small compared to the tiles. They are stored as length prefixed text records (one per line)
+ * so that they are still loaded by the existing importers of each entity.
+ *
+ * Layout (every integer is little endian):
+ * - Header: "ODLB", format version, number of sections, 0
+ * - Section table: for each section, its type, 0, its offset and its size
+ * - Sections, in the same order as in the text level and aligned on 8 bytes:
+ *   - Version: the OpenDungeons version string
+ *   - Text: number of lines then, for each line, its size and its characters. The first
+ *     line is the section tag (for example [Seats]) and the last one is the closing tag
+ *   - Tiles: map size X, map size Y, number of tiles, 0, then the TileRecords
+ *
+ * The conversion between text and binary levels is lossless except for the comments
+ * and the empty lines of the text level.
+ */
+namespace BinaryLevel
+{
+    static const char MAGIC[4] = { 'O', 'D', 'L', 'B' };
+    static const uint32_t FORMAT_VERSION = 1;
+
+    enum class SectionType : uint32_t
+    {
+        version = 1,
+        text = 2,
+        tiles = 3
+    };
+
+    //! \brief Tile as saved in binary levels. Its fields are the same as in the text levels
+    struct TileRecord
+    {
+        int32_t mX;
+        int32_t mY;
+        uint16_t mType;
+        //! \brief Set to 1 if the tile has a seat
+        uint16_t mHasSeat;
+        int32_t mSeatId;
+        double mFullness;
+    };
+
+    struct Section
+    {
+        SectionType mType;
+        const char* mData;
+        uint32_t mSize;
+    };
+
+    //! \brief Returns true if the given file starts like a binary level
+    bool isBinaryLevelFile(const std::string& fileName);
+
+    //! \brief Builds a binary level from the given text level. Returns false and sets error
+    //! if the text level is not valid
+    bool textToBinary(std::istream& text, std::vector<char>& binary, std::string& error);
+
+    //! \brief Converts the given level file from text to binary or from binary to text,
+    //! depending on the format of the input file
+    bool convertLevelFile(const std::string& inputFileName, const std::string& outputFileName, std::string& error);
+}
+
+//! \brief Gives access to the sections of a binary level without copying them
+class BinaryLevelReader
+{
+public:
+    BinaryLevelReader();
+
+    //! \brief Maps the given file and checks its header and sections
+    bool open(const std::string& fileName);
+
+    //! \brief Same as open but the data is given by the caller and must stay valid
+    bool openFromMemory(const char* data, std::size_t size);
+
+    inline const std::string& getError() const
+    { return mError; }
+
+    inline const std::vector<BinaryLevel::Section>& getSections() const
+    { return mSections; }
+
+    inline int32_t getMapSizeX() const
+    { return mMapSizeX; }
+
+    inline int32_t getMapSizeY() const
+    { return mMapSizeY; }
+
+    inline uint32_t getNbTiles() const
+    { return mNbTiles; }
+
+    //! \brief The tiles, directly in the mapped file
+    inline const BinaryLevel::TileRecord* getTiles() const
+    { return mTiles; }
+
+    //! \brief Writes the level as text. If withTiles is false, the [Tiles] section only contains
+    //! the map size. That is used when loading a binary level to parse the other sections
+    //! like text levels while the tiles are read from getTiles
+    void exportText(std::ostream& os, bool withTiles) const;
+
+private:
+    bool setError(const std::string& error);
+
+    bool readSections();
+
+    MappedFile mFile;
+    const char* mData;
+    std::size_t mSize;
+    std::string mError;
+    std::vector<BinaryLevel::Section> mSections;
+    int32_t mMapSizeX;
+    int32_t mMapSizeY;
+    uint32_t mNbTiles;
+    const BinaryLevel::TileRecord* mTiles;
+};
+
+#endif // BINARYLEVEL_H
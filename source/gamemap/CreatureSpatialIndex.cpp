@@ -0,0 +1,127 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/CreatureSpatialIndex.h"
+
+#include "utils/LogManager.h"
+#include "utils/Helper.h"
+
+#include <algorithm>
+
+const int CreatureSpatialIndex::CELL_SIZE = 8;
+
+CreatureSpatialIndex::CreatureSpatialIndex() :
+    mSizeX(0),
+    mSizeY(0),
+    mNbCellsX(0),
+    mNbCellsY(0),
+    mNbCreatures(0)
+{
+}
+
+void CreatureSpatialIndex::setMapSize(int sizeX, int sizeY)
+{
+    mSizeX = sizeX;
+    mSizeY = sizeY;
+    mNbCellsX = (sizeX + CELL_SIZE - 1) / CELL_SIZE;
+    mNbCellsY = (sizeY + CELL_SIZE - 1) / CELL_SIZE;
+    mNbCreatures = 0;
+    uint32_t nbCells = static_cast<uint32_t>(mNbCellsX * mNbCellsY);
+    mCells.clear();
+    mCells.resize(nbCells);
+    mOccupiedCells.assign((nbCells + 63) / 64, 0);
+}
+
+int CreatureSpatialIndex::cellIndexForTile(int x, int y) const
+{
+    if((x < 0) || (x >= mSizeX) || (y < 0) || (y >= mSizeY))
+        return -1;
+
+    return (y / CELL_SIZE) * mNbCellsX + (x / CELL_SIZE);
+}
+
+void CreatureSpatialIndex::addCreature(Creature* creature, int x, int y)
+{
+    int cellIndex = cellIndexForTile(x, y);
+    if(cellIndex < 0)
+    {
+        OD_LOG_ERR("Invalid tile x=" + Helper::toString(x) + ", y=" + Helper::toString(y));
+        return;
+    }
+
+    mCells[cellIndex].push_back({creature, x, y});
+    mOccupiedCells[cellIndex / 64] |= (static_cast<uint64_t>(1) << (cellIndex % 64));
+    ++mNbCreatures;
+}
+
+void CreatureSpatialIndex::removeCreature(Creature* creature, int x, int y)
+{
+    int cellIndex = cellIndexForTile(x, y);
+    if(cellIndex < 0)
+    {
+        OD_LOG_ERR("Invalid tile x=" + Helper::toString(x) + ", y=" + Helper::toString(y));
+        return;
+    }
+
+    std::vector<Entry>& cell = mCells[cellIndex];
+    auto it = std::find_if(cell.begin(), cell.end(), [creature, x, y](const Entry& entry)
+    {
+        return (entry.mCreature == creature) && (entry.mX == x) && (entry.mY == y);
+    });
+    if(it == cell.end())
+    {
+        OD_LOG_ERR("Creature not found on tile x=" + Helper::toString(x) + ", y=" + Helper::toString(y));
+        return;
+    }
+
+    // We keep the order of the other creatures
+    cell.erase(it);
+    if(cell.empty())
+        mOccupiedCells[cellIndex / 64] &= ~(static_cast<uint64_t>(1) << (cellIndex % 64));
+    --mNbCreatures;
+}
+
+void CreatureSpatialIndex::fillCreaturesInSquare(int x, int y, int radius, std::vector<Creature*>& creatures) const
+{
+    if(mNbCreatures == 0)
+        return;
+
+    int xMin = std::max(0, x - radius);
+    int xMax = std::min(mSizeX - 1, x + radius);
+    int yMin = std::max(0, y - radius);
+    int yMax = std::min(mSizeY - 1, y + radius);
+    if((xMin > xMax) || (yMin > yMax))
+        return;
+
+    for(int cellY = yMin / CELL_SIZE; cellY <= yMax / CELL_SIZE; ++cellY)
+    {
+        for(int cellX = xMin / CELL_SIZE; cellX <= xMax / CELL_SIZE; ++cellX)
+        {
+            int cellIndex = cellY * mNbCellsX + cellX;
+            if((mOccupiedCells[cellIndex / 64] & (static_cast<uint64_t>(1) << (cellIndex % 64))) == 0)
+                continue;
+
+            for(const Entry& entry : mCells[cellIndex])
+            {
+                if((entry.mX < xMin) || (entry.mX > xMax) || (entry.mY < yMin) || (entry.mY > yMax))
+                    continue;
+
+                creatures.push_back(entry.mCreature);
+            }
+        }
+    }
+}
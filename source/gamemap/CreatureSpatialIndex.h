@@ -0,0 +1,78 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CREATURESPATIALINDEX_H
+#define CREATURESPATIALINDEX_H
+
+#include <cstdint>
+#include <vector>
+
+class Creature;
+
+/*! \brief Uniform grid over the map telling which creatures stand in which area.
+ *
+ * The map is split in square cells. Each cell keeps the creatures standing on its tiles
+ * and a bitset tells which cells are not empty. That way, looking for the creatures around
+ * a tile only costs the number of non empty cells in the area and the creatures in them,
+ * instead of scanning every tile. The index is kept up to date by Tile::addEntity and
+ * Tile::removeEntity.
+ * The creatures are returned in a deterministic order (cells row by row, then insertion order).
+ */
+class CreatureSpatialIndex
+{
+public:
+    //! \brief Size (in tiles) of the square cells
+    static const int CELL_SIZE;
+
+    CreatureSpatialIndex();
+
+    //! \brief Clears the index and sets up the cells for the given map size
+    void setMapSize(int sizeX, int sizeY);
+
+    void addCreature(Creature* creature, int x, int y);
+    void removeCreature(Creature* creature, int x, int y);
+
+    //! \brief Adds to creatures the creatures standing on a tile in the square of the given
+    //! radius around (x, y)
+    void fillCreaturesInSquare(int x, int y, int radius, std::vector<Creature*>& creatures) const;
+
+    //! \brief Number of creatures in the index
+    inline uint32_t getNbCreatures() const
+    { return mNbCreatures; }
+
+private:
+    struct Entry
+    {
+        Creature* mCreature;
+        int mX;
+        int mY;
+    };
+
+    int mSizeX;
+    int mSizeY;
+    int mNbCellsX;
+    int mNbCellsY;
+    uint32_t mNbCreatures;
+    std::vector<std::vector<Entry>> mCells;
+    //! \brief One bit per cell, set if the cell is not empty
+    std::vector<uint64_t> mOccupiedCells;
+
+    //! \brief Returns the cell index for the given tile or -1 if it is outside the map
+    int cellIndexForTile(int x, int y) const;
+};
+
+#endif // CREATURESPATIALINDEX_H
@@ -0,0 +1,91 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/FloodFillRegions.h"
+
+#include <algorithm>
+
+void FloodFillRegions::clear()
+{
+    mLayers.clear();
+}
+
+uint32_t FloodFillRegions::find(uint32_t layer, uint32_t value) const
+{
+    if(layer >= mLayers.size())
+        return value;
+
+    const std::vector<uint32_t>& parents = mLayers[layer].mParents;
+    if(value >= parents.size())
+        return value;
+
+    while(parents[value] != value)
+        value = parents[value];
+
+    return value;
+}
+
+uint32_t FloodFillRegions::findAndCompress(uint32_t layer, uint32_t value)
+{
+    if(layer >= mLayers.size())
+        return value;
+
+    std::vector<uint32_t>& parents = mLayers[layer].mParents;
+    if(value >= parents.size())
+        return value;
+
+    // Path halving: each visited value is linked to its grand parent
+    while(parents[value] != value)
+    {
+        parents[value] = parents[parents[value]];
+        value = parents[value];
+    }
+
+    return value;
+}
+
+uint32_t FloodFillRegions::merge(uint32_t layer, uint32_t value1, uint32_t value2)
+{
+    if(layer >= mLayers.size())
+        mLayers.resize(layer + 1);
+
+    Layer& l = mLayers[layer];
+    uint32_t maxValue = std::max(value1, value2);
+    if(maxValue >= l.mParents.size())
+    {
+        uint32_t oldSize = static_cast<uint32_t>(l.mParents.size());
+        l.mParents.resize(maxValue + 1);
+        l.mRanks.resize(maxValue + 1, 0);
+        for(uint32_t i = oldSize; i <= maxValue; ++i)
+            l.mParents[i] = i;
+    }
+
+    uint32_t root1 = findAndCompress(layer, value1);
+    uint32_t root2 = findAndCompress(layer, value2);
+    if(root1 == root2)
+        return root1;
+
+    // Union by rank
+    if(l.mRanks[root1] < l.mRanks[root2])
+        std::swap(root1, root2);
+
+    l.mParents[root2] = root1;
+    if(l.mRanks[root1] == l.mRanks[root2])
+        ++l.mRanks[root1];
+
+    return root1;
+}
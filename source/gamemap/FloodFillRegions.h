@@ -0,0 +1,63 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLOODFILLREGIONS_H
+#define FLOODFILLREGIONS_H
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief Disjoint-set (union-find) of the floodfill values.
+ *
+ * Tiles store a floodfill value. When 2 areas get connected (a tile is dug, a door is unlocked, ...),
+ * instead of replacing the value of every tile of one of the areas, both values are merged here.
+ * The region of a tile is then the representative of its value. Thanks to union by rank (and path
+ * halving when merging), merging and finding are nearly constant time.
+ *
+ * find does not modify the set so that it can be called by several threads at the same time (for
+ * example while the creatures are sensing their surroundings) as long as nothing is merged.
+ *
+ * There is one independent set per layer (team and FloodFillType) because a same value can be shared
+ * by several teams when the floodfill is computed.
+ */
+class FloodFillRegions
+{
+public:
+    //! \brief Forgets every merged value
+    void clear();
+
+    //! \brief Returns the region the given value belongs to in the given layer. Values that have
+    //! never been merged are their own region
+    uint32_t find(uint32_t layer, uint32_t value) const;
+
+    //! \brief Merges the regions of the 2 given values in the given layer. Returns the resulting region
+    uint32_t merge(uint32_t layer, uint32_t value1, uint32_t value2);
+
+private:
+    //! \brief Same as find but links each visited value to its grand parent (path halving)
+    uint32_t findAndCompress(uint32_t layer, uint32_t value);
+
+    struct Layer
+    {
+        std::vector<uint32_t> mParents;
+        std::vector<uint8_t> mRanks;
+    };
+
+    std::vector<Layer> mLayers;
+};
+
+#endif // FLOODFILLREGIONS_H
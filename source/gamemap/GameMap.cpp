@@ -40,6 +40,8 @@
 #include "game/Seat.h"
 #include "gamemap/MapHandler.h"
 #include "gamemap/Pathfinding.h"
+#include "gamemap/PathfindingCache.h"
+#include "gamemap/PathfindingEngine.h"
 #include "gamemap/TileSet.h"
 #include "goals/Goal.h"
 #include "modes/ModeManager.h"
@@ -56,10 +58,15 @@
 #include "sound/SoundEffectsManager.h"
 #include "traps/Trap.h"
 #include "traps/TrapManager.h"
+#include "utils/AllocationCounter.h"
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/Random.h"
 #include "utils/ResourceManager.h"
+#include "utils/ScratchVector.h"
+#include "utils/ThreadPool.h"
+#include "utils/TurnProfiler.h"
 
 #include <OgreTimer.h>
 
@@ -73,82 +80,128 @@
 
 const std::string DEFAULT_NICK = "You";
 
+//! \brief Paths with a manhattan distance lower than this are always computed with the standard A*
+const int HIERARCHICAL_PATH_MIN_DISTANCE = 40;
+
 using namespace std;
 
-/*! \brief A helper class for the A* search in the GameMap::path function.
-*
-* This class stores the requisite information about a tile which is placed in
-* the search queue for the A-star, or A*, algorithm which is used to
-* calculate paths in the path function.
-*
-* The A* description can be found here:
-* http://en.wikipedia.org/wiki/A*_search_algorithm
-*/
-class AstarEntry
+//! \brief Returns the floodfill type to use to know where the given creature can go
+static FloodFillType getFloodFillTypeForCreature(const Creature& creature)
 {
-public:
-    AstarEntry() :
-        tile    (nullptr),
-        parent  (nullptr),
-        g       (0.0),
-        h       (0.0)
-    {}
-
-    AstarEntry(Tile* tile, int x1, int y1, int x2, int y2) :
-        tile    (tile),
-        parent  (nullptr),
-        g       (0.0),
-        h       (0.0),
-        mHasBeenProcessed (false)
+    FloodFillType floodFill = FloodFillType::ground;
+    if((creature.getMoveSpeedGround() > 0.0) &&
+        (creature.getMoveSpeedWater() > 0.0) &&
+        (creature.getMoveSpeedLava() > 0.0))
     {
-        h = computeHeuristic(x1, y1, x2, y2);
+        floodFill = FloodFillType::groundWaterLava;
     }
-
-    static double computeHeuristic(const int& x1, const int& y1, const int& x2, const int& y2)
+    if((creature.getMoveSpeedGround() > 0.0) &&
+        (creature.getMoveSpeedWater() > 0.0))
     {
-        return fabs(static_cast<double>(x2 - x1)) + fabs(static_cast<double>(y2 - y1));
+        floodFill = FloodFillType::groundWater;
     }
-
-    void setHeuristic(const int& x1, const int& y1, const int& x2, const int& y2)
+    if((creature.getMoveSpeedGround() > 0.0) &&
+        (creature.getMoveSpeedLava() > 0.0))
     {
-        h = fabs(static_cast<double>(x2 - x1)) + fabs(static_cast<double>(y2 - y1));
+        floodFill = FloodFillType::groundLava;
     }
+    return floodFill;
+}
 
-    inline double fCost() const
-    { return g + h; }
-
-    inline Tile* getTile() const
-    { return tile; }
+//! \brief Tells the pathfinding engine how the given creature can go through the tiles
+class CreaturePathAccess
+{
+public:
+    CreaturePathAccess(GameMap& gameMap, const Creature* creature, Seat* seat, bool throughDiggableTiles) :
+        mGameMap(gameMap),
+        mCreature(creature),
+        mSeat(seat),
+        mThroughDiggableTiles(throughDiggableTiles)
+    {}
 
-    inline bool getHasBeenProcessed() const
-    { return mHasBeenProcessed; }
+    PathfindingAccess operator()(int x, int y) const
+    {
+        Tile* tile = mGameMap.getTile(x, y);
+        if(mCreature->canGoThroughTile(tile))
+            return PathfindingAccess::walkable;
 
-    inline void setHasBeenProcessed()
-    { mHasBeenProcessed = true; }
+        if(mThroughDiggableTiles && tile->isDiggable(mSeat))
+            return PathfindingAccess::crossable;
 
-    inline void setTile(Tile* newTile)
-    { tile = newTile; }
+        return PathfindingAccess::blocked;
+    }
 
-    inline AstarEntry* getParent() const
-    { return parent; }
+private:
+    GameMap& mGameMap;
+    const Creature* mCreature;
+    Seat* mSeat;
+    bool mThroughDiggableTiles;
+};
 
-    inline void setParent(AstarEntry* newParent)
-    { parent = newParent; }
+//! \brief Gives the pathfinding engine the speed of the given creature when leaving a tile
+class CreaturePathSpeed
+{
+public:
+    CreaturePathSpeed(GameMap& gameMap, const Creature* creature) :
+        mGameMap(gameMap),
+        mCreature(creature)
+    {}
 
-    inline const double& getG() const
-    { return g; }
+    double operator()(int x, int y) const
+    {
+        Tile* tile = mGameMap.getTile(x, y);
+        if(tile->getFullness() == 0)
+            return mCreature->getMoveSpeed(tile);
 
-    inline void setG(const double& newG)
-    { g = newG; }
+        return mCreature->getMoveSpeedGround();
+    }
 
 private:
-    Tile*       tile;
-    AstarEntry* parent;
-    double      g;
-    double      h;
-    bool        mHasBeenProcessed;
+    GameMap& mGameMap;
+    const Creature* mCreature;
 };
 
+namespace
+{
+//! \brief Helpers for the name indexes of the entities on map
+template<typename T>
+void addToNameIndex(std::unordered_map<std::string, T*>& index, T* entity)
+{
+    // If there is already an entity with this name, we keep it like the former linear search did
+    index.emplace(entity->getName(), entity);
+}
+
+//! \brief Removes the given entity from the index. entities should not contain it anymore. If another
+//! entity has the same name, the first one in entities (the first added) is indexed instead
+template<typename T>
+void removeFromNameIndex(std::unordered_map<std::string, T*>& index, T* entity, const std::vector<T*>& entities)
+{
+    auto it = index.find(entity->getName());
+    if((it == index.end()) || (it->second != entity))
+        return;
+
+    for(T* other : entities)
+    {
+        if(other->getName() != entity->getName())
+            continue;
+
+        it->second = other;
+        return;
+    }
+
+    index.erase(it);
+}
+
+template<typename T>
+T* findInNameIndex(const std::unordered_map<std::string, T*>& index, const std::string& name)
+{
+    auto it = index.find(name);
+    if(it == index.end())
+        return nullptr;
+
+    return it->second;
+}
+}
 
 GameMap::GameMap(bool isServerGameMap) :
         TileContainer(isServerGameMap ? 15 : 0),
@@ -160,7 +213,9 @@ GameMap::GameMap(bool isServerGameMap) :
         mTimePayDay(0),
         mFloodFillEnabled(false),
         mIsFOWActivated(true),
+        mIsVisionFullRefreshNeeded(true),
         mNumCallsTo_path(0),
+        mPathfindingCache(*this),
         mAiManager(*this),
         mTileSet(nullptr)
 {
@@ -223,19 +278,12 @@ bool GameMap::loadLevel(const std::string& levelFilepath)
 
 bool GameMap::createNewMap(int sizeX, int sizeY)
 {
-    if (!allocateMapMemory(sizeX, sizeY))
+    // Every tile is created as a full dirt tile
+    if (!allocateMapMemory(this, sizeX, sizeY))
         return false;
 
-    for (int jj = 0; jj < mMapSizeY; ++jj)
-    {
-        for (int ii = 0; ii < mMapSizeX; ++ii)
-        {
-            Tile* tile = new Tile(this, ii, jj);
-            tile->setName(Tile::buildName(ii, jj));
-            tile->setType(TileType::dirt);
-            addTile(tile);
-        }
-    }
+    mPathfindingCache.setMapSize(sizeX, sizeY);
+    mCreatureSpatialIndex.setMapSize(sizeX, sizeY);
 
     mTurnNumber = -1;
 
@@ -284,6 +332,12 @@ void GameMap::clearAll()
     mTurnNumber = -1;
     resetUniqueNumbers();
     mIsFOWActivated = true;
+    mIsVisionFullRefreshNeeded = true;
+    mTilesClaimChanged.clear();
+    mTilesClaimChangedFlags.clear();
+    mTilesPermitsVisionChanged.clear();
+    mTilesPermitsVisionChangedFlags.clear();
+    mBlocksPermitsVisionChangedFlags.clear();
     mTimePayDay = 0;
 
     // We check if the different vectors are empty
@@ -323,6 +377,12 @@ void GameMap::clearAll()
         }
         mGameEntityClientUpkeep.clear();
     }
+    if(!mEntitiesById.empty())
+    {
+        OD_LOG_ERR("mEntitiesById not empty size=" + Helper::toString(static_cast<uint32_t>(mEntitiesById.size())));
+        mEntitiesById.clear();
+    }
+    mAnimatedObjectsById.clear();
 }
 
 void GameMap::clearCreatures()
@@ -336,6 +396,7 @@ void GameMap::clearCreatures()
     }
 
     mCreatures.clear();
+    mCreaturesByName.clear();
 }
 
 void GameMap::clearAiManager()
@@ -382,6 +443,7 @@ void GameMap::clearRenderedMovableEntities()
     }
 
     mRenderedMovableEntities.clear();
+    mRenderedMovableEntitiesByName.clear();
 }
 
 void GameMap::clearPlayers()
@@ -401,6 +463,38 @@ void GameMap::resetUniqueNumbers()
     mUniqueNumberTrap = 0;
     mUniqueNumberMapLight = 0;
     mUniqueFloodFillValue = 0;
+    mFloodFillRegions.clear();
+    mUniqueEntityId = GameEntity::NO_ID;
+}
+
+void GameMap::addEntityId(GameEntity* entity)
+{
+    if(isServerGameMap() && (entity->getId() == GameEntity::NO_ID))
+        entity->setId(++mUniqueEntityId);
+
+    if(entity->getId() == GameEntity::NO_ID)
+        return;
+
+    if(!mEntitiesById.emplace(entity->getId(), entity).second)
+        OD_LOG_ERR(serverStr() + "Entity id already used id=" + Helper::toString(entity->getId()) + ", name=" + entity->getName());
+}
+
+void GameMap::removeEntityId(GameEntity* entity)
+{
+    auto it = mEntitiesById.find(entity->getId());
+    if((it == mEntitiesById.end()) || (it->second != entity))
+        return;
+
+    mEntitiesById.erase(it);
+}
+
+GameEntity* GameMap::getEntityById(uint32_t id) const
+{
+    auto it = mEntitiesById.find(id);
+    if(it == mEntitiesById.end())
+        return nullptr;
+
+    return it->second;
 }
 
 void GameMap::addClassDescription(const CreatureDefinition *c)
@@ -490,6 +584,8 @@ void GameMap::addCreature(Creature *cc)
         + ", seatId=" + (cc->getSeat() != nullptr ? Helper::toString(cc->getSeat()->getId()) : std::string("null")));
 
     mCreatures.push_back(cc);
+    addEntityId(cc);
+    addToNameIndex(mCreaturesByName, cc);
 }
 
 void GameMap::removeCreature(Creature *c)
@@ -504,6 +600,9 @@ void GameMap::removeCreature(Creature *c)
     }
 
     mCreatures.erase(it);
+    removeEntityId(c);
+    removeFromNameIndex(mCreaturesByName, c, mCreatures);
+    c->removeVisionGiven();
 }
 
 void GameMap::queueEntityForDeletion(GameEntity *ge)
@@ -566,15 +665,20 @@ std::vector<Creature*> GameMap::getCreaturesByAlliedSeat(const Seat* seat) const
 std::vector<Creature*> GameMap::getCreaturesBySeat(const Seat* seat) const
 {
     std::vector<Creature*> tempVector;
+    getCreaturesBySeat(seat, tempVector);
+    return tempVector;
+}
 
-    // Loop over all the creatures in the GameMap and add them to the temp vector if their seat matches the one in parameter.
+void GameMap::getCreaturesBySeat(const Seat* seat, std::vector<Creature*>& creatures) const
+{
+    creatures.clear();
+
+    // Loop over all the creatures in the GameMap and add them to the vector if their seat matches the one in parameter.
     for (Creature* creature : mCreatures)
     {
         if (creature->getSeat() == seat && creature->isAlive())
-            tempVector.push_back(creature);
+            creatures.push_back(creature);
     }
-
-    return tempVector;
 }
 
 Creature* GameMap::getWorkerToPickupBySeat(Seat* seat)
@@ -596,8 +700,9 @@ Creature* GameMap::getWorkerToPickupBySeat(Seat* seat)
     Creature* diggerWorker = nullptr;
     uint32_t otherWorkerLevel = 0;
     Creature* otherWorker = nullptr;
-    std::vector<Creature*> creatures = getCreaturesBySeat(seat);
-    for(Creature* creature : creatures)
+    ScratchVector<Creature*> creatures;
+    getCreaturesBySeat(seat, *creatures);
+    for(Creature* creature : *creatures)
     {
         if(!creature->getDefinition()->isWorker())
             continue;
@@ -718,8 +823,9 @@ Creature* GameMap::getFighterToPickupBySeat(Seat* seat)
     Creature* busyFighter = nullptr;
     uint32_t otherFighterLevel = 0;
     Creature* otherFighter = nullptr;
-    std::vector<Creature*> creatures = getCreaturesBySeat(seat);
-    for(Creature* creature : creatures)
+    ScratchVector<Creature*> creatures;
+    getCreaturesBySeat(seat, *creatures);
+    for(Creature* creature : *creatures)
     {
         if(creature->getDefinition()->isWorker())
             continue;
@@ -806,6 +912,9 @@ Creature* GameMap::getFighterToPickupBySeat(Seat* seat)
 void GameMap::addAnimatedObject(MovableGameEntity *a)
 {
     mAnimatedObjects.push_back(a);
+    // The id is given when the entity is added to its own list (creatures, rendered entities, ...)
+    if(a->getId() != GameEntity::NO_ID)
+        mAnimatedObjectsById.emplace(a->getId(), a);
 }
 
 void GameMap::removeAnimatedObject(MovableGameEntity *a)
@@ -815,17 +924,19 @@ void GameMap::removeAnimatedObject(MovableGameEntity *a)
         return;
 
     mAnimatedObjects.erase(it);
+
+    auto itId = mAnimatedObjectsById.find(a->getId());
+    if((itId != mAnimatedObjectsById.end()) && (itId->second == a))
+        mAnimatedObjectsById.erase(itId);
 }
 
-MovableGameEntity* GameMap::getAnimatedObject(const std::string& name) const
+MovableGameEntity* GameMap::getAnimatedObject(uint32_t id) const
 {
-    for (MovableGameEntity* mge : mAnimatedObjects)
-    {
-        if (mge->getName().compare(name) == 0)
-            return mge;
-    }
+    auto it = mAnimatedObjectsById.find(id);
+    if(it == mAnimatedObjectsById.end())
+        return nullptr;
 
-    return nullptr;
+    return it->second;
 }
 
 void GameMap::addRenderedMovableEntity(RenderedMovableEntity *obj)
@@ -833,6 +944,8 @@ void GameMap::addRenderedMovableEntity(RenderedMovableEntity *obj)
     OD_LOG_INF(serverStr() + "Adding rendered object " + obj->getName()
         + ",MeshName=" + obj->getMeshName());
     mRenderedMovableEntities.push_back(obj);
+    addEntityId(obj);
+    addToNameIndex(mRenderedMovableEntitiesByName, obj);
 }
 
 void GameMap::removeRenderedMovableEntity(RenderedMovableEntity *obj)
@@ -847,16 +960,30 @@ void GameMap::removeRenderedMovableEntity(RenderedMovableEntity *obj)
     }
 
     mRenderedMovableEntities.erase(it);
+    removeEntityId(obj);
+    removeFromNameIndex(mRenderedMovableEntitiesByName, obj, mRenderedMovableEntities);
 }
 
 RenderedMovableEntity* GameMap::getRenderedMovableEntity(const std::string& name)
 {
-    for(RenderedMovableEntity* renderedMovableEntity : mRenderedMovableEntities)
+    return findInNameIndex(mRenderedMovableEntitiesByName, name);
+}
+
+RenderedMovableEntity* GameMap::getRenderedMovableEntityById(uint32_t id) const
+{
+    // Every animated object that is not a creature or a map light is a rendered movable entity
+    MovableGameEntity* entity = getAnimatedObject(id);
+    if(entity == nullptr)
+        return nullptr;
+
+    switch(entity->getObjectType())
     {
-        if(name.compare(renderedMovableEntity->getName()) == 0)
-            return renderedMovableEntity;
+        case GameEntityType::creature:
+        case GameEntityType::mapLight:
+            return nullptr;
+        default:
+            return static_cast<RenderedMovableEntity*>(entity);
     }
-    return nullptr;
 }
 
 void GameMap::addActiveObject(GameEntity *a)
@@ -1064,41 +1191,83 @@ void GameMap::destroyAllEntities()
 
 Creature* GameMap::getCreature(const std::string& cName) const
 {
-    for (Creature* creature : mCreatures)
+    return findInNameIndex(mCreaturesByName, cName);
+}
+
+Creature* GameMap::getCreatureById(uint32_t id) const
+{
+    GameEntity* entity = getEntityById(id);
+    if((entity == nullptr) || (entity->getObjectType() != GameEntityType::creature))
+        return nullptr;
+
+    return static_cast<Creature*>(entity);
+}
+
+//! \brief Profiler section used for the upkeep of the given type of active object
+static const char* getUpkeepProfilerSection(GameEntityType type)
+{
+    switch(type)
     {
-        if (creature->getName().compare(cName) == 0)
-            return creature;
+        case GameEntityType::creature:
+            return "creatures";
+        case GameEntityType::room:
+            return "rooms";
+        case GameEntityType::trap:
+            return "traps";
+        case GameEntityType::spell:
+            return "spells";
+        case GameEntityType::missileObject:
+            return "missiles";
+        default:
+            return "otherEntities";
     }
-    return nullptr;
 }
 
 void GameMap::doTurn(double timeSinceLastTurn)
 {
     OD_LOG_INF("Computing turn " + Helper::toString(mTurnNumber) + ", timeSinceLastTurn=" + Helper::toString(timeSinceLastTurn));
     unsigned int numCallsTo_path_atStart = mNumCallsTo_path;
+    mLastTurnPhaseTimes = TurnPhaseTimes();
+    uint64_t nbAllocationsAtStart = AllocationCounter::getNbAllocations();
 
     uint32_t miscUpkeepTime = doMiscUpkeep(timeSinceLastTurn);
 
-    for (Seat* seat : mSeats)
     {
-        if(seat->getPlayer() == nullptr)
-            continue;
+        OD_PROFILE_SCOPE("playersUpkeep");
+        for (Seat* seat : mSeats)
+        {
+            if(seat->getPlayer() == nullptr)
+                continue;
 
-        seat->getPlayer()->upkeepPlayer(timeSinceLastTurn);
+            seat->getPlayer()->upkeepPlayer(timeSinceLastTurn);
+        }
     }
 
+    mLastTurnPhaseTimes.mNbPathCalls = mNumCallsTo_path - numCallsTo_path_atStart;
+    mLastTurnPhaseTimes.mNbAllocations = AllocationCounter::getNbAllocations() - nbAllocationsAtStart;
     OD_LOG_INF("During this turn there were " + Helper::toString(mNumCallsTo_path - numCallsTo_path_atStart)
-        + " calls to GameMap::path(), miscUpkeepTime=" + Helper::toString(miscUpkeepTime));
+        + " calls to GameMap::path(), miscUpkeepTime=" + Helper::toString(miscUpkeepTime)
+        + (AllocationCounter::isEnabled() ? ", allocations=" + Helper::toString(mLastTurnPhaseTimes.mNbAllocations) : std::string()));
+}
+
+uint32_t GameMap::getNbSensingThreads() const
+{
+    if(mSensingThreadPool == nullptr)
+        return 0;
+
+    return mSensingThreadPool->getNbThreads();
 }
 
 void GameMap::doPlayerAITurn(double timeSinceLastTurn)
 {
+    OD_PROFILE_SCOPE("ai");
+    Ogre::Timer stopwatch;
     mAiManager.doTurn(timeSinceLastTurn);
+    mLastTurnPhaseTimes.mAI = stopwatch.getMicroseconds();
 }
 
 unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
 {
-    Tile *tempTile;
     Ogre::Timer stopwatch;
     unsigned long int timeTaken;
 
@@ -1184,57 +1353,71 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
             ++(tempSeat->mNumCreaturesFighters);
     }
 
-    // At each upkeep, we re-compute tiles with vision
-    for (Seat* seat : mSeats)
-        seat->clearTilesWithVision();
-
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
+    uint64_t phaseStart = stopwatch.getMicroseconds();
     {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
+        OD_PROFILE_SCOPE("vision");
+        updateVision();
+
+        for (Seat* seat : mSeats)
         {
-            getTile(ii,jj)->clearVision();
+            if(!seat->getIsDebuggingVision())
+                continue;
+
+            seat->refreshSeatVisualDebug();
         }
-    }
 
-    // Compute vision. We need to compute every seats including AI because
-    // a human can be allied with an AI and they would share vision
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
+        // We send to each seat the list of tiles he has vision on. A late client gets
+        // every change at once when it catches up
+        for (Seat* seat : mSeats)
         {
-            getTile(ii,jj)->computeVisibleTiles();
+            if(ODServer::getSingleton().isPlayerCatchingUp(seat->getPlayer()))
+                continue;
+
+            seat->sendVisibleTiles();
         }
     }
 
-    for (Creature* creature : mCreatures)
-    {
-        creature->computeVisibleTiles();
-    }
+    mLastTurnPhaseTimes.mVision = stopwatch.getMicroseconds() - phaseStart;
+    phaseStart = stopwatch.getMicroseconds();
 
-    for (Spell* spell : mSpells)
-    {
-        spell->computeVisibleTiles();
-    }
+    // What the creatures see only depends on the game map so it can be computed in parallel. Then,
+    // they act one after the other using what they saw at the beginning of the turn. Sensing must
+    // not modify the game map (the floodfill regions are only read with the non compressing find)
+    if(mSensingThreadPool == nullptr)
+        mSensingThreadPool.reset(new ThreadPool(ConfigManager::getSingleton().getSensingThreads()));
 
-    for (Seat* seat : mSeats)
     {
-        if(!seat->getIsDebuggingVision())
-            continue;
-
-        seat->refreshSeatVisualDebug();
+        OD_PROFILE_SCOPE("sensing");
+        mSensingThreadPool->parallelFor(static_cast<uint32_t>(mCreatures.size()), [this](uint32_t index)
+        {
+            Creature* creature = mCreatures[index];
+            Random::StreamScope randomScope(creature->getRandomStream(), RandomStreamContext::entity, creature->getId());
+            creature->senseSurroundings();
+        });
     }
 
-    // We send to each seat the list of tiles he has vision on
-    for (Seat* seat : mSeats)
-        seat->sendVisibleTiles();
+    mLastTurnPhaseTimes.mSensing = stopwatch.getMicroseconds() - phaseStart;
+    phaseStart = stopwatch.getMicroseconds();
 
     // Carry out the upkeep round of all the active objects in the game.
     // Here, we work on a copy of the active objects list because they might
-    // try to remove themselves which would break the iterator
+    // try to remove themselves which would break the iterator. Each entity draws
+    // its random numbers from its own stream
     std::vector<GameEntity*> activeObjects = mActiveObjects;
-    for(GameEntity* ge : activeObjects)
-        ge->doUpkeep();
+    {
+        OD_PROFILE_SCOPE("entitiesUpkeep");
+        for(GameEntity* ge : activeObjects)
+        {
+            OD_PROFILE_SCOPE(getUpkeepProfilerSection(ge->getObjectType()));
+            Random::StreamScope randomScope(ge->getRandomStream(), RandomStreamContext::entity, ge->getId());
+            ge->doUpkeep();
+        }
+    }
 
+    mLastTurnPhaseTimes.mEntitiesUpkeep = stopwatch.getMicroseconds() - phaseStart;
+    phaseStart = stopwatch.getMicroseconds();
+
+    OD_PROFILE_SCOPE("seatsUpkeep");
     // Carry out the upkeep round for each seat. This means recomputing how much gold is
     // available in their treasuries, how much mana they gain/lose during this turn, etc.
     for (Seat* seat : mSeats)
@@ -1273,28 +1456,105 @@ unsigned long int GameMap::doMiscUpkeep(double timeSinceLastTurn)
     }
 
     // Determine the number of tiles claimed by each seat.
-    // Begin by setting the number of claimed tiles for each seat to 0.
+    // We count the claimed tiles for each seat id
+    int maxSeatId = -1;
     for (Seat* seat : mSeats)
-        seat->setNumClaimedTiles(0);
+        maxSeatId = std::max(maxSeatId, seat->getId());
 
-    // Now loop over all of the tiles, if the tile is claimed increment the given seats count.
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
+    std::vector<unsigned int> nbClaimedTiles(static_cast<uint32_t>(maxSeatId + 1), 0);
+    for (Tile* tile : getTiles())
     {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
+        if(!tile->isClaimed())
+            continue;
+
+        int seatId = tile->getSeat()->getId();
+        if((seatId < 0) || (seatId > maxSeatId))
+            continue;
+
+        ++nbClaimedTiles[seatId];
+    }
+
+    for (Seat* seat : mSeats)
+    {
+        if(seat->getId() < 0)
         {
-            tempTile = getTile(ii,jj);
+            seat->setNumClaimedTiles(0);
+            continue;
+        }
 
-            // Check to see if the current tile is claimed by anyone.
-            if (tempTile->isClaimed())
+        seat->setNumClaimedTiles(nbClaimedTiles[seat->getId()]);
+    }
+
+    timeTaken = stopwatch.getMicroseconds();
+    mLastTurnPhaseTimes.mSeatsUpkeep = timeTaken - phaseStart;
+    return timeTaken;
+}
+
+void GameMap::updateVision()
+{
+    // We need to compute every seats including AI because a human can be allied with
+    // an AI and they would share vision
+    for (Seat* seat : mSeats)
+        seat->beginVisionUpdate();
+
+    if(mIsVisionFullRefreshNeeded)
+    {
+        mIsVisionFullRefreshNeeded = false;
+        for (Tile* tile : mTilesClaimChanged)
+            mTilesClaimChangedFlags[getTileIndex(tile->getX(), tile->getY())] = 0;
+        mTilesClaimChanged.clear();
+
+        for (Seat* seat : mSeats)
+            seat->clearTilesWithVision();
+
+        for (Creature* creature : mCreatures)
+            creature->forgetVisionGiven();
+
+        for (Spell* spell : mSpells)
+            spell->forgetVisionGiven();
+
+        for (Tile* tile : getTiles())
+            tile->resetVision();
+
+        for (Tile* tile : getTiles())
+        {
+            // If the FOW is deactivated, we allow vision for every seat. This vision is
+            // never removed until the next full refresh
+            if(!mIsFOWActivated)
             {
-                // Increment the count of the seat who owns the tile.
-                tempTile->getSeat()->incrementNumClaimedTiles();
+                for(Seat* seat : mSeats)
+                    tile->addVision(seat);
             }
+
+            tile->computeVisibleTiles();
         }
     }
+    else
+    {
+        for (Tile* tile : mTilesClaimChanged)
+        {
+            mTilesClaimChangedFlags[getTileIndex(tile->getX(), tile->getY())] = 0;
+            tile->computeVisibleTiles();
+        }
 
-    timeTaken = stopwatch.getMicroseconds();
-    return timeTaken;
+        mTilesClaimChanged.clear();
+    }
+
+    // Creatures only compute their vision again if they moved or if something changed around them
+    for (Creature* creature : mCreatures)
+        creature->computeVisibleTiles();
+
+    for (Spell* spell : mSpells)
+        spell->computeVisibleTiles();
+
+    int nbBlocksX = getNbVisionChangeBlocksX();
+    for (Tile* tile : mTilesPermitsVisionChanged)
+    {
+        mTilesPermitsVisionChangedFlags[getTileIndex(tile->getX(), tile->getY())] = 0;
+        int blockIndex = (tile->getY() / VISION_CHANGE_BLOCK_SIZE) * nbBlocksX + tile->getX() / VISION_CHANGE_BLOCK_SIZE;
+        mBlocksPermitsVisionChangedFlags[blockIndex] = 0;
+    }
+    mTilesPermitsVisionChanged.clear();
 }
 
 void GameMap::updateAnimations(Ogre::Real timeSinceLastFrame)
@@ -1334,51 +1594,56 @@ void GameMap::playerIsFighting(Player* player, Tile* tile)
     }
 }
 
-std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
+std::list<Tile*> GameMap::findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*>& possibleDests,
     Tile*& chosenTile)
 {
     chosenTile = nullptr;
     std::list<Tile*> returnList;
-    if(possibleDests.empty())
+    if(findNearestReachableTiles(creature, tileStart, possibleDests, 1, mNearestTiles) == 0)
         return returnList;
 
-    // We start by sorting the vector
-    std::vector<Tile*> possibleDestsTmp = possibleDests;
-    std::sort(possibleDestsTmp.begin(), possibleDestsTmp.end(), [this, &tileStart](Tile* tile1, Tile* tile2){
-              int d1 = Pathfinding::squaredDistanceTile(*tile1, *tileStart);
-              int d2 = Pathfinding::squaredDistanceTile(*tile2, *tileStart);
-              return d1 < d2;
-        });
+    ++mNumCallsTo_path;
+    chosenTile = mNearestTiles[0];
+    // The path to the chosen tile has been computed by the search
+    mPathfindingEngine.buildPath(mPathfindingEngine.toIndex(chosenTile->getX(), chosenTile->getY()), mPathBuffer);
+    for(uint32_t index : mPathBuffer)
+        returnList.push_back(getTile(mPathfindingEngine.indexToX(index), mPathfindingEngine.indexToY(index)));
 
-    double magic = 2.0;
-    for(Tile* tile : possibleDestsTmp)
+    return returnList;
+}
+
+uint32_t GameMap::findNearestReachableTiles(const Creature* creature, Tile* tileStart, const std::vector<Tile*>& possibleDests,
+    uint32_t maxTiles, std::vector<Tile*>& nearestTiles)
+{
+    nearestTiles.clear();
+    if((creature == nullptr) || (tileStart == nullptr) || possibleDests.empty())
+        return 0;
+
+    if(mPathfindingEngine.getMapSizeX() != getMapSizeX() || mPathfindingEngine.getMapSizeY() != getMapSizeY())
+        mPathfindingEngine.setMapSize(getMapSizeX(), getMapSizeY());
+
+    // We only keep the tiles in the same floodfill region. That way, the search will stop as soon as
+    // the wanted number of tiles is reached instead of expanding the whole region
+    mPathTargets.clear();
+    for(Tile* tile : possibleDests)
     {
         if(!pathExists(creature, tileStart, tile))
             continue;
 
-        // The first reachable tile is the best by default
-        Ogre::Real dist = std::hypotf(tile->getX() - tileStart->getX(), tile->getY() - tileStart->getY());
-        if(chosenTile == nullptr)
-        {
-            chosenTile = tile;
-            returnList = path(tileStart, tile, creature, creature->getSeat(), false);
-            continue;
-        }
+        mPathTargets.push_back(mPathfindingEngine.toIndex(tile->getX(), tile->getY()));
+    }
 
-        // We compute the path only if walkableDist < (dist * magic).
-        double walkableDist = static_cast<double>(returnList.size());
-        if(walkableDist < (dist * magic))
-            continue;
+    if(mPathTargets.empty())
+        return 0;
 
-        std::list<Tile*> pathTmp = path(tileStart, tile, creature, creature->getSeat(), false);
-        if(pathTmp.size() < returnList.size())
-        {
-            // The path is shorter
-            chosenTile = tile;
-            returnList = pathTmp;
-        }
-    }
-    return returnList;
+    CreaturePathAccess access(*this, creature, creature->getSeat(), false);
+    CreaturePathSpeed moveSpeed(*this, creature);
+    mPathfindingEngine.findNearestTargets(tileStart->getX(), tileStart->getY(), mPathTargets, maxTiles,
+        access, moveSpeed, mPathBuffer);
+    for(uint32_t index : mPathBuffer)
+        nearestTiles.push_back(getTile(mPathfindingEngine.indexToX(index), mPathfindingEngine.indexToY(index)));
+
+    return static_cast<uint32_t>(nearestTiles.size());
 }
 
 bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEnd)
@@ -1392,23 +1657,7 @@ bool GameMap::pathExists(const Creature* creature, Tile* tileStart, Tile* tileEn
     if(creature == nullptr)
         return false;
 
-    FloodFillType floodFill = FloodFillType::ground;
-    if((creature->getMoveSpeedGround() > 0.0) &&
-        (creature->getMoveSpeedWater() > 0.0) &&
-        (creature->getMoveSpeedLava() > 0.0))
-    {
-        floodFill = FloodFillType::groundWaterLava;
-    }
-    if((creature->getMoveSpeedGround() > 0.0) &&
-        (creature->getMoveSpeedWater() > 0.0))
-    {
-        floodFill = FloodFillType::groundWater;
-    }
-    if((creature->getMoveSpeedGround() > 0.0) &&
-        (creature->getMoveSpeedLava() > 0.0))
-    {
-        floodFill = FloodFillType::groundLava;
-    }
+    FloodFillType floodFill = getFloodFillTypeForCreature(*creature);
 
     if(creature->getDefinition()->isWorker())
     {
@@ -1454,198 +1703,57 @@ std::list<Tile*> GameMap::path(int x1, int y1, int x2, int y2, const Creature* c
     if (!throughDiggableTiles && !pathExists(creature, start, destination))
         return returnList;
 
-    AstarEntry *currentEntry = new AstarEntry(start, x1, y1, x2, y2);
-    AstarEntry neighbor;
+    if(mPathfindingEngine.getMapSizeX() != getMapSizeX() || mPathfindingEngine.getMapSizeY() != getMapSizeY())
+        mPathfindingEngine.setMapSize(getMapSizeX(), getMapSizeY());
 
-    std::vector<AstarEntry*> openList;
-    openList.push_back(currentEntry);
+    CreaturePathAccess access(*this, creature, seat, throughDiggableTiles);
+    CreaturePathSpeed moveSpeed(*this, creature);
 
-    // This list will contain the processed and the to process entries
-    // allowing to quickly know if a tile has been processed or not
-    std::vector<std::vector<AstarEntry*>> processList(getMapSizeX(), std::vector<AstarEntry*>(getMapSizeY(), nullptr));
-    processList[currentEntry->getTile()->getX()][currentEntry->getTile()->getY()] = currentEntry;
-    AstarEntry* destinationEntry = nullptr;
-    while (true)
+    // For long paths, we first search the waypoints on the hierarchical graph and then compute the path
+    // between each of them. If something goes wrong, we fall back on the standard search
+    if(!throughDiggableTiles && mFloodFillEnabled &&
+       (std::abs(x2 - x1) + std::abs(y2 - y1) >= HIERARCHICAL_PATH_MIN_DISTANCE) &&
+       mPathfindingCache.findWaypoints(creature->getSeat(), getFloodFillTypeForCreature(*creature), start, destination, mPathWaypoints))
     {
-        // if the openList is empty we failed to find a path
-        if (openList.empty())
-            break;
-
-        // openList being sorted, the last element is the smallest
-        AstarEntry* smallestAstar = *openList.rbegin();
-        openList.pop_back();
-
-        currentEntry = smallestAstar;
-        currentEntry->setHasBeenProcessed();
-
-        // We found the path, break out of the search loop
-        if (currentEntry->getTile() == destination)
-        {
-            destinationEntry = currentEntry;
-            break;
-        }
-
-        // Check the tiles surrounding the current square
-        bool areTilesPassable[4] = {false, false, false, false};
-        // Note : to disable diagonals, process tiles from 0 to 3. To allow them, process tiles from 0 to 7
-        for (unsigned int i = 0; i < 8; ++i)
+        bool isPathValid = true;
+        for(uint32_t i = 1; i < mPathWaypoints.size(); ++i)
         {
-            Tile* neighborTile = nullptr;
-            switch(i)
+            Tile* tileFrom = mPathWaypoints[i - 1];
+            Tile* tileTo = mPathWaypoints[i];
+            // The start tile is always considered as walkable by the search. We check intermediate waypoints
+            if((i > 1) && !creature->canGoThroughTile(tileFrom))
             {
-                // We process the 4 adjacent tiles
-                case 0:
-                    neighborTile = getTile(currentEntry->getTile()->getX() - 1, currentEntry->getTile()->getY());
-                    break;
-                case 1:
-                    neighborTile = getTile(currentEntry->getTile()->getX() + 1, currentEntry->getTile()->getY());
-                    break;
-                case 2:
-                    neighborTile = getTile(currentEntry->getTile()->getX(), currentEntry->getTile()->getY() - 1);
-                    break;
-                case 3:
-                    neighborTile = getTile(currentEntry->getTile()->getX(), currentEntry->getTile()->getY() + 1);
-                    break;
-                // We process the 4 diagonal tiles. We only process a diagonal tile if the 2 tiles adjacent to the original one are
-                // passable.
-                case 4:
-                    if(areTilesPassable[0] && areTilesPassable[2])
-                        neighborTile = getTile(currentEntry->getTile()->getX() - 1, currentEntry->getTile()->getY() - 1);
-                    break;
-                case 5:
-                    if(areTilesPassable[0] && areTilesPassable[3])
-                        neighborTile = getTile(currentEntry->getTile()->getX() - 1, currentEntry->getTile()->getY() + 1);
-                    break;
-                case 6:
-                    if(areTilesPassable[1] && areTilesPassable[2])
-                        neighborTile = getTile(currentEntry->getTile()->getX() + 1, currentEntry->getTile()->getY() - 1);
-                    break;
-                case 7:
-                    if(areTilesPassable[1] && areTilesPassable[3])
-                        neighborTile = getTile(currentEntry->getTile()->getX() + 1, currentEntry->getTile()->getY() + 1);
-                    break;
-                default:
-                    break;
+                isPathValid = false;
+                break;
             }
-            if(neighborTile == nullptr)
-                continue;
 
-            neighbor.setTile(neighborTile);
-
-            bool processNeighbor = false;
-            // We process the tile if the creature can go through. But if it is the first tile that is
-            // not passable, we also process it. That happens if a door is closed
-            if((creature->canGoThroughTile(neighbor.getTile())) ||
-               (neighbor.getTile() == start))
+            if(!mPathfindingEngine.findPath(tileFrom->getX(), tileFrom->getY(), tileTo->getX(), tileTo->getY(),
+                access, moveSpeed, mPathBuffer))
             {
-                processNeighbor = true;
-                // We set passability for the 4 adjacent tiles only
-                if(i < 4)
-                    areTilesPassable[i] = true;
-             }
-            else if(throughDiggableTiles && neighbor.getTile()->isDiggable(seat))
-                processNeighbor = true;
-
-            if (!processNeighbor)
-                continue;
-
-            // See if the neighbor has already been processed
-            AstarEntry* neighborEntry = processList[neighbor.getTile()->getX()][neighbor.getTile()->getY()];
-            if ((neighborEntry != nullptr) && (neighborEntry->getHasBeenProcessed()))
-                continue;
-
-            // If the neighbor is not in the open list
-            if (neighborEntry == nullptr)
-            {
-                double weightToParent = AstarEntry::computeHeuristic(neighbor.getTile()->getX(), neighbor.getTile()->getY(),
-                    currentEntry->getTile()->getX(), currentEntry->getTile()->getY());
-
-                if(currentEntry->getTile()->getFullness() == 0)
-                    weightToParent /= creature->getMoveSpeed(currentEntry->getTile());
-                else
-                    weightToParent /= creature->getMoveSpeedGround();
-                neighbor.setG(currentEntry->getG() + weightToParent);
-
-                // Use the manhattan distance for the heuristic
-                neighbor.setHeuristic(neighbor.getTile()->getX(), neighbor.getTile()->getY(), x2, y2);
-                neighbor.setParent(currentEntry);
-
-                AstarEntry* entry = new AstarEntry(neighbor);
-                auto itr = openList.begin();
-                while((itr != openList.end()) &&
-                      ((*itr)->fCost() > entry->fCost()))
-                {
-                    ++itr;
-                }
-
-                openList.insert(itr, entry);
-                processList[neighbor.getTile()->getX()][neighbor.getTile()->getY()] = entry;
-            }
-            else
-            {
-                // If this path to the given neighbor tile is a shorter path than the
-                // one already given, make this the new parent.
-                double weightToParent = AstarEntry::computeHeuristic(neighbor.getTile()->getX(), neighbor.getTile()->getY(),
-                    currentEntry->getTile()->getX(), currentEntry->getTile()->getY());
-
-                if(currentEntry->getTile()->getFullness() == 0)
-                    weightToParent /= creature->getMoveSpeed(currentEntry->getTile());
-                else
-                    weightToParent /= creature->getMoveSpeedGround();
-
-                if (currentEntry->getG() + weightToParent < neighborEntry->getG())
-                {
-                    neighborEntry->setG(currentEntry->getG() + weightToParent);
-                    neighborEntry->setParent(currentEntry);
-
-                    // The cost changed. We need to re-order openList
-                    auto itr = std::find(openList.begin(), openList.end(), neighborEntry);
-                    if(itr == openList.end())
-                    {
-                        OD_LOG_ERR("Unexpected entry not found tileStart=" + Tile::displayAsString(start)
-                            + ", tileDest=" + Tile::displayAsString(destination)
-                            + ", tile=" + Tile::displayAsString(neighborEntry->getTile()));
-                    }
-                    else
-                    {
-                        itr = openList.erase(itr);
-                        // We look for the new location
-                        while((itr != openList.end()) &&
-                              ((*itr)->fCost() > neighborEntry->fCost()))
-                        {
-                            ++itr;
-                        }
-
-                        openList.insert(itr, neighborEntry);
-                    }
-                }
+                isPathValid = false;
+                break;
             }
-        }
-    }
 
-    if (destinationEntry != nullptr)
-    {
-        // Follow the parent chain back the the starting tile
-        AstarEntry* curEntry = destinationEntry;
-        do
-        {
-            if (curEntry->getTile() != nullptr)
+            // The first tile is the last one of the previous part
+            for(uint32_t k = (i > 1 ? 1 : 0); k < mPathBuffer.size(); ++k)
             {
-                returnList.push_front(curEntry->getTile());
-                curEntry = curEntry->getParent();
+                uint32_t index = mPathBuffer[k];
+                returnList.push_back(getTile(mPathfindingEngine.indexToX(index), mPathfindingEngine.indexToY(index)));
             }
+        }
 
-        } while (curEntry != nullptr);
-    }
+        if(isPathValid)
+            return returnList;
 
-    // Clean up the memory we allocated by deleting the astarEntries.  Note that
-    // processList contains all the created entries so it is enough to clean it.
-    for (std::vector<AstarEntry*>& column : processList)
-    {
-        for (AstarEntry* entry : column)
-            delete entry;
+        returnList.clear();
     }
 
+    if(!mPathfindingEngine.findPath(x1, y1, x2, y2, access, moveSpeed, mPathBuffer))
+        return returnList;
+
+    for(uint32_t index : mPathBuffer)
+        returnList.push_back(getTile(mPathfindingEngine.indexToX(index), mPathfindingEngine.indexToY(index)));
+
     return returnList;
 }
 
@@ -1743,9 +1851,75 @@ std::vector<GameEntity*> GameMap::getVisibleForce(const std::vector<Tile*>& visi
     return returnList;
 }
 
+void GameMap::getVisibleForce(const Creature& viewer, Seat* seat, bool enemyForce, std::vector<GameEntity*>& entities)
+{
+    getVisibleCreatures(viewer, seat, enemyForce, entities);
+
+    // Buildings are static. We check the building covering each visible tile
+    ScratchVector<Building*> buildings;
+    for (Tile* tile : viewer.getVisibleTiles())
+    {
+        Building* building = tile->getCoveringBuilding();
+        if(building == nullptr)
+            continue;
+
+        if(building->getSeat()->isAlliedSeat(seat) == enemyForce)
+            continue;
+
+        if(enemyForce && !building->isAttackable(tile, seat))
+            continue;
+
+        if(std::find(buildings->begin(), buildings->end(), building) != buildings->end())
+            continue;
+
+        buildings->push_back(building);
+    }
+
+    entities.insert(entities.end(), buildings->begin(), buildings->end());
+}
+
+void GameMap::getVisibleCreatures(const Creature& viewer, Seat* seat, bool enemyCreatures, std::vector<GameEntity*>& returnList)
+{
+    returnList.clear();
+    Tile* sightTile = viewer.getSightTile();
+    if(sightTile == nullptr)
+        return;
+
+    ScratchVector<Creature*> creatures;
+    mCreatureSpatialIndex.fillCreaturesInSquare(sightTile->getX(), sightTile->getY(), viewer.getSightRadius(), *creatures);
+    for(Creature* creature : *creatures)
+    {
+        if(creature->getSeat() == nullptr)
+            continue;
+
+        if(creature->getSeat()->isAlliedSeat(seat) == enemyCreatures)
+            continue;
+
+        if(!creature->isAlive())
+            continue;
+
+        Tile* tile = creature->getPositionTile();
+        if((tile == nullptr) || !viewer.isTileVisible(tile))
+            continue;
+
+        if(enemyCreatures && !creature->isAttackable(tile, seat))
+            continue;
+
+        returnList.push_back(creature);
+    }
+}
+
 std::vector<GameEntity*> GameMap::getVisibleCreatures(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyCreatures)
 {
     std::vector<GameEntity*> returnList;
+    getVisibleCreatures(visibleTiles, seat, enemyCreatures, returnList);
+    return returnList;
+}
+
+void GameMap::getVisibleCreatures(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyCreatures,
+    std::vector<GameEntity*>& returnList)
+{
+    returnList.clear();
 
     // Loop over the visible tiles
     for (Tile* tile : visibleTiles)
@@ -1765,8 +1939,6 @@ std::vector<GameEntity*> GameMap::getVisibleCreatures(const std::vector<Tile*>&
             tile->fillWithEntities(returnList, SelectionEntityWanted::creatureAliveAllied, seat->getPlayer());
         }
     }
-
-    return returnList;
 }
 
 std::vector<GameEntity*> GameMap::getCarryableEntities(Creature* carrier, const std::vector<Tile*>& tiles)
@@ -1799,6 +1971,7 @@ void GameMap::clearRooms()
     }
 
     mRooms.clear();
+    mRoomsByName.clear();
 }
 
 void GameMap::addRoom(Room *r)
@@ -1812,6 +1985,8 @@ void GameMap::addRoom(Room *r)
     }
 
     mRooms.push_back(r);
+    addEntityId(r);
+    addToNameIndex(mRoomsByName, r);
 }
 
 void GameMap::removeRoom(Room *r)
@@ -1827,6 +2002,8 @@ void GameMap::removeRoom(Room *r)
     }
 
     mRooms.erase(it);
+    removeEntityId(r);
+    removeFromNameIndex(mRoomsByName, r, mRooms);
 }
 
 std::vector<Room*> GameMap::getRoomsByType(RoomType type) const
@@ -1844,13 +2021,18 @@ std::vector<Room*> GameMap::getRoomsByType(RoomType type) const
 std::vector<Room*> GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat)
 {
     std::vector<Room*> returnList;
+    getRoomsByTypeAndSeat(type, seat, returnList);
+    return returnList;
+}
+
+void GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat, std::vector<Room*>& rooms)
+{
+    rooms.clear();
     for (Room* room : mRooms)
     {
         if (room->getType() == type && room->getSeat() == seat && room->getHP(nullptr) > 0.0)
-            returnList.push_back(room);
+            rooms.push_back(room);
     }
-
-    return returnList;
 }
 
 std::vector<const Room*> GameMap::getRoomsByTypeAndSeat(RoomType type, const Seat* seat) const
@@ -1881,18 +2063,20 @@ std::vector<Room*> GameMap::getReachableRooms(const std::vector<Room*>& vec,
                                               const Creature* creature)
 {
     std::vector<Room*> returnVector;
+    getReachableRooms(vec, startTile, creature, returnVector);
+    return returnVector;
+}
 
-    for (unsigned int i = 0; i < vec.size(); ++i)
+void GameMap::getReachableRooms(const std::vector<Room*>& vec, Tile* startTile, const Creature* creature,
+                                std::vector<Room*>& reachableRooms)
+{
+    reachableRooms.clear();
+    for (Room* room : vec)
     {
-        Room* room = vec[i];
         Tile* coveredTile = room->getCoveredTile(0);
         if (pathExists(creature, startTile, coveredTile))
-        {
-            returnVector.push_back(room);
-        }
+            reachableRooms.push_back(room);
     }
-
-    return returnVector;
 }
 
 std::vector<Building*> GameMap::getReachableBuildingsPerSeat(Seat* seat,
@@ -1932,24 +2116,12 @@ std::vector<Building*> GameMap::getReachableBuildingsPerSeat(Seat* seat,
 
 Room* GameMap::getRoomByName(const std::string& name)
 {
-    for (Room* room : mRooms)
-    {
-        if(room->getName().compare(name) == 0)
-            return room;
-    }
-
-    return nullptr;
+    return findInNameIndex(mRoomsByName, name);
 }
 
 Trap* GameMap::getTrapByName(const std::string& name)
 {
-    for (Trap* trap : mTraps)
-    {
-        if(trap->getName().compare(name) == 0)
-            return trap;
-    }
-
-    return nullptr;
+    return findInNameIndex(mTrapsByName, name);
 }
 
 void GameMap::clearTraps()
@@ -1963,6 +2135,7 @@ void GameMap::clearTraps()
     }
 
     mTraps.clear();
+    mTrapsByName.clear();
 }
 
 void GameMap::addTrap(Trap *trap)
@@ -1972,6 +2145,8 @@ void GameMap::addTrap(Trap *trap)
         + Helper::toString(nbTiles) + ", seatId=" + Helper::toString(trap->getSeat()->getId()));
 
     mTraps.push_back(trap);
+    addEntityId(trap);
+    addToNameIndex(mTrapsByName, trap);
 }
 
 void GameMap::removeTrap(Trap *t)
@@ -1985,6 +2160,8 @@ void GameMap::removeTrap(Trap *t)
     }
 
     mTraps.erase(it);
+    removeEntityId(t);
+    removeFromNameIndex(mTrapsByName, t, mTraps);
 }
 
 bool GameMap::withdrawFromTreasuries(int gold, Seat* seat)
@@ -2020,12 +2197,15 @@ void GameMap::clearMapLights()
     }
 
     mMapLights.clear();
+    mMapLightsByName.clear();
 }
 
 void GameMap::addMapLight(MapLight *m)
 {
     OD_LOG_INF(serverStr() + "Adding MapLight " + m->getName());
     mMapLights.push_back(m);
+    addEntityId(m);
+    addToNameIndex(mMapLightsByName, m);
 }
 
 void GameMap::removeMapLight(MapLight *m)
@@ -2040,17 +2220,13 @@ void GameMap::removeMapLight(MapLight *m)
     }
 
     mMapLights.erase(it);
+    removeEntityId(m);
+    removeFromNameIndex(mMapLightsByName, m, mMapLights);
 }
 
 MapLight* GameMap::getMapLight(const std::string& name) const
 {
-    for (MapLight* mapLight : mMapLights)
-    {
-        if (mapLight->getName() == name)
-            return mapLight;
-    }
-
-    return nullptr;
+    return findInNameIndex(mMapLightsByName, name);
 }
 
 void GameMap::clearSeats()
@@ -2152,72 +2328,25 @@ void GameMap::clearGoalsForAllSeats()
     mGoalsForAllSeats.clear();
 }
 
-bool GameMap::doFloodFill(Seat* seat, Tile* tile)
+void GameMap::replaceFloodFill(Seat* seat, FloodFillType floodFillType, uint32_t colorOld, uint32_t colorNew)
 {
-    if (!mFloodFillEnabled)
-        return false;
-
-    if(tile->isFloodFillFilled(seat))
-        return false;
-
-    bool hasChanged = false;
-    // If a neigboor is colored with the same colors, we color the tile
-    for(Tile* neigh : tile->getAllNeighbors())
-    {
-        // TODO: check if this can be optimized with Tile::isFloodFillPossible
-        switch(tile->getType())
-        {
-            case TileType::dirt:
-            case TileType::gold:
-            case TileType::rock:
-            {
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::ground, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWater, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundLava, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWaterLava, neigh);
-                break;
-            }
-            case TileType::water:
-            {
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWater, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWaterLava, neigh);
-                break;
-            }
-            case TileType::lava:
-            {
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundLava, neigh);
-                hasChanged |= tile->updateFloodFillFromTile(seat, FloodFillType::groundWaterLava, neigh);
-                break;
-            }
-            default:
-                continue;
-        }
-
-        // If the tile is fully filled, no need to continue
-        if(tile->isFloodFillFilled(seat))
-            return true;
-    }
-
-    return hasChanged;
+    // Instead of replacing the value of every tile colored with colorOld, we merge both regions
+    uint32_t layer = seat->getTeamIndex() * static_cast<uint32_t>(FloodFillType::nbValues) + static_cast<uint32_t>(floodFillType);
+    mFloodFillRegions.merge(layer, colorOld, colorNew);
 }
 
-void GameMap::replaceFloodFill(Seat* seat, FloodFillType floodFillType, uint32_t colorOld, uint32_t colorNew)
+uint32_t GameMap::findFloodFillRegion(Seat* seat, FloodFillType floodFillType, uint32_t color) const
 {
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            Tile* tile = getTile(ii,jj);
-            if(tile->getFloodFillValue(seat, floodFillType) != colorOld)
-                continue;
+    if(color == Tile::NO_FLOODFILL)
+        return color;
 
-            tile->replaceFloodFill(seat, floodFillType, colorNew);
-        }
-    }
+    uint32_t layer = seat->getTeamIndex() * static_cast<uint32_t>(FloodFillType::nbValues) + static_cast<uint32_t>(floodFillType);
+    return mFloodFillRegions.find(layer, color);
 }
 
 void GameMap::refreshFloodFill(Seat* seat, Tile* tile)
 {
+    OD_PROFILE_SCOPE("floodFill");
     std::vector<uint32_t> colors(static_cast<uint32_t>(FloodFillType::nbValues), Tile::NO_FLOODFILL);
 
     // If the tile has opened a new place, we use the same floodfillcolor for all the areas
@@ -2276,169 +2405,78 @@ void GameMap::refreshFloodFill(Seat* seat, Tile* tile)
 
 void GameMap::enableFloodFill()
 {
+    OD_PROFILE_SCOPE("floodFill");
     // Carry out a flood fill of the whole level to make sure everything is good.
-    // Start by setting the flood fill color for every tile on the map to -1.
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            getTile(ii,jj)->resetFloodFill();
-        }
-    }
+    // Start by setting the flood fill color for every tile on the map to NO_FLOODFILL.
+    resetFloodFillColors();
 
     // The algorithm used to find a path is efficient when the path exists but not if it doesn't.
     // To improve path finding, we tag the contiguous tiles to know if a path exists between 2 tiles or not.
     // Because creatures can go through ground, water or lava, we process all of theses.
     // Note : when a tile is digged, floodfill will have to be refreshed.
     mFloodFillEnabled = true;
+    mFloodFillRegions.clear();
 
-    // To optimize floodfilling, we start by tagging the dirt tiles with fullness = 0
-    // because they are walkable for most creatures. When we will have tagged all
-    // thoses, we will deal with water/lava remaining (there can be some left if
-    // surrounded by not passable tiles).
-    FloodFillType currentType = FloodFillType::ground;
     // We do the floodfill for the rogue seat. Then, once it is done, we copy for the other seats.
-    // If there are locked doors, floodfill will be refreshed when they are added
+    // If there are locked doors, floodfill will be refreshed when they are added.
+    // For each floodfill type, we go through the map only once: each tile takes the color of its left or
+    // upper neighbor. If both are colored differently, their regions are merged.
+    // The tile types and fullness are read from the packed tile arrays.
     Seat* rogueSeat = getSeatRogue();
-    while(true)
+    const std::vector<TileType>& tileTypes = getTileTypes();
+    const std::vector<double>& tileFullness = getTileFullness();
+    for(uint32_t i = 0; i < static_cast<uint32_t>(FloodFillType::nbValues); ++i)
     {
-        int yy = 0;
+        FloodFillType type = static_cast<FloodFillType>(i);
+        uint32_t* colors = getFloodFillColors(rogueSeat->getTeamIndex(), type);
+        if(colors == nullptr)
+        {
+            OD_LOG_ERR("No floodfill colors for rogue seat teamIndex=" + Helper::toString(rogueSeat->getTeamIndex()));
+            return;
+        }
 
-        bool isTileFound;
-        isTileFound = false;
-        while(!isTileFound && (yy < getMapSizeY()))
+        uint32_t index = 0;
+        for(int yy = 0; yy < getMapSizeY(); ++yy)
         {
-            for(int xx = 0; xx < getMapSizeX(); ++xx)
+            for(int xx = 0; xx < getMapSizeX(); ++xx, ++index)
             {
-                Tile* tile = getTile(xx, yy);
-                if(tile->getFullness() > 0.0)
+                if(!Tile::isFloodFillPossible(tileTypes[index], tileFullness[index], type))
                     continue;
 
-                if(currentType == FloodFillType::ground)
-                {
-                    if(((tile->getType() == TileType::dirt) ||
-                        (tile->getType() == TileType::gold) ||
-                        (tile->getType() == TileType::rock)) &&
-                       (tile->getFloodFillValue(rogueSeat, FloodFillType::ground) == Tile::NO_FLOODFILL))
-                    {
-                        isTileFound = true;
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::ground) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::ground, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWater) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWater, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundLava, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWaterLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWaterLava, nextUniqueFloodFillValue());
-                        break;
-                    }
-                }
-                else if(currentType == FloodFillType::groundWater)
-                {
-                    if((tile->getType() == TileType::water) &&
-                       (tile->getFloodFillValue(rogueSeat, FloodFillType::groundWater) == Tile::NO_FLOODFILL))
-                    {
-                        isTileFound = true;
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWater) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWater, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWaterLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWaterLava, nextUniqueFloodFillValue());
-                        break;
-                    }
-                }
-                else if(currentType == FloodFillType::groundLava)
+                uint32_t colorLeft = (xx > 0) ? findFloodFillRegion(rogueSeat, type, colors[index - 1]) : Tile::NO_FLOODFILL;
+                uint32_t colorUp = (yy > 0) ? findFloodFillRegion(rogueSeat, type, colors[index - getMapSizeX()]) : Tile::NO_FLOODFILL;
+                uint32_t color;
+                if((colorLeft == Tile::NO_FLOODFILL) && (colorUp == Tile::NO_FLOODFILL))
+                    color = nextUniqueFloodFillValue();
+                else if(colorLeft == Tile::NO_FLOODFILL)
+                    color = colorUp;
+                else
                 {
-                    if((tile->getType() == TileType::lava) &&
-                       (tile->getFloodFillValue(rogueSeat, FloodFillType::groundLava) == Tile::NO_FLOODFILL))
-                    {
-                        isTileFound = true;
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundLava, nextUniqueFloodFillValue());
-                        if(tile->getFloodFillValue(rogueSeat, FloodFillType::groundWaterLava) == Tile::NO_FLOODFILL)
-                            tile->replaceFloodFill(rogueSeat, FloodFillType::groundWaterLava, nextUniqueFloodFillValue());
-                        break;
-                    }
+                    color = colorLeft;
+                    if((colorUp != Tile::NO_FLOODFILL) && (colorUp != colorLeft))
+                        replaceFloodFill(rogueSeat, type, colorUp, colorLeft);
                 }
-            }
-
-            if(!isTileFound)
-                ++yy;
-        }
 
-        // If there are no more walkable tiles, we go for water. Then, for lava. After that, floodfill should be complete
-        if(!isTileFound)
-        {
-            switch(currentType)
-            {
-                case FloodFillType::ground:
-                {
-                    // There are no more ground tiles. We go for water tiles
-                    currentType = FloodFillType::groundWater;
-                    isTileFound = true;
-                    break;
-                }
-                case FloodFillType::groundWater:
-                {
-                    // There are no more ground tiles. We go for water tiles
-                    currentType = FloodFillType::groundLava;
-                    isTileFound = true;
-                    break;
-                }
-                case FloodFillType::groundLava:
-                {
-                    // There are no more tiles. We can stop
-                    break;
-                }
-                default:
-                    OD_LOG_ERR("Unexpected enum value=" + Tile::toString(currentType));
-                    break;
+                colors[index] = color;
             }
         }
+    }
 
-        if(!isTileFound)
-            break;
-
-        while(yy < getMapSizeY())
-        {
-            int nbTiles = 0;
-            for(int xx = 0; xx < getMapSizeX(); ++xx)
-            {
-                Tile* tile = getTile(xx, yy);
-                if(doFloodFill(rogueSeat, tile))
-                    ++nbTiles;
-            }
-
-            // For optimization purposes, if a tile has changed, we go on the other side
-            if(nbTiles > 0)
-            {
-                for(int xx = getMapSizeX() - 1; xx >= 0; --xx)
-                {
-                    Tile* tile = getTile(xx, yy);
-                    if(doFloodFill(rogueSeat, tile))
-                        ++nbTiles;
-                }
-            }
-
-            // If at least one tile as been changed, we go back to the previous line
-            if((nbTiles > 0) && (yy > 0))
-                --yy;
-            else
-                ++yy;
-        }
+    // We set the final region on every tile so that the merged values can be forgotten
+    uint32_t nbTiles = getTiles().size();
+    for(uint32_t i = 0; i < static_cast<uint32_t>(FloodFillType::nbValues); ++i)
+    {
+        FloodFillType type = static_cast<FloodFillType>(i);
+        uint32_t* colors = getFloodFillColors(rogueSeat->getTeamIndex(), type);
+        for(uint32_t index = 0; index < nbTiles; ++index)
+            colors[index] = findFloodFillRegion(rogueSeat, type, colors[index]);
     }
+    mFloodFillRegions.clear();
 
     // We copy floodfill for all seats
-    for(int xx = 0; xx < getMapSizeX(); ++xx)
-    {
-        for(int yy = 0; yy < getMapSizeY(); ++yy)
-        {
-            Tile* tile = getTile(xx, yy);
-            if(tile == nullptr)
-                continue;
+    copyFloodFillColorsToOtherTeams(rogueSeat->getTeamIndex());
 
-            tile->copyFloodFillToOtherSeats(rogueSeat);
-        }
-    }
+    mPathfindingCache.invalidateAll();
 }
 
 std::list<Tile*> GameMap::path(Creature *c1, Creature *c2, const Creature* creature, Seat* seat, bool throughDiggableTiles)
@@ -2668,43 +2706,102 @@ std::string GameMap::nextUniqueNameMapLight()
     return ret;
 }
 
-GameEntity* GameMap::getEntityFromTypeAndName(GameEntityType entityType,
-    const std::string& entityName)
+void GameMap::floodFillChanged(Tile* tile)
+{
+    mPathfindingCache.invalidateTile(tile->getX(), tile->getY());
+}
+
+std::string GameMap::getPathfindingCacheStats(bool reset)
+{
+    std::string stats = mPathfindingCache.getStatsString();
+    if(reset)
+        mPathfindingCache.resetStats();
+
+    return stats;
+}
+
+void GameMap::tileClaimChanged(Tile* tile)
+{
+    if(!isServerGameMap())
+        return;
+
+    // The claim is changed many times while a tile is claimed. We only need to add it once
+    if(mTilesClaimChangedFlags.size() != getTiles().size())
+        mTilesClaimChangedFlags.assign(getTiles().size(), 0);
+
+    uint8_t& flag = mTilesClaimChangedFlags[getTileIndex(tile->getX(), tile->getY())];
+    if(flag != 0)
+        return;
+
+    flag = 1;
+    mTilesClaimChanged.push_back(tile);
+}
+
+void GameMap::tilePermitsVisionChanged(Tile* tile)
 {
-    switch(entityType)
+    tileOpacityChanged(tile);
+
+    if(!isServerGameMap())
+        return;
+
+    int nbBlocksX = getNbVisionChangeBlocksX();
+    if(mTilesPermitsVisionChangedFlags.size() != getTiles().size())
     {
-        case GameEntityType::creature:
-            return getCreature(entityName);
+        int nbBlocksY = (getMapSizeY() + VISION_CHANGE_BLOCK_SIZE - 1) / VISION_CHANGE_BLOCK_SIZE;
+        mTilesPermitsVisionChangedFlags.assign(getTiles().size(), 0);
+        mBlocksPermitsVisionChangedFlags.assign(static_cast<uint32_t>(nbBlocksX * nbBlocksY), 0);
+    }
 
-        case GameEntityType::buildingObject:
-        case GameEntityType::chickenEntity:
-        case GameEntityType::craftedTrap:
-        case GameEntityType::missileObject:
-        case GameEntityType::persistentObject:
-        case GameEntityType::smallSpiderEntity:
-        case GameEntityType::trapEntity:
-        case GameEntityType::treasuryObject:
-        case GameEntityType::skillEntity:
-        case GameEntityType::giftBoxEntity:
-            return getRenderedMovableEntity(entityName);
+    uint8_t& flag = mTilesPermitsVisionChangedFlags[getTileIndex(tile->getX(), tile->getY())];
+    if(flag != 0)
+        return;
 
-        case GameEntityType::spell:
-            return getSpell(entityName);
+    flag = 1;
+    int blockIndex = (tile->getY() / VISION_CHANGE_BLOCK_SIZE) * nbBlocksX + tile->getX() / VISION_CHANGE_BLOCK_SIZE;
+    mBlocksPermitsVisionChangedFlags[blockIndex] = 1;
+    mTilesPermitsVisionChanged.push_back(tile);
+}
 
-        case GameEntityType::mapLight:
-            return getMapLight(entityName);
+bool GameMap::isPermitsVisionChangedAround(int x, int y, int radius) const
+{
+    if(mTilesPermitsVisionChanged.empty())
+        return false;
 
-        case GameEntityType::room:
-            return getRoomByName(entityName);
+    // We only look at the tiles of the blocks that changed within the square around (x, y)
+    int minX = std::max(0, x - radius);
+    int maxX = std::min(getMapSizeX() - 1, x + radius);
+    int minY = std::max(0, y - radius);
+    int maxY = std::min(getMapSizeY() - 1, y + radius);
+    int radiusSquared = radius * radius;
+    int nbBlocksX = getNbVisionChangeBlocksX();
+    for(int blockY = minY / VISION_CHANGE_BLOCK_SIZE; blockY <= maxY / VISION_CHANGE_BLOCK_SIZE; ++blockY)
+    {
+        for(int blockX = minX / VISION_CHANGE_BLOCK_SIZE; blockX <= maxX / VISION_CHANGE_BLOCK_SIZE; ++blockX)
+        {
+            if(mBlocksPermitsVisionChangedFlags[blockY * nbBlocksX + blockX] == 0)
+                continue;
 
-        case GameEntityType::trap:
-            return getTrapByName(entityName);
+            int blockMinY = std::max(minY, blockY * VISION_CHANGE_BLOCK_SIZE);
+            int blockMaxY = std::min(maxY, (blockY + 1) * VISION_CHANGE_BLOCK_SIZE - 1);
+            int blockMinX = std::max(minX, blockX * VISION_CHANGE_BLOCK_SIZE);
+            int blockMaxX = std::min(maxX, (blockX + 1) * VISION_CHANGE_BLOCK_SIZE - 1);
+            for(int yy = blockMinY; yy <= blockMaxY; ++yy)
+            {
+                for(int xx = blockMinX; xx <= blockMaxX; ++xx)
+                {
+                    if(mTilesPermitsVisionChangedFlags[getTileIndex(xx, yy)] == 0)
+                        continue;
 
-        default:
-            break;
+                    int diffX = xx - x;
+                    int diffY = yy - y;
+                    if(diffX * diffX + diffY * diffY <= radiusSquared)
+                        return true;
+                }
+            }
+        }
     }
 
-    return nullptr;
+    return false;
 }
 
 void GameMap::logFloodFileTiles()
@@ -2768,6 +2865,7 @@ void GameMap::consoleSetLevelCreature(const std::string& creatureName, uint32_t
 void GameMap::consoleAskToggleFOW()
 {
     mIsFOWActivated = !mIsFOWActivated;
+    mIsVisionFullRefreshNeeded = true;
 }
 
 void GameMap::consoleAskUnlockSkills()
@@ -2804,21 +2902,20 @@ Creature* GameMap::getWorkerForPathFinding(Seat* seat)
 void GameMap::updateVisibleEntities()
 {
     // Notify what happened to entities on visible tiles
-    for (int jj = 0; jj < getMapSizeY(); ++jj)
-    {
-        for (int ii = 0; ii < getMapSizeX(); ++ii)
-        {
-            Tile* tile = getTile(ii,jj);
-            tile->notifyEntitiesSeatsWithVision();
-        }
-    }
+    for (Tile* tile : getTiles())
+        tile->notifyEntitiesSeatsWithVision();
 }
 
 void GameMap::fireRefreshEntities()
 {
-    // Notify changes on visible tiles
+    // Notify changes on visible tiles. The tiles stay changed for the seats whose client is late
     for(Seat* seat : mSeats)
+    {
+        if(ODServer::getSingleton().isPlayerCatchingUp(seat->getPlayer()))
+            continue;
+
         seat->notifyChangedVisibleTiles();
+    }
 
     for(Creature* creature : mCreatures)
     {
@@ -2831,6 +2928,8 @@ void GameMap::addSpell(Spell *spell)
     OD_LOG_INF(serverStr() + "Adding spell " + spell->getName()
         + ",MeshName=" + spell->getMeshName());
     mSpells.push_back(spell);
+    addEntityId(spell);
+    addToNameIndex(mSpellsByName, spell);
 }
 
 void GameMap::removeSpell(Spell *spell)
@@ -2845,16 +2944,14 @@ void GameMap::removeSpell(Spell *spell)
     }
 
     mSpells.erase(it);
+    removeEntityId(spell);
+    removeFromNameIndex(mSpellsByName, spell, mSpells);
+    spell->removeVisionGiven();
 }
 
 Spell* GameMap::getSpell(const std::string& name) const
 {
-    for(Spell* spell : mSpells)
-    {
-        if(name.compare(spell->getName()) == 0)
-            return spell;
-    }
-    return nullptr;
+    return findInNameIndex(mSpellsByName, name);
 }
 
 void GameMap::clearSpells()
@@ -2868,6 +2965,7 @@ void GameMap::clearSpells()
     }
 
     mSpells.clear();
+    mSpellsByName.clear();
 }
 
 std::vector<Spell*> GameMap::getSpellsBySeatAndType(Seat* seat, SpellType type) const
@@ -3058,6 +3156,11 @@ void GameMap::clientUpKeep(int64_t turnNumber)
 
 void GameMap::doorLock(Tile* tileDoor, Seat* seat, bool locked)
 {
+    // The connections around the door will change
+    mPathfindingCache.invalidateTile(tileDoor->getX(), tileDoor->getY());
+    // A locked door blocks vision
+    tilePermitsVisionChanged(tileDoor);
+
     if(!locked)
     {
         // When a door is unlocked, we check all its neighboors to find a floodfill value for each possible
@@ -3104,8 +3207,9 @@ void GameMap::doorLock(Tile* tileDoor, Seat* seat, bool locked)
             continue;
         }
 
-        std::vector<Creature*> alliedCreatures = getCreaturesBySeat(seat);
-        for(Creature* creature : alliedCreatures)
+        ScratchVector<Creature*> alliedCreatures;
+        getCreaturesBySeat(seat, *alliedCreatures);
+        for(Creature* creature : *alliedCreatures)
         {
             if(!pathExists(creature, tileDoor, creature->getPositionTile()))
                 continue;
@@ -3160,7 +3264,30 @@ void GameMap::doorLock(Tile* tileDoor, Seat* seat, bool locked)
 void GameMap::changeFloodFillConnectedTiles(Tile* startTile, Seat* seat, const std::vector<uint32_t>& oldColors,
     const std::vector<uint32_t>& newColors, Tile* tileIgnored)
 {
+    OD_PROFILE_SCOPE("floodFill");
     std::vector<Tile*> tiles;
+    // We replace the floodfill colors of the tiles when they are added to the list. That way, a tile
+    // that has already been added will not match oldColors anymore and will not be added again
+    auto replaceColors = [seat, &oldColors, &newColors](Tile* tile)
+    {
+        bool isReplaced = false;
+        for(uint32_t i = 0; i < newColors.size(); ++i)
+        {
+            if(newColors[i] == Tile::NO_FLOODFILL)
+                continue;
+
+            FloodFillType type = static_cast<FloodFillType>(i);
+            uint32_t color = tile->getFloodFillValue(seat, type);
+            if((color == Tile::NO_FLOODFILL) || (color != oldColors[i]))
+                continue;
+
+            tile->replaceFloodFill(seat, type, newColors[i]);
+            isReplaced = true;
+        }
+        return isReplaced;
+    };
+
+    replaceColors(startTile);
     tiles.push_back(startTile);
     while(!tiles.empty())
     {
@@ -3174,34 +3301,8 @@ void GameMap::changeFloodFillConnectedTiles(Tile* startTile, Seat* seat, const s
             if(neigh == tileIgnored)
                 continue;
 
-            for(uint32_t i = 0; i < newColors.size(); ++i)
-            {
-                if(newColors[i] == Tile::NO_FLOODFILL)
-                    continue;
-
-                FloodFillType type = static_cast<FloodFillType>(i);
-                uint32_t neighColor = neigh->getFloodFillValue(seat, type);
-                if(neighColor == Tile::NO_FLOODFILL)
-                    continue;
-
-                if((neighColor == oldColors[i]) &&
-                   (std::find(tiles.begin(), tiles.end(), tile) == tiles.end()))
-                {
-                    tiles.push_back(neigh);
-                    break;
-                }
-            }
-        }
-
-        // We replace floodillcolor for the current tile
-        for(uint32_t i = 0; i < newColors.size(); ++i)
-        {
-            FloodFillType type = static_cast<FloodFillType>(i);
-            if(newColors[i] == Tile::NO_FLOODFILL)
-                continue;
-
-            if(tile->getFloodFillValue(seat, type) == oldColors[i])
-                tile->replaceFloodFill(seat, type, newColors[i]);
+            if(replaceColors(neigh))
+                tiles.push_back(neigh);
         }
     }
 }
@@ -3233,18 +3334,7 @@ void GameMap::notifySeatsConfigured()
         seat->setTeamIndex(teamIndex);
     }
 
-    uint32_t nbTeams = mTeamIds.size();
-    for(int xxx = 0; xxx < getMapSizeX(); ++xxx)
-    {
-        for(int yyy = 0; yyy < getMapSizeY(); ++yyy)
-        {
-            Tile* tile = getTile(xxx, yyy);
-            if(tile == nullptr)
-                continue;
-
-            tile->setTeamsNumber(nbTeams);
-        }
-    }
+    setFloodFillTeamsNumber(mTeamIds.size());
     // Now that team ids are set and tiles are configured, we can compute floodfill
     enableFloodFill();
 }
@@ -18,6 +18,10 @@
 #ifndef GAMEMAP_H
 #define GAMEMAP_H
 
+#include "gamemap/CreatureSpatialIndex.h"
+#include "gamemap/FloodFillRegions.h"
+#include "gamemap/PathfindingCache.h"
+#include "gamemap/PathfindingEngine.h"
 #include "gamemap/TileContainer.h"
 
 #include "ai/AIManager.h"
@@ -32,6 +36,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include <OgreVector3.h>
 
@@ -45,6 +50,7 @@ class Seat;
 class Goal;
 class MapLight;
 class MovableGameEntity;
+class ThreadPool;
 class CreatureDefinition;
 class Weapon;
 class CreatureMood;
@@ -154,6 +160,9 @@ public:
     //! nullptr if it is not found
     Creature* getCreature(const std::string& cName) const;
 
+    //! \brief Returns a pointer to the creature with the given id or nullptr if it is not found
+    Creature* getCreatureById(uint32_t id) const;
+
     inline bool getIsFOWActivated() const
     { return mIsFOWActivated; }
 
@@ -161,6 +170,9 @@ public:
     std::vector<Creature*> getCreaturesByAlliedSeat(const Seat* seat) const;
     std::vector<Creature*> getCreaturesBySeat(const Seat* seat) const;
 
+    //! \brief Same as above but fills the given vector (that is cleared first)
+    void getCreaturesBySeat(const Seat* seat, std::vector<Creature*>& creatures) const;
+
     inline const std::vector<Creature*>& getCreatures() const
     { return mCreatures; }
 
@@ -170,7 +182,7 @@ public:
     //! \brief Animated objects related functions.
     void addAnimatedObject(MovableGameEntity *a);
     void removeAnimatedObject(MovableGameEntity *a);
-    MovableGameEntity* getAnimatedObject(const std::string& name) const;
+    MovableGameEntity* getAnimatedObject(uint32_t id) const;
 
     void addClientUpkeepEntity(GameEntity* entity);
     void removeClientUpkeepEntity(GameEntity* entity);
@@ -229,12 +241,17 @@ public:
     std::vector<Room*> getRoomsByType(RoomType type) const;
     std::vector<Room*> getRoomsByTypeAndSeat(RoomType type,
                         const Seat* seat);
+    //! \brief Same as above but fills the given vector (that is cleared first)
+    void getRoomsByTypeAndSeat(RoomType type, const Seat* seat, std::vector<Room*>& rooms);
     std::vector<const Room*> getRoomsByTypeAndSeat(RoomType type,
                           const Seat* seat) const;
     unsigned int numRoomsByTypeAndSeat(RoomType type,
                       const Seat* seat) const;
     std::vector<Room*> getReachableRooms(const std::vector<Room*> &vec,
                        Tile *startTile, const Creature* creature);
+    //! \brief Same as above but fills reachableRooms (that is cleared first). It should not be vec
+    void getReachableRooms(const std::vector<Room*>& vec, Tile* startTile, const Creature* creature,
+                       std::vector<Room*>& reachableRooms);
     std::vector<Building*> getReachableBuildingsPerSeat(Seat* seat,
         Tile *startTile, const Creature* creature);
     Room* getRoomByName(const std::string& name);
@@ -343,19 +360,50 @@ public:
 
     void doPlayerAITurn(double timeSinceLastTurn);
 
+    //! \brief Time spent (in microseconds) in the phases of a turn computed by doTurn and doPlayerAITurn
+    struct TurnPhaseTimes
+    {
+        //! \brief Vision computation and visible tiles sending
+        uint64_t mVision = 0;
+        //! \brief Creatures sensing, done in parallel before the upkeep
+        uint64_t mSensing = 0;
+        //! \brief Upkeep of the active objects (creatures, rooms, traps, ...)
+        uint64_t mEntitiesUpkeep = 0;
+        //! \brief Seats upkeep (gold, mana, claimed tiles)
+        uint64_t mSeatsUpkeep = 0;
+        //! \brief Keeper AIs
+        uint64_t mAI = 0;
+        //! \brief Calls to path during the turn
+        uint32_t mNbPathCalls = 0;
+        //! \brief Memory allocations done by doTurn (only counted if built with OD_COUNT_ALLOCATIONS)
+        uint64_t mNbAllocations = 0;
+    };
+
+    inline const TurnPhaseTimes& getLastTurnPhaseTimes() const
+    { return mLastTurnPhaseTimes; }
+
+    //! \brief Number of threads computing the creatures sensing. 0 until the first turn is computed
+    uint32_t getNbSensingThreads() const;
+
     //! \brief Tells whether a path exists between two tiles for the given creature.
     bool pathExists(const Creature* creature, Tile* tileStart, Tile* tileEnd);
 
     /*! \brief Calculates the walkable path between tileStart and one of the possibleDests. This function
-     * will choose the closest tile in possibleDests and return the path between tileStart and it.
+     * will choose the nearest tile (by walking cost) in possibleDests and return the path between tileStart and it.
      * If a path is found, it is returned and chosenTile is set to the chosen tile. If no path is found,
      * an empty list will be returned and chosenTile will be set to nullptr
-     * Note that this function will use some magic numbers to avoid computing paths that are likely to be
-     * further
+     * Note that only one search is done whatever the number of possibleDests (see findNearestReachableTiles)
      */
-    std::list<Tile*> findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*> possibleDests,
+    std::list<Tile*> findBestPath(const Creature* creature, Tile* tileStart, const std::vector<Tile*>& possibleDests,
         Tile*& chosenTile);
 
+    /*! \brief Searches the tiles in possibleDests that are the nearest from tileStart by walking cost for the given creature.
+     * The search expands once from tileStart and stops as soon as maxTiles tiles have been reached. nearestTiles is filled
+     * with the reached tiles sorted from the nearest. Returns the number of found tiles.
+     */
+    uint32_t findNearestReachableTiles(const Creature* creature, Tile* tileStart, const std::vector<Tile*>& possibleDests,
+        uint32_t maxTiles, std::vector<Tile*>& nearestTiles);
+
     /*! \brief Calculates the walkable path between tiles (x1, y1) and (x2, y2).
      *
      * The search is carried out using the A-star search algorithm.
@@ -378,20 +426,39 @@ public:
     //! (or if enemyForce is true, is not allied)
     std::vector<GameEntity*> getVisibleForce(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyForce);
 
+    //! \brief Fills entities (that is cleared first) with any creature/room/trap the viewer can see allied with the
+    //! given seat (or if enemyForce is true, not allied). The creatures are searched with the spatial index and the
+    //! viewer visible tiles bitset. Does not modify the game map so it can be called in parallel
+    void getVisibleForce(const Creature& viewer, Seat* seat, bool enemyForce, std::vector<GameEntity*>& entities);
+
     //! \brief Loops over the visibleTiles and returns any creature in those tiles allied with the given seat.
     //! (or if enemyCreatures is true, is not allied)
     std::vector<GameEntity*> getVisibleCreatures(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyCreatures);
 
+    //! \brief Same as above but fills the given vector (that is cleared first)
+    void getVisibleCreatures(const std::vector<Tile*>& visibleTiles, Seat* seat, bool enemyCreatures,
+        std::vector<GameEntity*>& creatures);
+
+    //! \brief Fills creatures (that is cleared first) with any creature the viewer can see allied with the given
+    //! seat (or if enemyCreatures is true, not allied). See getVisibleForce
+    void getVisibleCreatures(const Creature& viewer, Seat* seat, bool enemyCreatures, std::vector<GameEntity*>& creatures);
+
     //! \brief Loops over the given tiles and returns any carryable entity in those tiles
     std::vector<GameEntity*> getCarryableEntities(Creature* carrier, const std::vector<Tile*>& tiles);
 
-    //! \brief Checks the neighboor tiles to see if the floodfill can be used. Floodfill consists on tagging all contiguous tiles
-    //! to be able to know before computing it if a path exists between 2 tiles. We do that to avoid computing paths when we
-    //! already know that no path exists.
-    bool doFloodFill(Seat* seat, Tile* tile);
+    //! \brief Floodfill consists on tagging all contiguous tiles to be able to know before computing it if a path exists
+    //! between 2 tiles. We do that to avoid computing paths when we already know that no path exists.
+    //! refreshFloodFill updates the floodfill around the given tile after it has been dug
     void refreshFloodFill(Seat* seat, Tile* tile);
+
+    //! \brief Merges the regions colored with colorOld and colorNew for the given seat team. Every tile colored with
+    //! one of them will then be considered in the same region. The tiles are not modified
     void replaceFloodFill(Seat* seat, FloodFillType floodFillType, uint32_t colorOld, uint32_t colorNew);
 
+    //! \brief Returns the region the given floodfill color belongs to for the given seat team. Used by Tile::getFloodFillValue.
+    //! It does not modify the regions so it can be called in parallel (while no region is merged)
+    uint32_t findFloodFillRegion(Seat* seat, FloodFillType floodFillType, uint32_t color) const;
+
     //! \brief Temporarily disables the flood fill computations on this game map.
     void disableFloodFill()
     { mFloodFillEnabled = false; }
@@ -448,6 +515,28 @@ public:
 
     uint32_t getMaxNumberCreatures(Seat* seat) const;
 
+    //! \brief Called when the floodfill changes around the given tile (the tile becomes walkable or not for
+    //! some floodfill type). Used to refresh the pathfinding cache
+    void floodFillChanged(Tile* tile);
+
+    //! \brief Returns the pathfinding cache statistics. If reset is true, they are reset
+    std::string getPathfindingCacheStats(bool reset);
+
+    inline CreatureSpatialIndex& getCreatureSpatialIndex()
+    { return mCreatureSpatialIndex; }
+
+    //! \brief Called when the claim of the given tile changes. The vision given by the tile will be
+    //! computed again during the next upkeep
+    void tileClaimChanged(Tile* tile);
+
+    //! \brief Called when the given tile may have started or stopped blocking vision (dug wall, door
+    //! locked, ...). The creatures seeing around will compute their vision again during the next upkeep
+    void tilePermitsVisionChanged(Tile* tile);
+
+    //! \brief Returns true if a tile within the given radius around (x, y) started or stopped blocking
+    //! vision since the last vision update
+    bool isPermitsVisionChangedAround(int x, int y, int radius) const;
+
     void logFloodFileTiles();
     void consoleSetCreatureDestination(const std::string& creatureName, int x, int y);
     void consoleToggleCreatureVisualDebug(const std::string& creatureName);
@@ -470,9 +559,12 @@ public:
     void addRenderedMovableEntity(RenderedMovableEntity *obj);
     void removeRenderedMovableEntity(RenderedMovableEntity *obj);
     RenderedMovableEntity* getRenderedMovableEntity(const std::string& name);
+    RenderedMovableEntity* getRenderedMovableEntityById(uint32_t id) const;
     void clearRenderedMovableEntities();
-    GameEntity* getEntityFromTypeAndName(GameEntityType entityType,
-        const std::string& entityName);
+
+    //! \brief Returns the entity on map with the given id (see GameEntity::getId) or nullptr if there is none.
+    //! Used to find the entities referenced in the messages between the server and the clients
+    GameEntity* getEntityById(uint32_t id) const;
 
     //! brief Functions to add/remove/get Spells
     inline const std::vector<Spell*>& getSpells() const
@@ -562,6 +654,25 @@ private:
     int mUniqueNumberMapLight;
     uint32_t mUniqueFloodFillValue;
 
+    //! \brief Last id given to an entity added on the server gamemap
+    uint32_t mUniqueEntityId;
+
+    //! \brief Entities on map by id. On client side, only the entities sent by the server have an id
+    std::unordered_map<uint32_t, GameEntity*> mEntitiesById;
+    std::unordered_map<uint32_t, MovableGameEntity*> mAnimatedObjectsById;
+
+    //! \brief Entities on map by name. If several entities have the same name, the first added is indexed.
+    //! When it is removed, the next one is
+    std::unordered_map<std::string, Creature*> mCreaturesByName;
+    std::unordered_map<std::string, Room*> mRoomsByName;
+    std::unordered_map<std::string, Trap*> mTrapsByName;
+    std::unordered_map<std::string, MapLight*> mMapLightsByName;
+    std::unordered_map<std::string, RenderedMovableEntity*> mRenderedMovableEntitiesByName;
+    std::unordered_map<std::string, Spell*> mSpellsByName;
+
+    //! \brief Floodfill colors that have been merged (see replaceFloodFill)
+    FloodFillRegions mFloodFillRegions;
+
     //! \brief When paused, the GameMap is not updated.
     bool mIsPaused;
 
@@ -610,6 +721,29 @@ private:
     //! When true, fog of war will work normally. When false, every connected client will see the whole map
     bool mIsFOWActivated;
 
+    //! \brief When true, the vision will be computed from scratch for the whole map during the next upkeep
+    //! (new map, FOW toggled). Otherwise, only the vision sources that changed are computed again
+    bool mIsVisionFullRefreshNeeded;
+
+    //! \brief Tiles whose claim changed since the last vision update (see tileClaimChanged). Each tile is
+    //! only added once: mTilesClaimChangedFlags tells (same index as getTiles) if it is already there
+    std::vector<Tile*> mTilesClaimChanged;
+    std::vector<uint8_t> mTilesClaimChangedFlags;
+
+    //! \brief Size of the square blocks of tiles used by isPermitsVisionChangedAround
+    static const int VISION_CHANGE_BLOCK_SIZE = 8;
+
+    //! \brief Tiles that started or stopped blocking vision since the last vision update. The flags tell
+    //! for each tile (same index as getTiles) and for each block of VISION_CHANGE_BLOCK_SIZE tiles
+    //! wide if it changed. They are cleared at the end of the vision update
+    std::vector<Tile*> mTilesPermitsVisionChanged;
+    std::vector<uint8_t> mTilesPermitsVisionChangedFlags;
+    std::vector<uint8_t> mBlocksPermitsVisionChangedFlags;
+
+    //! \brief Number of blocks of VISION_CHANGE_BLOCK_SIZE tiles on a row of the map
+    inline int getNbVisionChangeBlocksX() const
+    { return (getMapSizeX() + VISION_CHANGE_BLOCK_SIZE - 1) / VISION_CHANGE_BLOCK_SIZE; }
+
     std::vector<GameEntity*> mActiveObjects;
 
     //! \brief Useless entities that need to be deleted. They will be deleted when processDeletionQueues is called
@@ -618,6 +752,31 @@ private:
     //! \brief Debug member used to know how many call to pathfinding has been made within the same turn.
     unsigned int mNumCallsTo_path;
 
+    //! \brief Threads used to compute the creatures sensing. Created on the first server turn
+    std::unique_ptr<ThreadPool> mSensingThreadPool;
+
+    //! \brief Phases times of the last computed turn
+    TurnPhaseTimes mLastTurnPhaseTimes;
+
+    //! \brief A* engine used by path. It is kept between calls to avoid allocating memory for each search
+    PathfindingEngine mPathfindingEngine;
+
+    //! \brief Buffer filled by mPathfindingEngine with the tiles of the last computed path
+    std::vector<uint32_t> mPathBuffer;
+
+    //! \brief Hierarchical graph used to speed up long paths computing
+    PathfindingCache mPathfindingCache;
+
+    //! \brief Creatures on map by area. Updated by Tile when creatures are added/removed
+    CreatureSpatialIndex mCreatureSpatialIndex;
+
+    //! \brief Buffer filled by mPathfindingCache with the waypoints of the last computed path
+    std::vector<Tile*> mPathWaypoints;
+
+    //! \brief Buffers used by findNearestReachableTiles and findBestPath
+    std::vector<uint32_t> mPathTargets;
+    std::vector<Tile*> mNearestTiles;
+
     std::vector<RenderedMovableEntity*> mRenderedMovableEntities;
 
     std::vector<Spell*> mSpells;
@@ -635,8 +794,17 @@ private:
     //! Updates active objects (creatures, rooms, ...), goals, count each team Workers, gold, mana and claimed tiles.
     unsigned long int doMiscUpkeep(double timeSinceLastTurn);
 
+    //! \brief Updates the tiles each seat has vision on. Only the vision sources (claimed tiles, creatures, spells)
+    //! that changed since the last call are computed again
+    void updateVision();
+
     //! \brief Resets the unique numbers
     void resetUniqueNumbers();
+
+    //! \brief Adds/removes the given entity to the id index. On server side, an id is given to the entity
+    //! the first time it is added
+    void addEntityId(GameEntity* entity);
+    void removeEntityId(GameEntity* entity);
 };
 
 #endif // GAMEMAP_H
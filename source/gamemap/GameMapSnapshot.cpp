@@ -0,0 +1,83 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/GameMapSnapshot.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+bool GameMapSnapshot::writeToFile(const std::string& fileName, bool makeBackup, std::string& error) const
+{
+    const std::string tmpFileName = fileName + ".tmp";
+    {
+        std::ofstream levelFile(tmpFileName.c_str(), std::ofstream::out);
+        if (!levelFile.good())
+        {
+            error = "Couldn't open file for writing: " + tmpFileName;
+            return false;
+        }
+
+        levelFile << mHeader;
+
+        levelFile << "\n[Tiles]\n";
+        levelFile << "# Map Size" << std::endl;
+        levelFile << mMapSizeX << " # MapSizeX" << std::endl;
+        levelFile << mMapSizeY << " # MapSizeY" << std::endl;
+        // Same format as Tile::exportToStream
+        levelFile << "# posX\tposY\ttype\tfullness\tseatId(optional)\n";
+        for(const BinaryLevel::TileRecord& tile : mTiles)
+        {
+            levelFile << tile.mX << "\t" << tile.mY << "\t" << tile.mType << "\t" << tile.mFullness;
+            if(tile.mHasSeat != 0)
+                levelFile << "\t" << tile.mSeatId;
+
+            levelFile << "\n";
+        }
+        levelFile << "[/Tiles]" << std::endl;
+
+        levelFile << mEntities;
+        levelFile.close();
+        if(levelFile.fail())
+        {
+            error = "Couldn't write file: " + tmpFileName;
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    if(makeBackup && boost::filesystem::exists(fileName, ec))
+    {
+        boost::filesystem::rename(fileName, fileName + ".bak", ec);
+        if(ec)
+        {
+            error = "Couldn't backup file " + fileName + ": " + ec.message();
+            return false;
+        }
+    }
+
+    // The renaming replaces the previous file at once so that a crash while saving does not
+    // leave a truncated level
+    boost::filesystem::rename(tmpFileName, fileName, ec);
+    if(ec)
+    {
+        error = "Couldn't rename " + tmpFileName + " to " + fileName + ": " + ec.message();
+        return false;
+    }
+
+    return true;
+}
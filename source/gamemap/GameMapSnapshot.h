@@ -0,0 +1,58 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GAMEMAPSNAPSHOT_H
+#define GAMEMAPSNAPSHOT_H
+
+#include "gamemap/BinaryLevel.h"
+
+#include <string>
+#include <vector>
+
+/*! \brief Copy of what is written in a level file, taken at a turn boundary.
+ *
+ * Taking the snapshot is done by the server thread (see MapHandler::takeGameMapSnapshot).
+ * The tiles, that are most of a level file, are only copied as fixed size records and
+ * formatted when the snapshot is written. As the snapshot does not reference the GameMap,
+ * it can be written by another thread while the game goes on.
+ */
+struct GameMapSnapshot
+{
+    GameMapSnapshot() :
+        mMapSizeX(0),
+        mMapSizeY(0)
+    {}
+
+    //! \brief Version, info, seats and goals sections
+    std::string mHeader;
+
+    int mMapSizeX;
+    int mMapSizeY;
+
+    //! \brief Saved tiles. Standard dirt tiles are not saved as they are filled at load time
+    std::vector<BinaryLevel::TileRecord> mTiles;
+
+    //! \brief Rooms and every section after them
+    std::string mEntities;
+
+    //! \brief Writes the level file. It is written in a temporary file first that replaces
+    //! fileName once complete. If makeBackup is true and fileName exists, it is renamed with
+    //! the .bak extension. Returns false and sets error if the file could not be written.
+    bool writeToFile(const std::string& fileName, bool makeBackup, std::string& error) const;
+};
+
+#endif // GAMEMAPSNAPSHOT_H
@@ -0,0 +1,299 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/LevelInfoIndex.h"
+
+#include "utils/LogManager.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+
+template<> LevelInfoIndex* Ogre::Singleton<LevelInfoIndex>::msSingleton = nullptr;
+
+const std::string LevelInfoIndex::INDEX_FILENAME = "levelinfo.index";
+
+//! \brief Changed when the index file format or the LevelInfo content changes
+static const std::string INDEX_HEADER = "ODLevelInfoIndex\t1";
+
+//! \brief The fields of an entry are separated by tabs and an entry is on one line
+static std::string escapeField(const std::string& field)
+{
+    std::string escaped;
+    escaped.reserve(field.size());
+    for(char c : field)
+    {
+        switch(c)
+        {
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            default:
+                escaped += c;
+                break;
+        }
+    }
+    return escaped;
+}
+
+static std::string unescapeField(const std::string& field)
+{
+    std::string unescaped;
+    unescaped.reserve(field.size());
+    for(uint32_t i = 0; i < field.size(); ++i)
+    {
+        if((field[i] != '\\') || (i + 1 >= field.size()))
+        {
+            unescaped += field[i];
+            continue;
+        }
+
+        ++i;
+        switch(field[i])
+        {
+            case 't':
+                unescaped += '\t';
+                break;
+            case 'n':
+                unescaped += '\n';
+                break;
+            case 'r':
+                unescaped += '\r';
+                break;
+            default:
+                unescaped += field[i];
+                break;
+        }
+    }
+    return unescaped;
+}
+
+LevelInfoIndex::LevelInfoIndex(const std::string& indexFileName, const ReadLevelInfo& readLevelInfo) :
+    mIndexFileName(indexFileName),
+    mReadLevelInfo(readLevelInfo),
+    mIsDirty(false),
+    mStopRefresh(false),
+    mNbLevelsRead(0)
+{
+    load();
+}
+
+LevelInfoIndex::~LevelInfoIndex()
+{
+    mStopRefresh = true;
+    if(mRefreshThread.joinable())
+        mRefreshThread.join();
+
+    save();
+}
+
+bool LevelInfoIndex::getLevelInfo(const std::string& fileName, LevelInfo& levelInfo)
+{
+    boost::system::error_code ec;
+    uint64_t fileSize = static_cast<uint64_t>(boost::filesystem::file_size(fileName, ec));
+    if(ec)
+        return false;
+
+    std::time_t modificationTime = boost::filesystem::last_write_time(fileName, ec);
+    if(ec)
+        return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mEntries.find(fileName);
+        if((it != mEntries.end()) &&
+           (it->second.mFileSize == fileSize) &&
+           (it->second.mModificationTime == modificationTime))
+        {
+            if(!it->second.mIsValid)
+                return false;
+
+            levelInfo = it->second.mLevelInfo;
+            return true;
+        }
+    }
+
+    // The level is read without holding the lock so that other levels can be read at the same time
+    Entry entry;
+    entry.mFileSize = fileSize;
+    entry.mModificationTime = modificationTime;
+    entry.mIsValid = mReadLevelInfo(fileName, entry.mLevelInfo);
+    ++mNbLevelsRead;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries[fileName] = entry;
+        mIsDirty = true;
+    }
+
+    if(!entry.mIsValid)
+        return false;
+
+    levelInfo = entry.mLevelInfo;
+    return true;
+}
+
+void LevelInfoIndex::refreshAsync(const std::vector<std::string>& folders, const std::string& extension)
+{
+    waitRefresh();
+    mStopRefresh = false;
+    mRefreshThread = std::thread(&LevelInfoIndex::refreshThread, this, folders, extension);
+}
+
+void LevelInfoIndex::waitRefresh()
+{
+    if(mRefreshThread.joinable())
+        mRefreshThread.join();
+}
+
+void LevelInfoIndex::refreshThread(std::vector<std::string> folders, std::string extension)
+{
+    for(const std::string& folder : folders)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::directory_iterator itr(folder, ec);
+        if(ec)
+            continue;
+
+        // The paths are the same as the ones given by Helper::fillFilesList to the menus
+        for(boost::filesystem::directory_iterator end; itr != end; itr.increment(ec))
+        {
+            if(ec || mStopRefresh)
+                break;
+
+            if(boost::filesystem::is_directory(itr->status()))
+                continue;
+
+            if(itr->path().filename().extension().string() != extension)
+                continue;
+
+            boost::filesystem::path path = boost::filesystem::canonical(itr->path(), ec);
+            if(ec)
+                continue;
+
+            LevelInfo levelInfo;
+            getLevelInfo(path.string(), levelInfo);
+        }
+
+        if(mStopRefresh)
+            return;
+    }
+
+    save();
+}
+
+bool LevelInfoIndex::load()
+{
+    std::ifstream indexFile(mIndexFileName.c_str(), std::ifstream::in);
+    if(!indexFile.good())
+        return false;
+
+    std::string line;
+    if(!std::getline(indexFile, line) || (line != INDEX_HEADER))
+    {
+        // The index will be rebuilt
+        OD_LOG_INF("Ignoring level info index with different format: " + mIndexFileName);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    while(std::getline(indexFile, line))
+    {
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while(std::getline(ss, field, '\t'))
+            fields.push_back(field);
+
+        // The description may be empty
+        if(fields.size() == 5)
+            fields.push_back(std::string());
+
+        if(fields.size() != 6)
+            continue;
+
+        Entry entry;
+        std::stringstream(fields[1]) >> entry.mFileSize;
+        int64_t modificationTime = 0;
+        std::stringstream(fields[2]) >> modificationTime;
+        entry.mModificationTime = static_cast<std::time_t>(modificationTime);
+        entry.mIsValid = (fields[3] == "1");
+        entry.mLevelInfo.mLevelName = unescapeField(fields[4]);
+        entry.mLevelInfo.mLevelDescription = unescapeField(fields[5]);
+        mEntries[unescapeField(fields[0])] = entry;
+    }
+
+    return true;
+}
+
+bool LevelInfoIndex::save()
+{
+    std::map<std::string, Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(!mIsDirty)
+            return true;
+
+        entries = mEntries;
+        mIsDirty = false;
+    }
+
+    const std::string tmpFileName = mIndexFileName + ".tmp";
+    {
+        std::ofstream indexFile(tmpFileName.c_str(), std::ofstream::out);
+        indexFile << INDEX_HEADER << "\n";
+        for(const std::pair<const std::string, Entry>& p : entries)
+        {
+            boost::system::error_code ec;
+            if(!boost::filesystem::exists(p.first, ec))
+                continue;
+
+            const Entry& entry = p.second;
+            indexFile << escapeField(p.first) << "\t" << entry.mFileSize << "\t"
+                << static_cast<int64_t>(entry.mModificationTime) << "\t" << (entry.mIsValid ? "1" : "0") << "\t"
+                << escapeField(entry.mLevelInfo.mLevelName) << "\t"
+                << escapeField(entry.mLevelInfo.mLevelDescription) << "\n";
+        }
+
+        indexFile.close();
+        if(indexFile.fail())
+        {
+            OD_LOG_WRN("Couldn't write level info index: " + tmpFileName);
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpFileName, mIndexFileName, ec);
+    if(ec)
+    {
+        OD_LOG_WRN("Couldn't rename " + tmpFileName + " to " + mIndexFileName + ": " + ec.message());
+        return false;
+    }
+
+    return true;
+}
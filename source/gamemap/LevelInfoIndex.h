@@ -0,0 +1,105 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LEVELINFOINDEX_H
+#define LEVELINFOINDEX_H
+
+#include "gamemap/MapHandler.h"
+
+#include <OgreSingleton.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*! \brief Persistent cache of the LevelInfo displayed by the level menus.
+ *
+ * Each entry is keyed by the level path and is valid as long as the file size and
+ * modification time did not change. Otherwise, the level is read again (only its header,
+ * see MapHandler::getMapInfo). The index is loaded from and saved to a file in the user
+ * data folder. refreshAsync reads the changed levels on a background thread so that the
+ * menus usually find every level in the index.
+ */
+class LevelInfoIndex : public Ogre::Singleton<LevelInfoIndex>
+{
+public:
+    typedef std::function<bool(const std::string& fileName, LevelInfo& levelInfo)> ReadLevelInfo;
+
+    //! \brief Loads the index from indexFileName (if it exists). readLevelInfo is called
+    //! for the levels not in the index (MapHandler::getMapInfo in the game)
+    LevelInfoIndex(const std::string& indexFileName, const ReadLevelInfo& readLevelInfo);
+
+    //! \brief Stops the refresh and saves the index
+    ~LevelInfoIndex();
+
+    LevelInfoIndex(const LevelInfoIndex&) = delete;
+    LevelInfoIndex& operator=(const LevelInfoIndex&) = delete;
+
+    //! \brief Same as MapHandler::getMapInfo but uses the index if the level did not change.
+    //! Can be called while a refresh is running
+    bool getLevelInfo(const std::string& fileName, LevelInfo& levelInfo);
+
+    //! \brief Updates, on a background thread, the entries of every level file (with the given
+    //! extension) in the given folders then saves the index if it changed
+    void refreshAsync(const std::vector<std::string>& folders, const std::string& extension);
+
+    //! \brief Blocks until the refresh started by refreshAsync is done
+    void waitRefresh();
+
+    //! \brief Writes the index file if it changed. The entries of the levels that do not exist
+    //! anymore are removed
+    bool save();
+
+    //! \brief Number of levels read (not found in the index) since the index was created
+    inline uint32_t getNbLevelsRead() const
+    { return mNbLevelsRead; }
+
+    //! \brief Name of the index file in the user data folder
+    static const std::string INDEX_FILENAME;
+
+private:
+    struct Entry
+    {
+        uint64_t mFileSize;
+        std::time_t mModificationTime;
+        bool mIsValid;
+        LevelInfo mLevelInfo;
+    };
+
+    bool load();
+
+    void refreshThread(std::vector<std::string> folders, std::string extension);
+
+    std::string mIndexFileName;
+    ReadLevelInfo mReadLevelInfo;
+
+    std::mutex mMutex;
+    std::map<std::string, Entry> mEntries;
+    bool mIsDirty;
+
+    std::thread mRefreshThread;
+    std::atomic<bool> mStopRefresh;
+    std::atomic<uint32_t> mNbLevelsRead;
+};
+
+#endif // LEVELINFOINDEX_H
@@ -18,7 +18,9 @@
 #include "gamemap/MapHandler.h"
 
 #include "creaturemood/CreatureMoodManager.h"
+#include "gamemap/BinaryLevel.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/GameMapSnapshot.h"
 #include "game/Seat.h"
 #include "goals/Goal.h"
 #include "goals/GoalLoading.h"
@@ -48,15 +50,72 @@
 
 #include "ODApplication.h"
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
 
 namespace MapHandler {
 
+//! \brief Fills levelFile with the text content of the given level. If the file is a binary
+//! level, the text sections are exported from it and the tiles are left in binaryLevel so that
+//! they can be read directly from the mapped file.
+static bool readLevelText(const std::string& fileName, std::stringstream& levelFile,
+    BinaryLevelReader& binaryLevel)
+{
+    if(!BinaryLevel::isBinaryLevelFile(fileName))
+        return Helper::readFileWithoutComments(fileName, levelFile);
+
+    if(!binaryLevel.open(fileName))
+    {
+        OD_LOG_ERR("Cannot read binary level file=" + fileName + ", error=" + binaryLevel.getError());
+        return false;
+    }
+
+    binaryLevel.exportText(levelFile, false);
+    return true;
+}
+
+//! \brief Same as readLevelText but, for text levels, stops reading after the map size. That
+//! is all getMapInfo needs and it avoids reading the tiles and the entities
+static bool readLevelHeader(const std::string& fileName, std::stringstream& levelFile,
+    BinaryLevelReader& binaryLevel)
+{
+    if(BinaryLevel::isBinaryLevelFile(fileName))
+        return readLevelText(fileName, levelFile, binaryLevel);
+
+    std::ifstream baseLevelFile(fileName.c_str(), std::ifstream::in);
+    if (!baseLevelFile.good())
+    {
+        OD_LOG_WRN("File not found=" + fileName);
+        return false;
+    }
+
+    // The map size is given by the 2 lines following [Tiles]
+    int nbSizeLinesToRead = -1;
+    std::string line;
+    while((nbSizeLinesToRead != 0) && std::getline(baseLevelFile, line))
+    {
+        line = line.substr(0, line.find('#'));
+        levelFile << line << "\n";
+
+        Helper::trim(line);
+        if(nbSizeLinesToRead > 0)
+        {
+            if(!line.empty())
+                --nbSizeLinesToRead;
+        }
+        else if(line == "[Tiles]")
+            nbSizeLinesToRead = 2;
+    }
+
+    return true;
+}
+
 bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
 {
     std::stringstream levelFile;
-    if(!Helper::readFileWithoutComments(fileName, levelFile))
+    BinaryLevelReader binaryLevel;
+    if(!readLevelText(fileName, levelFile, binaryLevel))
         return false;
 
     std::string nextParam;
@@ -214,6 +273,24 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
     // Read in the map tiles from disk
     gameMap.disableFloodFill();
 
+    // Binary levels give the tiles as fixed size records read directly from the mapped file
+    const BinaryLevel::TileRecord* tileRecords = binaryLevel.getTiles();
+    for(uint32_t i = 0; i < binaryLevel.getNbTiles(); ++i)
+    {
+        const BinaryLevel::TileRecord& record = tileRecords[i];
+        // The tiles are already allocated by createNewMap
+        Tile* tile = gameMap.getTile(record.mX, record.mY);
+        if(tile == nullptr)
+        {
+            OD_LOG_ERR("Tile out of map x=" + Helper::toString(record.mX) + ", y=" + Helper::toString(record.mY));
+            continue;
+        }
+
+        Tile::loadFromValues(tile, static_cast<TileType>(record.mType),
+            record.mFullness, record.mHasSeat != 0, record.mSeatId);
+        tile->computeTileVisual();
+    }
+
     while (true)
     {
         if(!levelFile.good())
@@ -231,12 +308,14 @@ bool readGameMapFromFile(const std::string& fileName, GameMap& gameMap)
         std::getline(levelFile, nextParam);
         entire_line += nextParam;
 
-        Tile* tile = new Tile(&gameMap, true);
+        Tile* tile = Tile::loadFromLine(entire_line, &gameMap);
+        if(tile == nullptr)
+        {
+            OD_LOG_ERR("Tile out of map line=" + entire_line);
+            continue;
+        }
 
-        Tile::loadFromLine(entire_line, tile);
         tile->computeTileVisual();
-
-        gameMap.addTile(tile);
     }
 
     gameMap.setAllFullnessAndNeighbors();
@@ -552,14 +631,23 @@ bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType ty
 
 bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
 {
-    std::ofstream levelFile(fileName.c_str(), std::ifstream::out);
+    GameMapSnapshot snapshot;
+    takeGameMapSnapshot(gameMap, snapshot);
 
-    // This is better than checking for .bad(), as it checks every error flags.
-    if (!levelFile.good()) {
-        OD_LOG_WRN("Couldn't open file for writing: " + fileName);
+    std::string error;
+    if(!snapshot.writeToFile(fileName, false, error))
+    {
+        OD_LOG_WRN(error);
         return false;
     }
 
+    return true;
+}
+
+void takeGameMapSnapshot(GameMap& gameMap, GameMapSnapshot& snapshot)
+{
+    std::ostringstream levelFile;
+
     // Write the identifier string and the version number
     levelFile << ODApplication::VERSIONSTRING
             << "  # The version of OpenDungeons which created this file (for compatibility reasons).\n";
@@ -602,16 +690,15 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
     }
     levelFile << "[/Goals]" << std::endl;
 
-    levelFile << "\n[Tiles]\n";
+    snapshot.mHeader = levelFile.str();
+    levelFile.str(std::string());
+
+    // The tiles are formatted when the snapshot is written
     int mapSizeX = gameMap.getMapSizeX();
     int mapSizeY = gameMap.getMapSizeY();
-    levelFile << "# Map Size" << std::endl;
-    levelFile << mapSizeX << " # MapSizeX" << std::endl;
-    levelFile << mapSizeY << " # MapSizeY" << std::endl;
-
-    // Write out the tiles to the file
-    levelFile << "# " << Tile::getFormat() << "\n";
-
+    snapshot.mMapSizeX = mapSizeX;
+    snapshot.mMapSizeY = mapSizeY;
+    snapshot.mTiles.clear();
     for(int ii = 0; ii < mapSizeX; ++ii)
     {
         for(int jj = 0; jj < mapSizeY; ++jj)
@@ -624,11 +711,16 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
             if (!tile->isClaimed() && tile->getType() == TileType::dirt && tile->getFullness() >= 100.0)
                 continue;
 
-            Tile::exportToStream(tile, levelFile);
-            levelFile << std::endl;
+            BinaryLevel::TileRecord record;
+            record.mX = tile->getX();
+            record.mY = tile->getY();
+            record.mType = static_cast<uint16_t>(tile->getType());
+            record.mHasSeat = (tile->getSeat() != nullptr) ? 1 : 0;
+            record.mSeatId = (tile->getSeat() != nullptr) ? tile->getSeat()->getId() : 0;
+            record.mFullness = tile->getFullness();
+            snapshot.mTiles.push_back(record);
         }
     }
-    levelFile << "[/Tiles]" << std::endl;
 
     std::vector<Room*> rooms = gameMap.getRooms();
     std::sort(rooms.begin(), rooms.end(), Room::sortForMapSave);
@@ -779,20 +871,15 @@ bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap)
     }
     levelFile << "[/Chickens]" << std::endl;
 
-    if (!levelFile.good()) {
-        OD_LOG_WRN("Unexpected failure on file: " + fileName);
-        return false;
-    }
-
-    levelFile.close();
-    return true;
+    snapshot.mEntities = levelFile.str();
 }
 
 bool getMapInfo(const std::string& fileName, LevelInfo& levelInfo)
 {
     // Prepare an invalid level reference
     std::stringstream levelFile;
-    if(!Helper::readFileWithoutComments(fileName, levelFile))
+    BinaryLevelReader binaryLevel;
+    if(!readLevelHeader(fileName, levelFile, binaryLevel))
         return false;
 
     std::string nextParam;
@@ -22,6 +22,7 @@
 #include <string>
 
 class GameMap;
+struct GameMapSnapshot;
 
 enum class GameEntityType;
 
@@ -44,6 +45,10 @@ namespace MapHandler
 
     bool writeGameMapToFile(const std::string& fileName, GameMap& gameMap);
 
+    //! \brief Copies what writeGameMapToFile writes so that it can be written later (or by
+    //! another thread). Must be called from the thread updating the gamemap
+    void takeGameMapSnapshot(GameMap& gameMap, GameMapSnapshot& snapshot);
+
     bool readGameEntity(GameMap& gameMap, const std::string& item, GameEntityType type, std::stringstream& levelFile);
 
     bool loadEquipments(const std::string& fileName, GameMap& gameMap);
@@ -0,0 +1,429 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/PathfindingCache.h"
+
+#include "entities/Tile.h"
+#include "game/Seat.h"
+#include "gamemap/GameMap.h"
+#include "utils/Helper.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+const int PathfindingCache::CLUSTER_SIZE = 16;
+
+//! \brief Border runs with at least this number of tiles get an entrance at each end instead of one in the middle
+static const int MIN_RUN_LENGTH_DOUBLE_ENTRANCE = 6;
+
+static inline uint32_t manhattanDistance(int x1, int y1, int x2, int y2)
+{
+    return static_cast<uint32_t>(std::abs(x2 - x1) + std::abs(y2 - y1));
+}
+
+PathfindingCache::PathfindingCache(GameMap& gameMap) :
+    mGameMap(gameMap),
+    mSizeX(0),
+    mSizeY(0),
+    mNbClustersX(0),
+    mNbClustersY(0),
+    mBfsGeneration(0),
+    mSearchGeneration(0),
+    mNbQueries(0),
+    mNbQueriesFound(0),
+    mNbClusterHits(0),
+    mNbClusterMisses(0)
+{
+}
+
+void PathfindingCache::setMapSize(int sizeX, int sizeY)
+{
+    mSizeX = sizeX;
+    mSizeY = sizeY;
+    mNbClustersX = (sizeX + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    mNbClustersY = (sizeY + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    mLayers.clear();
+    mClusterVersions.assign(static_cast<size_t>(mNbClustersX * mNbClustersY), 1);
+    mBfsDistances.assign(static_cast<size_t>(sizeX * sizeY), 0);
+    mBfsVisitedGeneration.assign(static_cast<size_t>(sizeX * sizeY), 0);
+    mBfsGeneration = 0;
+    mSearchNodes.assign(static_cast<size_t>(sizeX * sizeY), SearchNode{0, 0, 0, false});
+    mSearchGeneration = 0;
+}
+
+void PathfindingCache::invalidateAll()
+{
+    for(uint32_t& version : mClusterVersions)
+        ++version;
+}
+
+void PathfindingCache::invalidateTile(int x, int y)
+{
+    if(mClusterVersions.empty())
+        return;
+
+    // The connections between the tile and its neighbors may have changed. If the tile is on the border
+    // of its cluster, the entrances of the neighbor cluster may change too
+    static const int DX[5] = {0, -1, 1, 0, 0};
+    static const int DY[5] = {0, 0, 0, -1, 1};
+    int lastClusterIndex = -1;
+    for(int i = 0; i < 5; ++i)
+    {
+        int xx = x + DX[i];
+        int yy = y + DY[i];
+        if((xx < 0) || (xx >= mSizeX) || (yy < 0) || (yy >= mSizeY))
+            continue;
+
+        int clusterIndex = clusterIndexForTile(xx, yy);
+        if(clusterIndex == lastClusterIndex)
+            continue;
+
+        lastClusterIndex = clusterIndex;
+        ++mClusterVersions[clusterIndex];
+    }
+}
+
+bool PathfindingCache::isSameCluster(const Tile* tile1, const Tile* tile2) const
+{
+    return clusterIndexForTile(tile1->getX(), tile1->getY()) == clusterIndexForTile(tile2->getX(), tile2->getY());
+}
+
+uint32_t PathfindingCache::getFloodFill(Seat* seat, FloodFillType type, uint32_t tileIndex) const
+{
+    Tile* tile = mGameMap.getTile(static_cast<int>(tileIndex % mSizeX), static_cast<int>(tileIndex / mSizeX));
+    return tile->getFloodFillValue(seat, type);
+}
+
+const PathfindingCache::Cluster& PathfindingCache::getCluster(Layer& layer, Seat* seat, FloodFillType type, int clusterIndex)
+{
+    Cluster& cluster = layer.mClusters[clusterIndex];
+    if(cluster.mVersion == mClusterVersions[clusterIndex])
+    {
+        ++mNbClusterHits;
+        return cluster;
+    }
+
+    ++mNbClusterMisses;
+    computeCluster(cluster, seat, type, clusterIndex);
+    cluster.mVersion = mClusterVersions[clusterIndex];
+    return cluster;
+}
+
+void PathfindingCache::computeCluster(Cluster& cluster, Seat* seat, FloodFillType type, int clusterIndex)
+{
+    cluster.mEntrances.clear();
+    cluster.mEdges.clear();
+
+    int x0 = (clusterIndex % mNbClustersX) * CLUSTER_SIZE;
+    int y0 = (clusterIndex / mNbClustersX) * CLUSTER_SIZE;
+    int x1 = std::min(x0 + CLUSTER_SIZE, mSizeX) - 1;
+    int y1 = std::min(y0 + CLUSTER_SIZE, mSizeY) - 1;
+
+    // We compute the entrances on the 4 borders. Note that borders are always processed in the same direction
+    // so that the entrances computed by 2 neighbor clusters match
+    if(x0 > 0)
+        computeBorderEntrances(cluster, seat, type, x0, y0, 0, 1, -1, 0);
+    if(x1 < mSizeX - 1)
+        computeBorderEntrances(cluster, seat, type, x1, y0, 0, 1, 1, 0);
+    if(y0 > 0)
+        computeBorderEntrances(cluster, seat, type, x0, y0, 1, 0, 0, -1);
+    if(y1 < mSizeY - 1)
+        computeBorderEntrances(cluster, seat, type, x0, y1, 1, 0, 0, 1);
+
+    // Then, we compute the distances between the entrances
+    for(uint32_t i = 0; i < cluster.mEntrances.size(); ++i)
+        computeClusterDistances(cluster, seat, type, clusterIndex, cluster.mEntrances[i], cluster.mEdges[i]);
+}
+
+void PathfindingCache::computeBorderEntrances(Cluster& cluster, Seat* seat, FloodFillType type, int x, int y,
+    int stepX, int stepY, int dx, int dy)
+{
+    int length = (stepX != 0) ? std::min(CLUSTER_SIZE, mSizeX - x) : std::min(CLUSTER_SIZE, mSizeY - y);
+    int runStart = -1;
+    // We go one step further than the border length to close the last run
+    for(int k = 0; k <= length; ++k)
+    {
+        bool isCrossable = false;
+        if(k < length)
+        {
+            uint32_t tileIndex = toIndex(x + k * stepX, y + k * stepY);
+            uint32_t partnerIndex = toIndex(x + k * stepX + dx, y + k * stepY + dy);
+            uint32_t floodFill = getFloodFill(seat, type, tileIndex);
+            isCrossable = (floodFill != Tile::NO_FLOODFILL) &&
+                (floodFill == getFloodFill(seat, type, partnerIndex));
+        }
+
+        if(isCrossable)
+        {
+            if(runStart < 0)
+                runStart = k;
+            continue;
+        }
+
+        if(runStart < 0)
+            continue;
+
+        int runEnd = k - 1;
+        int entrancesPos[2];
+        int nbEntrances;
+        if(runEnd - runStart + 1 >= MIN_RUN_LENGTH_DOUBLE_ENTRANCE)
+        {
+            entrancesPos[0] = runStart;
+            entrancesPos[1] = runEnd;
+            nbEntrances = 2;
+        }
+        else
+        {
+            entrancesPos[0] = (runStart + runEnd) / 2;
+            nbEntrances = 1;
+        }
+        runStart = -1;
+
+        for(int i = 0; i < nbEntrances; ++i)
+        {
+            int pos = entrancesPos[i];
+            uint32_t tileIndex = toIndex(x + pos * stepX, y + pos * stepY);
+            uint32_t partnerIndex = toIndex(x + pos * stepX + dx, y + pos * stepY + dy);
+            // A corner tile can be an entrance on 2 borders
+            auto it = std::find(cluster.mEntrances.begin(), cluster.mEntrances.end(), tileIndex);
+            uint32_t slot = static_cast<uint32_t>(it - cluster.mEntrances.begin());
+            if(it == cluster.mEntrances.end())
+            {
+                cluster.mEntrances.push_back(tileIndex);
+                cluster.mEdges.push_back(std::vector<AbstractEdge>());
+            }
+            cluster.mEdges[slot].push_back(AbstractEdge{partnerIndex, 1});
+        }
+    }
+}
+
+void PathfindingCache::computeClusterDistances(const Cluster& cluster, Seat* seat, FloodFillType type, int clusterIndex,
+    uint32_t fromTileIndex, std::vector<AbstractEdge>& edges)
+{
+    int x0 = (clusterIndex % mNbClustersX) * CLUSTER_SIZE;
+    int y0 = (clusterIndex / mNbClustersX) * CLUSTER_SIZE;
+    int x1 = std::min(x0 + CLUSTER_SIZE, mSizeX) - 1;
+    int y1 = std::min(y0 + CLUSTER_SIZE, mSizeY) - 1;
+
+    ++mBfsGeneration;
+    if(mBfsGeneration == 0)
+    {
+        std::fill(mBfsVisitedGeneration.begin(), mBfsVisitedGeneration.end(), 0);
+        mBfsGeneration = 1;
+    }
+
+    uint32_t floodFill = getFloodFill(seat, type, fromTileIndex);
+    if(floodFill == Tile::NO_FLOODFILL)
+        return;
+
+    mBfsQueue.clear();
+    mBfsQueue.push_back(fromTileIndex);
+    mBfsVisitedGeneration[fromTileIndex] = mBfsGeneration;
+    mBfsDistances[fromTileIndex] = 0;
+    static const int DX[4] = {-1, 1, 0, 0};
+    static const int DY[4] = {0, 0, -1, 1};
+    for(uint32_t queueIndex = 0; queueIndex < mBfsQueue.size(); ++queueIndex)
+    {
+        uint32_t tileIndex = mBfsQueue[queueIndex];
+        int x = static_cast<int>(tileIndex % mSizeX);
+        int y = static_cast<int>(tileIndex / mSizeX);
+        for(int i = 0; i < 4; ++i)
+        {
+            int xx = x + DX[i];
+            int yy = y + DY[i];
+            if((xx < x0) || (xx > x1) || (yy < y0) || (yy > y1))
+                continue;
+
+            uint32_t neighIndex = toIndex(xx, yy);
+            if(mBfsVisitedGeneration[neighIndex] == mBfsGeneration)
+                continue;
+
+            if(getFloodFill(seat, type, neighIndex) != floodFill)
+                continue;
+
+            mBfsVisitedGeneration[neighIndex] = mBfsGeneration;
+            mBfsDistances[neighIndex] = mBfsDistances[tileIndex] + 1;
+            mBfsQueue.push_back(neighIndex);
+        }
+    }
+
+    for(uint32_t entrance : cluster.mEntrances)
+    {
+        if(entrance == fromTileIndex)
+            continue;
+
+        if(mBfsVisitedGeneration[entrance] != mBfsGeneration)
+            continue;
+
+        edges.push_back(AbstractEdge{entrance, mBfsDistances[entrance]});
+    }
+}
+
+bool PathfindingCache::findWaypoints(Seat* seat, FloodFillType type, Tile* tileStart, Tile* tileDest, std::vector<Tile*>& waypoints)
+{
+    waypoints.clear();
+    if(mClusterVersions.empty())
+        return false;
+
+    ++mNbQueries;
+    int clusterStart = clusterIndexForTile(tileStart->getX(), tileStart->getY());
+    int clusterDest = clusterIndexForTile(tileDest->getX(), tileDest->getY());
+    if(clusterStart == clusterDest)
+        return false;
+
+    uint32_t layerIndex = seat->getTeamIndex() * static_cast<uint32_t>(FloodFillType::nbValues) + static_cast<uint32_t>(type);
+    if(layerIndex >= mLayers.size())
+        mLayers.resize(layerIndex + 1);
+
+    Layer& layer = mLayers[layerIndex];
+    if(layer.mClusters.empty())
+        layer.mClusters.resize(mClusterVersions.size(), Cluster{0, {}, {}});
+
+    uint32_t startIndex = toIndex(tileStart->getX(), tileStart->getY());
+    uint32_t destIndex = toIndex(tileDest->getX(), tileDest->getY());
+
+    // We connect the start and the destination tiles to the entrances of their clusters
+    const Cluster& startCluster = getCluster(layer, seat, type, clusterStart);
+    mStartEdges.clear();
+    computeClusterDistances(startCluster, seat, type, clusterStart, startIndex, mStartEdges);
+    const Cluster& destCluster = getCluster(layer, seat, type, clusterDest);
+    mDestEdges.clear();
+    computeClusterDistances(destCluster, seat, type, clusterDest, destIndex, mDestEdges);
+    if(mDestEdges.empty())
+    {
+        // The destination might be an entrance itself
+        if(std::find(destCluster.mEntrances.begin(), destCluster.mEntrances.end(), destIndex) == destCluster.mEntrances.end())
+            return false;
+    }
+
+    // A* on the abstract graph
+    int destX = tileDest->getX();
+    int destY = tileDest->getY();
+    ++mSearchGeneration;
+    if(mSearchGeneration == 0)
+    {
+        for(SearchNode& node : mSearchNodes)
+            node.mGeneration = 0;
+        mSearchGeneration = 1;
+    }
+    mOpenList.clear();
+    mSearchNodes[startIndex] = SearchNode{mSearchGeneration, 0, startIndex, false};
+    mOpenList.push_back(std::make_pair(manhattanDistance(tileStart->getX(), tileStart->getY(), destX, destY), startIndex));
+
+    auto relax = [&](uint32_t fromIndex, uint32_t targetIndex, uint32_t cost)
+    {
+        SearchNode& node = mSearchNodes[targetIndex];
+        if(node.mGeneration == mSearchGeneration)
+        {
+            if(node.mProcessed || (node.mCost <= cost))
+                return;
+
+            node.mCost = cost;
+            node.mParent = fromIndex;
+        }
+        else
+            node = SearchNode{mSearchGeneration, cost, fromIndex, false};
+
+        uint32_t h = manhattanDistance(static_cast<int>(targetIndex % mSizeX), static_cast<int>(targetIndex / mSizeX), destX, destY);
+        mOpenList.push_back(std::make_pair(cost + h, targetIndex));
+        std::push_heap(mOpenList.begin(), mOpenList.end(), std::greater<std::pair<uint32_t, uint32_t>>());
+    };
+
+    bool found = false;
+    while(!mOpenList.empty())
+    {
+        std::pop_heap(mOpenList.begin(), mOpenList.end(), std::greater<std::pair<uint32_t, uint32_t>>());
+        uint32_t tileIndex = mOpenList.back().second;
+        mOpenList.pop_back();
+
+        SearchNode& node = mSearchNodes[tileIndex];
+        if(node.mProcessed)
+            continue;
+
+        node.mProcessed = true;
+        uint32_t cost = node.mCost;
+        if(tileIndex == destIndex)
+        {
+            found = true;
+            break;
+        }
+
+        if(tileIndex == startIndex)
+        {
+            for(const AbstractEdge& edge : mStartEdges)
+                relax(tileIndex, edge.mTileIndex, cost + edge.mCost);
+        }
+
+        int clusterIndex = clusterIndexForTile(static_cast<int>(tileIndex % mSizeX), static_cast<int>(tileIndex / mSizeX));
+        const Cluster& cluster = getCluster(layer, seat, type, clusterIndex);
+        auto it = std::find(cluster.mEntrances.begin(), cluster.mEntrances.end(), tileIndex);
+        if(it != cluster.mEntrances.end())
+        {
+            for(const AbstractEdge& edge : cluster.mEdges[it - cluster.mEntrances.begin()])
+                relax(tileIndex, edge.mTileIndex, cost + edge.mCost);
+        }
+
+        if(clusterIndex == clusterDest)
+        {
+            for(const AbstractEdge& edge : mDestEdges)
+            {
+                if(edge.mTileIndex != tileIndex)
+                    continue;
+
+                relax(tileIndex, destIndex, cost + edge.mCost);
+                break;
+            }
+        }
+    }
+
+    if(!found)
+        return false;
+
+    ++mNbQueriesFound;
+    uint32_t tileIndex = destIndex;
+    while(tileIndex != startIndex)
+    {
+        waypoints.push_back(mGameMap.getTile(static_cast<int>(tileIndex % mSizeX), static_cast<int>(tileIndex / mSizeX)));
+        tileIndex = mSearchNodes[tileIndex].mParent;
+    }
+    waypoints.push_back(tileStart);
+    std::reverse(waypoints.begin(), waypoints.end());
+    return true;
+}
+
+std::string PathfindingCache::getStatsString() const
+{
+    uint64_t nbClusterRequests = mNbClusterHits + mNbClusterMisses;
+    double hitRate = 0.0;
+    if(nbClusterRequests > 0)
+        hitRate = 100.0 * static_cast<double>(mNbClusterHits) / static_cast<double>(nbClusterRequests);
+
+    return "Pathfinding cache: queries=" + Helper::toString(mNbQueries)
+        + ", found=" + Helper::toString(mNbQueriesFound)
+        + ", cluster hits=" + Helper::toString(mNbClusterHits)
+        + ", cluster misses=" + Helper::toString(mNbClusterMisses)
+        + ", hit rate=" + Helper::toString(hitRate) + "%";
+}
+
+void PathfindingCache::resetStats()
+{
+    mNbQueries = 0;
+    mNbQueriesFound = 0;
+    mNbClusterHits = 0;
+    mNbClusterMisses = 0;
+}
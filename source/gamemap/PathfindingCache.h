@@ -0,0 +1,170 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATHFINDINGCACHE_H
+#define PATHFINDINGCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class GameMap;
+class Seat;
+class Tile;
+
+enum class FloodFillType;
+
+/*! \brief Hierarchical (HPA*) abstraction of the map used to speed up long path searches.
+ *
+ * The map is split in square clusters. For each team and each FloodFillType, entrances are computed
+ * on the borders between clusters and the walking distance between the entrances of a same cluster
+ * is cached. Two adjacent tiles are connected if they have the same floodfill value. That way, the
+ * abstract graph follows the floodfill regions (closed doors, bridges, ...) without knowing about them.
+ *
+ * Searching a long path then consists in a small search on the entrances graph, giving waypoints
+ * that are refined with the standard A* by GameMap::path.
+ *
+ * The clusters are computed lazily and invalidated when the floodfill changes around a tile
+ * (see invalidateTile). Only the touched clusters are computed again.
+ */
+class PathfindingCache
+{
+public:
+    //! \brief Size (in tiles) of the square clusters
+    static const int CLUSTER_SIZE;
+
+    PathfindingCache(GameMap& gameMap);
+
+    //! \brief Clears the cache and sets up the clusters for the given map size
+    void setMapSize(int sizeX, int sizeY);
+
+    //! \brief Marks every cluster as needing to be computed again. Should be called when the
+    //! floodfill is computed for the whole map
+    void invalidateAll();
+
+    //! \brief Marks the clusters around the given tile as needing to be computed again. Should be
+    //! called when the floodfill changes around a tile (dug tile, door locked, bridge built, ...)
+    void invalidateTile(int x, int y);
+
+    /*! \brief Computes the waypoints of a path between tileStart and tileDest using the abstract graph
+     * for the given seat team and floodfill type.
+     * waypoints is filled with tiles from tileStart to tileDest (both included). Two consecutive waypoints
+     * are either in the same cluster or adjacent. Returns false if no abstract path could be found
+     * (in which case, the caller should compute the path with the standard A*).
+     */
+    bool findWaypoints(Seat* seat, FloodFillType type, Tile* tileStart, Tile* tileDest, std::vector<Tile*>& waypoints);
+
+    //! \brief Returns true if both tiles are in the same cluster
+    bool isSameCluster(const Tile* tile1, const Tile* tile2) const;
+
+    //! \brief Returns the statistics of the cache (queries and cluster hit rate) in a printable form
+    std::string getStatsString() const;
+
+    void resetStats();
+
+private:
+    //! \brief Edge of the abstract graph. The destination is a tile index (y * sizeX + x)
+    struct AbstractEdge
+    {
+        uint32_t mTileIndex;
+        uint32_t mCost;
+    };
+
+    struct Cluster
+    {
+        //! \brief Version of the cluster when it was computed (see mClusterVersions)
+        uint32_t mVersion;
+        //! \brief Tile indexes of the entrances in this cluster
+        std::vector<uint32_t> mEntrances;
+        //! \brief Edges for each entrance (same index as mEntrances). Contains the other entrances of this
+        //! cluster that can be reached and the tiles across the borders
+        std::vector<std::vector<AbstractEdge>> mEdges;
+    };
+
+    //! \brief Clusters for one team and one floodfill type
+    struct Layer
+    {
+        std::vector<Cluster> mClusters;
+    };
+
+    //! \brief Node of the abstract search. The nodes are indexed by tile index. A node is only
+    //! valid if mGeneration is the one of the current search
+    struct SearchNode
+    {
+        uint32_t mGeneration;
+        uint32_t mCost;
+        uint32_t mParent;
+        bool mProcessed;
+    };
+
+    GameMap& mGameMap;
+    int mSizeX;
+    int mSizeY;
+    int mNbClustersX;
+    int mNbClustersY;
+
+    //! \brief Layers indexed by team index * FloodFillType::nbValues + FloodFillType
+    std::vector<Layer> mLayers;
+
+    //! \brief Current version of each cluster. It is incremented when a cluster is invalidated. That way,
+    //! invalidating a cluster does not depend on the number of layers
+    std::vector<uint32_t> mClusterVersions;
+
+    //! \brief Buffers reused between searches
+    std::vector<uint32_t> mBfsQueue;
+    std::vector<uint32_t> mBfsDistances;
+    std::vector<uint32_t> mBfsVisitedGeneration;
+    uint32_t mBfsGeneration;
+    std::vector<SearchNode> mSearchNodes;
+    uint32_t mSearchGeneration;
+    std::vector<std::pair<uint32_t, uint32_t>> mOpenList;
+    std::vector<AbstractEdge> mStartEdges;
+    std::vector<AbstractEdge> mDestEdges;
+
+    //! \brief Statistics
+    uint64_t mNbQueries;
+    uint64_t mNbQueriesFound;
+    uint64_t mNbClusterHits;
+    uint64_t mNbClusterMisses;
+
+    inline uint32_t toIndex(int x, int y) const
+    { return static_cast<uint32_t>(y * mSizeX + x); }
+
+    inline int clusterIndexForTile(int x, int y) const
+    { return (y / CLUSTER_SIZE) * mNbClustersX + (x / CLUSTER_SIZE); }
+
+    //! \brief Returns the floodfill value of the tile at the given index
+    uint32_t getFloodFill(Seat* seat, FloodFillType type, uint32_t tileIndex) const;
+
+    //! \brief Returns the given cluster after having computed it if needed
+    const Cluster& getCluster(Layer& layer, Seat* seat, FloodFillType type, int clusterIndex);
+
+    //! \brief Computes the entrances and the edges of the given cluster
+    void computeCluster(Cluster& cluster, Seat* seat, FloodFillType type, int clusterIndex);
+
+    //! \brief Adds the entrances found on the border between the given cluster and the tiles at
+    //! (dx, dy) from its side starting at (x, y) and going along (stepX, stepY).
+    void computeBorderEntrances(Cluster& cluster, Seat* seat, FloodFillType type, int x, int y,
+        int stepX, int stepY, int dx, int dy);
+
+    //! \brief Breadth first search restricted to the given cluster from the given tile. Adds to edges
+    //! the entrances of the cluster that can be reached and their distance.
+    void computeClusterDistances(const Cluster& cluster, Seat* seat, FloodFillType type, int clusterIndex,
+        uint32_t fromTileIndex, std::vector<AbstractEdge>& edges);
+};
+
+#endif // PATHFINDINGCACHE_H
@@ -0,0 +1,117 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/PathfindingEngine.h"
+
+PathfindingEngine::PathfindingEngine() :
+    mSizeX(0),
+    mSizeY(0),
+    mGeneration(0),
+    mSequence(0),
+    mNbExpanded(0),
+    mStartIndex(0)
+{
+}
+
+void PathfindingEngine::setMapSize(int sizeX, int sizeY)
+{
+    mSizeX = sizeX;
+    mSizeY = sizeY;
+    mNodes.clear();
+    mOpenList.clear();
+    mGeneration = 0;
+}
+
+void PathfindingEngine::beginSearch()
+{
+    mOpenList.clear();
+    mSequence = 0;
+    mNbExpanded = 0;
+
+    const size_t nbNodes = static_cast<size_t>(mSizeX) * static_cast<size_t>(mSizeY);
+    if(mNodes.size() != nbNodes)
+    {
+        mNodes.assign(nbNodes, Node{0.0, 0, 0, 0, 0, false});
+        // On big maps, the open list rarely contains more entries than the map perimeter. We reserve
+        // enough to avoid reallocations in most cases
+        mOpenList.reserve(static_cast<size_t>(4 * (mSizeX + mSizeY)));
+        mGeneration = 0;
+    }
+
+    ++mGeneration;
+    if(mGeneration == 0)
+    {
+        // The generation counter wrapped around. We reset the stamps so that no node
+        // looks like it was reached by the current search
+        for(Node& node : mNodes)
+        {
+            node.mGeneration = 0;
+            node.mTargetGeneration = 0;
+        }
+
+        mGeneration = 1;
+    }
+}
+
+void PathfindingEngine::pushStart(uint32_t startIndex, double fCost)
+{
+    mStartIndex = startIndex;
+    Node& startNode = mNodes[startIndex];
+    startNode.mG = 0.0;
+    startNode.mParent = startIndex;
+    startNode.mGeneration = mGeneration;
+    startNode.mProcessed = false;
+    pushOpen(startIndex, fCost);
+}
+
+bool PathfindingEngine::popOpen(uint32_t& index)
+{
+    while(!mOpenList.empty())
+    {
+        std::pop_heap(mOpenList.begin(), mOpenList.end(), OpenEntryCompare());
+        OpenEntry entry = mOpenList.back();
+        mOpenList.pop_back();
+
+        Node& node = mNodes[entry.mIndex];
+        // Outdated entry (the node has been pushed again with a lower cost since)
+        if(node.mProcessed || (node.mSequence != entry.mSequence))
+            continue;
+
+        node.mProcessed = true;
+        ++mNbExpanded;
+        index = entry.mIndex;
+        return true;
+    }
+
+    return false;
+}
+
+bool PathfindingEngine::buildPath(uint32_t index, std::vector<uint32_t>& path) const
+{
+    path.clear();
+    if((index >= mNodes.size()) || (mNodes[index].mGeneration != mGeneration))
+        return false;
+
+    while(index != mStartIndex)
+    {
+        path.push_back(index);
+        index = mNodes[index].mParent;
+    }
+    path.push_back(mStartIndex);
+    std::reverse(path.begin(), path.end());
+    return true;
+}
@@ -0,0 +1,320 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATHFINDINGENGINE_H
+#define PATHFINDINGENGINE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! \brief Tells how the A* search should consider a tile
+enum class PathfindingAccess
+{
+    //! \brief The tile cannot be crossed
+    blocked,
+    //! \brief The tile can be crossed and diagonals can be used along it
+    walkable,
+    //! \brief The tile can be crossed but diagonals cannot be used along it (for example, diggable tiles)
+    crossable
+};
+
+/*! \brief Reusable A* search on the map grid.
+ *
+ * The nodes are stored in a flat array indexed by tile (index = y * sizeX + x) that is kept
+ * between searches. Instead of clearing it for each search, every node is stamped with the
+ * generation of the search that last used it. The open list is a binary heap where updated
+ * nodes are pushed again and outdated entries are skipped when popped.
+ * Once the storage has been allocated for the map size, a search does not allocate memory.
+ *
+ * The expansion order is the same as the sorted open list previously used in GameMap::path:
+ * the entry with the smallest cost is processed first and, if several entries have the same
+ * cost, the one that was inserted (or updated) first is processed first. Thus, the returned
+ * paths are the same.
+ */
+class PathfindingEngine
+{
+public:
+    PathfindingEngine();
+
+    //! \brief Sets the map size. The node storage will be allocated during the next search.
+    void setMapSize(int sizeX, int sizeY);
+
+    inline int getMapSizeX() const
+    { return mSizeX; }
+
+    inline int getMapSizeY() const
+    { return mSizeY; }
+
+    inline uint32_t toIndex(int x, int y) const
+    { return static_cast<uint32_t>(y * mSizeX + x); }
+
+    inline int indexToX(uint32_t index) const
+    { return static_cast<int>(index % static_cast<uint32_t>(mSizeX)); }
+
+    inline int indexToY(uint32_t index) const
+    { return static_cast<int>(index / static_cast<uint32_t>(mSizeX)); }
+
+    //! \brief Number of nodes expanded by the last search. Used for debugging/benchmarking.
+    inline uint32_t getNbExpandedLastSearch() const
+    { return mNbExpanded; }
+
+    /*! \brief Computes the path between (x1, y1) and (x2, y2).
+     *
+     * access(x, y) should return the PathfindingAccess for the tile at the given (valid) coordinates.
+     * The start tile is always considered as walkable (a creature might be standing on a closed door).
+     * moveSpeed(x, y) should return the speed to use when leaving the tile at the given coordinates.
+     * Diagonal moves are allowed only if the 2 adjacent tiles are walkable.
+     *
+     * If a path is found, true is returned and path is filled with the indexes of the tiles from the
+     * start tile to the destination tile (both included). Otherwise, false is returned and path is
+     * left empty.
+     */
+    template<typename AccessFunc, typename SpeedFunc>
+    bool findPath(int x1, int y1, int x2, int y2, AccessFunc access, SpeedFunc moveSpeed,
+        std::vector<uint32_t>& path);
+
+    /*! \brief Dijkstra search from (x1, y1) towards several target tiles.
+     *
+     * access and moveSpeed are used like in findPath. targets contains the indexes of the wanted tiles.
+     * The search expands once from the start tile and stops as soon as maxTargets targets have been
+     * reached (or when there is nothing left to expand). foundTargets is filled with the indexes of the
+     * reached targets sorted by walking cost (the nearest first). The path to any of them can then be
+     * retrieved with buildPath until the next search. Returns the number of found targets.
+     */
+    template<typename AccessFunc, typename SpeedFunc>
+    uint32_t findNearestTargets(int x1, int y1, const std::vector<uint32_t>& targets, uint32_t maxTargets,
+        AccessFunc access, SpeedFunc moveSpeed, std::vector<uint32_t>& foundTargets);
+
+    //! \brief Fills path with the tiles from the start of the last search to the given tile (both included).
+    //! Returns false if the tile was not reached by the last search.
+    bool buildPath(uint32_t index, std::vector<uint32_t>& path) const;
+
+    //! \brief Manhattan distance used for both the heuristic and the move weight
+    static inline double computeHeuristic(int x1, int y1, int x2, int y2)
+    {
+        return std::fabs(static_cast<double>(x2 - x1)) + std::fabs(static_cast<double>(y2 - y1));
+    }
+
+private:
+    struct Node
+    {
+        double mG;
+        uint32_t mParent;
+        //! \brief Sequence number of the last time this node was pushed in the open list
+        uint32_t mSequence;
+        //! \brief Generation of the search that last used this node. If it is not the current one,
+        //! the node has not been reached yet
+        uint32_t mGeneration;
+        //! \brief Generation of the search where this node was a target (see findNearestTargets)
+        uint32_t mTargetGeneration;
+        bool mProcessed;
+    };
+
+    struct OpenEntry
+    {
+        double mFCost;
+        uint32_t mSequence;
+        uint32_t mIndex;
+    };
+
+    //! \brief Ordering used by the open list heap. The top of the heap is the entry
+    //! with the lowest cost and, if equal, the lowest sequence number
+    struct OpenEntryCompare
+    {
+        inline bool operator()(const OpenEntry& e1, const OpenEntry& e2) const
+        {
+            if(e1.mFCost != e2.mFCost)
+                return e1.mFCost > e2.mFCost;
+
+            return e1.mSequence > e2.mSequence;
+        }
+    };
+
+    int mSizeX;
+    int mSizeY;
+    uint32_t mGeneration;
+    uint32_t mSequence;
+    uint32_t mNbExpanded;
+    uint32_t mStartIndex;
+    std::vector<Node> mNodes;
+    std::vector<OpenEntry> mOpenList;
+
+    //! \brief Starts a new search. Allocates the node storage if needed and handles the generation wrap-around
+    void beginSearch();
+
+    inline void pushOpen(uint32_t index, double fCost)
+    {
+        Node& node = mNodes[index];
+        node.mSequence = ++mSequence;
+        mOpenList.push_back(OpenEntry{fCost, node.mSequence, index});
+        std::push_heap(mOpenList.begin(), mOpenList.end(), OpenEntryCompare());
+    }
+
+    //! \brief Initializes the start node and pushes it in the open list
+    void pushStart(uint32_t startIndex, double fCost);
+
+    //! \brief Pops the next node to process from the open list. Outdated entries are skipped. Returns
+    //! false if the open list is empty
+    bool popOpen(uint32_t& index);
+
+    //! \brief Processes the neighbors of the given node. heuristic(x, y) gives the estimated cost
+    //! from the tile at (x, y) to the destination
+    template<typename AccessFunc, typename SpeedFunc, typename HeuristicFunc>
+    void expandNode(uint32_t index, AccessFunc& access, SpeedFunc& moveSpeed, HeuristicFunc& heuristic);
+};
+
+template<typename AccessFunc, typename SpeedFunc, typename HeuristicFunc>
+void PathfindingEngine::expandNode(uint32_t index, AccessFunc& access, SpeedFunc& moveSpeed, HeuristicFunc& heuristic)
+{
+    // Offsets of the neighbors. The 4 adjacent tiles are processed first, then the diagonals
+    static const int NEIGHBOR_DX[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static const int NEIGHBOR_DY[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+    // For each diagonal, the 2 adjacent tiles that have to be walkable
+    static const int DIAGONAL_REQ1[4] = {0, 0, 1, 1};
+    static const int DIAGONAL_REQ2[4] = {2, 3, 2, 3};
+
+    const Node& current = mNodes[index];
+    const int curX = indexToX(index);
+    const int curY = indexToY(index);
+    // The speed only depends on the current tile so we compute it once
+    const double speed = moveSpeed(curX, curY);
+
+    bool areTilesPassable[4] = {false, false, false, false};
+    for(int i = 0; i < 8; ++i)
+    {
+        if((i >= 4) && (!areTilesPassable[DIAGONAL_REQ1[i - 4]] || !areTilesPassable[DIAGONAL_REQ2[i - 4]]))
+            continue;
+
+        const int nX = curX + NEIGHBOR_DX[i];
+        const int nY = curY + NEIGHBOR_DY[i];
+        if((nX < 0) || (nX >= mSizeX) || (nY < 0) || (nY >= mSizeY))
+            continue;
+
+        const uint32_t nIndex = toIndex(nX, nY);
+        PathfindingAccess nAccess = (nIndex == mStartIndex) ? PathfindingAccess::walkable : access(nX, nY);
+        if(nAccess == PathfindingAccess::blocked)
+            continue;
+
+        if((i < 4) && (nAccess == PathfindingAccess::walkable))
+            areTilesPassable[i] = true;
+
+        Node& neighbor = mNodes[nIndex];
+        const bool isKnown = (neighbor.mGeneration == mGeneration);
+        if(isKnown && neighbor.mProcessed)
+            continue;
+
+        double g = current.mG + computeHeuristic(nX, nY, curX, curY) / speed;
+        if(isKnown && (g >= neighbor.mG))
+            continue;
+
+        neighbor.mG = g;
+        neighbor.mParent = index;
+        neighbor.mGeneration = mGeneration;
+        neighbor.mProcessed = false;
+        pushOpen(nIndex, g + heuristic(nX, nY));
+    }
+}
+
+template<typename AccessFunc, typename SpeedFunc>
+bool PathfindingEngine::findPath(int x1, int y1, int x2, int y2, AccessFunc access, SpeedFunc moveSpeed,
+    std::vector<uint32_t>& path)
+{
+    path.clear();
+    if((x1 < 0) || (x1 >= mSizeX) || (y1 < 0) || (y1 >= mSizeY))
+        return false;
+    if((x2 < 0) || (x2 >= mSizeX) || (y2 < 0) || (y2 >= mSizeY))
+        return false;
+
+    beginSearch();
+
+    const uint32_t destIndex = toIndex(x2, y2);
+    pushStart(toIndex(x1, y1), computeHeuristic(x1, y1, x2, y2));
+
+    auto heuristic = [x2, y2](int x, int y)
+    {
+        return computeHeuristic(x, y, x2, y2);
+    };
+
+    uint32_t index;
+    while(popOpen(index))
+    {
+        if(index == destIndex)
+            return buildPath(destIndex, path);
+
+        expandNode(index, access, moveSpeed, heuristic);
+    }
+
+    return false;
+}
+
+template<typename AccessFunc, typename SpeedFunc>
+uint32_t PathfindingEngine::findNearestTargets(int x1, int y1, const std::vector<uint32_t>& targets, uint32_t maxTargets,
+    AccessFunc access, SpeedFunc moveSpeed, std::vector<uint32_t>& foundTargets)
+{
+    foundTargets.clear();
+    if((x1 < 0) || (x1 >= mSizeX) || (y1 < 0) || (y1 >= mSizeY))
+        return 0;
+    if(targets.empty() || (maxTargets == 0))
+        return 0;
+
+    beginSearch();
+
+    // We mark the targets so that checking if a node is one of them is cheap
+    uint32_t nbTargets = 0;
+    for(uint32_t target : targets)
+    {
+        if(target >= mNodes.size())
+            continue;
+
+        Node& node = mNodes[target];
+        if(node.mTargetGeneration == mGeneration)
+            continue;
+
+        node.mTargetGeneration = mGeneration;
+        ++nbTargets;
+    }
+    maxTargets = std::min(maxTargets, nbTargets);
+    if(maxTargets == 0)
+        return 0;
+
+    pushStart(toIndex(x1, y1), 0.0);
+
+    // No heuristic: the nodes are processed in walking cost order
+    auto heuristic = [](int, int)
+    {
+        return 0.0;
+    };
+
+    uint32_t index;
+    while(popOpen(index))
+    {
+        if(mNodes[index].mTargetGeneration == mGeneration)
+        {
+            foundTargets.push_back(index);
+            if(foundTargets.size() >= maxTargets)
+                break;
+        }
+
+        expandNode(index, access, moveSpeed, heuristic);
+    }
+
+    return static_cast<uint32_t>(foundTargets.size());
+}
+
+#endif // PATHFINDINGENGINE_H
@@ -18,16 +18,26 @@
 #ifndef TILECONTAINER_H
 #define TILECONTAINER_H
 
+#include "gamemap/VisibilityKernel.h"
+
 #include <cassert>
 #include <list>
 #include <vector>
 
+class GameMap;
 class ODPacket;
-class TileDistance;
 class Tile;
 
+enum class FloodFillType;
 enum class TileType;
 
+/*! \brief Stores the tiles of the map.
+ *
+ * The Tile objects are constructed in place in one slab, row-major (index = y * sizeX + x), when the
+ * map memory is allocated and live until it is cleared. The fields read by the whole map passes are
+ * only stored here, in packed arrays indexed the same way: the Tile getters read them (type and
+ * fullness) and the floodfill colors are only accessed through getFloodFillColors.
+ */
 class TileContainer
 {
 public:
@@ -37,26 +47,62 @@ public:
     //! \brief Clears the mesh and deletes the data structure for all the tiles in the TileContainer.
     void clearTiles();
 
-    //! \brief Adds the given tile on map. The tile coordinates members must be ready.
-    //! \returns true if added.
-    bool addTile(Tile* t);
-
     //! \brief Adds the address of a new tile to be stored in this TileContainer.
     void setTileNeighbors(Tile *t);
 
     //! \brief Returns a pointer to the tile at location (x, y) (const version).
     inline Tile* getTile(int xx, int yy) const
     {
-        assert(mTiles != nullptr);
-
         if (xx < getMapSizeX() && yy < getMapSizeY() && xx >= 0 && yy >= 0)
-            return mTiles[xx][yy];
+            return mTiles[getTileIndex(xx, yy)];
         else
         {
             return nullptr;
         }
     }
 
+    //! \brief Returns the index of the tile at location (x, y) in the tile arrays. The coordinates are not checked
+    inline uint32_t getTileIndex(int xx, int yy) const
+    { return static_cast<uint32_t>(yy * mMapSizeX + xx); }
+
+    //! \brief Returns all the tiles of the map ordered by index (row by row)
+    inline const std::vector<Tile*>& getTiles() const
+    { return mTiles; }
+
+    //! \brief Type and fullness of the tiles (same index as getTiles). They are only stored here
+    inline TileType getTileType(uint32_t index) const
+    { return mTileTypes[index]; }
+
+    inline void setTileType(uint32_t index, TileType type)
+    { mTileTypes[index] = type; }
+
+    inline double getTileFullness(uint32_t index) const
+    { return mTileFullness[index]; }
+
+    inline void setTileFullness(uint32_t index, double fullness)
+    { mTileFullness[index] = fullness; }
+
+    inline const std::vector<TileType>& getTileTypes() const
+    { return mTileTypes; }
+
+    inline const std::vector<double>& getTileFullness() const
+    { return mTileFullness; }
+
+    //! \brief Sets the number of teams (including the rogue team) the floodfill colors are stored for. The colors
+    //! of every tile are reset
+    void setFloodFillTeamsNumber(uint32_t nbTeams);
+
+    //! \brief Returns the floodfill colors of every tile (same index as getTiles) for the given team index and
+    //! floodfill type or nullptr if there is no such team
+    uint32_t* getFloodFillColors(uint32_t teamIndex, FloodFillType type);
+    const uint32_t* getFloodFillColors(uint32_t teamIndex, FloodFillType type) const;
+
+    //! \brief Sets every floodfill color of every tile to Tile::NO_FLOODFILL
+    void resetFloodFillColors();
+
+    //! \brief Copies the floodfill colors of the given team to every other team
+    void copyFloodFillColorsToOtherTeams(uint32_t teamIndex);
+
     //! \brief This functions exports the needed to retrieve a tile for networking.
     //! The tile informations are not embedded, only the needed to identify the tile
     void tileToPacket(ODPacket& packet, Tile* tile) const;
@@ -69,6 +115,9 @@ public:
     //! surrounding the given point and extending outward to the specified radius.
     std::vector<Tile*> circularRegion(int x, int y, int radius);
 
+    //! \brief Same as above but fills the given vector (that is cleared first)
+    void circularRegion(int x, int y, int radius, std::vector<Tile*>& tiles);
+
     //! \brief Returns a vector of all the valid tiles which are a neighbor
     //! to one or more tiles in the specified region,
     //! i.e. the "perimeter" of the region extended out one tile.
@@ -84,19 +133,27 @@ public:
     int getMapSizeY() const
     { return mMapSizeY; }
 
-    /*! \brief Returns a list of valid tiles along a straight line from (x1, y1) to (x2, y2)
+    /*! \brief Fills tiles (that is cleared first) with the valid tiles along a straight line from (x1, y1) to (x2, y2)
      * independently from their fullness or type.
      *
      * This algorithm is from
      * http://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
      * A more detailed description of how it works can be found there.
      */
-    std::list<Tile*> tilesBetween(int x1, int y1, int x2, int y2) const;
+    void tilesBetween(int x1, int y1, int x2, int y2, std::vector<Tile*>& tiles) const;
 
     //! \brief Returns the tiles visible from the given start tile within radius. The tiles are ordered from the closest to
     //! the furthest
     std::vector<Tile*> visibleTiles(int x, int y, int radius);
 
+    //! \brief Same as above but fills the given vector (that is cleared first). Reusing the same vector
+    //! avoids memory allocations
+    void visibleTiles(int x, int y, int radius, std::vector<Tile*>& tiles);
+
+    //! \brief Should be called when the given tile may have started or stopped blocking vision.
+    //! The opacity used by visibleTiles will be refreshed before the next computation
+    void tileOpacityChanged(Tile* tile);
+
 protected:
     //! \brief The map size
     int mMapSizeX;
@@ -104,20 +161,39 @@ protected:
 
     int mRr;
 
-    //! \brief Set the map size and memory
-    bool allocateMapMemory(int xSize, int ySize);
+    //! \brief Set the map size and memory. Every tile is constructed as a full dirt tile
+    bool allocateMapMemory(GameMap* gameMap, int xSize, int ySize);
 private:
-    Tile*** mTiles;
+    //! \brief Storage of the Tile objects, ordered by index (see getTileIndex)
+    Tile* mTileSlab;
+
+    //! \brief The tiles ordered by index. They point to mTileSlab
+    std::vector<Tile*> mTiles;
+
+    //! \brief Hot fields of the tiles (see getTileType)
+    std::vector<TileType> mTileTypes;
+    std::vector<double> mTileFullness;
+
+    //! \brief Floodfill colors. There is one array of getTiles().size() colors for each team and floodfill type
+    //! (see getFloodFillColors)
+    std::vector<uint32_t> mFloodFillColors;
+    uint32_t mNbFloodFillTeams;
+
+    //! \brief Precomputed tables used by circularRegion and visibleTiles. It also stores the
+    //! tiles blocking vision
+    VisibilityKernel mVisibilityKernel;
+
+    //! \brief true if the opacity of every tile has been set in mVisibilityKernel
+    bool mIsOpacityBuilt;
 
-    //! \brief Fills mTileDistance that will help to compute a vector with sorted Tiles more efficiently
-    void buildTileDistance(int distance);
+    //! \brief Tiles whose opacity has to be refreshed before the next visibleTiles computation
+    std::vector<Tile*> mTilesOpacityChanged;
 
-    //! \brief Helper to compute tile distances more efficiently
-    std::vector<TileDistance> mTileDistance;
+    //! \brief Buffer reused by visibleTiles
+    std::vector<uint32_t> mVisibleTileIndexes;
 
-    //! \brief Stores the highest distance computed. If a bigger distance is asked, mTileDistance will have to be updated by
-    //! calling buildTileDistance with the higher distance
-    int mTileDistanceComputed;
+    //! \brief Updates the opacity in mVisibilityKernel from the tiles
+    void refreshOpacity();
 };
 
 #endif //TILECONTAINER_H
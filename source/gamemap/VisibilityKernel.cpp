@@ -0,0 +1,411 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/VisibilityKernel.h"
+
+#include <algorithm>
+
+namespace
+{
+//! \brief Transformations from an offset (0 <= y <= x) to the 8 parts of the circle. For the part k,
+//! the tile is at (x + X_FROM_X[k] * diffX + X_FROM_Y[k] * diffY, y + Y_FROM_X[k] * diffX + Y_FROM_Y[k] * diffY).
+//! They are processed in this order (c being the center tile):
+//! 514
+//! 2c0
+//! 637
+const int X_FROM_X[8] = { 1,  0, -1,  0,  0,  1,  0, -1};
+const int X_FROM_Y[8] = { 0,  1,  0, -1,  1,  0, -1,  0};
+const int Y_FROM_X[8] = { 0, -1,  0,  1,  1,  0, -1,  0};
+const int Y_FROM_Y[8] = { 1,  0, -1,  0,  0, -1,  0,  1};
+
+bool sortByDistSquared(const VisibilityKernel::Offset& offset1, const VisibilityKernel::Offset& offset2)
+{
+    return offset1.mDistSquared < offset2.mDistSquared;
+}
+}
+
+VisibilityKernel::VisibilityKernel() :
+    mSizeX(0),
+    mSizeY(0),
+    mRadiusComputed(-1)
+{
+}
+
+void VisibilityKernel::setMapSize(int sizeX, int sizeY)
+{
+    mSizeX = sizeX;
+    mSizeY = sizeY;
+    size_t nbTiles = static_cast<size_t>(sizeX) * static_cast<size_t>(sizeY);
+    mOpacity.assign((nbTiles + 63) / 64, 0);
+}
+
+uint32_t VisibilityKernel::getNbOffsets(int radius) const
+{
+    if(radius < 0)
+        return 0;
+
+    if(radius > mRadiusComputed)
+        return static_cast<uint32_t>(mOffsets.size());
+
+    return mNbOffsetsForRadius[static_cast<uint32_t>(radius)];
+}
+
+void VisibilityKernel::buildTables(int radius)
+{
+    if(mRadiusComputed >= radius)
+        return;
+
+    // We want to be able to fill a vector of tiles sorted beginning with the closest tile. If we look a grid (each letter
+    // represents a tile at the same distance from the center: a):
+    // jihghij
+    // ifedefi
+    // hecbceh
+    // gdbabdg
+    // hecbceh
+    // ifedefi
+    // jihghij
+    // We can see that there are 3 kind of tiles:
+    // - Vertical/Horizontal tiles (abdg): at each distance, there are 4 of them
+    // - Diagonal tiles (acfj): at each distance, there are 4 of them
+    // - Other tiles (ehi...): at each distance, there are 8 of them
+    // Moreover, we can see a symmetry. We can compute all tiles by computing only 1/8 tiles:
+    //    j
+    //   fi
+    //  ceh
+    // abdg
+    // If we compute only the minimum tiles needed, we have no vertical tiles (since each of them can be deduced from the horizontal)
+    mOffsets.clear();
+    mHiddenTiles.clear();
+    for(int y = 0; y <= radius; ++y)
+    {
+        for(int x = y; x <= radius; ++x)
+        {
+            OffsetType type;
+            if(y == 0)
+                type = OffsetType::horizontal;
+            else if(x == y)
+                type = OffsetType::diagonal;
+            else
+                type = OffsetType::other;
+
+            mOffsets.push_back(Offset{x, y, x * x + y * y, type, 0, 0, 0, 0});
+        }
+    }
+
+    std::sort(mOffsets.begin(), mOffsets.end(), sortByDistSquared);
+
+    // Now, we compute how each tile hides the other ones when it blocks vision. The hidden tiles
+    // are sorted by index so that the tiles out of the wanted radius can be skipped easily
+    std::vector<HiddenTile> hiddenNorth;
+    std::vector<HiddenTile> hiddenSouth;
+    for(Offset& offset : mOffsets)
+    {
+        // The center tile does not hide anything
+        if(offset.mDistSquared == 0)
+            continue;
+
+        double coefNorth = (static_cast<double>(offset.mDiffY) + 0.5) / (static_cast<double>(offset.mDiffX) - 0.5);
+        double coefSouth = (static_cast<double>(offset.mDiffY) - 0.5) / (static_cast<double>(offset.mDiffX) + 0.5);
+        hiddenNorth.clear();
+        hiddenSouth.clear();
+        for(uint32_t index = 0; index < mOffsets.size(); ++index)
+            computeHiddenTile(offset, coefNorth, coefSouth, mOffsets[index], index, hiddenNorth, hiddenSouth);
+
+        offset.mHiddenNorthBegin = static_cast<uint32_t>(mHiddenTiles.size());
+        mHiddenTiles.insert(mHiddenTiles.end(), hiddenNorth.begin(), hiddenNorth.end());
+        offset.mHiddenNorthEnd = static_cast<uint32_t>(mHiddenTiles.size());
+        offset.mHiddenSouthBegin = offset.mHiddenNorthEnd;
+        mHiddenTiles.insert(mHiddenTiles.end(), hiddenSouth.begin(), hiddenSouth.end());
+        offset.mHiddenSouthEnd = static_cast<uint32_t>(mHiddenTiles.size());
+    }
+
+    mNbOffsetsForRadius.assign(static_cast<uint32_t>(radius) + 1, 0);
+    for(int r = 0; r <= radius; ++r)
+    {
+        int radiusSquared = r * r;
+        uint32_t nbOffsets = 0;
+        while((nbOffsets < mOffsets.size()) && (mOffsets[nbOffsets].mDistSquared <= radiusSquared))
+            ++nbOffsets;
+
+        mNbOffsetsForRadius[static_cast<uint32_t>(r)] = nbOffsets;
+    }
+
+    mRadiusComputed = radius;
+}
+
+void VisibilityKernel::computeHiddenTile(const Offset& offset, double coefNorth, double coefSouth, const Offset& hidden,
+    uint32_t hiddenIndex, std::vector<HiddenTile>& hiddenNorth, std::vector<HiddenTile>& hiddenSouth)
+{
+    // A tile can only hide tiles behind (x > tile.x and y > tile.y)
+    if(hidden.mDiffX < offset.mDiffX)
+        return;
+    if(hidden.mDiffY < offset.mDiffY)
+        return;
+
+    // We don't want a tile to hide itself
+    if((hidden.mDiffX == offset.mDiffX) &&
+       (hidden.mDiffY == offset.mDiffY))
+    {
+        return;
+    }
+
+    double xTileDeb = static_cast<double>(hidden.mDiffX) - 0.5;
+    double xTileEnd = xTileDeb + 1.0;
+    double yTileDeb = static_cast<double>(hidden.mDiffY) - 0.5;
+    double yTileEnd = yTileDeb + 1.0;
+
+    if(offset.mType == OffsetType::horizontal)
+    {
+        // For horizontal tiles, we hide following tiles (x > tile.x). But we process
+        // north tiles normally
+        if(hidden.mType == OffsetType::horizontal)
+        {
+            hiddenSouth.push_back(HiddenTile{hiddenIndex, 1.0});
+            return;
+        }
+
+        double yHideDebNorth = coefNorth * xTileDeb;
+        double yHideEndNorth = coefNorth * xTileEnd;
+
+        // If the tile is over the North ray, it is not hidden
+        if(yHideEndNorth <= yTileDeb)
+            return;
+
+        // We check which part of the tile is hidden
+        if((yHideDebNorth >= yTileDeb) &&
+           (yHideEndNorth <= yTileEnd))
+        {
+            // The ray hits the left side of the tile and the right side.
+            // The south part is partially hidden
+            double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+            hiddenArea += yHideDebNorth - yTileDeb;
+            hiddenSouth.push_back(HiddenTile{hiddenIndex, hiddenArea});
+        }
+        else if((yHideDebNorth < yTileDeb) &&
+                (yHideEndNorth > yTileDeb))
+        {
+            // The ray hits the bottom side of the tile but hits the right side. We compute
+            // the south visible part
+            double xHit = yTileDeb / coefNorth;
+            double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+            hiddenSouth.push_back(HiddenTile{hiddenIndex, hiddenArea});
+        }
+        else if((yHideDebNorth < yTileEnd) &&
+                (yHideEndNorth > yTileEnd))
+        {
+            // The ray hits the left side of the tile but is over the right side. We compute
+            // the hidden part on north.
+            double xHit = yTileEnd / coefNorth;
+            double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+            hiddenSouth.push_back(HiddenTile{hiddenIndex, 1.0 - visibleArea});
+        }
+        else
+        {
+            // The entire tile is hidden
+            hiddenSouth.push_back(HiddenTile{hiddenIndex, 1.0});
+        }
+
+        return;
+    }
+
+    // We check if the current tile is hidden by the tile. To consider that the
+    // tile is hidden by the south, as we know the angle will be between 0 and 45 degrees,
+    // we consider that the tile has to be hit by the ray passing through the hiding tile
+    // on the left side of the tile (otherwise, the hidden part will be too small).
+    double yHideDebSouth = coefSouth * xTileDeb;
+    double yHideEndSouth = coefSouth * xTileEnd;
+    double yHideDebNorth = coefNorth * xTileDeb;
+    double yHideEndNorth = coefNorth * xTileEnd;
+    // We check if at least a part of the tile is hidden
+    if((yHideDebSouth >= yTileEnd) ||
+       (yHideEndNorth <= yTileDeb))
+    {
+        return;
+    }
+
+    if((yHideDebSouth >= yTileDeb) &&
+       (yHideEndSouth <= yTileEnd))
+    {
+        // The ray hits the left side of the tile and the right side.
+        // The south part is partially hidden
+        // The visible part is composed from a square between the tile inferior part and
+        // the triangle made by the ray
+        double visibleArea = (yHideEndSouth - yHideDebSouth) / 2.0;
+        visibleArea += yHideDebSouth - yTileDeb;
+        hiddenNorth.push_back(HiddenTile{hiddenIndex, 1.0 - visibleArea});
+    }
+    else if((yHideDebSouth < yTileDeb) &&
+            (yHideEndSouth > yTileDeb))
+    {
+        // The ray hits the bottom side of the tile but hits the right side. We compute
+        // the south visible part
+        double xHit = yTileDeb / coefSouth;
+        double visibleArea = (yHideEndSouth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+        hiddenNorth.push_back(HiddenTile{hiddenIndex, 1.0 - visibleArea});
+    }
+    else if((yHideDebSouth < yTileEnd) &&
+            (yHideEndSouth > yTileEnd))
+    {
+        // The ray hits the left side of the tile but is over the right side. We compute
+        // the hidden part on north.
+        double xHit = yTileEnd / coefSouth;
+        double hiddenArea = (yTileEnd - yHideDebSouth) * (xHit - xTileDeb) / 2.0;
+        hiddenNorth.push_back(HiddenTile{hiddenIndex, hiddenArea});
+    }
+    else if((yHideDebNorth >= yTileDeb) &&
+            (yHideEndNorth <= yTileEnd))
+    {
+        double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+        hiddenArea += yHideDebNorth - yTileDeb;
+        hiddenSouth.push_back(HiddenTile{hiddenIndex, hiddenArea});
+    }
+    else if((yHideDebNorth < yTileDeb) &&
+            (yHideEndNorth > yTileDeb))
+    {
+        // The ray hits the bottom side of the tile but hits the right side. We compute
+        // the south visible part
+        double xHit = yTileDeb / coefNorth;
+        double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+        hiddenSouth.push_back(HiddenTile{hiddenIndex, hiddenArea});
+    }
+    else if((yHideDebNorth < yTileEnd) &&
+            (yHideEndNorth > yTileEnd))
+    {
+        // The ray hits the left side of the tile but is over the right side. We compute
+        // the hidden part on north.
+        double xHit = yTileEnd / coefNorth;
+        double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+        hiddenSouth.push_back(HiddenTile{hiddenIndex, 1.0 - visibleArea});
+    }
+    else
+    {
+        // The entire tile is hidden
+        hiddenSouth.push_back(HiddenTile{hiddenIndex, 1.0});
+    }
+}
+
+template<bool CheckBounds>
+void VisibilityKernel::applyOpacity(int x, int y, uint32_t nbOffsets)
+{
+    for(uint32_t k = 0; k < 8; ++k)
+    {
+        int32_t* tileIndexes = &mTileIndexes[k * nbOffsets];
+        double* hiddenNorth = &mHiddenNorth[k * nbOffsets];
+        double* hiddenSouth = &mHiddenSouth[k * nbOffsets];
+        for(uint32_t i = 0; i < nbOffsets; ++i)
+        {
+            const Offset& offset = mOffsets[i];
+            int tileX = x + X_FROM_X[k] * offset.mDiffX + X_FROM_Y[k] * offset.mDiffY;
+            int tileY = y + Y_FROM_X[k] * offset.mDiffX + Y_FROM_Y[k] * offset.mDiffY;
+            if(CheckBounds && ((tileX < 0) || (tileX >= mSizeX) || (tileY < 0) || (tileY >= mSizeY)))
+            {
+                tileIndexes[i] = -1;
+                continue;
+            }
+
+            int32_t index = tileY * mSizeX + tileX;
+            tileIndexes[i] = index;
+            uint32_t bit = static_cast<uint32_t>(index);
+            if(((mOpacity[bit / 64] >> (bit % 64)) & 1) == 0)
+                continue;
+
+            // The tile blocks vision. We process the tiles it hides. We only keep the highest value.
+            // Since the hidden tiles are sorted, we can stop at the first one out of the radius
+            for(uint32_t h = offset.mHiddenNorthBegin; h < offset.mHiddenNorthEnd; ++h)
+            {
+                const HiddenTile& hidden = mHiddenTiles[h];
+                if(hidden.mIndex >= nbOffsets)
+                    break;
+
+                if(hidden.mHiddenValue > hiddenNorth[hidden.mIndex])
+                    hiddenNorth[hidden.mIndex] = hidden.mHiddenValue;
+            }
+            for(uint32_t h = offset.mHiddenSouthBegin; h < offset.mHiddenSouthEnd; ++h)
+            {
+                const HiddenTile& hidden = mHiddenTiles[h];
+                if(hidden.mIndex >= nbOffsets)
+                    break;
+
+                if(hidden.mHiddenValue > hiddenSouth[hidden.mIndex])
+                    hiddenSouth[hidden.mIndex] = hidden.mHiddenValue;
+            }
+        }
+    }
+}
+
+void VisibilityKernel::computeVisibleTiles(int x, int y, int radius, std::vector<uint32_t>& visibleTiles)
+{
+    visibleTiles.clear();
+    if((x < 0) || (x >= mSizeX) || (y < 0) || (y >= mSizeY))
+        return;
+    if(radius < 0)
+        radius = 0;
+
+    buildTables(radius);
+    const uint32_t nbOffsets = getNbOffsets(radius);
+    const size_t nbValues = 8 * static_cast<size_t>(nbOffsets);
+    if(mTileIndexes.size() < nbValues)
+    {
+        mTileIndexes.resize(nbValues);
+        mHiddenNorth.resize(nbValues);
+        mHiddenSouth.resize(nbValues);
+    }
+    std::fill(mHiddenNorth.begin(), mHiddenNorth.begin() + nbValues, 0.0);
+    std::fill(mHiddenSouth.begin(), mHiddenSouth.begin() + nbValues, 0.0);
+
+    // Most of the time, the whole circle is on the map and we don't need to check the bounds
+    if((x - radius >= 0) && (x + radius < mSizeX) && (y - radius >= 0) && (y + radius < mSizeY))
+        applyOpacity<false>(x, y, nbOffsets);
+    else
+        applyOpacity<true>(x, y, nbOffsets);
+
+    // Now, we process all the tiles. Note that horizontal tiles are common for 2 consecutive
+    // parts and that diagonal tiles should be merged
+    for(uint32_t i = 0; i < nbOffsets; ++i)
+    {
+        const Offset& offset = mOffsets[i];
+        for(uint32_t k = 0; k < 8; ++k)
+        {
+            // We avoid adding several times the center tile
+            if((k > 0) && (offset.mDistSquared == 0))
+                continue;
+
+            // Because horizontal tiles are common, we don't process them for the 4 last parts.
+            // Diagonal tiles will be merged for the 4 first parts
+            if((k > 3) && (offset.mType != OffsetType::other))
+                continue;
+
+            int32_t index = mTileIndexes[k * nbOffsets + i];
+            if(index < 0)
+                continue;
+
+            double hiddenNorth = mHiddenNorth[k * nbOffsets + i];
+            double hiddenSouth = mHiddenSouth[k * nbOffsets + i];
+            if(offset.mType == OffsetType::diagonal)
+            {
+                // Because the mirrored parts are inverted, south hidden value becomes north and vice-versa
+                hiddenNorth = std::max(hiddenNorth, mHiddenSouth[(k + 4) * nbOffsets + i]);
+                hiddenSouth = std::max(hiddenSouth, mHiddenNorth[(k + 4) * nbOffsets + i]);
+            }
+
+            if((hiddenNorth + hiddenSouth) > 0.5)
+                continue;
+
+            visibleTiles.push_back(static_cast<uint32_t>(index));
+        }
+    }
+}
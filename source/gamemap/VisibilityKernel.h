@@ -0,0 +1,138 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VISIBILITYKERNEL_H
+#define VISIBILITYKERNEL_H
+
+#include <cstdint>
+#include <vector>
+
+/*! \brief Computes the tiles visible from a given tile on the map grid.
+ *
+ * The vision is computed on 1/8 of the circle (0 <= y <= x) and mirrored to the 7 other parts. For each tile
+ * offset of this part, the list of offsets it hides (and how much of them) is computed once and stored in flat
+ * tables sorted by distance. A tile is visible if less than half of it is hidden by the tiles blocking vision.
+ *
+ * The tiles blocking vision are stored in a bitmap (1 bit per tile) that the owner has to keep up to date with
+ * setOpaque. The visible tiles are returned as tile indexes (y * sizeX + x) in a caller supplied buffer. Once the
+ * tables and the scratch buffers are allocated for the wanted radius, computing the visible tiles does not allocate.
+ */
+class VisibilityKernel
+{
+public:
+    //! \brief Type of a tile offset. Horizontal offsets (y = 0) are shared between 2 consecutive parts of the
+    //! circle, diagonal offsets (x = y) are shared between 2 mirrored parts. The others are only in one part.
+    enum class OffsetType : uint8_t
+    {
+        horizontal,
+        diagonal,
+        other
+    };
+
+    //! \brief Offset (with 0 <= y <= x) of a tile relative to the center
+    struct Offset
+    {
+        int32_t mDiffX;
+        int32_t mDiffY;
+        int32_t mDistSquared;
+        OffsetType mType;
+        //! \brief Range of the hidden tiles (in mHiddenTiles) north and south of the tile
+        uint32_t mHiddenNorthBegin;
+        uint32_t mHiddenNorthEnd;
+        uint32_t mHiddenSouthBegin;
+        uint32_t mHiddenSouthEnd;
+    };
+
+    VisibilityKernel();
+
+    //! \brief Makes sure the tables are computed for at least the given radius. If a bigger radius
+    //! than the computed one is needed, the tables are computed again
+    void buildTables(int radius);
+
+    //! \brief Sets the map size. Every tile is considered as not blocking vision.
+    void setMapSize(int sizeX, int sizeY);
+
+    inline void setOpaque(int x, int y, bool opaque)
+    {
+        uint32_t index = static_cast<uint32_t>(y * mSizeX + x);
+        if(opaque)
+            mOpacity[index / 64] |= (static_cast<uint64_t>(1) << (index % 64));
+        else
+            mOpacity[index / 64] &= ~(static_cast<uint64_t>(1) << (index % 64));
+    }
+
+    inline bool isOpaque(int x, int y) const
+    {
+        uint32_t index = static_cast<uint32_t>(y * mSizeX + x);
+        return ((mOpacity[index / 64] >> (index % 64)) & 1) != 0;
+    }
+
+    //! \brief Returns the number of offsets within the given radius. The offsets are sorted by distance
+    //! so the offsets within the radius are the first ones. buildTables should have been called with
+    //! at least this radius.
+    uint32_t getNbOffsets(int radius) const;
+
+    inline const Offset& getOffset(uint32_t index) const
+    { return mOffsets[index]; }
+
+    /*! \brief Fills visibleTiles with the indexes of the tiles visible from (x, y) within radius. The tiles
+     * are ordered from the closest to the furthest. The tiles outside the map are ignored. The center tile
+     * is always visible.
+     */
+    void computeVisibleTiles(int x, int y, int radius, std::vector<uint32_t>& visibleTiles);
+
+private:
+    struct HiddenTile
+    {
+        //! \brief Index of the hidden offset in mOffsets
+        uint32_t mIndex;
+        //! \brief Part of the tile that is hidden (between 0 and 1)
+        double mHiddenValue;
+    };
+
+    int mSizeX;
+    int mSizeY;
+
+    //! \brief Highest radius the tables have been computed for
+    int mRadiusComputed;
+
+    std::vector<Offset> mOffsets;
+    std::vector<HiddenTile> mHiddenTiles;
+
+    //! \brief Number of offsets within each radius (indexed by radius)
+    std::vector<uint32_t> mNbOffsetsForRadius;
+
+    //! \brief 1 bit per tile (index = y * sizeX + x). 1 if the tile blocks vision
+    std::vector<uint64_t> mOpacity;
+
+    //! \brief Scratch buffers used during the computation. They contain 8 parts (one for each
+    //! part of the circle) of nbOffsets values
+    std::vector<int32_t> mTileIndexes;
+    std::vector<double> mHiddenNorth;
+    std::vector<double> mHiddenSouth;
+
+    //! \brief Computes how the tile at offset hides the tile at hidden offset and adds it to the given lists
+    static void computeHiddenTile(const Offset& offset, double coefNorth, double coefSouth, const Offset& hidden,
+        uint32_t hiddenIndex, std::vector<HiddenTile>& hiddenNorth, std::vector<HiddenTile>& hiddenSouth);
+
+    //! \brief Fills mTileIndexes and the hidden values for the 8 parts of the circle. If CheckBounds is false,
+    //! the whole circle is known to be on the map
+    template<bool CheckBounds>
+    void applyOpacity(int x, int y, uint32_t nbOffsets);
+};
+
+#endif // VISIBILITYKERNEL_H
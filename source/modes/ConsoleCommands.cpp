@@ -15,6 +15,8 @@
 #include "utils/ConfigManager.h"
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
+#include "utils/ResourceManager.h"
+#include "utils/TurnProfiler.h"
 
 #include <OgreCamera.h>
 #include <OgreSceneManager.h>
@@ -45,6 +47,7 @@ const std::string HELPMESSAGE =
         "\n\ticanseedeadpeople - Toggles on/off fog of war for every connected player."
         "\n\n==Developer\'s options=="
         "\n\tfps - Sets the maximum framerate cap."
+        "\n\tframetimes - Displays the frame time percentiles."
         "\n\tambientlight - Sets the ambient light color."
         "\n\tnearclip - Sets the near clipping distance."
         "\n\tfarclip - Sets the far clipping distance."
@@ -56,7 +59,10 @@ const std::string HELPMESSAGE =
         "\n\tcatmullspline - Triggers the catmullspline camera movement type."
         "\n\tcirclearound - Triggers the circle camera movement type."
         "\n\tsetcamerafovy - Sets the camera vertical field of view aspect ratio value."
-        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap.";
+        "\n\tlogfloodfill - Displays the FloodFillValues of all the Tiles in the GameMap."
+        "\n\tpathfindingcache - Displays the hierarchical pathfinding cache statistics."
+        "\n\tclientlag - Displays how late the clients are on the server turns."
+        "\n\tprofiler - Enables the server turn profiler and displays its timings.";
 
 //! \brief Template function to get/set a variable from the ODFrameListener object
 template<typename ValType, typename Getter, typename Setter>
@@ -150,6 +156,16 @@ Command::Result cFPS(const Command::ArgumentList_t& args, ConsoleInterface& c, A
     return Command::Result::SUCCESS;
 }
 
+Command::Result cFrameTimes(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
+{
+    FrameTimeStats& stats = ODFrameListener::getSingleton().getFrameTimeStats();
+    c.print(stats.getStatsText() + "\n");
+    if((args.size() >= 2) && (args[1] == "reset"))
+        stats.reset();
+
+    return Command::Result::SUCCESS;
+}
+
 Command::Result cSrvAddCreature(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
 {
     if (args.size() < 6)
@@ -418,6 +434,77 @@ Command::Result cSrvLogFloodFill(const Command::ArgumentList_t&, ConsoleInterfac
     return Command::Result::SUCCESS;
 }
 
+Command::Result cSrvPathfindingCache(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap& gameMap)
+{
+    bool reset = (args.size() >= 2) && (args[1] == "reset");
+    c.print(gameMap.getPathfindingCacheStats(reset) + "\n");
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvClientLag(const Command::ArgumentList_t&, ConsoleInterface& c, GameMap&)
+{
+    c.print(ODServer::getSingleton().getClientsTurnLagStats());
+    return Command::Result::SUCCESS;
+}
+
+Command::Result cSrvProfiler(const Command::ArgumentList_t& args, ConsoleInterface& c, GameMap&)
+{
+    if(args.size() < 2)
+    {
+        c.print(TurnProfiler::getStatsText() + "\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "on")
+    {
+        TurnProfiler::setEnabled(true);
+        c.print("Turn profiler enabled\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "off")
+    {
+        TurnProfiler::setEnabled(false);
+        c.print("Turn profiler disabled\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if(args[1] == "reset")
+    {
+        TurnProfiler::reset();
+        c.print("Turn profiler statistics cleared\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if((args[1] == "histogram") && (args.size() >= 3))
+    {
+        c.print(TurnProfiler::getHistogramText(args[2]) + "\n");
+        return Command::Result::SUCCESS;
+    }
+
+    if((args[1] == "trace") && (args.size() >= 3))
+    {
+        // The command may come from a client so we only allow writing in the user data folder
+        const std::string& filename = args[2];
+        if(filename.find_first_of("/\\") != std::string::npos)
+        {
+            c.print("\nERROR : The trace file name cannot contain a path\n");
+            return Command::Result::INVALID_ARGUMENT;
+        }
+
+        uint32_t nbTurns = (args.size() >= 4) ? Helper::toUInt32(args[3]) : 100;
+        if(nbTurns == 0)
+            return Command::Result::INVALID_ARGUMENT;
+
+        std::string path = ResourceManager::getSingleton().getUserDataPath() + filename;
+        TurnProfiler::startTrace(path, nbTurns);
+        c.print("The next " + Helper::toString(nbTurns) + " turns will be written to " + path + "\n");
+        return Command::Result::SUCCESS;
+    }
+
+    return Command::Result::INVALID_ARGUMENT;
+}
+
 Command::Result cSetCameraFOVy(const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&)
 {
     Ogre::Camera* cam = ODFrameListener::getSingleton().getCameraManager()->getActiveCamera();
@@ -530,6 +617,14 @@ void addConsoleCommands(ConsoleInterface& cl)
                   cFPS,
                   Command::cStubServer,
                   {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
+    cl.addCommand("frametimes",
+                  "'frametimes' displays the time between the frames and the time spent processing the server messages "
+                  "(average, median, 95th and 99th percentiles and max over the last frames, in microseconds).\n\nExample:\n"
+                  "frametimes\n"
+                  "frametimes reset (displays and clears the frame times)",
+                  cFrameTimes,
+                  Command::cStubServer,
+                  {AbstractModeManager::ModeType::GAME, AbstractModeManager::ModeType::EDITOR});
     cl.addCommand("nearclip",
                    "Sets the minimal viewpoint clipping distance. Objects nearer than that won't be rendered.\n\nE.g.: nearclip 3.0",
                    [](const Command::ArgumentList_t& args, ConsoleInterface& c, AbstractModeManager&) {
@@ -662,6 +757,34 @@ void addConsoleCommands(ConsoleInterface& cl)
                    cSrvLogFloodFill,
                    {AbstractModeManager::ModeType::GAME},
                    {});
+    cl.addCommand("pathfindingcache",
+                   "'pathfindingcache' displays the hierarchical pathfinding cache statistics (queries and cluster hit rate).\n\nExample:\n"
+                   "pathfindingcache\n"
+                   "pathfindingcache reset (displays and resets the statistics)",
+                   cSendCmdToServer,
+                   cSrvPathfindingCache,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("clientlag",
+                   "'clientlag' displays, for each client, how many turns were started by the server while the client "
+                   "was late by 0, 1, 2, ... turns and how many turns it held back by being more than MaxClientTurnLag "
+                   "turns late.",
+                   cSendCmdToServer,
+                   cSrvClientLag,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
+    cl.addCommand("profiler",
+                   "'profiler' displays the time spent by the server in each part of the turns (average, median, 95th "
+                   "percentile and max over the last turns, in microseconds). The profiler is disabled by default.\n\nExample:\n"
+                   "profiler on (starts recording the timings)\n"
+                   "profiler off\n"
+                   "profiler reset (clears the timings)\n"
+                   "profiler histogram vision (displays the histogram of the time spent in the vision sections)\n"
+                   "profiler trace turns.json 50 (writes the next 50 turns in a Chrome trace file in the user data folder)",
+                   cSendCmdToServer,
+                   cSrvProfiler,
+                   {AbstractModeManager::ModeType::GAME},
+                   {});
     cl.addCommand("listmeshanims",
                    "'listmeshanims' lists all the animations for the given mesh.",
                    cListMeshAnims,
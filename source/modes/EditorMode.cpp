@@ -481,8 +481,7 @@ bool EditorMode::mousePressed(const OIS::MouseEvent &arg, OIS::MouseButtonID id)
             if(closestEntity != nullptr)
             {
                 ODClient::getSingleton().queueClientNotification(ClientNotificationType::askSlapEntity,
-                     closestEntity->getObjectType(),
-                     closestEntity->getName());
+                     closestEntity->getId());
                 return true;
             }
         }
@@ -534,8 +533,7 @@ bool EditorMode::mousePressed(const OIS::MouseEvent &arg, OIS::MouseButtonID id)
     if(closestEntity != nullptr)
     {
         ODClient::getSingleton().queueClientNotification(ClientNotificationType::askEntityPickUp,
-            closestEntity->getObjectType(),
-            closestEntity->getName());
+            closestEntity->getId());
         return true;
     }
 
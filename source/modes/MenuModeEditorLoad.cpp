@@ -27,6 +27,7 @@
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
 #include "utils/LogManager.h"
+#include "gamemap/LevelInfoIndex.h"
 #include "gamemap/MapHandler.h"
 #include "utils/ResourceManager.h"
 #include "utils/ConfigManager.h"
@@ -191,7 +192,7 @@ bool MenuModeEditorLoad::updateFilesList(const CEGUI::EventArgs&)
             std::string mapName;
             std::string mapDescription;
             bool customMapExists = findFileStemIn(officialFileList, filename);
-            if(MapHandler::getMapInfo(filename, levelInfo))
+            if(LevelInfoIndex::getSingleton().getLevelInfo(filename, levelInfo))
             {
                 mapName.clear();
                 if (customMapExists)
@@ -27,6 +27,7 @@
 #include "network/ODClient.h"
 #include "network/ServerMode.h"
 #include "utils/LogManager.h"
+#include "gamemap/LevelInfoIndex.h"
 #include "gamemap/MapHandler.h"
 #include "utils/ConfigManager.h"
 #include "utils/ResourceManager.h"
@@ -169,7 +170,7 @@ bool MenuModeSkirmish::updateFilesList(const CEGUI::EventArgs&)
             LevelInfo levelInfo;
             std::string mapName;
             std::string mapDescription;
-            if(MapHandler::getMapInfo(filename, levelInfo))
+            if(LevelInfoIndex::getSingleton().getLevelInfo(filename, levelInfo))
             {
                 mapName = levelInfo.mLevelName;
                 mapDescription = levelInfo.mLevelDescription;
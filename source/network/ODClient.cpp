@@ -35,6 +35,7 @@
 #include "modes/ModeManager.h"
 #include "network/ChatEventMessage.h"
 #include "network/ODPacket.h"
+#include "network/PacketCompression.h"
 #include "network/ServerMode.h"
 #include "network/ServerNotification.h"
 #include "render/ODFrameListener.h"
@@ -55,7 +56,8 @@ template<> ODClient* Ogre::Singleton<ODClient>::msSingleton = nullptr;
 
 ODClient::ODClient() :
     ODSocketClient(),
-    mIsPlayerConfig(false)
+    mIsPlayerConfig(false),
+    mJoinStatsPending(false)
 {
 }
 
@@ -339,6 +341,7 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
             // Now that the we have received all needed information, we can launch the requested mode
             OD_LOG_INF("Starting game map");
+            mJoinStatsPending = true;
             gameMap->setGamePaused(false);
             // Create ogre entities for the tiles, rooms, and creatures
             gameMap->createAllEntities();
@@ -433,13 +436,12 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::removeEntity:
         {
-            GameEntityType entityType;
-            std::string entityName;
-            OD_ASSERT_TRUE(packetReceived >> entityType >> entityName);
-            GameEntity* entity = gameMap->getEntityFromTypeAndName(entityType, entityName);
+            uint32_t entityId;
+            OD_ASSERT_TRUE(packetReceived >> entityId);
+            GameEntity* entity = gameMap->getEntityById(entityId);
             if(entity == nullptr)
             {
-                OD_LOG_ERR("entityType=" + Helper::toString(static_cast<int32_t>(entityType)) + ", entityName=" + entityName);
+                OD_LOG_ERR("entityId=" + Helper::toString(entityId));
                 break;
             }
 
@@ -455,6 +457,13 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
             OD_ASSERT_TRUE(packetReceived >> turnNum);
             OD_LOG_INF("Client (" + getPlayer()->getNick() + ") received turnStarted="
                 + boost::lexical_cast<std::string>(turnNum));
+            if(mJoinStatsPending)
+            {
+                mJoinStatsPending = false;
+                OD_LOG_INF("Joined the game in " + Helper::toString(getGameTimeMillis()) + " ms, received "
+                    + Helper::toString(getNbBytesReceived()) + " bytes ("
+                    + Helper::toString(getNbBytesDecoded()) + " bytes uncompressed)");
+            }
 
             gameMap->clientUpKeep(turnNum);
             // We acknowledge the new turn to the server so that he knows we are
@@ -473,19 +482,19 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::animatedObjectSetWalkPath:
         {
-            std::string objName;
+            uint32_t objId;
             std::string walkAnim;
             std::string endAnim;
             bool loopEndAnim;
             bool playIdleWhenAnimationEnds;
             uint32_t nbDest;
-            OD_ASSERT_TRUE(packetReceived >> objName >> walkAnim >> endAnim);
+            OD_ASSERT_TRUE(packetReceived >> objId >> walkAnim >> endAnim);
             OD_ASSERT_TRUE(packetReceived >> loopEndAnim >> playIdleWhenAnimationEnds >> nbDest);
 
-            MovableGameEntity *tempAnimatedObject = gameMap->getAnimatedObject(objName);
+            MovableGameEntity *tempAnimatedObject = gameMap->getAnimatedObject(objId);
             if(tempAnimatedObject == nullptr)
             {
-                OD_LOG_ERR("objName=" + objName);
+                OD_LOG_ERR("objId=" + Helper::toString(objId));
                 break;
             }
 
@@ -505,9 +514,8 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
         case ServerNotificationType::entityPickedUp:
         {
             int seatId;
-            GameEntityType entityType;
-            std::string entityName;
-            OD_ASSERT_TRUE(packetReceived >> seatId >> entityType >> entityName);
+            uint32_t entityId;
+            OD_ASSERT_TRUE(packetReceived >> seatId >> entityId);
             Player *tempPlayer = gameMap->getPlayerBySeatId(seatId);
             if(tempPlayer == nullptr)
             {
@@ -515,10 +523,10 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
                 break;
             }
 
-            GameEntity* entity = gameMap->getEntityFromTypeAndName(entityType, entityName);
+            GameEntity* entity = gameMap->getEntityById(entityId);
             if(entity == nullptr)
             {
-                OD_LOG_ERR("entityType=" + Helper::toString(static_cast<int32_t>(entityType)) + ", entityName=" + entityName);
+                OD_LOG_ERR("entityId=" + Helper::toString(entityId));
                 break;
             }
 
@@ -552,17 +560,17 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::setObjectAnimationState:
         {
-            std::string objName;
+            uint32_t objId;
             std::string animState;
             bool loop;
             bool playIdleWhenAnimationEnds;
             bool shouldSetWalkDirection;
-            OD_ASSERT_TRUE(packetReceived >> objName >> animState
+            OD_ASSERT_TRUE(packetReceived >> objId >> animState
                 >> loop >> playIdleWhenAnimationEnds >> shouldSetWalkDirection);
-            MovableGameEntity *obj = gameMap->getAnimatedObject(objName);
+            MovableGameEntity *obj = gameMap->getAnimatedObject(objId);
             if (obj == nullptr)
             {
-                OD_LOG_ERR("objName=" + objName + ", state=" + animState);
+                OD_LOG_ERR("objId=" + Helper::toString(objId) + ", state=" + animState);
                 break;
             }
 
@@ -590,18 +598,17 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
         case ServerNotificationType::entitiesRefresh:
         {
             uint32_t nbEntities;
-            GameEntityType entityType;
-            std::string entityName;
-            OD_ASSERT_TRUE(packetReceived >> nbEntities);
+            uint32_t entityId;
+            // Ids and counts are sent as variable length integers
+            OD_ASSERT_TRUE(packetReceived.readVarUInt32(nbEntities));
             while(nbEntities > 0)
             {
                 --nbEntities;
-                OD_ASSERT_TRUE(packetReceived >> entityType);
-                OD_ASSERT_TRUE(packetReceived >> entityName);
-                GameEntity* entity = gameMap->getEntityFromTypeAndName(entityType, entityName);
+                OD_ASSERT_TRUE(packetReceived.readVarUInt32(entityId));
+                GameEntity* entity = gameMap->getEntityById(entityId);
                 if(entity == nullptr)
                 {
-                    OD_LOG_ERR("entityType=" + Helper::toString(static_cast<int32_t>(entityType)) + ", entityName=" + entityName);
+                    OD_LOG_ERR("entityId=" + Helper::toString(entityId));
                     break;
                 }
 
@@ -638,14 +645,14 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::setEntityOpacity:
         {
-            std::string entityName;
+            uint32_t entityId;
             float opacity;
-            OD_ASSERT_TRUE(packetReceived >> entityName >> opacity);
+            OD_ASSERT_TRUE(packetReceived >> entityId >> opacity);
 
-            RenderedMovableEntity* entity = gameMap->getRenderedMovableEntity(entityName);
+            RenderedMovableEntity* entity = gameMap->getRenderedMovableEntityById(entityId);
             if(entity == nullptr)
             {
-                OD_LOG_ERR("entityName=" + entityName);
+                OD_LOG_ERR("entityId=" + Helper::toString(entityId));
                 break;
             }
 
@@ -804,6 +811,33 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
             break;
         }
 
+        case ServerNotificationType::refreshTilesChanges:
+        {
+            uint32_t nbTiles;
+            OD_ASSERT_TRUE(packetReceived.readVarUInt32(nbTiles));
+            std::vector<Tile*> tiles;
+            while(nbTiles > 0)
+            {
+                --nbTiles;
+                uint32_t x;
+                uint32_t y;
+                OD_ASSERT_TRUE(packetReceived.readVarUInt32(x));
+                OD_ASSERT_TRUE(packetReceived.readVarUInt32(y));
+                Tile* gameTile = gameMap->getTile(static_cast<int>(x), static_cast<int>(y));
+                if(gameTile == nullptr)
+                {
+                    // The size of the tile changes is not known so we cannot read the next tiles
+                    OD_LOG_ERR("x=" + Helper::toString(x) + ", y=" + Helper::toString(y));
+                    break;
+                }
+
+                gameTile->updateChangesFromPacket(packetReceived);
+                tiles.push_back(gameTile);
+            }
+            gameMap->refreshBorderingTilesOf(tiles);
+            break;
+        }
+
         case ServerNotificationType::markTiles:
         {
             bool digSet;
@@ -828,21 +862,20 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::carryEntity:
         {
-            std::string carrierName;
-            GameEntityType entityType;
-            std::string carriedName;
-            OD_ASSERT_TRUE(packetReceived >> carrierName >> entityType >> carriedName);
-            Creature* carrier = gameMap->getCreature(carrierName);
+            uint32_t carrierId;
+            uint32_t carriedId;
+            OD_ASSERT_TRUE(packetReceived >> carrierId >> carriedId);
+            Creature* carrier = gameMap->getCreatureById(carrierId);
             if(carrier == nullptr)
             {
-                OD_LOG_ERR("carrierName=" + carrierName);
+                OD_LOG_ERR("carrierId=" + Helper::toString(carrierId));
                 break;
             }
 
-            GameEntity* carried = gameMap->getEntityFromTypeAndName(entityType, carriedName);
+            GameEntity* carried = gameMap->getEntityById(carriedId);
             if(carried == nullptr)
             {
-                OD_LOG_ERR("entityType=" + Helper::toString(static_cast<int32_t>(entityType)) + ", carriedName=" + carriedName);
+                OD_LOG_ERR("carriedId=" + Helper::toString(carriedId));
                 break;
             }
 
@@ -854,22 +887,21 @@ bool ODClient::processMessage(ServerNotificationType cmd, ODPacket& packetReceiv
 
         case ServerNotificationType::releaseCarriedEntity:
         {
-            std::string carrierName;
-            GameEntityType entityType;
-            std::string carriedName;
+            uint32_t carrierId;
+            uint32_t carriedId;
             Ogre::Vector3 pos;
-            OD_ASSERT_TRUE(packetReceived >> carrierName >> entityType >> carriedName >> pos);
-            Creature* carrier = gameMap->getCreature(carrierName);
+            OD_ASSERT_TRUE(packetReceived >> carrierId >> carriedId >> pos);
+            Creature* carrier = gameMap->getCreatureById(carrierId);
             if(carrier == nullptr)
             {
-                OD_LOG_ERR("carrierName=" + carrierName);
+                OD_LOG_ERR("carrierId=" + Helper::toString(carrierId));
                 break;
             }
 
-            GameEntity* carried = gameMap->getEntityFromTypeAndName(entityType, carriedName);
+            GameEntity* carried = gameMap->getEntityById(carriedId);
             if(carried == nullptr)
             {
-                OD_LOG_ERR("entityType=" + Helper::toString(static_cast<int32_t>(entityType)) + ", carriedName=" + carriedName);
+                OD_LOG_ERR("carriedId=" + Helper::toString(carriedId));
                 break;
             }
 
@@ -1027,13 +1059,23 @@ bool ODClient::connect(const std::string& host, const int port, uint32_t timeout
         return false;
     }
 
+    // The compression has to be set before connecting as the packets are received in another thread
+    ConfigManager& config = ConfigManager::getSingleton();
+    bool useCompression = (config.getGameValue(Config::NETWORK_COMPRESSION, "No", false) == "Yes");
+    const std::string& dictionary = config.getPacketDictionary();
+    if(useCompression)
+        setCompression(Compression::dictionary, dictionary);
+    else
+        setCompression(Compression::none, std::string());
+
     if(!ODSocketClient::connect(host, port, timeout, outputReplayFilename))
         return false;
 
     // Send a hello request to start the conversation with the server
     ODPacket packSend;
     packSend << ClientNotificationType::hello
-        << std::string("OpenDungeons V ") + ODApplication::VERSION;
+        << std::string("OpenDungeons V ") + ODApplication::VERSION
+        << useCompression << PacketCompression::dictionaryHash(dictionary);
     send(packSend);
 
     return true;
@@ -104,6 +104,9 @@ class ODClient: public Ogre::Singleton<ODClient>,
     // true if the server told us we are allowed to configure the game. False otherwise
     bool mIsPlayerConfig;
 
+    //! \brief Set when the game starts. The time and the bytes received to join the game
+    //! are logged when the first turn is received
+    bool mJoinStatsPending;
 };
 
 template<typename ...Args>
@@ -17,6 +17,10 @@
 
 #include "network/ODPacket.h"
 
+#include "network/PacketCompression.h"
+
+#include <vector>
+
 #define OD_INT64TOINT32H(valInt64)              (static_cast<int32_t>(valInt64 >> 32))
 #define OD_INT64TOINT32L(valInt64)              (static_cast<int32_t>(valInt64))
 #define OD_INT32TOINT64(valInt32h,valInt32l)    ((((static_cast<int64_t>(valInt32h)) << 32) & static_cast<int64_t>(0xFFFFFFFF00000000)) + ((static_cast<int64_t>(valInt32l)) & static_cast<int64_t>(0x00000000FFFFFFFF)))
@@ -233,6 +237,34 @@ ODPacket& ODPacket::operator <<(const Ogre::Vector3&   data)
     return *this;
 }
 
+ODPacket& ODPacket::writeVarUInt32(uint32_t data)
+{
+    while(data >= 0x80)
+    {
+        mPacket << static_cast<uint8_t>((data & 0x7F) | 0x80);
+        data >>= 7;
+    }
+    mPacket << static_cast<uint8_t>(data);
+    return *this;
+}
+
+ODPacket& ODPacket::readVarUInt32(uint32_t& data)
+{
+    data = 0;
+    // A 32 bits value takes at most 5 bytes
+    for(uint32_t shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t byte = 0;
+        if(!(mPacket >> byte))
+            break;
+
+        data |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0)
+            break;
+    }
+    return *this;
+}
+
 ODPacket::operator bool() const
 {
     return mPacket;
@@ -248,6 +280,26 @@ void ODPacket::writePacket(int32_t timestamp, std::ofstream& os)
     int32_t bufferSize = mPacket.getDataSize();
     const char* buffer = static_cast<const char*>(mPacket.getData());
     os.write(reinterpret_cast<const char*>(&timestamp), sizeof(int32_t));
+
+    // Big packets are compressed. To stay compatible with the replays written before, the
+    // size of a compressed packet is negative and followed by the uncompressed size
+    if(static_cast<std::size_t>(bufferSize) >= PacketCompression::MIN_SIZE_TO_COMPRESS)
+    {
+        // The replay is written by the receive thread of each client
+        static thread_local PacketCompression::Compressor compressor;
+        static thread_local std::vector<char> compressed;
+        compressed.clear();
+        int32_t compressedSize = static_cast<int32_t>(compressor.compress(buffer, bufferSize, compressed));
+        if(compressedSize + static_cast<int32_t>(sizeof(int32_t)) < bufferSize)
+        {
+            int32_t size = -compressedSize;
+            os.write(reinterpret_cast<const char*>(&size), sizeof(int32_t));
+            os.write(reinterpret_cast<const char*>(&bufferSize), sizeof(int32_t));
+            os.write(compressed.data(), compressedSize);
+            return;
+        }
+    }
+
     os.write(reinterpret_cast<const char*>(&bufferSize), sizeof(int32_t));
     os.write(buffer, bufferSize);
 }
@@ -266,6 +318,30 @@ int32_t ODPacket::readPacket(std::ifstream& is)
         return -1;
 
     mPacket.clear();
+    if(packetSize < 0)
+    {
+        int32_t uncompressedSize;
+        is.read(reinterpret_cast<char*>(&uncompressedSize), sizeof(int32_t));
+        if(is.eof() || (uncompressedSize < 0))
+            return -1;
+
+        std::vector<char> compressed(static_cast<std::size_t>(-packetSize));
+        is.read(compressed.data(), compressed.size());
+        if(is.eof())
+            return -1;
+
+        std::vector<char> content;
+        if(!PacketCompression::decompress(compressed.data(), compressed.size(), std::string(),
+            static_cast<std::size_t>(uncompressedSize), content))
+        {
+            return -1;
+        }
+
+        if(!content.empty())
+            mPacket.append(content.data(), content.size());
+        return timestamp;
+    }
+
     char buffer[BUFFER_SIZE];
     while(packetSize > 0)
     {
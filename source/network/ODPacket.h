@@ -113,6 +113,13 @@ class ODPacket
         ODPacket& operator <<(const std::wstring&   data);
         ODPacket& operator <<(const Ogre::Vector3&   data);
 
+        /*! \brief Writes an unsigned integer on a variable number of bytes (7 bits per byte, the
+         * highest bit telling if another byte follows). Small values like ids or counters take
+         * 1 or 2 bytes instead of 4. It should be read with readVarUInt32
+         */
+        ODPacket& writeVarUInt32(uint32_t data);
+        ODPacket& readVarUInt32(uint32_t& data);
+
         /*! \brief Return true if there were no error exporting data (operator >>).
          * This behaviour is the same as standard C++ streams :
          * If we try to export data while the packet is empty or from incompatible types,
@@ -29,10 +29,13 @@
 #include "game/SkillManager.h"
 #include "game/SkillType.h"
 #include "game/Seat.h"
+#include "gamemap/AsyncMapSaver.h"
 #include "gamemap/GameMap.h"
+#include "gamemap/GameMapSnapshot.h"
 #include "gamemap/MapHandler.h"
 #include "modes/ConsoleCommands.h"
 #include "network/ODClient.h"
+#include "network/PacketCompression.h"
 #include "network/ServerMode.h"
 #include "network/ServerNotification.h"
 #include "rooms/RoomManager.h"
@@ -46,7 +49,9 @@
 #include "utils/Helper.h"
 #include "utils/LogManager.h"
 #include "utils/MasterServer.h"
+#include "utils/Random.h"
 #include "utils/ResourceManager.h"
+#include "utils/TurnProfiler.h"
 #include "ODApplication.h"
 
 #include <SFML/Network.hpp>
@@ -75,7 +80,8 @@ ODServer::ODServer() :
     mSeatsConfigured(false),
     mPlayerConfig(nullptr),
     mConsoleInterface(std::bind(&ODServer::printConsoleMsg, this, std::placeholders::_1)),
-    mMasterServerGameStatusUpdateTime(0)
+    mMasterServerGameStatusUpdateTime(0),
+    mMapSaver(new AsyncMapSaver)
 {
     ConsoleCommands::addConsoleCommands(mConsoleInterface);
 }
@@ -94,6 +100,7 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
     mMasterServerGameId.clear();
     mMasterServerGameStatusUpdateTime = 0.0;
     mPlayerConfig = nullptr;
+    mDictionaryCompressor.setDictionary(ConfigManager::getSingleton().getPacketDictionary());
 
     // Start the server socket listener as well as the server socket thread
     if (isConnected())
@@ -232,6 +239,75 @@ bool ODServer::startServer(const std::string& creator, const std::string& levelF
     return true;
 }
 
+bool ODServer::startSimulation(const std::string& levelFilename)
+{
+    OD_LOG_INF("Asked to launch simulation with levelFilename=" + levelFilename);
+
+    mSeatsConfigured = false;
+    mServerMode = ServerMode::ModeGameSinglePlayer;
+    mServerState = ServerState::StateConfiguration;
+    mUniqueNumberPlayer = 0;
+    GameMap* gameMap = mGameMap;
+    if (!gameMap->loadLevel(levelFilename))
+    {
+        mServerMode = ServerMode::ModeNone;
+        mServerState = ServerState::StateNone;
+        OD_LOG_ERR("Couldn't start simulation. The level file can't be loaded: " + levelFilename);
+        return false;
+    }
+
+    // Every seat is given to a Keeper AI. The faction and the team are chosen like in a
+    // single player game when they are not fixed by the level
+    const std::vector<std::string>& factions = ConfigManager::getSingleton().getFactions();
+    for(Seat* seat : gameMap->getSeats())
+    {
+        if(seat->isRogueSeat())
+            continue;
+
+        uint32_t cptFaction = 0;
+        for(const std::string& faction : factions)
+        {
+            if(seat->getFaction().compare(faction) == 0)
+                break;
+
+            ++cptFaction;
+        }
+        if(cptFaction >= factions.size())
+            cptFaction = 0;
+
+        seat->setFaction(factions[cptFaction]);
+
+        const std::vector<int>& availableTeamIds = seat->getAvailableTeamIds();
+        if(!availableTeamIds.empty())
+            seat->setTeamId(availableTeamIds.front());
+
+        Player* aiPlayer = new Player(gameMap, 0);
+        aiPlayer->setNick("Keeper AI " + KeeperAITypes::toString(KeeperAIType::normal) + " " + Helper::toString(seat->getId()));
+        gameMap->addPlayer(aiPlayer);
+        seat->setPlayer(aiPlayer);
+        gameMap->assignAI(*aiPlayer, KeeperAIType::normal);
+        seat->setMapSize(gameMap->getMapSizeX(), gameMap->getMapSizeY());
+    }
+
+    mServerState = ServerState::StateGame;
+    for(Seat* seat : gameMap->getSeats())
+        seat->initSeat();
+
+    mSeatsConfigured = true;
+    gameMap->notifySeatsConfigured();
+
+    launchGame();
+    return true;
+}
+
+void ODServer::doSimulationTurn(double timeSinceLastTurn)
+{
+    startNewTurn(timeSinceLastTurn);
+    processServerNotifications();
+    processMapSaverResults();
+    TurnProfiler::endTurn();
+}
+
 void ODServer::queueServerNotification(ServerNotification* n)
 {
     if ((n == nullptr) || (!isConnected()))
@@ -249,11 +325,27 @@ void ODServer::sendAsyncMsg(ServerNotification& notif)
 
 void ODServer::sendMsg(Player* player, ODPacket& packet)
 {
+    queueMsg(player, packet);
+    flushClients();
+}
+
+void ODServer::queueMsg(Player* player, ODPacket& packet)
+{
+    // The packet is framed once per compression mode even if it is sent to every client
+    for(std::shared_ptr<std::vector<char>>& framedPacket : mFramedPackets)
+        framedPacket.reset();
+
     if(player == nullptr)
     {
-        // If player is nullptr, we send the message to every connected player
+        // If player is nullptr, we send the message to every connected player. The clients we could not
+        // send data to will be removed so we do not frame anything for them
         for (ODSocketClient* client : mSockClients)
-            client->send(packet);
+        {
+            if(client->isSendFailed())
+                continue;
+
+            client->queueFramedData(getFramedPacket(packet, client->getCompression()));
+        }
 
         return;
     }
@@ -269,8 +361,27 @@ void ODServer::sendMsg(Player* player, ODPacket& packet)
         return;
     }
 
-    if(client != nullptr)
-        client->send(packet);
+    if((client != nullptr) && !client->isSendFailed())
+        client->queueFramedData(getFramedPacket(packet, client->getCompression()));
+}
+
+ODSocketClient::FramedData ODServer::getFramedPacket(ODPacket& packet, ODSocketClient::Compression compression)
+{
+    std::shared_ptr<std::vector<char>>& framedPacket = mFramedPackets[static_cast<std::size_t>(compression)];
+    if(framedPacket == nullptr)
+    {
+        framedPacket = std::make_shared<std::vector<char>>();
+        ODSocketClient::appendFramedPacket(packet, compression,
+            (compression == ODSocketClient::Compression::dictionary) ? mDictionaryCompressor : mCompressor,
+            *framedPacket);
+    }
+    return framedPacket;
+}
+
+void ODServer::flushClients()
+{
+    for (ODSocketClient* client : mSockClients)
+        client->flushSend();
 }
 
 void ODServer::handleConsoleCommand(Player* player, GameMap* gameMap, const std::vector<std::string>& args)
@@ -306,14 +417,31 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
     GameMap* gameMap = mGameMap;
     int64_t turn = gameMap->getTurnNumber();
 
-    // We wait until every client acknowledge the turn to start the next one. This way, we ensure
-    // synchronisation is not too bad
+    // The clients do not have to acknowledge every turn for the server to start the next one. That way,
+    // a slow client does not slow down the game for everybody. But if a client is too late, we wait
+    // for it. We also wait for every client to have processed the first turn (when the game is loaded)
+    int64_t maxLag = static_cast<int64_t>(ConfigManager::getSingleton().getMaxClientTurnLag());
     for (ODSocketClient* client : mSockClients)
     {
-        if(client->getLastTurnAck() != turn)
+        // The clients we could not send data to are about to be disconnected
+        if(client->isSendFailed())
+            continue;
+
+        int64_t lastTurnAck = client->getLastTurnAck();
+        if((turn >= 0) && (lastTurnAck < 0))
+            return;
+
+        if(turn - lastTurnAck > maxLag)
+        {
+            client->incNbTurnsHeldBack();
             return;
+        }
     }
 
+    OD_PROFILE_SCOPE("turn");
+    for (ODSocketClient* client : mSockClients)
+        client->recordTurnLag(static_cast<uint32_t>(turn - client->getLastTurnAck()));
+
     gameMap->setTurnNumber(++turn);
 
     ServerNotification* serverNotification = new ServerNotification(
@@ -326,9 +454,18 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
 
     gameMap->updateAnimations(timeSinceLastTurn);
 
-    // We notify the clients about what they got
+    // We notify the clients about what they got. As it is the full state, a client that did not
+    // process the previous one yet will only get the next one. Until then, it is not sent the entities
+    // and tiles refreshes either (see isPlayerCatchingUp)
     for (ODSocketClient* sock : mSockClients)
     {
+        OD_PROFILE_SCOPE("playerSnapshots");
+        bool catchingUp = (sock->getLastTurnAck() < sock->getLastSnapshotTurn());
+        sock->setCatchingUp(catchingUp);
+        if(catchingUp)
+            continue;
+
+        sock->setLastSnapshotTurn(turn);
         Player* player = sock->getPlayer();
         // For now, only the player whose seat changed is notified. If we need it, we could send the event to every player
         // so that they can see how far from the goals the other players are
@@ -364,7 +501,11 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
         }
     }
 
-    gameMap->updateVisibleEntities();
+    {
+        OD_PROFILE_SCOPE("visibleEntities");
+        gameMap->updateVisibleEntities();
+    }
+
     switch(mServerMode)
     {
         case ServerMode::ModeGameSinglePlayer:
@@ -386,8 +527,201 @@ void ODServer::startNewTurn(double timeSinceLastTurn)
             break;
     }
 
-    gameMap->fireRefreshEntities();
-    gameMap->processDeletionQueues();
+    {
+        OD_PROFILE_SCOPE("refreshEntities");
+        gameMap->fireRefreshEntities();
+        gameMap->processDeletionQueues();
+    }
+
+    autosaveGameMap(turn);
+}
+
+std::string ODServer::getSaveGameName() const
+{
+    const boost::filesystem::path levelPath(mGameMap->getLevelFileName());
+    std::string fileLevel = levelPath.filename().string();
+    std::string name;
+    switch(mServerMode)
+    {
+        case ServerMode::ModeGameSinglePlayer:
+            name = SAVEGAME_SKIRMISH_PREFIX + fileLevel;
+            break;
+        case ServerMode::ModeGameMultiPlayer:
+            name = SAVEGAME_MULTIPLAYER_PREFIX + fileLevel;
+            break;
+        case ServerMode::ModeGameLoaded:
+        {
+            // We look for the Skirmish or multiplayer prefix and keep it.
+            size_t indexSk = fileLevel.find(SAVEGAME_SKIRMISH_PREFIX);
+            size_t indexMp = fileLevel.find(SAVEGAME_MULTIPLAYER_PREFIX);
+            if((indexSk != std::string::npos) && (indexMp == std::string::npos))
+            {
+                // Skirmish savegame
+                name = SAVEGAME_SKIRMISH_PREFIX + fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
+            }
+            else if((indexSk == std::string::npos) && (indexMp != std::string::npos))
+            {
+                // Multiplayer savegame
+                name = SAVEGAME_MULTIPLAYER_PREFIX + fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
+            }
+            else if((indexSk != std::string::npos) && (indexMp != std::string::npos))
+            {
+                // We found both prefixes. That can happen if the name contains the other
+                // prefix. Because of filename construction, we know that the lowest is the good
+                if(indexSk < indexMp)
+                    name = SAVEGAME_SKIRMISH_PREFIX + fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
+                else
+                    name = SAVEGAME_MULTIPLAYER_PREFIX + fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
+            }
+            else
+            {
+                // We couldn't find any prefix. That's not normal
+                OD_LOG_ERR("fileLevel=" + fileLevel);
+                name = fileLevel;
+            }
+            break;
+        }
+        default:
+            OD_LOG_ERR("mode=" + Helper::toString(static_cast<int>(mServerMode)));
+            name = fileLevel;
+            break;
+    }
+    return name;
+}
+
+void ODServer::saveGameMap(const std::string& fileName, bool makeBackup, bool isAutosave)
+{
+    OD_PROFILE_SCOPE("saveSnapshot");
+    std::unique_ptr<GameMapSnapshot> snapshot(new GameMapSnapshot);
+    MapHandler::takeGameMapSnapshot(*mGameMap, *snapshot);
+    mMapSaver->save(std::move(snapshot), fileName, makeBackup, isAutosave);
+}
+
+void ODServer::autosaveGameMap(int64_t turn)
+{
+    switch(mServerMode)
+    {
+        case ServerMode::ModeGameSinglePlayer:
+        case ServerMode::ModeGameMultiPlayer:
+        case ServerMode::ModeGameLoaded:
+            break;
+        default:
+            return;
+    }
+
+    uint32_t autosaveTurns = ConfigManager::getSingleton().getAutosaveTurns();
+    if((autosaveTurns == 0) || (turn <= 0) || ((turn % autosaveTurns) != 0))
+        return;
+
+    // If the previous save is not written yet, we skip this one so that the snapshots do not pile up
+    if(mMapSaver->isBusy())
+    {
+        OD_LOG_WRN("Skipping autosave at turn " + Helper::toString(turn) + " because the previous save is still being written");
+        return;
+    }
+
+    std::string savePath = ResourceManager::getSingleton().getSaveGamePath() + "autosave-" + getSaveGameName();
+    saveGameMap(savePath, false, true);
+}
+
+void ODServer::processMapSaverResults()
+{
+    std::vector<AsyncMapSaver::Result> results;
+    mMapSaver->popResults(results);
+    for(const AsyncMapSaver::Result& result : results)
+    {
+        if(result.mIsAutosave)
+        {
+            if(result.mSuccess)
+                OD_LOG_INF("Game autosaved as " + result.mFileName + " in " + Helper::toString(result.mWriteTimeUs) + "us");
+            else
+                OD_LOG_WRN("Couldn't autosave game: " + result.mError);
+
+            continue;
+        }
+
+        std::string msg = "Map saved successfully as: " + result.mFileName;
+        if(!result.mSuccess)
+        {
+            OD_LOG_WRN(result.mError);
+            msg = "Couldn't not save map file as: " + result.mFileName + "\nPlease check logs.";
+        }
+        // We notify all the players that the game was saved successfully
+        ServerNotification notif(ServerNotificationType::chatServer, nullptr);
+        notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
+        sendAsyncMsg(notif);
+    }
+}
+
+void ODServer::launchGame()
+{
+    // The thread running the game always uses the same stream so that the game only
+    // depends on the seed and the inputs
+    Random::resetThreadStream();
+
+    GameMap* gameMap = mGameMap;
+    const std::vector<Seat*>& seats = gameMap->getSeats();
+    for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
+    {
+        for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
+        {
+            Tile* tile = gameMap->getTile(ii,jj);
+            tile->setSeats(seats);
+        }
+    }
+
+    // We set allied seats
+    for(Seat* seat : seats)
+    {
+        for(Seat* alliedSeat : seats)
+        {
+            if(alliedSeat == seat)
+                continue;
+            if(!seat->isAlliedSeat(alliedSeat))
+                continue;
+            seat->addAlliedSeat(alliedSeat);
+        }
+    }
+
+    // Every client is connected and ready, we can launch the game
+    // Send turn 0 to init the map
+    ServerNotification* serverNotification = new ServerNotification(
+        ServerNotificationType::turnStarted, nullptr);
+    serverNotification->mPacket << static_cast<int64_t>(0);
+    queueServerNotification(serverNotification);
+
+    OD_LOG_INF("Server ready, starting game");
+    gameMap->setTurnNumber(0);
+    gameMap->setGamePaused(false);
+
+    // In editor mode, we give vision on all the gamemap tiles
+    if(mServerMode == ServerMode::ModeEditor)
+    {
+        for (Seat* seat : gameMap->getSeats())
+        {
+            for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
+            {
+                for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
+                {
+                    gameMap->getTile(ii,jj)->addVision(seat);
+                }
+            }
+
+            seat->sendVisibleTiles();
+        }
+    }
+
+    gameMap->createAllEntities();
+
+    // Fill starting gold
+    for(Seat* seat : gameMap->getSeats())
+    {
+        if(seat->getPlayer() == nullptr)
+            continue;
+
+        if(seat->getGold() > 0)
+            gameMap->addGoldToSeat(seat->getGold(), seat->getId());
+    }
 }
 
 void ODServer::serverThread()
@@ -422,69 +756,7 @@ void ODServer::serverThread()
                     MasterServer::updateGame(mMasterServerGameId, MASTER_SERVER_STATUS_STARTED);
                 }
 
-                // We configure the game for launching
-                const std::vector<Seat*>& seats = gameMap->getSeats();
-                for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
-                {
-                    for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
-                    {
-                        Tile* tile = gameMap->getTile(ii,jj);
-                        tile->setSeats(seats);
-                    }
-                }
-
-                // We set allied seats
-                for(Seat* seat : seats)
-                {
-                    for(Seat* alliedSeat : seats)
-                    {
-                        if(alliedSeat == seat)
-                            continue;
-                        if(!seat->isAlliedSeat(alliedSeat))
-                            continue;
-                        seat->addAlliedSeat(alliedSeat);
-                    }
-                }
-
-                // Every client is connected and ready, we can launch the game
-                // Send turn 0 to init the map
-                ServerNotification* serverNotification = new ServerNotification(
-                    ServerNotificationType::turnStarted, nullptr);
-                serverNotification->mPacket << static_cast<int64_t>(0);
-                queueServerNotification(serverNotification);
-
-                OD_LOG_INF("Server ready, starting game");
-                gameMap->setTurnNumber(0);
-                gameMap->setGamePaused(false);
-
-                // In editor mode, we give vision on all the gamemap tiles
-                if(mServerMode == ServerMode::ModeEditor)
-                {
-                    for (Seat* seat : gameMap->getSeats())
-                    {
-                        for (int jj = 0; jj < gameMap->getMapSizeY(); ++jj)
-                        {
-                            for (int ii = 0; ii < gameMap->getMapSizeX(); ++ii)
-                            {
-                                gameMap->getTile(ii,jj)->notifyVision(seat);
-                            }
-                        }
-
-                        seat->sendVisibleTiles();
-                    }
-                }
-
-                gameMap->createAllEntities();
-
-                // Fill starting gold
-                for(Seat* seat : gameMap->getSeats())
-                {
-                    if(seat->getPlayer() == nullptr)
-                        continue;
-
-                    if(seat->getGold() > 0)
-                        gameMap->addGoldToSeat(seat->getGold(), seat->getId());
-                }
+                launchGame();
             }
             else
             {
@@ -513,6 +785,8 @@ void ODServer::serverThread()
         startNewTurn(static_cast<double>(clock.restart().asSeconds()) * 0.95);
 
         processServerNotifications();
+        processMapSaverResults();
+        TurnProfiler::endTurn();
     }
 
     if(!mMasterServerGameId.empty())
@@ -524,12 +798,14 @@ void ODServer::serverThread()
 
 void ODServer::processServerNotifications()
 {
+    OD_PROFILE_SCOPE("network");
     GameMap* gameMap = mGameMap;
 
     bool running = true;
 
     while (running)
     {
+        OD_PROFILE_SCOPE("encoding");
         // If the queue is empty, let's get out of the loop.
         if (mServerNotificationQueue.empty())
             break;
@@ -550,40 +826,56 @@ void ODServer::processServerNotifications()
             case ServerNotificationType::turnStarted:
                 OD_LOG_INF("Server sends newturn="
                     + boost::lexical_cast<std::string>(gameMap->getTurnNumber()));
-                sendMsg(event->mConcernedPlayer, event->mPacket);
+                queueMsg(event->mConcernedPlayer, event->mPacket);
                 break;
 
             case ServerNotificationType::entityPickedUp:
                 // This message should not be sent by human players (they are notified asynchronously)
                 OD_ASSERT_TRUE_MSG(event->mConcernedPlayer->getIsHuman(), "nick=" + event->mConcernedPlayer->getNick());
-                sendMsg(event->mConcernedPlayer, event->mPacket);
+                queueMsg(event->mConcernedPlayer, event->mPacket);
                 break;
 
             case ServerNotificationType::entityDropped:
                 // This message should not be sent by human players (they are notified asynchronously)
                 OD_ASSERT_TRUE_MSG(event->mConcernedPlayer->getIsHuman(), "nick=" + event->mConcernedPlayer->getNick());
-                sendMsg(event->mConcernedPlayer, event->mPacket);
+                queueMsg(event->mConcernedPlayer, event->mPacket);
                 break;
 
             case ServerNotificationType::entitySlapped:
                 // This message should not be sent by human players (they are notified asynchronously)
                 OD_ASSERT_TRUE_MSG(!event->mConcernedPlayer->getIsHuman(), "nick=" + event->mConcernedPlayer->getNick());
-                sendMsg(event->mConcernedPlayer, event->mPacket);
+                queueMsg(event->mConcernedPlayer, event->mPacket);
                 break;
 
             case ServerNotificationType::exit:
                 running = false;
+                // We try to send what was queued before closing the connexions
+                flushClients();
                 stopServer();
                 break;
 
             default:
-                sendMsg(event->mConcernedPlayer, event->mPacket);
+                queueMsg(event->mConcernedPlayer, event->mPacket);
                 break;
         }
 
         delete event;
         event = nullptr;
     }
+
+    // Everything queued during this turn is sent with 1 write per client. If a client could
+    // not read everything, what remains will be sent on next flush
+    {
+        OD_PROFILE_SCOPE("send");
+        flushClients();
+    }
+
+    mLastTurnNetworkStats = NetworkStats();
+    for (ODSocketClient* client : mSockClients)
+        client->takeSendStats(mLastTurnNetworkStats.mNbBytesSent, mLastTurnNetworkStats.mNbSendCalls);
+
+    OD_LOG_DBG("Server sent bytes=" + Helper::toString(mLastTurnNetworkStats.mNbBytesSent)
+        + ", sendCalls=" + Helper::toString(mLastTurnNetworkStats.mNbSendCalls));
 }
 
 bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
@@ -667,6 +959,20 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
                 return false;
             }
 
+            // The client tells if it wants the packets to be compressed. The dictionary
+            // is only used if both sides have the same
+            bool useCompression;
+            uint32_t dictionaryHash;
+            OD_ASSERT_TRUE(packetReceived >> useCompression >> dictionaryHash);
+            if(useCompression)
+            {
+                const std::string& dictionary = ConfigManager::getSingleton().getPacketDictionary();
+                if(dictionaryHash == PacketCompression::dictionaryHash(dictionary))
+                    clientSocket->setCompression(ODSocketClient::Compression::dictionary, dictionary);
+                else
+                    clientSocket->setCompression(ODSocketClient::Compression::noDictionary, std::string());
+            }
+
             // Tell the client to load the given map
             OD_LOG_INF("Level sent to client: " + gameMap->getLevelName());
             clientSocket->setState("loadLevel");
@@ -1145,15 +1451,14 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
 
         case ClientNotificationType::askEntityPickUp:
         {
-            std::string entityName;
-            GameEntityType entityType;
-            OD_ASSERT_TRUE(packetReceived >> entityType >> entityName);
+            uint32_t entityId;
+            OD_ASSERT_TRUE(packetReceived >> entityId);
 
             Player *player = clientSocket->getPlayer();
-            GameEntity* entity = gameMap->getEntityFromTypeAndName(entityType, entityName);
+            GameEntity* entity = gameMap->getEntityById(entityId);
             if(entity == nullptr)
             {
-                OD_LOG_ERR("entityType=" + Helper::toString(static_cast<int32_t>(entityType)) + ", entityName=" + entityName);
+                OD_LOG_ERR("entityId=" + Helper::toString(entityId));
                 break;
             }
             bool allowPickup = entity->tryPickup(player->getSeat());
@@ -1161,8 +1466,8 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
             {
                 OD_LOG_INF("player=" + player->getNick()
                         + " could not pickup entity entityType="
-                        + Helper::toString(static_cast<int32_t>(entityType))
-                        + ", entityName=" + entityName);
+                        + Helper::toString(static_cast<int32_t>(entity->getObjectType()))
+                        + ", entityName=" + entity->getName());
                 break;
             }
 
@@ -1228,14 +1533,13 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
 
         case ClientNotificationType::askSlapEntity:
         {
-            GameEntityType entityType;
-            std::string entityName;
+            uint32_t entityId;
             Player* player = clientSocket->getPlayer();
-            OD_ASSERT_TRUE(packetReceived >> entityType >> entityName);
-            GameEntity* entity = gameMap->getEntityFromTypeAndName(entityType, entityName);
+            OD_ASSERT_TRUE(packetReceived >> entityId);
+            GameEntity* entity = gameMap->getEntityById(entityId);
             if(entity == nullptr)
             {
-                OD_LOG_WRN("entityType=" + Helper::toString(static_cast<int32_t>(entityType)) + ", entityName=" + entityName);
+                OD_LOG_WRN("entityId=" + Helper::toString(entityId));
                 break;
             }
 
@@ -1243,8 +1547,8 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
             {
                 OD_LOG_INF("player seatId=" + Helper::toString(player->getSeat()->getId())
                     + " could not slap entity entityType="
-                    + Helper::toString(static_cast<int32_t>(entityType))
-                    + ", entityName=" + entityName);
+                    + Helper::toString(static_cast<int32_t>(entity->getObjectType()))
+                    + ", entityName=" + entity->getName());
                 break;
             }
 
@@ -1491,80 +1795,14 @@ bool ODServer::processClientNotifications(ODSocketClient* clientSocket)
 
                 std::ostringstream ss;
                 ss.imbue(loc);
-                ss << boost::posix_time::second_clock::local_time() << "-";
-                switch(mServerMode)
-                {
-                    case ServerMode::ModeGameSinglePlayer:
-                        ss << SAVEGAME_SKIRMISH_PREFIX;
-                        ss << fileLevel;
-                        break;
-                    case ServerMode::ModeGameMultiPlayer:
-                        ss << SAVEGAME_MULTIPLAYER_PREFIX;
-                        ss << fileLevel;
-                        break;
-                    case ServerMode::ModeGameLoaded:
-                    {
-                        // We look for the Skirmish or multiplayer prefix and keep it.
-                        size_t indexSk = fileLevel.find(SAVEGAME_SKIRMISH_PREFIX);
-                        size_t indexMp = fileLevel.find(SAVEGAME_MULTIPLAYER_PREFIX);
-                        if((indexSk != std::string::npos) && (indexMp == std::string::npos))
-                        {
-                            // Skirmish savegame
-                            ss << SAVEGAME_SKIRMISH_PREFIX;
-                            ss << fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
-
-                        }
-                        else if((indexSk == std::string::npos) && (indexMp != std::string::npos))
-                        {
-                            // Multiplayer savegame
-                            ss << SAVEGAME_MULTIPLAYER_PREFIX;
-                            ss << fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
-                        }
-                        else if((indexSk != std::string::npos) && (indexMp != std::string::npos))
-                        {
-                            // We found both prefixes. That can happen if the name contains the other
-                            // prefix. Because of filename construction, we know that the lowest is the good
-                            if(indexSk < indexMp)
-                            {
-                                ss << SAVEGAME_SKIRMISH_PREFIX;
-                                ss << fileLevel.substr(indexSk + SAVEGAME_SKIRMISH_PREFIX.length());
-                            }
-                            else
-                            {
-                                ss << SAVEGAME_MULTIPLAYER_PREFIX;
-                                ss << fileLevel.substr(indexMp + SAVEGAME_MULTIPLAYER_PREFIX.length());
-                            }
-                        }
-                        else
-                        {
-                            // We couldn't find any prefix. That's not normal
-                            OD_LOG_ERR("fileLevel=" + fileLevel);
-                            ss << fileLevel;
-                        }
-                        break;
-                    }
-                    default:
-                        OD_LOG_ERR("mode=" + Helper::toString(static_cast<int>(mServerMode)));
-                        ss << fileLevel;
-                        break;
-                }
+                ss << boost::posix_time::second_clock::local_time() << "-" << getSaveGameName();
                 std::string savePath = ResourceManager::getSingleton().getSaveGamePath() + ss.str();
                 levelSave = boost::filesystem::path(savePath);
             }
 
-            // If the file exists, we make a backup
-            if (boost::filesystem::exists(levelSave))
-                boost::filesystem::rename(levelSave, levelSave.string() + ".bak");
-
-            std::string msg = "Map saved successfully as: " + levelSave.string();
-            if (!MapHandler::writeGameMapToFile(levelSave.string(), *gameMap))
-            {
-                msg = "Couldn't not save map file as: " + levelSave.string() + "\nPlease check logs.";
-            }
-            // We notify all the players that the game was saved successfully
-            ServerNotification notif(ServerNotificationType::chatServer, nullptr);
-            notif.mPacket << msg << EventShortNoticeType::genericGameInfo;
-            sendAsyncMsg(notif);
+            // The file is written by another thread (if it exists, we make a backup). The players
+            // are notified once it is written
+            saveGameMap(levelSave.string(), true, false);
             break;
         }
 
@@ -1867,7 +2105,8 @@ ODSocketClient* ODServer::notifyNewConnection(sf::TcpListener& sockListener)
 
 bool ODServer::notifyClientMessage(ODSocketClient *clientSocket)
 {
-    bool ret = processClientNotifications(clientSocket);
+    // If we could not send data to the client, we disconnect it
+    bool ret = !clientSocket->isSendFailed() && processClientNotifications(clientSocket);
     if(!ret)
     {
         std::string nick = clientSocket->getPlayer() ? clientSocket->getPlayer()->getNick() : std::string();
@@ -1903,6 +2142,10 @@ bool ODServer::notifyClientMessage(ODSocketClient *clientSocket)
 
 void ODServer::stopServer()
 {
+    // The clients are deleted with the server so we log how late they were first
+    if(mServerState == ServerState::StateGame)
+        OD_LOG_INF("Clients turn lag:\n" + getClientsTurnLagStats());
+
     // We start by stopping server to make sure no new message comes
     ODSocketServer::stopServer();
 
@@ -1917,6 +2160,10 @@ void ODServer::stopServer()
         delete mServerNotificationQueue.front();
         mServerNotificationQueue.pop_front();
     }
+
+    // The saves asked before stopping are still written
+    mMapSaver->waitIdle();
+    processMapSaverResults();
     mGameMap->clearAll();
 }
 
@@ -1933,6 +2180,18 @@ void ODServer::notifyExit()
     queueServerNotification(exitServerNotification);
 }
 
+bool ODServer::isPlayerCatchingUp(Player* player)
+{
+    if(player == nullptr)
+        return false;
+
+    ODSocketClient* client = getClientFromPlayer(player);
+    if(client == nullptr)
+        return false;
+
+    return client->isCatchingUp();
+}
+
 ODSocketClient* ODServer::getClientFromPlayer(Player* player)
 {
     for (ODSocketClient* client : mSockClients)
@@ -2023,6 +2282,26 @@ int32_t ODServer::getNetworkPort() const
     return ConfigManager::getSingleton().getNetworkPort();
 }
 
+std::string ODServer::getClientsTurnLagStats() const
+{
+    std::string stats;
+    for (ODSocketClient* client : mSockClients)
+    {
+        Player* player = client->getPlayer();
+        stats += (player != nullptr ? player->getNick() : std::string("?")) + ":";
+        const std::vector<uint32_t>& histogram = client->getTurnLagHistogram();
+        for(uint32_t lag = 0; lag < histogram.size(); ++lag)
+        {
+            if(histogram[lag] == 0)
+                continue;
+
+            stats += " lag" + Helper::toString(lag) + "=" + Helper::toString(histogram[lag]);
+        }
+        stats += " heldBack=" + Helper::toString(client->getNbTurnsHeldBack()) + "\n";
+    }
+    return stats;
+}
+
 void ODServer::printConsoleMsg(const std::string& text)
 {
     OD_LOG_INF("Console:" + text);
@@ -23,6 +23,10 @@
 
 #include <OgreSingleton.h>
 
+#include <array>
+#include <memory>
+
+class AsyncMapSaver;
 class ServerNotification;
 class GameMap;
 
@@ -95,6 +99,41 @@ class ODServer: public Ogre::Singleton<ODServer>,
 
     int32_t getNetworkPort() const;
 
+    //! \brief Loads the given level and launches the game without listening for clients. Every
+    //! seat is played by a Keeper AI. The turns are then computed by calling doSimulationTurn.
+    //! Used to benchmark the server side of the game
+    bool startSimulation(const std::string& levelFilename);
+
+    //! \brief Computes a turn of the game launched by startSimulation
+    void doSimulationTurn(double timeSinceLastTurn);
+
+    inline GameMap* getGameMap() const
+    { return mGameMap; }
+
+    //! \brief Data sent to the clients during a server turn
+    struct NetworkStats
+    {
+        NetworkStats() :
+            mNbBytesSent(0),
+            mNbSendCalls(0)
+        {}
+
+        uint64_t mNbBytesSent;
+        uint32_t mNbSendCalls;
+    };
+
+    //! \brief Returns true if the client of the given player is late and should not be sent the
+    //! per entity and per tile refreshes this turn (see ODSocketClient::isCatchingUp)
+    bool isPlayerCatchingUp(Player* player);
+
+    //! \brief Returns, for each client, how many turns were started while it was late by
+    //! 0, 1, 2, ... turns
+    std::string getClientsTurnLagStats() const;
+
+    //! \brief Returns what was sent during the last turn (since previous call to processServerNotifications)
+    inline const NetworkStats& getLastTurnNetworkStats() const
+    { return mLastTurnNetworkStats; }
+
 protected:
     ODSocketClient* notifyNewConnection(sf::TcpListener& sockListener) override;
     bool notifyClientMessage(ODSocketClient *sock) override;
@@ -116,17 +155,47 @@ private:
 
     ConsoleInterface mConsoleInterface;
 
+    //! \brief Packet given to queueMsg framed for each ODSocketClient::Compression value (nullptr if
+    //! not framed yet). They are shared by the outbound queues of the clients they are sent to
+    std::array<std::shared_ptr<std::vector<char>>, 3> mFramedPackets;
+
+    //! \brief Compress the broadcast packets with and without the packet dictionary
+    PacketCompression::Compressor mCompressor;
+    PacketCompression::Compressor mDictionaryCompressor;
+
+    NetworkStats mLastTurnNetworkStats;
+
     std::string mMasterServerGameId;
     double mMasterServerGameStatusUpdateTime;
 
+    //! \brief Writes the saved games without blocking the server thread
+    std::unique_ptr<AsyncMapSaver> mMapSaver;
+
     void printConsoleMsg(const std::string& text);
 
     ODSocketClient* getClientFromPlayer(Player* player);
     ODSocketClient* getClientFromPlayerId(int32_t playerId);
 
+    //! \brief Called when every seat is configured to set up the gamemap and start turn 0.
+    void launchGame();
+
     //! \brief Called when a new turn started.
     void startNewTurn(double timeSinceLastTurn);
 
+    //! \brief Returns the name of the saved games of the current level, without the folder
+    //! nor the date (for example SK-Level.level)
+    std::string getSaveGameName() const;
+
+    //! \brief Takes a snapshot of the gamemap and queues it to be written in fileName. The
+    //! players are notified when it is written (see processMapSaverResults)
+    void saveGameMap(const std::string& fileName, bool makeBackup, bool isAutosave);
+
+    //! \brief Saves the game if autosave is enabled and it is time to
+    void autosaveGameMap(int64_t turn);
+
+    //! \brief Notifies the players about the saves written since last call
+    void processMapSaverResults();
+
     /*! \brief Monitors mServerNotificationQueue for new events and informs the clients about them.
      *
      * This function is used in server mode and acts as a "consumer" on
@@ -148,6 +217,17 @@ private:
     //! \brief Sends the packet to the given player. If player is nullptr, the packet is sent to every connected player
     void sendMsg(Player* player, ODPacket& packet);
 
+    //! \brief Same as sendMsg but the packet is only appended to the outbound queue of the concerned clients.
+    //! It will be sent on next call to flushClients
+    void queueMsg(Player* player, ODPacket& packet);
+
+    //! \brief Writes the outbound queues of the clients without blocking
+    void flushClients();
+
+    //! \brief Returns the packet framed with the given compression. Computed at most once per
+    //! compression for each packet given to queueMsg
+    ODSocketClient::FramedData getFramedPacket(ODPacket& packet, ODSocketClient::Compression compression);
+
     void fireSeatConfigurationRefresh();
 
     //! \brief Handles console command. player is the player that launched the command
@@ -17,6 +17,7 @@
 
 #include "ODSocketClient.h"
 #include "network/ODPacket.h"
+#include "network/PacketCompression.h"
 #include "network/ServerNotification.h"
 
 #include "utils/Helper.h"
@@ -25,6 +26,8 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+
 bool ODSocketClient::connect(const std::string& host, const int port, uint32_t timeout, const std::string& outputReplayFilename)
 {
     mSource = ODSource::none;
@@ -46,9 +49,60 @@ bool ODSocketClient::connect(const std::string& host, const int port, uint32_t t
     mReplayOutputStream.open(mOutputReplayFilename, std::ios::out | std::ios::binary);
     mGameClock.restart();
     mSource = ODSource::network;
+
+    mReceivedPackets.clear();
+    mReceiveError = false;
+    mNbBytesReceived = 0;
+    mNbBytesDecoded = 0;
+    mReceiveThreadRunning = true;
+    mReceiveThread = new sf::Thread(&ODSocketClient::receiveThread, this);
+    mReceiveThread->launch();
     return true;
 }
 
+void ODSocketClient::receiveThread()
+{
+    ODPacket packet;
+    while(mReceiveThreadRunning)
+    {
+        // We do not wait forever to be able to check regularly if we should stop
+        if(!mSockSelector.wait(sf::milliseconds(100)))
+            continue;
+
+        if(!mSockSelector.isReady(mSockClient))
+            continue;
+
+        if(recvFromSocket(packet) != ODComStatus::OK)
+        {
+            mReceiveError = true;
+            return;
+        }
+
+        packet.writePacket(mGameClock.getElapsedTime().asMilliseconds(),
+            mReplayOutputStream);
+
+        // If the main thread is late, we wait for it
+        while(!mReceivedPackets.push(packet))
+        {
+            if(!mReceiveThreadRunning)
+                return;
+
+            sf::sleep(sf::milliseconds(1));
+        }
+    }
+}
+
+void ODSocketClient::stopReceiveThread()
+{
+    if(mReceiveThread == nullptr)
+        return;
+
+    mReceiveThreadRunning = false;
+    delete mReceiveThread; // Delete waits for the thread to finish
+    mReceiveThread = nullptr;
+    mReceivedPackets.clear();
+}
+
 bool ODSocketClient::replay(const std::string& filename)
 {
     OD_LOG_INF("Reading replay from file " + filename);
@@ -72,6 +126,9 @@ void ODSocketClient::disconnect(bool keepReplay)
         }
         case ODSource::network:
         {
+            stopReceiveThread();
+            clearOutbound();
+            mSendFailed = false;
             // Remove any remaining client sockets from the socket selector,
             // if there is any left.
             mSockSelector.clear();
@@ -105,11 +162,14 @@ bool ODSocketClient::isDataAvailable()
         }
         case ODSource::network:
         {
-            // There is only 1 socket in the selector so it should be ready if
-            // wait returns true but it doesn't hurt to return isReady...
-            if(!mSockSelector.wait(sf::milliseconds(5)))
-                return false;
-            return mSockSelector.isReady(mSockClient);
+            // The receive thread is only launched for clients. The server knows from its
+            // own selector if data is available
+            if(mReceiveThread == nullptr)
+                return true;
+
+            // If the connection is lost, we return true so that recv gets called and
+            // reports the error once the received packets are processed
+            return !mReceivedPackets.empty() || mReceiveError;
         }
         case ODSource::file:
         {
@@ -140,6 +200,15 @@ ODSocketClient::ODComStatus ODSocketClient::send(ODPacket& s)
     if(mSource != ODSource::network)
         return ODComStatus::OK;
 
+    if(mBufferedSend)
+    {
+        // We go through the outbound queue to keep the order with what is already queued
+        std::shared_ptr<std::vector<char>> framedData = std::make_shared<std::vector<char>>();
+        appendFramedPacket(s, mCompression, mCompressor, *framedData);
+        queueFramedData(framedData);
+        return flushSend();
+    }
+
     sf::Socket::Status status = mSockClient.send(s.mPacket);
     if (status == sf::Socket::Done)
         return ODComStatus::OK;
@@ -149,6 +218,165 @@ ODSocketClient::ODComStatus ODSocketClient::send(ODPacket& s)
     return ODComStatus::Error;
 }
 
+namespace
+{
+    //! \brief First byte of the packets sent by the server when compression is negotiated
+    const uint8_t PACKET_RAW = 0;
+    const uint8_t PACKET_COMPRESSED = 1;
+    const uint8_t PACKET_COMPRESSED_DICTIONARY = 2;
+
+    void appendUInt32(uint32_t value, std::vector<char>& buffer)
+    {
+        // Network byte order, like sf::Packet
+        buffer.push_back(static_cast<char>((value >> 24) & 0xFF));
+        buffer.push_back(static_cast<char>((value >> 16) & 0xFF));
+        buffer.push_back(static_cast<char>((value >> 8) & 0xFF));
+        buffer.push_back(static_cast<char>(value & 0xFF));
+    }
+
+    uint32_t readUInt32(const char* data)
+    {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+            (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+    }
+}
+
+void ODSocketClient::appendFramedPacket(ODPacket& s, Compression compression,
+    PacketCompression::Compressor& compressor, std::vector<char>& buffer)
+{
+    // Same framing as sf::TcpSocket: the size of the data in network byte order followed by the data
+    std::size_t size = s.mPacket.getDataSize();
+    const char* data = static_cast<const char*>(s.mPacket.getData());
+    if(compression == Compression::none)
+    {
+        appendUInt32(static_cast<uint32_t>(size), buffer);
+        if(size > 0)
+            buffer.insert(buffer.end(), data, data + size);
+        return;
+    }
+
+    // We write the size once we know it
+    std::size_t headerPos = buffer.size();
+    appendUInt32(0, buffer);
+    std::size_t payloadPos = buffer.size();
+    if(size >= PacketCompression::MIN_SIZE_TO_COMPRESS)
+    {
+        bool useDictionary = (compression == Compression::dictionary);
+        buffer.push_back(static_cast<char>(useDictionary ? PACKET_COMPRESSED_DICTIONARY : PACKET_COMPRESSED));
+        appendUInt32(static_cast<uint32_t>(size), buffer);
+        std::size_t compressedSize = compressor.compress(data, size, buffer);
+        // If it is not worth it, we send the packet as is
+        if(compressedSize + 5 >= size + 1)
+            buffer.resize(payloadPos);
+    }
+
+    if(buffer.size() == payloadPos)
+    {
+        buffer.push_back(static_cast<char>(PACKET_RAW));
+        if(size > 0)
+            buffer.insert(buffer.end(), data, data + size);
+    }
+
+    uint32_t payloadSize = static_cast<uint32_t>(buffer.size() - payloadPos);
+    buffer[headerPos] = static_cast<char>((payloadSize >> 24) & 0xFF);
+    buffer[headerPos + 1] = static_cast<char>((payloadSize >> 16) & 0xFF);
+    buffer[headerPos + 2] = static_cast<char>((payloadSize >> 8) & 0xFF);
+    buffer[headerPos + 3] = static_cast<char>(payloadSize & 0xFF);
+}
+
+void ODSocketClient::queueFramedData(const FramedData& framedData)
+{
+    OD_ASSERT_TRUE(mBufferedSend);
+    if(mSendFailed || framedData->empty())
+        return;
+
+    mOutboundChunks.push_back(framedData);
+    mOutboundPendingBytes += framedData->size();
+}
+
+ODSocketClient::ODComStatus ODSocketClient::flushSend()
+{
+    if(mSendFailed)
+        return ODComStatus::Error;
+
+    while(!mOutboundChunks.empty())
+    {
+        // We gather the queued chunks to write them with as few calls as possible
+        mSendBuffer.clear();
+        std::size_t offset = mOutboundOffset;
+        for(const FramedData& chunk : mOutboundChunks)
+        {
+            std::size_t size = std::min(chunk->size() - offset, MAX_SEND_GATHER_BYTES - mSendBuffer.size());
+            mSendBuffer.insert(mSendBuffer.end(), chunk->begin() + offset, chunk->begin() + offset + size);
+            offset = 0;
+            if(mSendBuffer.size() >= MAX_SEND_GATHER_BYTES)
+                break;
+        }
+
+        // We do not want to wait for a slow client
+        std::size_t sent = 0;
+        mSockClient.setBlocking(false);
+        sf::Socket::Status status = mSockClient.send(mSendBuffer.data(), mSendBuffer.size(), sent);
+        mSockClient.setBlocking(true);
+        ++mNbSendCalls;
+        mNbBytesSent += sent;
+        consumeOutbound(sent);
+
+        if(status == sf::Socket::Done)
+            continue;
+
+        if((status == sf::Socket::Partial) || (status == sf::Socket::NotReady))
+        {
+            if(mOutboundPendingBytes <= MAX_PENDING_SEND_BYTES)
+                return ODComStatus::NotReady;
+
+            OD_LOG_ERR("Client too slow, pending bytes=" + Helper::toString(static_cast<uint64_t>(mOutboundPendingBytes)));
+        }
+        else
+            OD_LOG_ERR("Could not send data to client status=" + Helper::toString(status));
+
+        mSendFailed = true;
+        clearOutbound();
+        return ODComStatus::Error;
+    }
+
+    return ODComStatus::OK;
+}
+
+void ODSocketClient::consumeOutbound(std::size_t nbBytes)
+{
+    mOutboundPendingBytes -= nbBytes;
+    while(nbBytes > 0)
+    {
+        std::size_t remaining = mOutboundChunks.front()->size() - mOutboundOffset;
+        if(nbBytes < remaining)
+        {
+            mOutboundOffset += nbBytes;
+            return;
+        }
+
+        nbBytes -= remaining;
+        mOutboundChunks.pop_front();
+        mOutboundOffset = 0;
+    }
+}
+
+void ODSocketClient::clearOutbound()
+{
+    mOutboundChunks.clear();
+    mOutboundOffset = 0;
+    mOutboundPendingBytes = 0;
+}
+
+void ODSocketClient::takeSendStats(uint64_t& nbBytesSent, uint32_t& nbSendCalls)
+{
+    nbBytesSent += mNbBytesSent;
+    nbSendCalls += mNbSendCalls;
+    mNbBytesSent = 0;
+    mNbSendCalls = 0;
+}
+
 ODSocketClient::ODComStatus ODSocketClient::recv(ODPacket& s)
 {
     switch(mSource)
@@ -161,27 +389,16 @@ ODSocketClient::ODComStatus ODSocketClient::recv(ODPacket& s)
         }
         case ODSource::network:
         {
-            sf::Socket::Status status = mSockClient.receive(s.mPacket);
-            if (status == sf::Socket::Done)
-            {
-                s.writePacket(mGameClock.getElapsedTime().asMilliseconds(),
-                    mReplayOutputStream);
-                return ODComStatus::OK;
-            }
+            if(mReceiveThread == nullptr)
+                return recvFromSocket(s);
 
-            if((!mSockClient.isBlocking()) &&
-                    (status == sf::Socket::NotReady))
-            {
-                return ODComStatus::NotReady;
-            }
+            if(mReceivedPackets.pop(s))
+                return ODComStatus::OK;
 
-            if(status == sf::Socket::Disconnected)
-            {
-                OD_LOG_WRN("Socket disconnected");
+            if(mReceiveError)
                 return ODComStatus::Error;
-            }
-            OD_LOG_ERR("Could not receive data from client status=" + Helper::toString(status));
-            return ODComStatus::Error;
+
+            return ODComStatus::NotReady;
         }
         case ODSource::file:
         {
@@ -196,6 +413,80 @@ ODSocketClient::ODComStatus ODSocketClient::recv(ODPacket& s)
     return ODComStatus::Error;
 }
 
+ODSocketClient::ODComStatus ODSocketClient::recvFromSocket(ODPacket& s)
+{
+    sf::Socket::Status status = mSockClient.receive(s.mPacket);
+    if (status == sf::Socket::Done)
+    {
+        mNbBytesReceived += s.mPacket.getDataSize();
+        // Only the packets sent by the server are compressed
+        if((mCompression != Compression::none) && !mBufferedSend && !decodeReceivedPacket(s))
+        {
+            OD_LOG_ERR("Received invalid compressed packet size=" + Helper::toString(static_cast<uint64_t>(s.mPacket.getDataSize())));
+            return ODComStatus::Error;
+        }
+        mNbBytesDecoded += s.mPacket.getDataSize();
+        return ODComStatus::OK;
+    }
+
+    if((!mSockClient.isBlocking()) &&
+            (status == sf::Socket::NotReady))
+    {
+        return ODComStatus::NotReady;
+    }
+
+    if(status == sf::Socket::Disconnected)
+    {
+        OD_LOG_WRN("Socket disconnected");
+        return ODComStatus::Error;
+    }
+    OD_LOG_ERR("Could not receive data from client status=" + Helper::toString(status));
+    return ODComStatus::Error;
+}
+
+bool ODSocketClient::decodeReceivedPacket(ODPacket& s)
+{
+    std::size_t size = s.mPacket.getDataSize();
+    const char* data = static_cast<const char*>(s.mPacket.getData());
+    if(size < 1)
+        return false;
+
+    uint8_t type = static_cast<uint8_t>(data[0]);
+    if(type == PACKET_RAW)
+    {
+        std::vector<char> content(data + 1, data + size);
+        s.mPacket.clear();
+        if(!content.empty())
+            s.mPacket.append(content.data(), content.size());
+        return true;
+    }
+
+    if(((type != PACKET_COMPRESSED) && (type != PACKET_COMPRESSED_DICTIONARY)) || (size < 5))
+        return false;
+
+    uint32_t uncompressedSize = readUInt32(data + 1);
+    std::vector<char> content;
+    if(!PacketCompression::decompress(data + 5, size - 5,
+        (type == PACKET_COMPRESSED_DICTIONARY) ? mCompressionDictionary : std::string(),
+        uncompressedSize, content))
+    {
+        return false;
+    }
+
+    s.mPacket.clear();
+    if(!content.empty())
+        s.mPacket.append(content.data(), content.size());
+    return true;
+}
+
+void ODSocketClient::recordTurnLag(uint32_t lag)
+{
+    if(lag >= mTurnLagHistogram.size())
+        mTurnLagHistogram.resize(lag + 1, 0);
+
+    ++mTurnLagHistogram[lag];
+}
+
 bool ODSocketClient::isConnected()
 {
     return mSource != ODSource::none;
@@ -19,10 +19,17 @@
 #define ODSOCKETCLIENT_H
 
 #include "network/ODPacket.h"
+#include "network/PacketCompression.h"
+#include "utils/SpscQueue.h"
 
 #include <SFML/Network.hpp>
+#include <SFML/System.hpp>
 
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <string>
+#include <vector>
 #include <cstdint>
 #include <fstream>
 
@@ -45,15 +52,40 @@ class ODSocketClient
             file
         };
 
+        //! \brief Framing of the packets sent by the server. If not none, each packet starts with
+        //! a byte telling if it is compressed (and how). Negotiated in the hello message
+        enum class Compression
+        {
+            none,
+            noDictionary,
+            dictionary
+        };
+
         ODSocketClient():
             mSource(ODSource::none),
             mPlayer(nullptr),
             mLastTurnAck(-1),
-            mPendingTimestamp(-1)
+            mLastSnapshotTurn(-1),
+            mCatchingUp(false),
+            mNbTurnsHeldBack(0),
+            mPendingTimestamp(-1),
+            mReceiveThread(nullptr),
+            mReceivedPackets(MAX_RECEIVED_PACKETS),
+            mReceiveThreadRunning(false),
+            mReceiveError(false),
+            mNbBytesReceived(0),
+            mNbBytesDecoded(0),
+            mBufferedSend(false),
+            mSendFailed(false),
+            mOutboundOffset(0),
+            mOutboundPendingBytes(0),
+            mNbBytesSent(0),
+            mNbSendCalls(0),
+            mCompression(Compression::none)
         {}
 
         virtual ~ODSocketClient()
-        {}
+        { stopReceiveThread(); }
 
         // Client initialization
         bool isConnected();
@@ -69,7 +101,34 @@ class ODSocketClient
         void setPlayer(Player* player) { mPlayer = player; }
         int64_t getLastTurnAck() { return mLastTurnAck; }
         void setLastTurnAck(int64_t lastTurnAck) { mLastTurnAck = lastTurnAck; }
+
+        //! \brief Used on server side. Turn when the per turn state (seat, creature infos) was last sent.
+        //! It is not sent again until the client acknowledges that turn so that a late client only gets
+        //! the most recent state
+        int64_t getLastSnapshotTurn() const { return mLastSnapshotTurn; }
+        void setLastSnapshotTurn(int64_t turn) { mLastSnapshotTurn = turn; }
+
+        //! \brief Used on server side. Set at each turn when the client has not acknowledged the last
+        //! snapshot yet. The per entity and per tile refreshes are then not sent to it. As they are
+        //! computed against what was last sent, it will get them coalesced once it catches up
+        bool isCatchingUp() const { return mCatchingUp; }
+        void setCatchingUp(bool catchingUp) { mCatchingUp = catchingUp; }
+
+        //! \brief Used on server side. Called at each turn with the number of turns the client is late
+        void recordTurnLag(uint32_t lag);
+
+        //! \brief Number of turns started while the client was late by the index value
+        const std::vector<uint32_t>& getTurnLagHistogram() const
+        { return mTurnLagHistogram; }
+
+        //! \brief Used on server side. Number of turns the server could not start because the client
+        //! was more than MaxClientTurnLag turns late
+        uint32_t getNbTurnsHeldBack() const { return mNbTurnsHeldBack; }
+        void incNbTurnsHeldBack() { ++mNbTurnsHeldBack; }
+
         const std::string& getState() {return mState;}
+        //! \brief Returns true if a packet can be read with recv. For a client connected
+        //! to a server, this never blocks: the packets are received by the receive thread
         bool isDataAvailable();
         int32_t getGameTimeMillis()
         { return mGameClock.getElapsedTime().asMilliseconds(); }
@@ -82,6 +141,29 @@ class ODSocketClient
         void setSource(ODSource source)
         { mSource = source; }
 
+        //! \brief If set, the packets sent are appended to an outbound queue that is written
+        //! without blocking. Used by the server so that a slow client cannot stall it
+        void setBufferedSend(bool bufferedSend)
+        { mBufferedSend = bufferedSend; }
+
+        //! \brief On server side (buffered send), sets how the packets sent to this client are compressed.
+        //! On client side, tells that the packets received are framed for compression. In both cases,
+        //! dictionary should be the one of both sides (see ConfigManager::getPacketDictionary)
+        void setCompression(Compression compression, const std::string& dictionary)
+        {
+            mCompression = compression;
+            mCompressionDictionary = dictionary;
+            mCompressor.setDictionary(compression == Compression::dictionary ? dictionary : std::string());
+        }
+
+        Compression getCompression() const
+        { return mCompression; }
+
+        //! \brief Returns true if the outbound queue could not be written (connection lost
+        //! or client too slow to read what is sent). The client should then be disconnected
+        bool isSendFailed() const
+        { return mSendFailed; }
+
         // Data Transimission
         /*! \brief Sends a packet through the network
          * ODPacket should preserve integrity. That means that if an ODSocketClient
@@ -90,6 +172,37 @@ class ODSocketClient
          */
         ODComStatus send(ODPacket& s);
 
+        /*! \brief Appends the given packet to the given buffer framed the same way
+         * sf::TcpSocket does. That allows to frame once a packet sent to several clients
+         * and to send several packets with only one write.
+         * If compression is not none, the packet is compressed if it is big enough. compressor
+         * should use the dictionary if compression is dictionary and no dictionary otherwise
+         */
+        static void appendFramedPacket(ODPacket& s, Compression compression,
+            PacketCompression::Compressor& compressor, std::vector<char>& buffer);
+
+        //! \brief Data framed by appendFramedPacket. A packet sent to several clients is framed once
+        //! and shared by their outbound queues
+        typedef std::shared_ptr<const std::vector<char>> FramedData;
+
+        //! \brief Appends data framed by appendFramedPacket to the outbound queue. It will be
+        //! sent on next call to flushSend. Only allowed when buffered send is set
+        void queueFramedData(const FramedData& framedData);
+
+        //! \brief Writes as much of the outbound queue as possible without blocking. What
+        //! cannot be written is kept for next call
+        ODComStatus flushSend();
+
+        //! \brief Adds the number of bytes written and of writes since last call to the given values
+        void takeSendStats(uint64_t& nbBytesSent, uint32_t& nbSendCalls);
+
+        //! \brief Number of bytes of the packets received since connecting, as received and once
+        //! decompressed. Can be called while the receive thread runs
+        uint64_t getNbBytesReceived() const
+        { return mNbBytesReceived; }
+        uint64_t getNbBytesDecoded() const
+        { return mNbBytesDecoded; }
+
         /*! \brief Receives a packet through the network
          * ODPacket should preserve integrity. That means that if an ODSocketClient
          * sends an ODPacket, the server should receive exactly 1 similar ODPacket (same data,
@@ -109,13 +222,49 @@ class ODSocketClient
         {}
 
     private :
+        //! \brief Maximum number of packets received by the network thread and not yet processed.
+        //! If reached, the network thread waits for the main thread to process some
+        static const std::size_t MAX_RECEIVED_PACKETS = 4096;
+
+        //! \brief Maximum number of bytes waiting to be sent to a client. If the client does not
+        //! read fast enough to stay under this, we give up sending to it
+        static const std::size_t MAX_PENDING_SEND_BYTES = 8 * 1024 * 1024;
+
+        //! \brief Maximum number of bytes of the outbound queue gathered for one write
+        static const std::size_t MAX_SEND_GATHER_BYTES = 64 * 1024;
+
         bool processOneClientSocketMessage();
 
+        //! \brief Receives the packets sent by the server, writes them to the replay and pushes
+        //! them to mReceivedPackets until stopped or until the connection is lost.
+        //! Runs in mReceiveThread
+        void receiveThread();
+
+        //! \brief Stops the receive thread (if any) and waits for it to finish
+        void stopReceiveThread();
+
+        //! \brief Receives a packet from the socket
+        ODComStatus recvFromSocket(ODPacket& s);
+
+        //! \brief Removes the given number of bytes from the front of the outbound queue
+        void consumeOutbound(std::size_t nbBytes);
+
+        //! \brief Clears the outbound queue
+        void clearOutbound();
+
+        //! \brief Replaces the content of a packet framed by appendFramedPacket with compression
+        //! by the original content. Returns false if the packet is not valid
+        bool decodeReceivedPacket(ODPacket& s);
+
         ODSource mSource;
         sf::SocketSelector mSockSelector;
         sf::TcpSocket mSockClient;
         Player* mPlayer;
         int64_t mLastTurnAck;
+        int64_t mLastSnapshotTurn;
+        bool mCatchingUp;
+        std::vector<uint32_t> mTurnLagHistogram;
+        uint32_t mNbTurnsHeldBack;
         std::string mState;
 
         sf::Clock mGameClock;
@@ -127,6 +276,34 @@ class ODSocketClient
         //! \brief the replay filename being written. Used to later optionally delete it
         //! if asked to.
         std::string mOutputReplayFilename;
+
+        //! \brief Only used on the client side (after connect). The server side receives
+        //! directly from the socket when its selector tells there is something to read
+        sf::Thread* mReceiveThread;
+        SpscQueue<ODPacket> mReceivedPackets;
+        std::atomic<bool> mReceiveThreadRunning;
+        //! \brief Set by the receive thread when the connection is lost. The packets received
+        //! before are still processed
+        std::atomic<bool> mReceiveError;
+        std::atomic<uint64_t> mNbBytesReceived;
+        std::atomic<uint64_t> mNbBytesDecoded;
+
+        bool mBufferedSend;
+        bool mSendFailed;
+        //! \brief Framed data waiting to be sent. The first mOutboundOffset bytes of the first
+        //! chunk are already sent. mOutboundPendingBytes is what remains to send in the queue
+        std::deque<FramedData> mOutboundChunks;
+        std::size_t mOutboundOffset;
+        std::size_t mOutboundPendingBytes;
+        //! \brief Buffer the chunks are gathered in to be written with one call
+        std::vector<char> mSendBuffer;
+        uint64_t mNbBytesSent;
+        uint32_t mNbSendCalls;
+
+        Compression mCompression;
+        std::string mCompressionDictionary;
+        //! \brief Used for the packets sent directly to this client (not broadcast)
+        PacketCompression::Compressor mCompressor;
 };
 
 #endif // ODSOCKETCLIENT_H
@@ -24,6 +24,8 @@
 
 #include <SFML/System.hpp>
 
+#include <algorithm>
+
 ODSocketServer::ODSocketServer():
     mThread(nullptr),
     mIsConnected(false)
@@ -69,8 +71,16 @@ void ODSocketServer::doTask(int timeoutMs)
     while((timeoutMs == 0) ||
           (timeoutMs > mClockMainTask.getElapsedTime().asMilliseconds()))
     {
+        // The clients we could not send data to are removed without waiting for them to send something.
+        // Note that a zero time means waiting forever for the selector so we poll with the smallest one
+        bool isSendFailed = std::any_of(mSockClients.begin(), mSockClients.end(),
+            [](const ODSocketClient* client) { return client->isSendFailed(); });
         bool isSockReady;
-        if(timeoutMs != 0)
+        if(isSendFailed)
+        {
+            isSockReady = mSockSelector.wait(sf::microseconds(1));
+        }
+        else if(timeoutMs != 0)
         {
             // We adapt the timeout so that the function returns after timeoutMs
             // even if events occurred
@@ -83,10 +93,10 @@ void ODSocketServer::doTask(int timeoutMs)
         }
 
         // Check if a client tries to connect or to communicate
-        if(!isSockReady)
+        if(!isSockReady && !isSendFailed)
             continue;
 
-        if(mSockSelector.isReady(mSockListener))
+        if(isSockReady && mSockSelector.isReady(mSockListener))
         {
             // New connection
             ODSocketClient* newClient = notifyNewConnection(mSockListener);
@@ -96,6 +106,7 @@ void ODSocketServer::doTask(int timeoutMs)
                 OD_LOG_INF("New client connected.");
                 // The server wants to keep the client
                 newClient->setSource(ODSocketClient::ODSource::network);
+                newClient->setBufferedSend(true);
                 mSockSelector.add(newClient->getSockClient());
                 mSockClients.push_back(newClient);
             }
@@ -106,7 +117,8 @@ void ODSocketServer::doTask(int timeoutMs)
             for(std::vector<ODSocketClient*>::iterator it = mSockClients.begin(); it != mSockClients.end();)
             {
                 ODSocketClient* client = *it;
-                if((mSockSelector.isReady(client->getSockClient())) &&
+                // Clients we could not send data to are also notified so that they get removed
+                if(((isSockReady && mSockSelector.isReady(client->getSockClient())) || client->isSendFailed()) &&
                     (!notifyClientMessage(client)))
                 {
                     // The server wants to remove the client
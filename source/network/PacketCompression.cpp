@@ -0,0 +1,247 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/PacketCompression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const std::size_t MIN_MATCH = 4;
+    const std::size_t MAX_OFFSET = 0xFFFF;
+    const uint32_t HASH_BITS = 12;
+    //! \brief Above this, the size given to decompress is considered wrong
+    const std::size_t MAX_UNCOMPRESSED_SIZE = 64 * 1024 * 1024;
+
+    inline uint32_t read32(const char* p)
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t hash32(uint32_t value)
+    {
+        return (value * 2654435761U) >> (32 - HASH_BITS);
+    }
+
+    //! \brief Writes the part of a length that does not fit in the token nibble
+    void writeLengthExtension(std::size_t length, std::vector<char>& output)
+    {
+        if(length < 15)
+            return;
+
+        length -= 15;
+        while(length >= 255)
+        {
+            output.push_back(static_cast<char>(255));
+            length -= 255;
+        }
+        output.push_back(static_cast<char>(length));
+    }
+
+    bool readLengthExtension(const unsigned char*& p, const unsigned char* end, std::size_t& length)
+    {
+        if(length < 15)
+            return true;
+
+        while(p < end)
+        {
+            unsigned char byte = *p++;
+            length += byte;
+            if(byte != 255)
+                return true;
+        }
+        return false;
+    }
+
+    void writeSequence(const char* literals, std::size_t nbLiterals, std::size_t offset,
+        std::size_t matchLength, std::vector<char>& output)
+    {
+        std::size_t matchCode = (matchLength >= MIN_MATCH) ? matchLength - MIN_MATCH : 0;
+        unsigned char token = static_cast<unsigned char>(
+            ((nbLiterals < 15 ? nbLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+        output.push_back(static_cast<char>(token));
+        writeLengthExtension(nbLiterals, output);
+        output.insert(output.end(), literals, literals + nbLiterals);
+
+        // The last sequence only has literals
+        if(matchLength == 0)
+            return;
+
+        output.push_back(static_cast<char>(offset & 0xFF));
+        output.push_back(static_cast<char>((offset >> 8) & 0xFF));
+        writeLengthExtension(matchCode, output);
+    }
+}
+
+namespace PacketCompression
+{
+Compressor::Compressor(const std::string& dictionary) :
+    mDictionarySize(0),
+    mDictionaryTable(static_cast<std::size_t>(1) << HASH_BITS, -1),
+    mHashTable(static_cast<std::size_t>(1) << HASH_BITS, -1),
+    mHashStamps(static_cast<std::size_t>(1) << HASH_BITS, 0),
+    mStamp(0)
+{
+    setDictionary(dictionary);
+}
+
+void Compressor::setDictionary(const std::string& dictionary)
+{
+    mInput.assign(dictionary.begin(), dictionary.end());
+    mDictionarySize = dictionary.size();
+    std::fill(mDictionaryTable.begin(), mDictionaryTable.end(), -1);
+    const char* base = mInput.data();
+    for(std::size_t i = 0; i + MIN_MATCH <= mDictionarySize; ++i)
+        mDictionaryTable[hash32(read32(base + i))] = static_cast<int32_t>(i);
+}
+
+std::size_t Compressor::compress(const char* data, std::size_t size, std::vector<char>& output)
+{
+    std::size_t initialSize = output.size();
+
+    // The dictionary is seen as data placed just before
+    mInput.resize(mDictionarySize);
+    mInput.insert(mInput.end(), data, data + size);
+    const char* base = mInput.data();
+    const std::size_t start = mDictionarySize;
+    const std::size_t end = mInput.size();
+
+    // The entries set by the previous calls are invalidated by changing the stamp
+    ++mStamp;
+    if(mStamp == 0)
+    {
+        std::fill(mHashStamps.begin(), mHashStamps.end(), 0);
+        mStamp = 1;
+    }
+
+    std::size_t anchor = start;
+    std::size_t pos = start;
+    while(pos + MIN_MATCH <= end)
+    {
+        uint32_t hash = hash32(read32(base + pos));
+        int32_t candidate = (mHashStamps[hash] == mStamp) ? mHashTable[hash] : mDictionaryTable[hash];
+        mHashTable[hash] = static_cast<int32_t>(pos);
+        mHashStamps[hash] = mStamp;
+        if((candidate < 0) ||
+           (pos - static_cast<std::size_t>(candidate) > MAX_OFFSET) ||
+           (read32(base + candidate) != read32(base + pos)))
+        {
+            ++pos;
+            continue;
+        }
+
+        std::size_t matchLength = MIN_MATCH;
+        while((pos + matchLength < end) &&
+              (base[candidate + matchLength] == base[pos + matchLength]))
+        {
+            ++matchLength;
+        }
+
+        writeSequence(base + anchor, pos - anchor, pos - static_cast<std::size_t>(candidate),
+            matchLength, output);
+        pos += matchLength;
+        anchor = pos;
+    }
+
+    writeSequence(base + anchor, end - anchor, 0, 0, output);
+    return output.size() - initialSize;
+}
+
+std::size_t compress(const char* data, std::size_t size, const std::string& dictionary,
+    std::vector<char>& output)
+{
+    Compressor compressor(dictionary);
+    return compressor.compress(data, size, output);
+}
+
+bool decompress(const char* data, std::size_t size, const std::string& dictionary,
+    std::size_t uncompressedSize, std::vector<char>& output)
+{
+    output.clear();
+    if(uncompressedSize > MAX_UNCOMPRESSED_SIZE)
+        return false;
+
+    std::vector<char> decoded;
+    decoded.reserve(dictionary.size() + uncompressedSize);
+    decoded.insert(decoded.end(), dictionary.begin(), dictionary.end());
+    const std::size_t expectedEnd = dictionary.size() + uncompressedSize;
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    while(p < end)
+    {
+        unsigned char token = *p++;
+        std::size_t nbLiterals = token >> 4;
+        if(!readLengthExtension(p, end, nbLiterals))
+            return false;
+        if((static_cast<std::size_t>(end - p) < nbLiterals) ||
+           (decoded.size() + nbLiterals > expectedEnd))
+        {
+            return false;
+        }
+
+        decoded.insert(decoded.end(), p, p + nbLiterals);
+        p += nbLiterals;
+
+        // Last sequence
+        if(p == end)
+            break;
+
+        if(end - p < 2)
+            return false;
+        std::size_t offset = static_cast<std::size_t>(p[0]) | (static_cast<std::size_t>(p[1]) << 8);
+        p += 2;
+        std::size_t matchLength = token & 0x0F;
+        if(!readLengthExtension(p, end, matchLength))
+            return false;
+        matchLength += MIN_MATCH;
+
+        if((offset == 0) ||
+           (offset > decoded.size()) ||
+           (decoded.size() + matchLength > expectedEnd))
+        {
+            return false;
+        }
+
+        // The match can overlap what it produces so we copy byte by byte
+        std::size_t from = decoded.size() - offset;
+        for(std::size_t i = 0; i < matchLength; ++i)
+            decoded.push_back(decoded[from + i]);
+    }
+
+    if(decoded.size() != expectedEnd)
+        return false;
+
+    output.assign(decoded.begin() + dictionary.size(), decoded.end());
+    return true;
+}
+
+uint32_t dictionaryHash(const std::string& dictionary)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261U;
+    for(char c : dictionary)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+}
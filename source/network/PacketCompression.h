@@ -0,0 +1,85 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PACKETCOMPRESSION_H
+#define PACKETCOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*! \brief Fast LZ77 compression used for the big network packets and for the replays.
+ *
+ * The format is close to LZ4 block format: a sequence of tokens, each one made of literals
+ * copied as is followed by a match (offset and length) in the data already decoded. Compression
+ * is much weaker than zlib but very fast, which matters as it is done on the server thread.
+ * A dictionary can be given to both compress and decompress. The data can then reference it
+ * as if it was just before. It allows to compress well the short packets containing names
+ * found in the dictionary. The same dictionary must be used on both sides.
+ */
+namespace PacketCompression
+{
+    //! \brief Packets smaller than this are not worth being compressed
+    const std::size_t MIN_SIZE_TO_COMPRESS = 128;
+
+    /*! \brief Compresses data with a given dictionary. The dictionary is hashed once when set
+     * and the buffers are kept between calls so that compressing a packet does not allocate
+     * once they are big enough. A compressor must not be used by several threads at once.
+     */
+    class Compressor
+    {
+    public:
+        explicit Compressor(const std::string& dictionary = std::string());
+
+        //! \brief Hashes the given dictionary. It will be used by the next calls to compress
+        void setDictionary(const std::string& dictionary);
+
+        //! \brief Appends to output the compressed data. Returns the number of bytes appended
+        std::size_t compress(const char* data, std::size_t size, std::vector<char>& output);
+
+    private:
+        //! \brief The dictionary followed by the data being compressed. Only the data
+        //! part is replaced at each call
+        std::vector<char> mInput;
+        std::size_t mDictionarySize;
+
+        //! \brief Last position in the dictionary for each hash (-1 if none)
+        std::vector<int32_t> mDictionaryTable;
+
+        //! \brief Last position in the data for each hash. An entry is only valid if its
+        //! stamp is the one of the current call. Otherwise, mDictionaryTable is used
+        std::vector<int32_t> mHashTable;
+        std::vector<uint32_t> mHashStamps;
+        uint32_t mStamp;
+    };
+
+    //! \brief Appends to output the compressed data. Returns the number of bytes appended.
+    //! The dictionary is hashed at each call. Compressor should be used to compress many packets
+    std::size_t compress(const char* data, std::size_t size, const std::string& dictionary,
+        std::vector<char>& output);
+
+    //! \brief Replaces output content with the decompressed data. uncompressedSize is the size of
+    //! the data given to compress. Returns false if data is not valid
+    bool decompress(const char* data, std::size_t size, const std::string& dictionary,
+        std::size_t uncompressedSize, std::vector<char>& output);
+
+    //! \brief Hash of the dictionary. Allows to check that both sides use the same one
+    uint32_t dictionaryHash(const std::string& dictionary);
+}
+
+#endif // PACKETCOMPRESSION_H
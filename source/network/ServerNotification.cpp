@@ -98,6 +98,8 @@ std::string ServerNotification::typeString(ServerNotificationType type)
             return "markTiles";
         case ServerNotificationType::refreshTiles:
             return "refreshTiles";
+        case ServerNotificationType::refreshTilesChanges:
+            return "refreshTilesChanges";
         case ServerNotificationType::refreshVisibleTiles:
             return "refreshVisibleTiles";
         case ServerNotificationType::carryEntity:
@@ -73,6 +73,7 @@ enum class ServerNotificationType
 
     markTiles,
     refreshTiles,
+    refreshTilesChanges, // Per turn tile refreshes with only the fields that changed
     refreshVisibleTiles,
     carryEntity,
     releaseCarriedEntity,
@@ -51,6 +51,7 @@
 #include <CEGUI/System.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 
@@ -208,8 +209,15 @@ bool ODFrameListener::frameRenderingQueued(const Ogre::FrameEvent& evt)
     printDebugInfo();
 
     mGameMap.get()->processDeletionQueues();
+    std::chrono::steady_clock::time_point networkStart = std::chrono::steady_clock::now();
     ODClient::getSingleton().processClientSocketMessages();
     ODClient::getSingleton().processClientNotifications();
+    uint64_t networkTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - networkStart).count();
+
+    uint64_t frameTime = static_cast<uint64_t>(evt.timeSinceLastFrame * 1000000.0f);
+    if(mFrameTimeStats.addFrame(frameTime, networkTime) && ODClient::getSingleton().isConnected())
+        OD_LOG_INF(mFrameTimeStats.getStatsText());
 
     return mContinue;
 }
@@ -25,6 +25,7 @@
 
 #include "camera/CameraManager.h"
 #include "utils/FrameRateLimiter.h"
+#include "utils/FrameTimeStats.h"
 
 #include <OgreFrameListener.h>
 #include <OgreSceneQuery.h>
@@ -171,6 +172,10 @@ public:
         return mFpsLimiter.getFrameRate();
     }
 
+    //! \brief Frame times of the last frames. Frames where the game is paused are not counted
+    inline FrameTimeStats& getFrameTimeStats()
+    { return mFrameTimeStats; }
+
 private:
     //! \brief Tells whether the frame listener is initialized.
     bool mInitialized;
@@ -199,6 +204,10 @@ private:
 
     FrameRateLimiter mFpsLimiter;
 
+    //! \brief Time between the frames and time spent processing the server messages. They are
+    //! logged every FrameTimeStats::NB_FRAMES_HISTORY frames while connected to a server
+    FrameTimeStats mFrameTimeStats;
+
     bool mIsMainMenuCreated;
 
     //! \brief Actually exit application
@@ -54,7 +54,7 @@ class RoomCasinoFactory : public RoomFactory
     { return RoomCasinoNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("CasinoCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfigParam::casinoCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -375,11 +375,11 @@ void RoomCasino::doUpkeep()
         // TODO: we could use the wall active spots to change feePercent/bets
 
         // We set anim for both creatures
-        uint32_t cooldown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("CasinoCooldownWorkMin"),
-            ConfigManager::getSingleton().getRoomConfigUInt32("CasinoCooldownWorkMax"));
-        double feePercent = std::min(ConfigManager::getSingleton().getRoomConfigDouble("CasinoFee"), 1.0);
-        double wakefullness = ConfigManager::getSingleton().getRoomConfigDouble("CasinoWakefulnessPerWork");
-        int32_t creatureBet = ConfigManager::getSingleton().getRoomConfigInt32("CasinoBet");
+        uint32_t cooldown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfigParam::casinoCooldownWorkMin),
+            ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfigParam::casinoCooldownWorkMax));
+        double feePercent = std::min(ConfigManager::getSingleton().getRoomConfigDouble(RoomConfigParam::casinoFee), 1.0);
+        double wakefullness = ConfigManager::getSingleton().getRoomConfigDouble(RoomConfigParam::casinoWakefulnessPerWork);
+        int32_t creatureBet = ConfigManager::getSingleton().getRoomConfigInt32(RoomConfigParam::casinoBet);
         creatureBet = std::min(creatureBet, p.second.mCreature1.mCreature->getGoldCarried());
         creatureBet = std::min(creatureBet, p.second.mCreature2.mCreature->getGoldCarried());
         int32_t totalBet = 0;
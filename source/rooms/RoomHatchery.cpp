@@ -49,7 +49,7 @@ class RoomHatcheryFactory : public RoomFactory
     { return RoomHatcheryNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("HatcheryCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfigParam::hatcheryCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -155,7 +155,7 @@ void RoomHatchery::doUpkeep()
 
     // Chickens have been eaten. We check when we will spawn another one
     ++mSpawnChickenCooldown;
-    if(mSpawnChickenCooldown < ConfigManager::getSingleton().getRoomConfigUInt32("HatcheryChickenSpawnRate"))
+    if(mSpawnChickenCooldown < ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfigParam::hatcheryChickenSpawnRate))
         return;
 
     // We spawn 1 chicken per chicken coop (until chickens are maxed)
@@ -216,8 +216,8 @@ void RoomPortal::doUpkeep()
         --mSpawnCreatureCountdown;
         return;
     }
-    mSpawnCreatureCountdown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMin"),
-        ConfigManager::getSingleton().getRoomConfigUInt32("PortalCooldownSpawnMax"));
+    mSpawnCreatureCountdown = Random::Uint(ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfigParam::portalCooldownSpawnMin),
+        ConfigManager::getSingleton().getRoomConfigUInt32(RoomConfigParam::portalCooldownSpawnMax));
 
     if (mCoveredTiles.empty())
         return;
@@ -53,7 +53,7 @@ class RoomPrisonFactory : public RoomFactory
     { return RoomPrisonNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getRoomConfigInt32("PrisonCostPerTile"); }
+    { return ConfigManager::getSingleton().getRoomConfigInt32(RoomConfigParam::prisonCostPerTile); }
 
     void checkBuildRoom(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const override
     {
@@ -210,7 +210,7 @@ void RoomPrison::doUpkeep()
 
             ++nbCreatures;
             // We slightly damage the prisoner
-            double damage = ConfigManager::getSingleton().getRoomConfigDouble("PrisonDamagePerTurn");
+            double damage = ConfigManager::getSingleton().getRoomConfigDouble(RoomConfigParam::prisonDamagePerTurn);
             creature->takeDamage(this, damage, 0.0, 0.0, 0.0, creatureTile, false);
             creature->increaseTurnsPrison();
 
@@ -235,7 +235,7 @@ void RoomPrison::doUpkeep()
             creature->removeFromGameMap();
             creature->deleteYourself();
 
-            const std::string& className = ConfigManager::getSingleton().getRoomConfigString("PrisonSpawnClass");
+            const std::string& className = ConfigManager::getSingleton().getRoomConfigString(RoomConfigParam::prisonSpawnClass);
             const CreatureDefinition* classToSpawn = getGameMap()->getClassDescription(className);
             if(classToSpawn == nullptr)
             {
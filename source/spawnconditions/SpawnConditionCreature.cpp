@@ -18,14 +18,16 @@
 #include "entities/Creature.h"
 
 #include "gamemap/GameMap.h"
+#include "utils/ScratchVector.h"
 
 #include "spawnconditions/SpawnConditionCreature.h"
 
 bool SpawnConditionCreature::computePointsForSeat(const GameMap& gameMap, const Seat& seat, int32_t& computedPoints) const
 {
     int32_t nbCreatures = 0;
-    std::vector<Creature*> creatures = gameMap.getCreaturesBySeat(&seat);
-    for(Creature* creature : creatures)
+    ScratchVector<Creature*> creatures;
+    gameMap.getCreaturesBySeat(&seat, *creatures);
+    for(Creature* creature : *creatures)
     {
         if(creature->getDefinition() == mCreatureDefinition)
             ++nbCreatures;
@@ -55,7 +55,7 @@ public:
 
     virtual void doUpkeep() override;
 
-    //! \brief Computes the visible tiles and tags them to know which are visible
+    //! \brief Computes the visible tiles and gives vision on them (see GameEntity::setVisionGiven)
     virtual void computeVisibleTiles()
     {}
 
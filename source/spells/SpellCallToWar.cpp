@@ -32,7 +32,6 @@
 
 const std::string SpellCallToWarName = "callToWar";
 const std::string SpellCallToWarNameDisplay = "Call to war";
-const std::string SpellCallToWarCooldownKey = "CallToWarCooldown";
 const SpellType SpellCallToWar::mSpellType = SpellType::callToWar;
 
 namespace
@@ -45,8 +44,8 @@ class SpellCallToWarFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCallToWarName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCallToWarCooldownKey; }
+    SpellConfigParam getCooldownParam() const override
+    { return SpellConfigParam::callToWarCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCallToWarNameDisplay; }
@@ -70,7 +69,7 @@ static SpellRegister reg(new SpellCallToWarFactory);
 
 SpellCallToWar::SpellCallToWar(GameMap* gameMap) :
     Spell(gameMap, SpellManager::getSpellNameFromSpellType(SpellType::callToWar), "WarBanner", 0.0,
-        ConfigManager::getSingleton().getSpellConfigInt32("CallToWarNbTurnsMax"))
+        ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::callToWarNbTurnsMax))
 {
     mPrevAnimationState = "Loop";
     mPrevAnimationStateLoop = true;
@@ -110,7 +109,7 @@ void SpellCallToWar::checkSpellCast(GameMap* gameMap, const InputManager& inputM
         return;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32("CallToWarPrice");
+    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::callToWarPrice);
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
         if(playerMana < price)
@@ -153,7 +152,7 @@ bool SpellCallToWar::castSpell(GameMap* gameMap, Player* player, ODPacket& packe
         return false;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32("CallToWarPrice");
+    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::callToWarPrice);
     if(playerMana < manaCost)
         return false;
 
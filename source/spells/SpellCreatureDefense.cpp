@@ -37,7 +37,6 @@
 
 const std::string SpellCreatureDefenseName = "creatureDefense";
 const std::string SpellCreatureDefenseNameDisplay = "Creature defense";
-const std::string SpellCreatureDefenseCooldownKey = "CreatureDefenseCooldown";
 const SpellType SpellCreatureDefense::mSpellType = SpellType::creatureDefense;
 
 namespace
@@ -50,8 +49,8 @@ class SpellCreatureDefenseFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureDefenseName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureDefenseCooldownKey; }
+    SpellConfigParam getCooldownParam() const override
+    { return SpellConfigParam::creatureDefenseCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureDefenseNameDisplay; }
@@ -76,7 +75,7 @@ static SpellRegister reg(new SpellCreatureDefenseFactory);
 void SpellCreatureDefense::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureDefensePrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureDefensePrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -194,13 +193,13 @@ bool SpellCreatureDefense::castSpell(GameMap* gameMap, Player* player, ODPacket&
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureDefensePrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureDefensePrice);
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureDefenseDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureDefenseValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfigParam::creatureDefenseDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfigParam::creatureDefenseValue);
     CreatureEffectDefense* effect = new CreatureEffectDefense(duration, value, 0.0, 0.0, "SpellCreatureDefense");
     creature->addCreatureEffect(effect);
 
@@ -36,7 +36,6 @@
 
 const std::string SpellCreatureHealName = "creatureHeal";
 const std::string SpellCreatureHealNameDisplay = "Creature heal";
-const std::string SpellCreatureHealCooldownKey = "CreatureHealCooldown";
 const SpellType SpellCreatureHeal::mSpellType = SpellType::creatureHeal;
 
 namespace
@@ -49,8 +48,8 @@ class SpellCreatureHealFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureHealName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureHealCooldownKey; }
+    SpellConfigParam getCooldownParam() const override
+    { return SpellConfigParam::creatureHealCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureHealNameDisplay; }
@@ -76,7 +75,7 @@ void SpellCreatureHeal::checkSpellCast(GameMap* gameMap, const InputManager& inp
 {
     Player* player = gameMap->getLocalPlayer();
     int32_t priceTotal = 0;
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHealPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureHealPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -233,7 +232,7 @@ bool SpellCreatureHeal::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
     if(creatures.empty())
         return false;
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureHealPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureHealPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     uint32_t nbTargets = std::min(static_cast<uint32_t>(playerMana / pricePerTarget), static_cast<uint32_t>(creatures.size()));
     int32_t priceTotal = nbTargets * pricePerTarget;
@@ -244,8 +243,8 @@ bool SpellCreatureHeal::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
     if(!player->getSeat()->takeMana(priceTotal))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureHealDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureHealValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfigParam::creatureHealDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfigParam::creatureHealValue);
     std::vector<Tile*> affectedTiles;
     for(Creature* creature : creatures)
     {
@@ -36,7 +36,6 @@
 
 const std::string SpellCreatureSlowName = "creatureSlow";
 const std::string SpellCreatureSlowNameDisplay = "Creature Slow";
-const std::string SpellCreatureSlowCooldownKey = "CreatureSlowCooldown";
 const SpellType SpellCreatureSlow::mSpellType = SpellType::creatureSlow;
 
 namespace
@@ -49,8 +48,8 @@ class SpellCreatureSlowFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureSlowName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureSlowCooldownKey; }
+    SpellConfigParam getCooldownParam() const override
+    { return SpellConfigParam::creatureSlowCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureSlowNameDisplay; }
@@ -75,7 +74,7 @@ static SpellRegister reg(new SpellCreatureSlowFactory);
 void SpellCreatureSlow::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureSlowPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureSlowPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +192,13 @@ bool SpellCreatureSlow::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureSlowPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureSlowPrice);
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureSlowDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureSlowValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfigParam::creatureSlowDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfigParam::creatureSlowValue);
     CreatureEffectSpeedChange* effect = new CreatureEffectSpeedChange(duration, value, "SpellCreatureSlow");
     creature->addCreatureEffect(effect);
 
@@ -36,7 +36,6 @@
 
 const std::string SpellCreatureStrengthName = "creatureStrength";
 const std::string SpellCreatureStrengthNameDisplay = "Creature Strength";
-const std::string SpellCreatureStrengthCooldownKey = "CreatureStrengthCooldown";
 const SpellType SpellCreatureStrength::mSpellType = SpellType::creatureStrength;
 
 namespace
@@ -49,8 +48,8 @@ class SpellCreatureStrengthFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureStrengthName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureStrengthCooldownKey; }
+    SpellConfigParam getCooldownParam() const override
+    { return SpellConfigParam::creatureStrengthCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureStrengthNameDisplay; }
@@ -75,7 +74,7 @@ static SpellRegister reg(new SpellCreatureStrengthFactory);
 void SpellCreatureStrength::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureStrengthPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureStrengthPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +192,13 @@ bool SpellCreatureStrength::castSpell(GameMap* gameMap, Player* player, ODPacket
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureStrengthPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureStrengthPrice);
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureStrengthDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureStrengthValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfigParam::creatureStrengthDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfigParam::creatureStrengthValue);
     CreatureEffectStrengthChange* effect = new CreatureEffectStrengthChange(duration, value, "SpellCreatureStrength");
     creature->addCreatureEffect(effect);
 
@@ -36,7 +36,6 @@
 
 const std::string SpellCreatureWeakName = "creatureWeak";
 const std::string SpellCreatureWeakNameDisplay = "Creature Weak";
-const std::string SpellCreatureWeakCooldownKey = "CreatureWeakCooldown";
 const SpellType SpellCreatureWeak::mSpellType = SpellType::creatureWeak;
 
 namespace
@@ -49,8 +48,8 @@ class SpellCreatureWeakFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellCreatureWeakName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellCreatureWeakCooldownKey; }
+    SpellConfigParam getCooldownParam() const override
+    { return SpellConfigParam::creatureWeakCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellCreatureWeakNameDisplay; }
@@ -75,7 +74,7 @@ static SpellRegister reg(new SpellCreatureWeakFactory);
 void SpellCreatureWeak::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
 {
     Player* player = gameMap->getLocalPlayer();
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureWeakPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureWeakPrice);
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
@@ -193,13 +192,13 @@ bool SpellCreatureWeak::castSpell(GameMap* gameMap, Player* player, ODPacket& pa
         return false;
     }
 
-    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32("CreatureWeakPrice");
+    int32_t pricePerTarget = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::creatureWeakPrice);
 
     if(!player->getSeat()->takeMana(pricePerTarget))
         return false;
 
-    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32("CreatureWeakDuration");
-    double value = ConfigManager::getSingleton().getSpellConfigDouble("CreatureWeakValue");
+    uint32_t duration = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfigParam::creatureWeakDuration);
+    double value = ConfigManager::getSingleton().getSpellConfigDouble(SpellConfigParam::creatureWeakValue);
     CreatureEffectStrengthChange* effect = new CreatureEffectStrengthChange(duration, value, "SpellCreatureWeak");
     creature->addCreatureEffect(effect);
 
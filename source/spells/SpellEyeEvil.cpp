@@ -32,7 +32,6 @@
 
 const std::string SpellEyeEvilName = "eyeEvil";
 const std::string SpellEyeEvilNameDisplay = "Eye of Evil";
-const std::string SpellEyeEvilCooldownKey = "EyeEvilCooldown";
 const SpellType SpellEyeEvil::mSpellType = SpellType::eyeEvil;
 
 namespace
@@ -45,8 +44,8 @@ class SpellEyeEvilFactory : public SpellFactory
     const std::string& getName() const override
     { return SpellEyeEvilName; }
 
-    const std::string& getCooldownKey() const override
-    { return SpellEyeEvilCooldownKey; }
+    SpellConfigParam getCooldownParam() const override
+    { return SpellConfigParam::eyeEvilCooldown; }
 
     const std::string& getNameReadable() const override
     { return SpellEyeEvilNameDisplay; }
@@ -70,7 +69,7 @@ static SpellRegister reg(new SpellEyeEvilFactory);
 
 SpellEyeEvil::SpellEyeEvil(GameMap* gameMap) :
     Spell(gameMap, SpellManager::getSpellNameFromSpellType(getSpellType()), "FlyingSkull", 0.0,
-        ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilNbTurns"))
+        ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::eyeEvilNbTurns))
 {
     mPrevAnimationState = "Triggered";
     mPrevAnimationStateLoop = true;
@@ -82,7 +81,11 @@ SpellEyeEvil::~SpellEyeEvil()
 
 void SpellEyeEvil::computeVisibleTiles()
 {
-    uint32_t radius = ConfigManager::getSingleton().getSpellConfigUInt32("EyeEvilRadiusTiles");
+    // The eye does not move. Once the vision is given, it stays the same
+    if(getVisionGivenSeat() == getSeat())
+        return;
+
+    uint32_t radius = ConfigManager::getSingleton().getSpellConfigUInt32(SpellConfigParam::eyeEvilRadiusTiles);
     Tile* posTile = getPositionTile();
     if(posTile == nullptr)
     {
@@ -91,8 +94,7 @@ void SpellEyeEvil::computeVisibleTiles()
     }
 
     std::vector<Tile*> tiles = getGameMap()->circularRegion(posTile->getX(), posTile->getY(), radius);
-    for(Tile* tile : tiles)
-        tile->notifyVision(getSeat());
+    setVisionGiven(getSeat(), tiles);
 }
 
 void SpellEyeEvil::checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand)
@@ -104,7 +106,7 @@ void SpellEyeEvil::checkSpellCast(GameMap* gameMap, const InputManager& inputMan
         return;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilPrice");
+    int32_t price = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::eyeEvilPrice);
     if(inputManager.mCommandState == InputCommandState::infoOnly)
     {
         if(playerMana < price)
@@ -147,7 +149,7 @@ bool SpellEyeEvil::castSpell(GameMap* gameMap, Player* player, ODPacket& packet)
         return false;
 
     int32_t playerMana = static_cast<int32_t>(player->getSeat()->getMana());
-    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32("EyeEvilPrice");
+    int32_t manaCost = ConfigManager::getSingleton().getSpellConfigInt32(SpellConfigParam::eyeEvilPrice);
     if(playerMana < manaCost)
         return false;
 
@@ -31,6 +31,7 @@ class Player;
 class Seat;
 class Spell;
 
+enum class SpellConfigParam;
 enum class SpellType;
 
 //! \brief Factory class to register a new spell
@@ -43,7 +44,7 @@ public:
     virtual SpellType getSpellType() const = 0;
     virtual const std::string& getName() const = 0;
     virtual const std::string& getNameReadable() const = 0;
-    virtual const std::string& getCooldownKey() const = 0;
+    virtual SpellConfigParam getCooldownParam() const = 0;
 
     virtual void checkSpellCast(GameMap* gameMap, const InputManager& inputManager, InputCommand& inputCommand) const = 0;
     virtual bool castSpell(GameMap* gameMap, Player* player, ODPacket& packet) const = 0;
@@ -0,0 +1,349 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE CreatureActionsBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include "creatureaction/CreatureAction.h"
+#include "creatureaction/CreatureActionCarryEntity.h"
+#include "creatureaction/CreatureActionClaimGroundTile.h"
+#include "creatureaction/CreatureActionClaimWallTile.h"
+#include "creatureaction/CreatureActionDigTile.h"
+#include "creatureaction/CreatureActionEatChicken.h"
+#include "creatureaction/CreatureActionFight.h"
+#include "creatureaction/CreatureActionFightFriendly.h"
+#include "creatureaction/CreatureActionFindHome.h"
+#include "creatureaction/CreatureActionFlee.h"
+#include "creatureaction/CreatureActionGetFee.h"
+#include "creatureaction/CreatureActionGoCallToWar.h"
+#include "creatureaction/CreatureActionGrabEntity.h"
+#include "creatureaction/CreatureActionLeaveDungeon.h"
+#include "creatureaction/CreatureActionSearchEntityToCarry.h"
+#include "creatureaction/CreatureActionSearchFood.h"
+#include "creatureaction/CreatureActionSearchGroundTileToClaim.h"
+#include "creatureaction/CreatureActionSearchJob.h"
+#include "creatureaction/CreatureActionSearchTileToDig.h"
+#include "creatureaction/CreatureActionSearchWallTileToClaim.h"
+#include "creatureaction/CreatureActionSleep.h"
+#include "creatureaction/CreatureActionStealFreeGold.h"
+#include "creatureaction/CreatureActionUseRoom.h"
+#include "creatureaction/CreatureActionWalkToTile.h"
+#include "utils/AllocationCounter.h"
+#include "utils/BlockPool.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+//! \brief Action queue working like the one in Creature
+class ActionQueue
+{
+public:
+    ActionQueue()
+    { mActions.reserve(8); }
+
+    void pushAction(std::unique_ptr<CreatureAction>&& action)
+    { mActions.push_back(std::move(action)); }
+
+    void popAction()
+    { mActions.pop_back(); }
+
+    bool empty() const
+    { return mActions.empty(); }
+
+    CreatureAction* back()
+    { return mActions.back().get(); }
+
+private:
+    std::vector<std::unique_ptr<CreatureAction>> mActions;
+};
+
+// The mocked actions never use the creature so we just need something to reference
+static char creatureStorage[16];
+
+static Creature& getCreature()
+{ return *reinterpret_cast<Creature*>(creatureStorage); }
+
+//! \brief Walks during a few turns then pops itself
+class ActionWalk : public CreatureAction
+{
+public:
+    ActionWalk(ActionQueue& queue, int32_t nbTurnsToWalk) :
+        CreatureAction(getCreature()),
+        mQueue(queue),
+        mNbTurnsToWalk(nbTurnsToWalk)
+    {}
+
+    CreatureActionType getType() const override
+    { return CreatureActionType::walkToTile; }
+
+    bool action() override
+    { return handleWalk(mQueue, getNbTurns(), mNbTurnsToWalk); }
+
+    static bool handleWalk(ActionQueue& queue, int32_t nbTurns, int32_t nbTurnsToWalk)
+    {
+        if(nbTurns < nbTurnsToWalk)
+            return false;
+
+        queue.popAction();
+        return true;
+    }
+
+private:
+    ActionQueue& mQueue;
+    int32_t mNbTurnsToWalk;
+};
+
+//! \brief Works on some tiles (bigger than the other actions)
+class ActionWork : public CreatureAction
+{
+public:
+    ActionWork(ActionQueue& queue, const std::vector<int32_t>& tiles) :
+        CreatureAction(getCreature()),
+        mQueue(queue),
+        mTiles(tiles)
+    {}
+
+    CreatureActionType getType() const override
+    { return CreatureActionType::digTile; }
+
+    bool action() override
+    { return handleWork(mQueue, getNbTurns(), mTiles.size()); }
+
+    static bool handleWork(ActionQueue& queue, int32_t nbTurns, std::size_t nbTiles)
+    {
+        if(nbTurns < static_cast<int32_t>(nbTiles))
+            return false;
+
+        queue.popAction();
+        return true;
+    }
+
+private:
+    ActionQueue& mQueue;
+    std::vector<int32_t> mTiles;
+};
+
+//! \brief Searches something to do and pushes the corresponding actions
+class ActionSearch : public CreatureAction
+{
+public:
+    ActionSearch(ActionQueue& queue) :
+        CreatureAction(getCreature()),
+        mQueue(queue)
+    {}
+
+    CreatureActionType getType() const override
+    { return CreatureActionType::searchJob; }
+
+    bool action() override
+    { return handleSearch(mQueue); }
+
+    static bool handleSearch(ActionQueue& queue)
+    {
+        // Like the real actions, we pop ourselves before pushing the next ones
+        queue.popAction();
+        queue.pushAction(std::unique_ptr<CreatureAction>(new ActionSearch(queue)));
+        queue.pushAction(std::unique_ptr<CreatureAction>(new ActionWork(queue, std::vector<int32_t>())));
+        queue.pushAction(std::unique_ptr<CreatureAction>(new ActionWalk(queue, 2)));
+        return true;
+    }
+
+private:
+    ActionQueue& mQueue;
+};
+
+//! \brief Runs the actions like Creature::doUpkeep does
+static uint32_t doUpkeep(ActionQueue& queue)
+{
+    uint32_t nbActions = 0;
+    bool loopBack;
+    int32_t loops = 0;
+    do
+    {
+        ++loops;
+        loopBack = false;
+        if(queue.empty())
+        {
+            queue.pushAction(std::unique_ptr<CreatureAction>(new ActionSearch(queue)));
+            loopBack = true;
+        }
+        else
+        {
+            ++nbActions;
+            loopBack = queue.back()->action();
+        }
+    } while (loopBack && loops < 20);
+
+    if(!queue.empty())
+        queue.back()->increaseNbTurn();
+
+    return nbActions;
+}
+
+BOOST_AUTO_TEST_CASE(test_BlockPool)
+{
+    void* ptr1 = BlockPool::allocate(40);
+    void* ptr2 = BlockPool::allocate(40);
+    BOOST_CHECK(ptr1 != ptr2);
+    BlockPool::release(ptr1, 40);
+    BlockPool::release(ptr2, 40);
+
+    // Released blocks should be given back for the same size class
+    uint64_t nbAllocationsBefore = AllocationCounter::getNbAllocations();
+    void* ptr3 = BlockPool::allocate(33);
+    void* ptr4 = BlockPool::allocate(48);
+    BOOST_CHECK_EQUAL(AllocationCounter::getNbAllocations(), nbAllocationsBefore);
+    BOOST_CHECK(ptr3 == ptr2);
+    BOOST_CHECK(ptr4 == ptr1);
+    BlockPool::release(ptr3, 33);
+    BlockPool::release(ptr4, 48);
+
+    // Another size class should not get these blocks
+    void* ptr5 = BlockPool::allocate(64);
+    BOOST_CHECK(ptr5 != ptr1);
+    BOOST_CHECK(ptr5 != ptr2);
+    BlockPool::release(ptr5, 64);
+}
+
+BOOST_AUTO_TEST_CASE(test_BlockPoolThreadExit)
+{
+    // The blocks freed by a thread that exited should be reused by the other threads. We use
+    // a size class no other test uses
+    const std::size_t size = 250;
+    void* ptrThread = nullptr;
+    std::thread thread([&ptrThread, size]()
+    {
+        ptrThread = BlockPool::allocate(size);
+        BlockPool::release(ptrThread, size);
+    });
+    thread.join();
+
+    uint64_t nbAllocationsBefore = AllocationCounter::getNbAllocations();
+    void* ptr = BlockPool::allocate(size);
+    BOOST_CHECK_EQUAL(AllocationCounter::getNbAllocations(), nbAllocationsBefore);
+    BOOST_CHECK(ptr == ptrThread);
+    BlockPool::release(ptr, size);
+}
+
+//! \brief Sizes of the real creature actions. The actions cannot be run without a game map so
+//! we allocate and release their blocks in the same order as Creature::doUpkeep would
+static const std::size_t REAL_ACTION_SIZES[] =
+{
+    sizeof(CreatureActionCarryEntity),
+    sizeof(CreatureActionClaimGroundTile),
+    sizeof(CreatureActionClaimWallTile),
+    sizeof(CreatureActionDigTile),
+    sizeof(CreatureActionEatChicken),
+    sizeof(CreatureActionFight),
+    sizeof(CreatureActionFightFriendly),
+    sizeof(CreatureActionFindHome),
+    sizeof(CreatureActionFlee),
+    sizeof(CreatureActionGetFee),
+    sizeof(CreatureActionGoCallToWar),
+    sizeof(CreatureActionGrabEntity),
+    sizeof(CreatureActionLeaveDungeon),
+    sizeof(CreatureActionSearchEntityToCarry),
+    sizeof(CreatureActionSearchFood),
+    sizeof(CreatureActionSearchGroundTileToClaim),
+    sizeof(CreatureActionSearchJob),
+    sizeof(CreatureActionSearchTileToDig),
+    sizeof(CreatureActionSearchWallTileToClaim),
+    sizeof(CreatureActionSleep),
+    sizeof(CreatureActionStealFreeGold),
+    sizeof(CreatureActionUseRoom),
+    sizeof(CreatureActionWalkToTile)
+};
+
+BOOST_AUTO_TEST_CASE(test_RealCreatureActionsAllocations)
+{
+    BOOST_REQUIRE(AllocationCounter::isEnabled());
+
+    // Every real action must fit in a pool block. Otherwise, it would be allocated on each push
+    for(std::size_t size : REAL_ACTION_SIZES)
+        BOOST_CHECK(size <= BlockPool::MAX_BLOCK_SIZE);
+
+    // Each creature pushes a few actions of every kind and pops them (in another order) each turn
+    const uint32_t nbCreatures = 200;
+    const uint32_t nbTurns = 100;
+    const std::size_t nbSizes = sizeof(REAL_ACTION_SIZES) / sizeof(REAL_ACTION_SIZES[0]);
+    std::vector<std::vector<void*>> actions(nbCreatures);
+    uint64_t nbAllocationsTurns = 0;
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        // The first turn fills the pool
+        uint64_t nbAllocationsBefore = AllocationCounter::getNbAllocations();
+        for(uint32_t creature = 0; creature < nbCreatures; ++creature)
+        {
+            std::vector<void*>& queue = actions[creature];
+            for(std::size_t i = 0; i < 4; ++i)
+            {
+                std::size_t size = REAL_ACTION_SIZES[(creature + turn + i) % nbSizes];
+                queue.push_back(CreatureAction::operator new(size));
+            }
+            for(std::size_t i = 0; i < 4; ++i)
+            {
+                std::size_t size = REAL_ACTION_SIZES[(creature + turn + 3 - i) % nbSizes];
+                CreatureAction::operator delete(queue.back(), size);
+                queue.pop_back();
+            }
+        }
+        if(turn > 0)
+            nbAllocationsTurns += AllocationCounter::getNbAllocations() - nbAllocationsBefore;
+    }
+
+    BOOST_CHECK_EQUAL(nbAllocationsTurns, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_CreatureActionsSteadyStateAllocations)
+{
+    BOOST_REQUIRE(AllocationCounter::isEnabled());
+
+    const uint32_t nbCreatures = 500;
+    const uint32_t nbTurns = 2000;
+    std::vector<ActionQueue> queues(nbCreatures);
+
+    // Warm up: the first turns fill the pool
+    for(uint32_t turn = 0; turn < 10; ++turn)
+    {
+        for(ActionQueue& queue : queues)
+            doUpkeep(queue);
+    }
+
+    uint64_t nbAllocationsBefore = AllocationCounter::getNbAllocations();
+    uint64_t nbActions = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t turn = 0; turn < nbTurns; ++turn)
+    {
+        for(ActionQueue& queue : queues)
+            nbActions += doUpkeep(queue);
+    }
+    auto end = std::chrono::steady_clock::now();
+    uint64_t nbAllocationsTurns = AllocationCounter::getNbAllocations() - nbAllocationsBefore;
+
+    BOOST_CHECK(nbActions > 0);
+    BOOST_CHECK_EQUAL(nbAllocationsTurns, 0u);
+
+    std::stringstream ss;
+    ss << nbActions << " actions in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms, "
+        << nbAllocationsTurns << " allocations";
+    BOOST_TEST_MESSAGE(ss.str());
+}
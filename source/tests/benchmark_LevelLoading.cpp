@@ -0,0 +1,188 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE LevelLoadingBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include "gamemap/BinaryLevel.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//! \brief Tile as filled by the level loading
+struct LoadedTile
+{
+    int mX;
+    int mY;
+    int mType;
+    double mFullness;
+    int mSeatId;
+};
+
+//! \brief Writes a text level with a sizeX * sizeY map similar to the official levels
+static void writeTextLevel(const std::string& fileName, int sizeX, int sizeY)
+{
+    std::srand(0);
+    std::ofstream os(fileName);
+    os << "0.7.0\n[Info]\nName\tBenchmark\n[/Info]\n";
+    os << "[Tiles]\n# Map size\n" << sizeX << "\n" << sizeY << "\n";
+    os << "# Tiles\n";
+    for(int y = 0; y < sizeY; ++y)
+    {
+        for(int x = 0; x < sizeX; ++x)
+        {
+            int type = std::rand() % 6;
+            double fullness = (type == 2) ? 0.0 : 100.0;
+            os << x << "\t" << y << "\t" << type << "\t" << fullness;
+            if(std::rand() % 10 == 0)
+                os << "\t" << (std::rand() % 4);
+            os << "\n";
+        }
+    }
+    os << "[/Tiles]\n[Rooms]\n0\n[/Rooms]\n";
+}
+
+//! \brief Copy of the text level tile loading (Helper::readFileWithoutComments then Tile::loadFromLine)
+static void loadTextTiles(const std::string& fileName, std::vector<LoadedTile>& tiles)
+{
+    std::stringstream levelFile;
+    std::ifstream baseLevelFile(fileName.c_str(), std::ifstream::in);
+    std::string nextParam;
+    while (baseLevelFile.good())
+    {
+        std::getline(baseLevelFile, nextParam);
+        levelFile << nextParam.substr(0, nextParam.find('#')) << "\n";
+    }
+
+    while(levelFile.good())
+    {
+        levelFile >> nextParam;
+        if(nextParam == "[Tiles]")
+            break;
+    }
+    int mapSizeX;
+    int mapSizeY;
+    levelFile >> mapSizeX;
+    levelFile >> mapSizeY;
+    tiles.clear();
+    while(levelFile.good())
+    {
+        levelFile >> nextParam;
+        if (nextParam == "[/Tiles]")
+            break;
+
+        std::string entireLine = nextParam;
+        std::getline(levelFile, nextParam);
+        entireLine += nextParam;
+
+        std::vector<std::string> elems;
+        std::stringstream ss(entireLine);
+        std::string item;
+        while (std::getline(ss, item, '\t'))
+            elems.push_back(item);
+
+        LoadedTile tile;
+        std::stringstream(elems[0]) >> tile.mX;
+        std::stringstream(elems[1]) >> tile.mY;
+        std::stringstream(elems[2]) >> tile.mType;
+        std::stringstream(elems[3]) >> tile.mFullness;
+        tile.mSeatId = 0;
+        if(elems.size() >= 5)
+            std::stringstream(elems[4]) >> tile.mSeatId;
+        tiles.push_back(tile);
+    }
+}
+
+static void loadBinaryTiles(const std::string& fileName, std::vector<LoadedTile>& tiles)
+{
+    BinaryLevelReader reader;
+    if(!reader.open(fileName))
+        return;
+
+    tiles.clear();
+    const BinaryLevel::TileRecord* records = reader.getTiles();
+    for(uint32_t i = 0; i < reader.getNbTiles(); ++i)
+    {
+        const BinaryLevel::TileRecord& record = records[i];
+        LoadedTile tile;
+        tile.mX = record.mX;
+        tile.mY = record.mY;
+        tile.mType = record.mType;
+        tile.mFullness = record.mFullness;
+        tile.mSeatId = (record.mHasSeat != 0) ? record.mSeatId : 0;
+        tiles.push_back(tile);
+    }
+}
+
+template<typename F>
+static double timeLoading(F load, const std::string& fileName, std::vector<LoadedTile>& tiles)
+{
+    const int nbLoads = 5;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < nbLoads; ++i)
+        load(fileName, tiles);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / nbLoads;
+}
+
+BOOST_AUTO_TEST_CASE(test_LevelLoading)
+{
+    const std::string textFile = "benchmark_LevelLoading.level";
+    const std::string binaryFile = "benchmark_LevelLoading.bin.level";
+    const int sizes[] = { 100, 200, 400 };
+    for(int size : sizes)
+    {
+        writeTextLevel(textFile, size, size);
+        std::string error;
+        BOOST_REQUIRE(BinaryLevel::convertLevelFile(textFile, binaryFile, error));
+
+        std::vector<LoadedTile> textTiles;
+        std::vector<LoadedTile> binaryTiles;
+        double textTime = timeLoading(loadTextTiles, textFile, textTiles);
+        double binaryTime = timeLoading(loadBinaryTiles, binaryFile, binaryTiles);
+
+        // Both formats give the same tiles
+        BOOST_REQUIRE(textTiles.size() == static_cast<uint32_t>(size * size));
+        BOOST_REQUIRE(binaryTiles.size() == textTiles.size());
+        bool sameTiles = true;
+        for(uint32_t i = 0; i < textTiles.size(); ++i)
+        {
+            const LoadedTile& t1 = textTiles[i];
+            const LoadedTile& t2 = binaryTiles[i];
+            if((t1.mX != t2.mX) || (t1.mY != t2.mY) || (t1.mType != t2.mType) ||
+               (t1.mFullness != t2.mFullness) || (t1.mSeatId != t2.mSeatId))
+            {
+                sameTiles = false;
+                break;
+            }
+        }
+        BOOST_CHECK(sameTiles);
+
+        std::stringstream ss;
+        ss << "Map " << size << "x" << size << ": text tiles=" << textTime << "ms, binary tiles="
+            << binaryTime << "ms";
+        BOOST_TEST_MESSAGE(ss.str());
+    }
+
+    std::remove(textFile.c_str());
+    std::remove(binaryFile.c_str());
+}
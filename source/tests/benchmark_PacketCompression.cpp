@@ -0,0 +1,238 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE PacketCompressionBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include "network/PacketCompression.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//! \brief Writes the values like sf::Packet does: integers and string sizes in big endian,
+//! floating point values as they are in memory
+class PacketWriter
+{
+public:
+    explicit PacketWriter(std::vector<char>& data) :
+        mData(data)
+    {}
+
+    PacketWriter& operator<<(uint32_t value)
+    {
+        mData.push_back(static_cast<char>((value >> 24) & 0xFF));
+        mData.push_back(static_cast<char>((value >> 16) & 0xFF));
+        mData.push_back(static_cast<char>((value >> 8) & 0xFF));
+        mData.push_back(static_cast<char>(value & 0xFF));
+        return *this;
+    }
+
+    PacketWriter& operator<<(int32_t value)
+    { return *this << static_cast<uint32_t>(value); }
+
+    PacketWriter& operator<<(bool value)
+    {
+        mData.push_back(value ? 1 : 0);
+        return *this;
+    }
+
+    PacketWriter& operator<<(float value)
+    { return writeRaw(&value, sizeof(value)); }
+
+    PacketWriter& operator<<(double value)
+    { return writeRaw(&value, sizeof(value)); }
+
+    PacketWriter& operator<<(const std::string& value)
+    {
+        *this << static_cast<uint32_t>(value.size());
+        mData.insert(mData.end(), value.begin(), value.end());
+        return *this;
+    }
+
+private:
+    PacketWriter& writeRaw(const void* value, std::size_t size)
+    {
+        const char* bytes = static_cast<const char*>(value);
+        mData.insert(mData.end(), bytes, bytes + size);
+        return *this;
+    }
+
+    std::vector<char>& mData;
+};
+
+//! \brief Reads the lines of the given section of a level or config file without the comments
+static std::vector<std::vector<std::string>> readSection(const std::string& fileName, const std::string& section)
+{
+    std::vector<std::vector<std::string>> lines;
+    std::ifstream file(fileName.c_str());
+    std::string line;
+    bool inSection = false;
+    while(std::getline(file, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::vector<std::string> elems;
+        std::stringstream ss(line);
+        std::string item;
+        while(ss >> item)
+            elems.push_back(item);
+
+        if(elems.empty())
+            continue;
+
+        if(elems[0] == "[" + section + "]")
+            inSection = true;
+        else if(elems[0] == "[/" + section + "]")
+            inSection = false;
+        else if(inSection)
+            lines.push_back(elems);
+    }
+    return lines;
+}
+
+//! \brief Copy of ConfigManager::buildPacketDictionary from the config files
+static std::string buildDictionary()
+{
+    std::string dictionary;
+    std::vector<char> data;
+    PacketWriter writer(data);
+    const std::pair<const char*, const char*> sections[] = {
+        { "creatures.cfg", "CreatureDefinitions" },
+        { "equipments.cfg", "EquipmentDefinitions" }
+    };
+    for(const std::pair<const char*, const char*>& section : sections)
+    {
+        for(const std::vector<std::string>& elems : readSection(std::string(OD_CONFIG_PATH) + section.first, section.second))
+        {
+            if((elems.size() >= 2) && ((elems[0] == "Name") || (elems[0] == "MeshName")))
+                writer << elems[1];
+        }
+    }
+    return std::string(data.begin(), data.end());
+}
+
+//! \brief Tiles part of the loadLevel packet sent by ODServer: the gold, rock and gem tiles positions
+static std::vector<char> buildLoadLevelTiles(const std::string& levelFile)
+{
+    std::vector<std::vector<std::string>> tiles = readSection(levelFile, "Tiles");
+    std::vector<char> data;
+    PacketWriter writer(data);
+    const int32_t tileTypes[] = { 2, 3, 6 }; // TileType::gold, rock and gem
+    for(int32_t tileType : tileTypes)
+    {
+        std::vector<std::pair<int32_t, int32_t>> positions;
+        // The first 2 lines are the map size
+        for(uint32_t i = 2; i < tiles.size(); ++i)
+        {
+            if((tiles[i].size() >= 3) && (std::stoi(tiles[i][2]) == tileType))
+                positions.emplace_back(std::stoi(tiles[i][0]), std::stoi(tiles[i][1]));
+        }
+        writer << static_cast<int32_t>(positions.size());
+        for(const std::pair<int32_t, int32_t>& pos : positions)
+            writer << pos.first << pos.second;
+    }
+    return data;
+}
+
+//! \brief One addEntity packet per creature of the level, laid out as Creature::exportToPacket.
+//! The values not in the level file are set to usual ones
+static std::vector<std::vector<char>> buildAddCreatures(const std::string& levelFile)
+{
+    std::vector<std::vector<char>> packets;
+    int32_t id = 0;
+    for(const std::vector<std::string>& elems : readSection(levelFile, "Creatures"))
+    {
+        if(elems.size() < 15)
+            continue;
+
+        packets.emplace_back();
+        PacketWriter writer(packets.back());
+        writer << id++ << static_cast<int32_t>(std::stoi(elems[0]));
+        writer << elems[1] << elems[2];
+        writer << std::stof(elems[3]) << std::stof(elems[4]) << std::stof(elems[5]);
+        writer << static_cast<uint32_t>(0);
+        writer << std::string("Idle") << true << 0.0f << 0.0f << 0.0f;
+        writer << elems[6] << static_cast<uint32_t>(std::stoi(elems[7])) << 0.0;
+        writer << 100.0 << 100.0 << 0.5 << 0.5 << 100.0 << 0.0;
+        writer << 1.0 << 0.0 << 0.0 << 2.0 << 1.0 << 0.5;
+        writer << static_cast<uint32_t>(0) << static_cast<uint32_t>(0) << 1.0;
+        writer << elems[13] << elems[14];
+    }
+    return packets;
+}
+
+//! \brief Compresses each packet like ODSocketClient does and checks it can be decompressed
+static void benchmarkPackets(const std::string& name, const std::vector<std::vector<char>>& packets,
+    const std::string& dictionary)
+{
+    PacketCompression::Compressor compressor(dictionary);
+    std::vector<char> compressed;
+    std::vector<char> decompressed;
+    std::size_t rawSize = 0;
+    std::size_t compressedSize = 0;
+    double compressionTime = 0.0;
+    bool roundTripOk = true;
+    for(const std::vector<char>& packet : packets)
+    {
+        rawSize += packet.size();
+        if(packet.size() < PacketCompression::MIN_SIZE_TO_COMPRESS)
+        {
+            compressedSize += packet.size();
+            continue;
+        }
+
+        compressed.clear();
+        auto start = std::chrono::steady_clock::now();
+        compressor.compress(packet.data(), packet.size(), compressed);
+        compressionTime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        compressedSize += compressed.size();
+
+        if(!PacketCompression::decompress(compressed.data(), compressed.size(), dictionary, packet.size(), decompressed) ||
+           (decompressed != packet))
+        {
+            roundTripOk = false;
+        }
+    }
+    BOOST_CHECK(roundTripOk);
+    BOOST_CHECK(compressedSize < rawSize);
+
+    std::stringstream ss;
+    ss << name << (dictionary.empty() ? " (no dictionary)" : " (dictionary)") << ": " << packets.size()
+        << " packets, " << rawSize << " bytes, compressed " << compressedSize << " bytes ("
+        << (100 * compressedSize / rawSize) << "%) in " << compressionTime << "us";
+    BOOST_TEST_MESSAGE(ss.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_PacketCompressionStoneKeep)
+{
+    const std::string levelFile = std::string(OD_LEVELS_PATH) + "skirmish/StoneKeep.level";
+    std::vector<std::vector<char>> loadLevel = { buildLoadLevelTiles(levelFile) };
+    std::vector<std::vector<char>> addCreatures = buildAddCreatures(levelFile);
+    BOOST_REQUIRE(loadLevel[0].size() > 12);
+    BOOST_REQUIRE(!addCreatures.empty());
+
+    const std::string dictionary = buildDictionary();
+    BOOST_REQUIRE(!dictionary.empty());
+    for(const std::string& dict : { std::string(), dictionary })
+    {
+        benchmarkPackets("loadLevel tiles", loadLevel, dict);
+        benchmarkPackets("addEntity creatures", addCreatures, dict);
+    }
+}
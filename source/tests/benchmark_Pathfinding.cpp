@@ -0,0 +1,350 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE PathfindingBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include "gamemap/PathfindingEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+//! \brief Grid used to compare the sorted list A* formerly used in GameMap::path with PathfindingEngine.
+//! Tiles can be walkable ('.', with a speed depending on the tile), diggable ('d') or blocked ('#')
+struct BenchGrid
+{
+    int mSizeX;
+    int mSizeY;
+    std::vector<char> mTiles;
+
+    BenchGrid(int sizeX, int sizeY, unsigned int seed) :
+        mSizeX(sizeX),
+        mSizeY(sizeY),
+        mTiles(sizeX * sizeY, '.')
+    {
+        std::srand(seed);
+        for(char& c : mTiles)
+        {
+            int r = std::rand() % 100;
+            if(r < 25)
+                c = '#';
+            else if(r < 35)
+                c = 'd';
+            else if(r < 45)
+                c = 'w';
+        }
+    }
+
+    char get(int x, int y) const
+    { return mTiles[y * mSizeX + x]; }
+
+    PathfindingAccess access(int x, int y, bool throughDiggable) const
+    {
+        char c = get(x, y);
+        if(c == '.' || c == 'w')
+            return PathfindingAccess::walkable;
+        if(throughDiggable && c == 'd')
+            return PathfindingAccess::crossable;
+        return PathfindingAccess::blocked;
+    }
+
+    double speed(int x, int y) const
+    { return get(x, y) == 'w' ? 0.5 : 1.0; }
+};
+
+//! \brief Copy of the former GameMap::path algorithm (sorted vector open list and one heap allocated entry per tile)
+struct ReferenceEntry
+{
+    int x;
+    int y;
+    ReferenceEntry* parent;
+    double g;
+    double h;
+    bool processed;
+
+    double fCost() const
+    { return g + h; }
+};
+
+static bool referencePath(const BenchGrid& grid, int x1, int y1, int x2, int y2, bool throughDiggable,
+    std::vector<uint32_t>& path)
+{
+    path.clear();
+    ReferenceEntry* currentEntry = new ReferenceEntry{x1, y1, nullptr, 0.0,
+        PathfindingEngine::computeHeuristic(x1, y1, x2, y2), false};
+    std::vector<ReferenceEntry*> openList;
+    openList.push_back(currentEntry);
+    std::vector<std::vector<ReferenceEntry*>> processList(grid.mSizeX, std::vector<ReferenceEntry*>(grid.mSizeY, nullptr));
+    processList[x1][y1] = currentEntry;
+    ReferenceEntry* destinationEntry = nullptr;
+    static const int dx[8] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    static const int dy[8] = {0, 0, -1, 1, -1, 1, -1, 1};
+    while(!openList.empty())
+    {
+        currentEntry = openList.back();
+        openList.pop_back();
+        currentEntry->processed = true;
+        if(currentEntry->x == x2 && currentEntry->y == y2)
+        {
+            destinationEntry = currentEntry;
+            break;
+        }
+
+        bool passable[4] = {false, false, false, false};
+        for(int i = 0; i < 8; ++i)
+        {
+            if(i == 4 && !(passable[0] && passable[2])) continue;
+            if(i == 5 && !(passable[0] && passable[3])) continue;
+            if(i == 6 && !(passable[1] && passable[2])) continue;
+            if(i == 7 && !(passable[1] && passable[3])) continue;
+            int nx = currentEntry->x + dx[i];
+            int ny = currentEntry->y + dy[i];
+            if(nx < 0 || ny < 0 || nx >= grid.mSizeX || ny >= grid.mSizeY)
+                continue;
+
+            PathfindingAccess acc = (nx == x1 && ny == y1) ? PathfindingAccess::walkable : grid.access(nx, ny, throughDiggable);
+            if(acc == PathfindingAccess::blocked)
+                continue;
+            if(i < 4 && acc == PathfindingAccess::walkable)
+                passable[i] = true;
+
+            ReferenceEntry* neighborEntry = processList[nx][ny];
+            if(neighborEntry != nullptr && neighborEntry->processed)
+                continue;
+
+            double w = PathfindingEngine::computeHeuristic(nx, ny, currentEntry->x, currentEntry->y)
+                / grid.speed(currentEntry->x, currentEntry->y);
+            if(neighborEntry == nullptr)
+            {
+                ReferenceEntry* entry = new ReferenceEntry{nx, ny, currentEntry, currentEntry->g + w,
+                    PathfindingEngine::computeHeuristic(nx, ny, x2, y2), false};
+                auto itr = openList.begin();
+                while(itr != openList.end() && (*itr)->fCost() > entry->fCost())
+                    ++itr;
+                openList.insert(itr, entry);
+                processList[nx][ny] = entry;
+            }
+            else if(currentEntry->g + w < neighborEntry->g)
+            {
+                neighborEntry->g = currentEntry->g + w;
+                neighborEntry->parent = currentEntry;
+                auto itr = std::find(openList.begin(), openList.end(), neighborEntry);
+                itr = openList.erase(itr);
+                while(itr != openList.end() && (*itr)->fCost() > neighborEntry->fCost())
+                    ++itr;
+                openList.insert(itr, neighborEntry);
+            }
+        }
+    }
+
+    for(ReferenceEntry* entry = destinationEntry; entry != nullptr; entry = entry->parent)
+        path.insert(path.begin(), static_cast<uint32_t>(entry->y * grid.mSizeX + entry->x));
+
+    for(std::vector<ReferenceEntry*>& column : processList)
+        for(ReferenceEntry* entry : column)
+            delete entry;
+
+    return destinationEntry != nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(test_PathfindingEngineSamePaths)
+{
+    BenchGrid grid(64, 64, 42);
+    PathfindingEngine engine;
+    engine.setMapSize(grid.mSizeX, grid.mSizeY);
+    std::vector<uint32_t> refPath;
+    std::vector<uint32_t> enginePath;
+    std::srand(1234);
+    for(int i = 0; i < 300; ++i)
+    {
+        int x1 = std::rand() % grid.mSizeX;
+        int y1 = std::rand() % grid.mSizeY;
+        int x2 = std::rand() % grid.mSizeX;
+        int y2 = std::rand() % grid.mSizeY;
+        bool throughDiggable = (i % 3) == 0;
+        auto access = [&grid, throughDiggable](int x, int y) { return grid.access(x, y, throughDiggable); };
+        auto speed = [&grid](int x, int y) { return grid.speed(x, y); };
+        bool refFound = referencePath(grid, x1, y1, x2, y2, throughDiggable, refPath);
+        bool engineFound = engine.findPath(x1, y1, x2, y2, access, speed, enginePath);
+        BOOST_CHECK(refFound == engineFound);
+        BOOST_CHECK(refPath == enginePath);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_PathfindingEngineBenchmark)
+{
+    BenchGrid grid(400, 400, 7);
+    PathfindingEngine engine;
+    engine.setMapSize(grid.mSizeX, grid.mSizeY);
+    std::vector<uint32_t> path;
+    const int nbSearches = 50;
+    std::vector<int> coords;
+    std::srand(99);
+    for(int i = 0; i < nbSearches * 4; ++i)
+        coords.push_back(std::rand() % 400);
+
+    auto access = [&grid](int x, int y) { return grid.access(x, y, false); };
+    auto speed = [&grid](int x, int y) { return grid.speed(x, y); };
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t nbFoundRef = 0;
+    for(int i = 0; i < nbSearches; ++i)
+    {
+        if(referencePath(grid, coords[i * 4], coords[i * 4 + 1], coords[i * 4 + 2], coords[i * 4 + 3], false, path))
+            ++nbFoundRef;
+    }
+    auto middle = std::chrono::steady_clock::now();
+    uint32_t nbFoundEngine = 0;
+    for(int i = 0; i < nbSearches; ++i)
+    {
+        if(engine.findPath(coords[i * 4], coords[i * 4 + 1], coords[i * 4 + 2], coords[i * 4 + 3], access, speed, path))
+            ++nbFoundEngine;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    BOOST_CHECK(nbFoundRef == nbFoundEngine);
+    std::stringstream ss;
+    ss << nbSearches << " searches on a 400x400 map: sorted list="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()
+        << "ms, PathfindingEngine="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count() << "ms";
+    BOOST_TEST_MESSAGE(ss.str());
+}
+
+//! \brief Returns the cost of the given path as computed by PathfindingEngine
+static double pathCost(const BenchGrid& grid, const std::vector<uint32_t>& path)
+{
+    double cost = 0.0;
+    for(uint32_t i = 1; i < path.size(); ++i)
+    {
+        int x1 = static_cast<int>(path[i - 1] % grid.mSizeX);
+        int y1 = static_cast<int>(path[i - 1] / grid.mSizeX);
+        int x2 = static_cast<int>(path[i] % grid.mSizeX);
+        int y2 = static_cast<int>(path[i] / grid.mSizeX);
+        cost += PathfindingEngine::computeHeuristic(x1, y1, x2, y2) / grid.speed(x1, y1);
+    }
+    return cost;
+}
+
+BOOST_AUTO_TEST_CASE(test_PathfindingEngineNearestTargets)
+{
+    BenchGrid grid(64, 64, 42);
+    PathfindingEngine engine;
+    engine.setMapSize(grid.mSizeX, grid.mSizeY);
+    auto access = [&grid](int x, int y) { return grid.access(x, y, false); };
+    auto speed = [&grid](int x, int y) { return grid.speed(x, y); };
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> found;
+    std::vector<uint32_t> path;
+    std::srand(4321);
+    for(int i = 0; i < 100; ++i)
+    {
+        int x1 = std::rand() % grid.mSizeX;
+        int y1 = std::rand() % grid.mSizeY;
+        targets.clear();
+        for(int k = 0; k < 20; ++k)
+            targets.push_back(static_cast<uint32_t>(std::rand() % (grid.mSizeX * grid.mSizeY)));
+
+        // Reference: one A* per target
+        std::vector<double> costs;
+        for(uint32_t target : targets)
+        {
+            if(engine.findPath(x1, y1, static_cast<int>(target % grid.mSizeX), static_cast<int>(target / grid.mSizeX), access, speed, path))
+                costs.push_back(pathCost(grid, path));
+        }
+        std::sort(costs.begin(), costs.end());
+
+        uint32_t nbFound = engine.findNearestTargets(x1, y1, targets, 3, access, speed, found);
+        BOOST_CHECK(nbFound == std::min<uint32_t>(3, static_cast<uint32_t>(costs.size())));
+        for(uint32_t k = 0; k < nbFound; ++k)
+        {
+            BOOST_CHECK(engine.buildPath(found[k], path));
+            BOOST_CHECK(path.front() == static_cast<uint32_t>(y1 * grid.mSizeX + x1));
+            BOOST_CHECK(path.back() == found[k]);
+            BOOST_CHECK_CLOSE(pathCost(grid, path), costs[k], 0.0001);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_PathfindingEngineNearestTargetsBenchmark)
+{
+    BenchGrid grid(200, 200, 11);
+    PathfindingEngine engine;
+    engine.setMapSize(grid.mSizeX, grid.mSizeY);
+    auto access = [&grid](int x, int y) { return grid.access(x, y, false); };
+    auto speed = [&grid](int x, int y) { return grid.speed(x, y); };
+    const int nbSearches = 50;
+    const int nbTargets = 50;
+    std::vector<std::vector<uint32_t>> targetsList(nbSearches);
+    std::vector<int> starts;
+    std::srand(77);
+    for(std::vector<uint32_t>& targets : targetsList)
+    {
+        int x = std::rand() % grid.mSizeX;
+        int y = std::rand() % grid.mSizeY;
+        starts.push_back(x);
+        starts.push_back(y);
+        // Targets around the start tile like the tiles a worker could dig or claim
+        for(int k = 0; k < nbTargets; ++k)
+        {
+            int tx = std::min(std::max(x + std::rand() % 31 - 15, 0), grid.mSizeX - 1);
+            int ty = std::min(std::max(y + std::rand() % 31 - 15, 0), grid.mSizeY - 1);
+            targets.push_back(static_cast<uint32_t>(ty * grid.mSizeX + tx));
+        }
+    }
+
+    // GameMap only keeps the targets in the same floodfill region. We do the same here so that
+    // the A* searches do not expand the whole map for unreachable targets
+    std::vector<uint32_t> found;
+    for(int i = 0; i < nbSearches; ++i)
+    {
+        engine.findNearestTargets(starts[i * 2], starts[i * 2 + 1], targetsList[i], nbTargets, access, speed, found);
+        targetsList[i] = found;
+    }
+
+    std::vector<uint32_t> path;
+    auto start = std::chrono::steady_clock::now();
+    for(int i = 0; i < nbSearches; ++i)
+    {
+        for(uint32_t target : targetsList[i])
+            engine.findPath(starts[i * 2], starts[i * 2 + 1], static_cast<int>(target % grid.mSizeX),
+                static_cast<int>(target / grid.mSizeX), access, speed, path);
+    }
+    auto middle = std::chrono::steady_clock::now();
+    uint32_t nbFound = 0;
+    for(int i = 0; i < nbSearches; ++i)
+        nbFound += engine.findNearestTargets(starts[i * 2], starts[i * 2 + 1], targetsList[i], 1, access, speed, found);
+    auto end = std::chrono::steady_clock::now();
+
+    std::stringstream ss;
+    ss << nbSearches << " searches among " << nbTargets << " targets: one A* per target="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()
+        << "ms, multi-target search="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count() << "ms";
+    BOOST_TEST_MESSAGE(ss.str());
+
+    uint32_t nbSearchesWithTargets = 0;
+    for(const std::vector<uint32_t>& targets : targetsList)
+    {
+        if(!targets.empty())
+            ++nbSearchesWithTargets;
+    }
+    BOOST_CHECK(nbFound == nbSearchesWithTargets);
+}
@@ -0,0 +1,76 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE RandomBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include "utils/Random.h"
+
+#include <chrono>
+#include <sstream>
+
+//! \brief Copy of the global LCG formerly used by Random
+static unsigned long lcgSeed = 42;
+
+static int lcgInt(int lo, int hi)
+{
+    lcgSeed = lcgSeed * 1103515245 + 12345;
+    unsigned long value = static_cast<unsigned int>(lcgSeed / 65536) % 32768;
+    double uniform = value * 1.0 / 32768.0;
+    return static_cast<int>(uniform * (hi - lo + 1) + lo);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark_Random)
+{
+    const int nbValues = 20000000;
+    Random::initialize(42);
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t sumLcg = 0;
+    for(int i = 0; i < nbValues; ++i)
+        sumLcg += lcgInt(0, 99);
+
+    auto middle = std::chrono::steady_clock::now();
+    int64_t sumThread = 0;
+    for(int i = 0; i < nbValues; ++i)
+        sumThread += Random::Int(0, 99);
+
+    auto middle2 = std::chrono::steady_clock::now();
+    int64_t sumScope = 0;
+    RandomStream stream;
+    for(int i = 0; i < nbValues; ++i)
+    {
+        // Like the entities, a scope is opened for a few values only
+        Random::StreamScope scope(stream, RandomStreamContext::entity, 1);
+        sumScope += Random::Int(0, 99);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // The mean should be around 49.5 for every generator
+    BOOST_CHECK(sumLcg / (nbValues / 100) > 4900 && sumLcg / (nbValues / 100) < 5000);
+    BOOST_CHECK(sumThread / (nbValues / 100) > 4900 && sumThread / (nbValues / 100) < 5000);
+    BOOST_CHECK(sumScope / (nbValues / 100) > 4900 && sumScope / (nbValues / 100) < 5000);
+
+    std::stringstream ss;
+    ss << nbValues << " Random::Int: old LCG="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()
+        << "ms, thread stream="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(middle2 - middle).count()
+        << "ms, scoped stream="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle2).count() << "ms";
+    BOOST_TEST_MESSAGE(ss.str());
+}
@@ -0,0 +1,186 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ScratchVectorBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include "utils/AllocationCounter.h"
+#include "utils/ScratchVector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <sstream>
+#include <vector>
+
+//! \brief Map of tile ids queried like GameMap::circularRegion and GameMap::tilesBetween
+class Grid
+{
+public:
+    Grid(int sizeX, int sizeY) :
+        mSizeX(sizeX),
+        mSizeY(sizeY)
+    {}
+
+    //! \brief Same loops as GameMap::circularRegion, filling the given vector
+    void circularRegion(int x, int y, int radius, std::vector<int>& tiles) const
+    {
+        tiles.clear();
+        int radiusSquared = radius * radius;
+        for(int i = x - radius; i <= x + radius; ++i)
+        {
+            for(int j = y - radius; j <= y + radius; ++j)
+            {
+                if((i < 0) || (j < 0) || (i >= mSizeX) || (j >= mSizeY))
+                    continue;
+
+                int dist = (i - x) * (i - x) + (j - y) * (j - y);
+                if(dist < radiusSquared)
+                    tiles.push_back(i + j * mSizeX);
+            }
+        }
+    }
+
+    //! \brief The by value version as it was before the fill overloads
+    std::vector<int> circularRegion(int x, int y, int radius) const
+    {
+        std::vector<int> tiles;
+        circularRegion(x, y, radius, tiles);
+        return tiles;
+    }
+
+    //! \brief Tiles on the line between 2 tiles, as returned by tilesBetween before it filled a vector
+    std::list<int> tilesBetweenList(int x1, int y1, int x2, int y2) const
+    {
+        std::list<int> tiles;
+        int nbSteps = std::max(std::abs(x2 - x1), std::abs(y2 - y1));
+        for(int step = 0; step <= nbSteps; ++step)
+            tiles.push_back(lerpTile(x1, y1, x2, y2, step, nbSteps));
+        return tiles;
+    }
+
+    void tilesBetween(int x1, int y1, int x2, int y2, std::vector<int>& tiles) const
+    {
+        tiles.clear();
+        int nbSteps = std::max(std::abs(x2 - x1), std::abs(y2 - y1));
+        for(int step = 0; step <= nbSteps; ++step)
+            tiles.push_back(lerpTile(x1, y1, x2, y2, step, nbSteps));
+    }
+
+private:
+    int lerpTile(int x1, int y1, int x2, int y2, int step, int nbSteps) const
+    {
+        if(nbSteps == 0)
+            return x1 + y1 * mSizeX;
+
+        int x = x1 + ((x2 - x1) * step) / nbSteps;
+        int y = y1 + ((y2 - y1) * step) / nbSteps;
+        return x + y * mSizeX;
+    }
+
+    int mSizeX;
+    int mSizeY;
+};
+
+//! \brief Allocations and time of one turn, averaged over NB_TURNS
+struct Result
+{
+    uint64_t mAllocations;
+    double mTimeUs;
+    uint64_t mChecksum;
+};
+
+static const int NB_CREATURES = 300;
+static const int NB_TURNS = 20;
+static const int SIGHT_RADIUS = 10;
+static const int NB_LINES_OF_SIGHT = 4;
+
+//! \brief Calls creatureUpkeep for each creature during NB_TURNS turns. Like a creature during its
+//! upkeep, it looks around and checks the line of sight to a few tiles
+template<typename F>
+static Result runTurns(F creatureUpkeep)
+{
+    Result result;
+    result.mChecksum = 0;
+    // The first turn fills the reused buffers, we measure the next ones
+    for(int creature = 0; creature < NB_CREATURES; ++creature)
+        result.mChecksum += creatureUpkeep(creature);
+
+    result.mChecksum = 0;
+    uint64_t nbAllocationsAtStart = AllocationCounter::getNbAllocations();
+    auto start = std::chrono::steady_clock::now();
+    for(int turn = 0; turn < NB_TURNS; ++turn)
+    {
+        for(int creature = 0; creature < NB_CREATURES; ++creature)
+            result.mChecksum += creatureUpkeep(creature);
+    }
+    result.mTimeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / NB_TURNS;
+    result.mAllocations = (AllocationCounter::getNbAllocations() - nbAllocationsAtStart) / NB_TURNS;
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_PerTurnQueriesAllocations)
+{
+    BOOST_REQUIRE(AllocationCounter::isEnabled());
+
+    const int mapSize = 200;
+    Grid grid(mapSize, mapSize);
+    auto posX = [](int creature) { return (creature * 37) % mapSize; };
+    auto posY = [](int creature) { return (creature * 53) % mapSize; };
+
+    // Before: every query returns a new container
+    Result byValue = runTurns([&](int creature)
+    {
+        uint64_t checksum = 0;
+        std::vector<int> tiles = grid.circularRegion(posX(creature), posY(creature), SIGHT_RADIUS);
+        for(int i = 0; i < NB_LINES_OF_SIGHT; ++i)
+        {
+            int target = tiles[(i * 97) % tiles.size()];
+            std::list<int> line = grid.tilesBetweenList(posX(creature), posY(creature), target % mapSize, target / mapSize);
+            checksum += line.size();
+        }
+        return checksum + tiles.size();
+    });
+
+    // After: the queries fill vectors borrowed from the per thread pool
+    Result scratch = runTurns([&](int creature)
+    {
+        uint64_t checksum = 0;
+        ScratchVector<int> tiles;
+        ScratchVector<int> line;
+        grid.circularRegion(posX(creature), posY(creature), SIGHT_RADIUS, *tiles);
+        for(int i = 0; i < NB_LINES_OF_SIGHT; ++i)
+        {
+            int target = (*tiles)[(i * 97) % tiles->size()];
+            grid.tilesBetween(posX(creature), posY(creature), target % mapSize, target / mapSize, *line);
+            checksum += line->size();
+        }
+        return checksum + tiles->size();
+    });
+
+    BOOST_CHECK_EQUAL(byValue.mChecksum, scratch.mChecksum);
+    BOOST_CHECK(byValue.mAllocations > 0);
+    BOOST_CHECK_EQUAL(scratch.mAllocations, 0);
+
+    std::stringstream ss;
+    ss << NB_CREATURES << " creatures, per turn: by value=" << byValue.mAllocations << " allocations in "
+        << byValue.mTimeUs << "us, scratch vectors=" << scratch.mAllocations << " allocations in "
+        << scratch.mTimeUs << "us";
+    BOOST_TEST_MESSAGE(ss.str());
+}
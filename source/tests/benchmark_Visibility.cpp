@@ -0,0 +1,688 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#define BOOST_TEST_MODULE VisibilityBenchmark
+#include "BoostTestTargetConfig.h"
+
+#include "gamemap/VisibilityKernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! \brief Grid where each tile blocks vision or not
+struct VisionGrid
+{
+    int mSizeX;
+    int mSizeY;
+    std::vector<bool> mOpaque;
+
+    VisionGrid(int sizeX, int sizeY, int opaquePercent, unsigned int seed) :
+        mSizeX(sizeX),
+        mSizeY(sizeY),
+        mOpaque(sizeX * sizeY, false)
+    {
+        std::srand(seed);
+        for(uint32_t i = 0; i < mOpaque.size(); ++i)
+            mOpaque[i] = (std::rand() % 100) < opaquePercent;
+    }
+
+    bool isOpaque(int32_t index) const
+    { return mOpaque[index]; }
+
+    void fillKernel(VisibilityKernel& kernel) const
+    {
+        kernel.setMapSize(mSizeX, mSizeY);
+        for(int y = 0; y < mSizeY; ++y)
+            for(int x = 0; x < mSizeX; ++x)
+                kernel.setOpaque(x, y, mOpaque[y * mSizeX + x]);
+    }
+};
+
+//! \brief Copy of the helpers formerly used by TileContainer::visibleTiles
+class TileDistance
+{
+public:
+    enum TileDistanceType
+    {
+        Horizontal,
+        Diagonal,
+        Other
+    };
+
+    TileDistance(int diffX, int diffY, TileDistanceType type, int distSquared):
+        mDiffX(diffX),
+        mDiffY(diffY),
+        mType(type),
+        mDistSquared(distSquared)
+    {
+    }
+
+    inline int getDiffX() const
+    { return mDiffX; }
+
+    inline int getDiffY() const
+    { return mDiffY; }
+
+    inline TileDistanceType getType() const
+    { return mType; }
+
+    inline int getDistSquared() const
+    { return mDistSquared; }
+
+    void computeTileDistances(double coefNorth, double coefSouth, const TileDistance& tileDistance,
+        uint32_t indexTileDistance)
+    {
+        // A tile can only hide tiles behind (x > tile.x and y > tile.y)
+        if(tileDistance.getDiffX() < getDiffX())
+            return;
+        if(tileDistance.getDiffY() < getDiffY())
+            return;
+
+        // We don't want a tile to hide itself
+        if((tileDistance.getDiffX() == getDiffX()) &&
+           (tileDistance.getDiffY() == getDiffY()))
+        {
+            return;
+        }
+
+        if(getType() == TileDistance::TileDistanceType::Horizontal)
+        {
+            // For horizontal tiles, we hide following tiles (x > tile.x). But we process
+            // north tiles normally
+            if(tileDistance.getType() == TileDistance::TileDistanceType::Horizontal)
+            {
+                addHiddenTileSouth(indexTileDistance, 1.0);
+                return;
+            }
+
+            double xTileDeb = static_cast<double>(tileDistance.getDiffX()) - 0.5;
+            double xTileEnd = xTileDeb + 1.0;
+            double yTileDeb = static_cast<double>(tileDistance.getDiffY()) - 0.5;
+            double yTileEnd = yTileDeb + 1.0;
+            double yHideDebNorth = coefNorth * xTileDeb;
+            double yHideEndNorth = coefNorth * xTileEnd;
+
+            // If the tile is over the North ray, it is not hidden
+            if(yHideEndNorth <= yTileDeb)
+                return;
+
+            // We check which part of the tile is hidden
+            if((yHideDebNorth >= yTileDeb) &&
+               (yHideEndNorth <= yTileEnd))
+            {
+                // The ray hits the left side of the tile and the right side.
+                // The south part is partially hidden
+                double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+                hiddenArea += yHideDebNorth - yTileDeb;
+                addHiddenTileSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileDeb) &&
+                    (yHideEndNorth > yTileDeb))
+            {
+                // The ray hits the bottom side of the tile but hits the right side. We compute
+                // the south visible part
+                double xHit = yTileDeb / coefNorth;
+                double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+                addHiddenTileSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileEnd) &&
+                    (yHideEndNorth > yTileEnd))
+            {
+                // The ray hits the left side of the tile but is over the right side. We compute
+                // the hidden part on north.
+                double xHit = yTileEnd / coefNorth;
+                double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+                addHiddenTileSouth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else
+            {
+                // The entire tile is hidden
+                addHiddenTileSouth(indexTileDistance, 1.0);
+            }
+
+            return;
+        }
+
+        double xTileDeb = static_cast<double>(tileDistance.getDiffX()) - 0.5;
+        double xTileEnd = xTileDeb + 1.0;
+        double yTileDeb = static_cast<double>(tileDistance.getDiffY()) - 0.5;
+        double yTileEnd = yTileDeb + 1.0;
+
+        // We check if the current tile is hidden by the tile. To consider that the
+        // tile is hidden by the south, as we know the angle will be between 0 and 45 degrees,
+        // we consider that the tile has to be hit by the ray passing through the hiding tile
+        // on the left side of the tile (otherwise, the hidden part will be too small).
+        double yHideDebSouth = coefSouth * xTileDeb;
+        double yHideEndSouth = coefSouth * xTileEnd;
+        double yHideDebNorth = coefNorth * xTileDeb;
+        double yHideEndNorth = coefNorth * xTileEnd;
+        // We check if at least a part of the tile is hidden
+        if((yHideDebSouth < yTileEnd) &&
+           (yHideEndNorth > yTileDeb))
+        {
+            // At least a part of this tile is hidden
+            if((yHideDebSouth >= yTileDeb) &&
+               (yHideEndSouth <= yTileEnd))
+            {
+                // The ray hits the left side of the tile and the right side.
+                // The south part is partially hidden
+                // The visible part is composed from a square between the tile inferior part and
+                // the triangle made by the ray
+                double visibleArea = (yHideEndSouth - yHideDebSouth) / 2.0;
+                visibleArea += yHideDebSouth - yTileDeb;
+                addHiddenTileNorth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else if((yHideDebSouth < yTileDeb) &&
+                    (yHideEndSouth > yTileDeb))
+            {
+                // The ray hits the bottom side of the tile but hits the right side. We compute
+                // the south visible part
+                double xHit = yTileDeb / coefSouth;
+                double visibleArea = (yHideEndSouth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+                addHiddenTileNorth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else if((yHideDebSouth < yTileEnd) &&
+                    (yHideEndSouth > yTileEnd))
+            {
+                // The ray hits the left side of the tile but is over the right side. We compute
+                // the hidden part on north.
+                double xHit = yTileEnd / coefSouth;
+                double hiddenArea = (yTileEnd - yHideDebSouth) * (xHit - xTileDeb) / 2.0;
+                addHiddenTileNorth(indexTileDistance, hiddenArea);
+
+            }
+            else if((yHideDebNorth >= yTileDeb) &&
+               (yHideEndNorth <= yTileEnd))
+            {
+                double hiddenArea = (yHideEndNorth - yHideDebNorth) / 2.0;
+                hiddenArea += yHideDebNorth - yTileDeb;
+                addHiddenTileSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileDeb) &&
+                    (yHideEndNorth > yTileDeb))
+            {
+                // The ray hits the bottom side of the tile but hits the right side. We compute
+                // the south visible part
+                double xHit = yTileDeb / coefNorth;
+                double hiddenArea = (yHideEndNorth - yTileDeb) * (xTileEnd - xHit) / 2.0;
+                addHiddenTileSouth(indexTileDistance, hiddenArea);
+            }
+            else if((yHideDebNorth < yTileEnd) &&
+                    (yHideEndNorth > yTileEnd))
+            {
+                // The ray hits the left side of the tile but is over the right side. We compute
+                // the hidden part on north.
+                double xHit = yTileEnd / coefNorth;
+                double visibleArea = (yTileEnd - yHideDebNorth) * (xHit - xTileDeb) / 2.0;
+                addHiddenTileSouth(indexTileDistance, 1.0 - visibleArea);
+            }
+            else
+            {
+                // The entire tile is hidden
+                addHiddenTileSouth(indexTileDistance, 1.0);
+            }
+        }
+    }
+
+
+    const std::vector<std::pair<uint32_t, double>>& getHiddenTilesNorth() const
+    {
+        return mHiddenTilesNorth;
+    }
+
+    const std::vector<std::pair<uint32_t, double>>& getHiddenTilesSouth() const
+    {
+        return mHiddenTilesSouth;
+    }
+
+private:
+    void addHiddenTileNorth(uint32_t indexTile, double hiddenPercent)
+    {
+        mHiddenTilesNorth.push_back(std::pair<uint32_t, double>(indexTile, hiddenPercent));
+    }
+
+    void addHiddenTileSouth(uint32_t indexTile, double hiddenPercent)
+    {
+        mHiddenTilesSouth.push_back(std::pair<uint32_t, double>(indexTile, hiddenPercent));
+    }
+
+    int mDiffX;
+    int mDiffY;
+    TileDistanceType mType;
+    int mDistSquared;
+    std::vector<std::pair<uint32_t, double>> mHiddenTilesNorth;
+    std::vector<std::pair<uint32_t, double>> mHiddenTilesSouth;
+};
+
+class TileDistanceProcess
+{
+public:
+    TileDistanceProcess(const TileDistance& tileDistance, int32_t tile):
+        mTileDistance(tileDistance),
+        mTile(tile),
+        mHiddenValueNorth(0.0),
+        mHiddenValueSouth(0.0)
+    {
+    }
+
+    inline const TileDistance& getTileDistance() const
+    {
+        return mTileDistance;
+    }
+
+    void addHiddenValueNorth(double val)
+    {
+        // We only add the highest value
+        if(val <= mHiddenValueNorth)
+            return;
+
+        mHiddenValueNorth = val;
+    }
+
+    void addHiddenValueSouth(double val)
+    {
+        // We only add the highest value
+        if(val <= mHiddenValueSouth)
+            return;
+
+        mHiddenValueSouth = val;
+    }
+
+    inline bool isTileVisible() const
+    {
+        return (mHiddenValueNorth + mHiddenValueSouth) <= 0.5;
+    }
+
+    inline double getHiddenValueNorth() const
+    {
+        return mHiddenValueNorth;
+    }
+
+    inline double getHiddenValueSouth() const
+    {
+        return mHiddenValueSouth;
+    }
+
+    inline int32_t getTile() const
+    {
+        return mTile;
+    }
+
+private:
+    const TileDistance& mTileDistance;
+    int32_t mTile;
+    double mHiddenValueNorth;
+    double mHiddenValueSouth;
+};
+
+static bool sortByDistSquared(const TileDistance& tileDist1, const TileDistance& tileDist2)
+{
+    return tileDist1.getDistSquared() < tileDist2.getDistSquared();
+}
+
+//! \brief Copy of the former TileContainer::visibleTiles algorithm (8 vectors of TileDistanceProcess built
+//! for each call). Tiles are identified by their index in the grid (-1 if out of the map)
+class ReferenceVisibility
+{
+public:
+    ReferenceVisibility(const VisionGrid& grid, int initTileDistance) :
+        mGrid(grid),
+        mTileDistanceComputed(0)
+    {
+        buildTileDistance(initTileDistance);
+    }
+
+    int32_t getTile(int x, int y) const
+    {
+        if((x < 0) || (x >= mGrid.mSizeX) || (y < 0) || (y >= mGrid.mSizeY))
+            return -1;
+
+        return y * mGrid.mSizeX + x;
+    }
+
+    void buildTileDistance(int distance)
+    {
+        if(mTileDistanceComputed >= distance)
+            return;
+
+        // We want to be able to fill a vector of tiles sorted beginning with the closest tile. If we look a grid (each letter
+        // represents a tile at the same distance from the center: a):
+        // jihghij
+        // ifedefi
+        // hecbceh
+        // gdbabdg
+        // hecbceh
+        // ifedefi
+        // jihghij
+        // We can see that there are 3 kind of tiles:
+        // - Vertical/Horizontal tiles (abdg): at each distance, there are 4 of them
+        // - Diagonal tiles (acfj): at each distance, there are 4 of them
+        // - Other tiles (ehi...): at each distance, there are 8 of them
+        // Moreover, we can see a symmetry. We can compute all tiles by computing only 1/8 tiles:
+        //    j
+        //   fi
+        //  ceh
+        // abdg
+
+        // If we compute only the minimum tiles needed, we have no vertical tiles (since each of them can be deduced from the horizontal)
+        // To compute tiles easily, we will compute the 1/8 tiles until distance. Then, we will sort the tiles to begin with
+        // closest distance until farthest
+        mTileDistance.clear();
+        for(int y = 0; y <= distance; ++y)
+        {
+            for(int x = y; x <= distance; ++x)
+            {
+                TileDistance::TileDistanceType type;
+                if(y == 0)
+                {
+                    type = TileDistance::TileDistanceType::Horizontal;
+                }
+                else if(x == y)
+                {
+                    type = TileDistance::TileDistanceType::Diagonal;
+                }
+                else
+                {
+                    type = TileDistance::TileDistanceType::Other;
+                }
+                int distSquared = x * x + y * y;
+                mTileDistance.push_back(TileDistance(x, y, type, distSquared));
+            }
+        }
+
+        std::sort(mTileDistance.begin(), mTileDistance.end(), sortByDistSquared);
+
+        // We have filled the tile distance vector. Now, we fill how each tile hides the
+        // other ones when they mask vision to help calculate visible tiles
+        for(TileDistance& tileDistance : mTileDistance)
+        {
+            // We don't process the first tile
+            if(tileDistance.getDiffX() == 0 && tileDistance.getDiffY() == 0)
+                continue;
+
+            // Other tiles can hide with their down side and their up side other tiles
+            // or diagonal tiles (but not Horizontal tiles)
+            // We compute the tiles hidden from the south. In this case, only tiles with
+            // x > tile.x can be hidden
+            double coefNorth = (static_cast<double>(tileDistance.getDiffY()) + 0.5) / (static_cast<double>(tileDistance.getDiffX()) - 0.5);
+            double coefSouth = (static_cast<double>(tileDistance.getDiffY()) - 0.5) / (static_cast<double>(tileDistance.getDiffX()) + 0.5);
+            for(uint32_t index = 0; index < mTileDistance.size(); ++index)
+            {
+                const TileDistance& tileDistance2 = mTileDistance[index];
+                tileDistance.computeTileDistances(coefNorth, coefSouth, tileDistance2, index);
+            }
+        }
+
+        mTileDistanceComputed = distance;
+    }
+
+    std::vector<uint32_t> visibleTiles(int x, int y, int radius)
+    {
+        // To compute the tiles within this region, we use the symmetry of the square. That's why we mix tile x/y coordinate
+        // with tileDist diffX/diffY. More explanation can be found in the buildTileDistance function
+        std::vector<uint32_t> returnList;
+
+        if(radius > mTileDistanceComputed)
+            buildTileDistance(radius);
+
+        int radiusSquared = radius * radius;
+
+        // To have all the tiles around, we process mTileDistance 8 times.
+        // We will process in, this order (c being the starting tile):
+        // 514
+        // 2c0
+        // 637
+        // Then, we will have to merge diagonal/horizontal tiles
+        // Because we want the index to be correct, we will add tiles even when null in tilesProcess
+        std::vector<TileDistanceProcess> tilesProcess[8];
+        for(uint32_t k = 0; k < 8; ++k)
+        {
+            for(const TileDistance& tileDist : mTileDistance)
+            {
+                if(tileDist.getDistSquared() > radiusSquared)
+                    break;
+
+                switch(k)
+                {
+                    case 0:
+                    {
+                        int32_t tile = getTile(x + tileDist.getDiffX(), y + tileDist.getDiffY());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    case 1:
+                    {
+                        int32_t tile = getTile(x + tileDist.getDiffY(), y - tileDist.getDiffX());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    case 2:
+                    {
+                        int32_t tile = getTile(x - tileDist.getDiffX(), y - tileDist.getDiffY());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    case 3:
+                    {
+                        int32_t tile = getTile(x - tileDist.getDiffY(), y + tileDist.getDiffX());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    case 4:
+                    {
+                        int32_t tile = getTile(x + tileDist.getDiffY(), y + tileDist.getDiffX());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    case 5:
+                    {
+                        int32_t tile = getTile(x + tileDist.getDiffX(), y - tileDist.getDiffY());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    case 6:
+                    {
+                        int32_t tile = getTile(x - tileDist.getDiffY(), y - tileDist.getDiffX());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    case 7:
+                    {
+                        int32_t tile = getTile(x - tileDist.getDiffX(), y + tileDist.getDiffY());
+                        tilesProcess[k].push_back(TileDistanceProcess(tileDist, tile));
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+        }
+
+        // The array of tiles is filled. Now, we apply the visibility.
+        for(uint32_t k = 0; k < 8; ++k)
+        {
+            for(TileDistanceProcess& tileDistanceProcess : tilesProcess[k])
+            {
+                if(tileDistanceProcess.getTile() < 0)
+                    continue;
+
+                if(!mGrid.isOpaque(tileDistanceProcess.getTile()))
+                    continue;
+
+                // The tile hides vision. We process tiles it hides
+                for(const std::pair<uint32_t, double>& p : tileDistanceProcess.getTileDistance().getHiddenTilesNorth())
+                {
+                    // mTileDistance might be bigger than the actual vector because it can include tiles
+                    // farther than the ones currently computed (for example if sight < computedSight)
+                    if(p.first >= tilesProcess[k].size())
+                        continue;
+
+                    tilesProcess[k][p.first].addHiddenValueNorth(p.second);
+                }
+                for(const std::pair<uint32_t, double>& p : tileDistanceProcess.getTileDistance().getHiddenTilesSouth())
+                {
+                    // mTileDistance might be bigger than the actual vector because it can include tiles
+                    // farther than the ones currently computed (for example if sight < computedSight)
+                    if(p.first >= tilesProcess[k].size())
+                        continue;
+
+                    tilesProcess[k][p.first].addHiddenValueSouth(p.second);
+                }
+            }
+        }
+
+        // Now, we process all the tiles. Note that horizontal tiles are common for 2 consecutive
+        // vectors in tilesProcess and that diagonal tiles should be merged.
+        // The 8 vectors have the same size
+        for(uint32_t i = 0; i < tilesProcess[0].size(); ++i)
+        {
+            for(uint32_t k = 0; k < 8; ++k)
+            {
+                TileDistanceProcess& tileDistanceProcess = tilesProcess[k][i];
+                if(tileDistanceProcess.getTile() < 0)
+                    continue;
+
+                // We avoid adding several times the center tile
+                if((k > 0) && (tileDistanceProcess.getTileDistance().getDistSquared() == 0))
+                    continue;
+
+                // Because horizontal tiles are common, we don't process them for the 4 last vectors
+                if((tileDistanceProcess.getTileDistance().getType() == TileDistance::TileDistanceType::Horizontal) &&
+                   (k > 3))
+                {
+                    continue;
+                }
+
+                // Diagonal tiles need to be merged (because south hiding and north hiding are not
+                // computed within the same array). They will be processed for k < 4
+                if((tileDistanceProcess.getTileDistance().getType() == TileDistance::TileDistanceType::Diagonal) &&
+                   (k > 3))
+                {
+                    continue;
+                }
+
+                if(tileDistanceProcess.getTileDistance().getType() == TileDistance::TileDistanceType::Diagonal)
+                {
+                    // We merge diagonal tiles. Because they are inverted, south hidden value becomes north and vice-versa
+                    TileDistanceProcess& tileDistanceProcess2 = tilesProcess[k + 4][i];
+                    tileDistanceProcess.addHiddenValueNorth(tileDistanceProcess2.getHiddenValueSouth());
+                    tileDistanceProcess.addHiddenValueSouth(tileDistanceProcess2.getHiddenValueNorth());
+                }
+
+                if(!tileDistanceProcess.isTileVisible())
+                    continue;
+
+                returnList.push_back(static_cast<uint32_t>(tileDistanceProcess.getTile()));
+            }
+        }
+        return returnList;
+    }
+
+private:
+    const VisionGrid& mGrid;
+    std::vector<TileDistance> mTileDistance;
+    int mTileDistanceComputed;
+};
+
+BOOST_AUTO_TEST_CASE(test_VisibilityKernelSameTiles)
+{
+    for(int opaquePercent : {0, 15, 40})
+    {
+        VisionGrid grid(48, 48, opaquePercent, 42 + opaquePercent);
+        ReferenceVisibility reference(grid, 15);
+        VisibilityKernel kernel;
+        kernel.buildTables(15);
+        grid.fillKernel(kernel);
+        std::vector<uint32_t> tiles;
+        std::srand(1234);
+        for(int i = 0; i < 300; ++i)
+        {
+            int x = std::rand() % grid.mSizeX;
+            int y = std::rand() % grid.mSizeY;
+            int radius = std::rand() % 16;
+            kernel.computeVisibleTiles(x, y, radius, tiles);
+            BOOST_CHECK(reference.visibleTiles(x, y, radius) == tiles);
+        }
+
+        // A bigger radius than the tables computed on both sides
+        kernel.computeVisibleTiles(20, 20, 20, tiles);
+        BOOST_CHECK(reference.visibleTiles(20, 20, 20) == tiles);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_VisibilityKernelCenterAndBorders)
+{
+    VisionGrid grid(10, 10, 100, 0);
+    VisibilityKernel kernel;
+    grid.fillKernel(kernel);
+    std::vector<uint32_t> tiles;
+
+    // Even surrounded by walls, the center tile and the walls around are visible
+    kernel.computeVisibleTiles(0, 0, 5, tiles);
+    BOOST_REQUIRE(!tiles.empty());
+    BOOST_CHECK(tiles[0] == 0);
+    BOOST_CHECK(std::find(tiles.begin(), tiles.end(), 1) != tiles.end());
+    BOOST_CHECK(std::find(tiles.begin(), tiles.end(), 10) != tiles.end());
+    BOOST_CHECK(std::find(tiles.begin(), tiles.end(), 3) == tiles.end());
+
+    kernel.computeVisibleTiles(-1, 0, 5, tiles);
+    BOOST_CHECK(tiles.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_VisibilityKernelBenchmark)
+{
+    VisionGrid grid(200, 200, 20, 7);
+    ReferenceVisibility reference(grid, 15);
+    VisibilityKernel kernel;
+    kernel.buildTables(15);
+    grid.fillKernel(kernel);
+    const int nbComputations = 5000;
+    const int radius = 10;
+    std::vector<std::pair<int, int>> coords;
+    std::srand(99);
+    for(int i = 0; i < nbComputations; ++i)
+        coords.push_back(std::make_pair(std::rand() % grid.mSizeX, std::rand() % grid.mSizeY));
+
+    auto start = std::chrono::steady_clock::now();
+    size_t nbTilesRef = 0;
+    for(const std::pair<int, int>& coord : coords)
+        nbTilesRef += reference.visibleTiles(coord.first, coord.second, radius).size();
+
+    auto middle = std::chrono::steady_clock::now();
+    size_t nbTilesKernel = 0;
+    std::vector<uint32_t> tiles;
+    for(const std::pair<int, int>& coord : coords)
+    {
+        kernel.computeVisibleTiles(coord.first, coord.second, radius, tiles);
+        nbTilesKernel += tiles.size();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    BOOST_CHECK(nbTilesRef == nbTilesKernel);
+    std::stringstream ss;
+    ss << nbComputations << " computations with radius " << radius << " on a 200x200 map: former visibleTiles="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(middle - start).count()
+        << "ms, VisibilityKernel="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - middle).count() << "ms";
+    BOOST_TEST_MESSAGE(ss.str());
+}
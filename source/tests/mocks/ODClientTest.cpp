@@ -17,6 +17,7 @@
 
 #include "ODClientTest.h"
 
+#include "entities/GameEntityType.h"
 #include "game/SeatData.h"
 #include "network/ClientNotification.h"
 #include "network/ServerMode.h"
@@ -70,6 +71,10 @@ bool ODClientTest::connect(const std::string& host, const int port, uint32_t tim
     ODPacket packSend;
     packSend << ClientNotificationType::hello
         << std::string("OpenDungeons V ") + OD_VERSION_STR;
+    // The mock client does not use compression
+    bool useCompression = false;
+    uint32_t dictionaryHash = 0;
+    packSend << useCompression << dictionaryHash;
     send(packSend);
 
     return true;
@@ -394,15 +399,29 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             BOOST_CHECK(packetReceived >> mPlayers[mLocalPlayerIndex].mGoals);
             break;
         }
-        case ServerNotificationType::setObjectAnimationState:
+        case ServerNotificationType::addEntity:
         {
+            // We only read the entity header to know its name
+            GameEntityType entityType;
+            uint32_t entityId;
+            int seatId;
             std::string entityName;
+            BOOST_CHECK(packetReceived >> entityType >> entityId);
+            if(entityType != GameEntityType::mapLight)
+                BOOST_CHECK(packetReceived >> seatId);
+            BOOST_CHECK(packetReceived >> entityName);
+            mEntityNames[entityId] = entityName;
+            break;
+        }
+        case ServerNotificationType::setObjectAnimationState:
+        {
+            uint32_t entityId;
             std::string animState;
             bool loop;
             bool playIdleWhenAnimationEnds;
             bool shouldSetWalkDirection;
             Ogre::Vector3 walkDirection(0, 0, 0);
-            BOOST_CHECK(packetReceived >> entityName >> animState
+            BOOST_CHECK(packetReceived >> entityId >> animState
                 >> loop >> playIdleWhenAnimationEnds >> shouldSetWalkDirection);
 
             if(shouldSetWalkDirection)
@@ -410,18 +429,18 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
                 BOOST_CHECK(packetReceived >> walkDirection);
             }
 
-            animationPlayed(entityName, animState, loop, playIdleWhenAnimationEnds, shouldSetWalkDirection, walkDirection);
+            animationPlayed(getEntityName(entityId), animState, loop, playIdleWhenAnimationEnds, shouldSetWalkDirection, walkDirection);
             break;
         }
         case ServerNotificationType::animatedObjectSetWalkPath:
         {
-            std::string entityName;
+            uint32_t entityId;
             std::string walkAnim;
             std::string endAnim;
             bool loopEndAnim;
             bool playIdleWhenAnimationEnds;
             uint32_t nbDest;
-            BOOST_CHECK(packetReceived >> entityName >> walkAnim >> endAnim);
+            BOOST_CHECK(packetReceived >> entityId >> walkAnim >> endAnim);
             BOOST_CHECK(packetReceived >> loopEndAnim >> playIdleWhenAnimationEnds >> nbDest);
             std::vector<Ogre::Vector3> path;
             while(nbDest)
@@ -433,6 +452,7 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
             }
 
             //! We want to make sure animationPlayed is played for both animations (if required)
+            const std::string& entityName = getEntityName(entityId);
             if(!walkAnim.empty())
                 animationPlayed(entityName, walkAnim, true, false, false, Ogre::Vector3::ZERO);
             if(!endAnim.empty())
@@ -447,6 +467,16 @@ bool ODClientTest::processMessage(ServerNotificationType cmd, ODPacket& packetRe
     return false;
 }
 
+const std::string& ODClientTest::getEntityName(uint32_t entityId) const
+{
+    static const std::string emptyString;
+    auto it = mEntityNames.find(entityId);
+    if(it == mEntityNames.end())
+        return emptyString;
+
+    return it->second;
+}
+
 SeatData* ODClientTest::getLocalSeat() const
 {
     if(mLocalPlayerIndex >= mPlayers.size())
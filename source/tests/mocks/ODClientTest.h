@@ -21,6 +21,7 @@
 
 #include "network/ODSocketClient.h"
 
+#include <map>
 #include <string>
 
 class SeatData;
@@ -90,6 +91,10 @@ private:
     std::vector<PlayerInfo> mPlayers;
     std::vector<SeatData*> mSeats;
     uint32_t mLocalPlayerIndex;
+    //! \brief Names of the entities added by the server. The server refers to them by id
+    std::map<uint32_t, std::string> mEntityNames;
+
+    const std::string& getEntityName(uint32_t entityId) const;
 };
 
 #endif // ODCLIENTTEST_H
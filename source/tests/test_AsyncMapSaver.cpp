@@ -0,0 +1,131 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE AsyncMapSaver
+#include "BoostTestTargetConfig.h"
+
+#include "gamemap/AsyncMapSaver.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::unique_ptr<GameMapSnapshot> createSnapshot(int nbTiles)
+{
+    std::unique_ptr<GameMapSnapshot> snapshot(new GameMapSnapshot);
+    snapshot->mHeader = "0.7.0\n\n[Info]\nName\tTest\n[/Info]\n";
+    snapshot->mMapSizeX = nbTiles;
+    snapshot->mMapSizeY = 1;
+    for(int i = 0; i < nbTiles; ++i)
+    {
+        BinaryLevel::TileRecord tile;
+        tile.mX = i;
+        tile.mY = 0;
+        tile.mType = 2;
+        tile.mHasSeat = (i % 2 == 0) ? 1 : 0;
+        tile.mSeatId = 3;
+        tile.mFullness = 12.5;
+        snapshot->mTiles.push_back(tile);
+    }
+    snapshot->mEntities = "\n[Rooms]\n[/Rooms]\n";
+    return snapshot;
+}
+
+static std::string readFile(const std::string& fileName)
+{
+    std::ifstream is(fileName);
+    std::stringstream ss;
+    ss << is.rdbuf();
+    return ss.str();
+}
+
+BOOST_AUTO_TEST_CASE(test_GameMapSnapshot)
+{
+    const std::string fileName = "test_GameMapSnapshot.level";
+    std::string error;
+    BOOST_REQUIRE(createSnapshot(2)->writeToFile(fileName, false, error));
+    BOOST_CHECK(readFile(fileName) ==
+        "0.7.0\n\n[Info]\nName\tTest\n[/Info]\n"
+        "\n[Tiles]\n# Map Size\n2 # MapSizeX\n1 # MapSizeY\n"
+        "# posX\tposY\ttype\tfullness\tseatId(optional)\n"
+        "0\t0\t2\t12.5\t3\n"
+        "1\t0\t2\t12.5\n"
+        "[/Tiles]\n"
+        "\n[Rooms]\n[/Rooms]\n");
+    BOOST_CHECK(!boost::filesystem::exists(fileName + ".tmp"));
+
+    // A backup is only made if asked
+    BOOST_REQUIRE(createSnapshot(3)->writeToFile(fileName, false, error));
+    BOOST_CHECK(!boost::filesystem::exists(fileName + ".bak"));
+    BOOST_REQUIRE(createSnapshot(4)->writeToFile(fileName, true, error));
+    BOOST_CHECK(boost::filesystem::exists(fileName + ".bak"));
+    BOOST_CHECK(readFile(fileName + ".bak").find("2\t0\t2") != std::string::npos);
+    BOOST_CHECK(readFile(fileName + ".bak").find("3\t0\t2") == std::string::npos);
+    BOOST_CHECK(readFile(fileName).find("3\t0\t2") != std::string::npos);
+
+    // Writing in a folder that does not exist fails without touching anything
+    BOOST_CHECK(!createSnapshot(1)->writeToFile("notExistingFolder/test.level", false, error));
+    BOOST_CHECK(!error.empty());
+
+    boost::filesystem::remove(fileName);
+    boost::filesystem::remove(fileName + ".bak");
+}
+
+BOOST_AUTO_TEST_CASE(test_AsyncMapSaver)
+{
+    const std::string fileName1 = "test_AsyncMapSaver1.level";
+    const std::string fileName2 = "test_AsyncMapSaver2.level";
+    AsyncMapSaver saver;
+    BOOST_CHECK(!saver.isBusy());
+
+    saver.save(createSnapshot(10000), fileName1, false, false);
+    saver.save(createSnapshot(5), fileName2, false, true);
+    saver.save(createSnapshot(5), "notExistingFolder/test.level", false, true);
+    saver.waitIdle();
+    BOOST_CHECK(!saver.isBusy());
+
+    // The saves are written in the order they were asked
+    std::vector<AsyncMapSaver::Result> results;
+    saver.popResults(results);
+    BOOST_REQUIRE(results.size() == 3);
+    BOOST_CHECK(results[0].mFileName == fileName1 && results[0].mSuccess && !results[0].mIsAutosave);
+    BOOST_CHECK(results[1].mFileName == fileName2 && results[1].mSuccess && results[1].mIsAutosave);
+    BOOST_CHECK(!results[2].mSuccess && !results[2].mError.empty());
+    BOOST_CHECK(readFile(fileName1).find("9999\t0\t2\t12.5\n") != std::string::npos);
+
+    results.clear();
+    saver.popResults(results);
+    BOOST_CHECK(results.empty());
+
+    boost::filesystem::remove(fileName1);
+    boost::filesystem::remove(fileName2);
+}
+
+BOOST_AUTO_TEST_CASE(test_AsyncMapSaverDestruction)
+{
+    // Pending saves are written when the saver is destroyed
+    const std::string fileName = "test_AsyncMapSaverDestruction.level";
+    {
+        AsyncMapSaver saver;
+        saver.save(createSnapshot(10000), fileName, false, false);
+    }
+    BOOST_CHECK(readFile(fileName).find("[/Rooms]") != std::string::npos);
+    boost::filesystem::remove(fileName);
+}
@@ -0,0 +1,146 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE BinaryLevel
+#include "BoostTestTargetConfig.h"
+
+#include "gamemap/BinaryLevel.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const std::string TEST_LEVEL =
+    "0.7.0\n"
+    "# Comments and blank lines are not kept in the binary format\n"
+    "[Info]\n"
+    "Name\tTest level\n"
+    "[/Info]\n"
+    "\n"
+    "[Seats]\n"
+    "[Seat]\n"
+    "seatId\t1\n"
+    "[/Seat]\n"
+    "[/Seats]\n"
+    "[Tiles]\n"
+    "3\n"
+    "2\n"
+    "0\t0\t1\t100\n"
+    "1\t0\t2\t0.5\t1 # dirt claimed by seat 1\n"
+    "2\t0\t4\t0\n"
+    "0\t1\t1\t0\t1\n"
+    "[/Tiles]\n"
+    "[Rooms]\n"
+    "1\n"
+    "[/Rooms]\n";
+
+static bool toBinary(const std::string& text, std::vector<char>& binary)
+{
+    std::istringstream is(text);
+    std::string error;
+    return BinaryLevel::textToBinary(is, binary, error);
+}
+
+BOOST_AUTO_TEST_CASE(test_BinaryLevelTiles)
+{
+    std::vector<char> binary;
+    BOOST_REQUIRE(toBinary(TEST_LEVEL, binary));
+
+    BinaryLevelReader reader;
+    BOOST_REQUIRE(reader.openFromMemory(binary.data(), binary.size()));
+    BOOST_CHECK(reader.getMapSizeX() == 3);
+    BOOST_CHECK(reader.getMapSizeY() == 2);
+    BOOST_REQUIRE(reader.getNbTiles() == 4);
+
+    const BinaryLevel::TileRecord* tiles = reader.getTiles();
+    BOOST_CHECK(tiles[0].mX == 0 && tiles[0].mY == 0 && tiles[0].mType == 1);
+    BOOST_CHECK(tiles[0].mFullness == 100.0);
+    BOOST_CHECK(tiles[0].mHasSeat == 0);
+    BOOST_CHECK(tiles[1].mX == 1 && tiles[1].mType == 2);
+    BOOST_CHECK(tiles[1].mFullness == 0.5);
+    BOOST_CHECK(tiles[1].mHasSeat != 0 && tiles[1].mSeatId == 1);
+    BOOST_CHECK(tiles[3].mY == 1 && tiles[3].mSeatId == 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_BinaryLevelRoundTrip)
+{
+    std::vector<char> binary;
+    BOOST_REQUIRE(toBinary(TEST_LEVEL, binary));
+
+    BinaryLevelReader reader;
+    BOOST_REQUIRE(reader.openFromMemory(binary.data(), binary.size()));
+
+    // The text exported from the binary level gives the same binary level
+    std::stringstream text;
+    reader.exportText(text, true);
+    std::vector<char> binary2;
+    BOOST_REQUIRE(toBinary(text.str(), binary2));
+    BOOST_CHECK(binary == binary2);
+
+    // Comments are removed and the other sections are kept
+    BOOST_CHECK(text.str().find('#') == std::string::npos);
+    BOOST_CHECK(text.str().find("Name\tTest level") != std::string::npos);
+    BOOST_CHECK(text.str().find("[Rooms]") != std::string::npos);
+
+    // Without the tiles, only the map size is exported
+    std::stringstream textNoTiles;
+    reader.exportText(textNoTiles, false);
+    BOOST_CHECK(textNoTiles.str().find("[Tiles]\n3\n2\n[/Tiles]") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_BinaryLevelInvalid)
+{
+    std::vector<char> binary;
+    BOOST_REQUIRE(toBinary(TEST_LEVEL, binary));
+
+    BinaryLevelReader reader;
+    std::vector<char> badMagic = binary;
+    badMagic[0] = 'X';
+    BOOST_CHECK(!reader.openFromMemory(badMagic.data(), badMagic.size()));
+
+    std::vector<char> truncated(binary.begin(), binary.begin() + 20);
+    BOOST_CHECK(!reader.openFromMemory(truncated.data(), truncated.size()));
+    BOOST_CHECK(!reader.getError().empty());
+
+    std::vector<char> badTiles;
+    BOOST_CHECK(!toBinary("0.7.0\n[Tiles]\n3\n2\n0\t0\n[/Tiles]\n", badTiles));
+}
+
+BOOST_AUTO_TEST_CASE(test_BinaryLevelFile)
+{
+    const std::string textFile = "test_BinaryLevel.level";
+    const std::string binaryFile = "test_BinaryLevel.bin.level";
+    {
+        std::ofstream os(textFile);
+        os << TEST_LEVEL;
+    }
+
+    std::string error;
+    BOOST_REQUIRE(BinaryLevel::convertLevelFile(textFile, binaryFile, error));
+    BOOST_CHECK(!BinaryLevel::isBinaryLevelFile(textFile));
+    BOOST_CHECK(BinaryLevel::isBinaryLevelFile(binaryFile));
+
+    BinaryLevelReader reader;
+    BOOST_REQUIRE(reader.open(binaryFile));
+    BOOST_CHECK(reader.getNbTiles() == 4);
+    BOOST_CHECK(reader.getTiles()[1].mFullness == 0.5);
+
+    std::remove(textFile.c_str());
+    std::remove(binaryFile.c_str());
+}
@@ -0,0 +1,76 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gamemap/CreatureSpatialIndex.h"
+
+#define BOOST_TEST_MODULE CreatureSpatialIndex
+#include "BoostTestTargetConfig.h"
+
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_CreatureSpatialIndex)
+{
+    // The index only stores the pointers so we can use fake creatures
+    Creature* creature1 = reinterpret_cast<Creature*>(1);
+    Creature* creature2 = reinterpret_cast<Creature*>(2);
+    Creature* creature3 = reinterpret_cast<Creature*>(3);
+
+    CreatureSpatialIndex index;
+    index.setMapSize(50, 30);
+    index.addCreature(creature1, 10, 10);
+    index.addCreature(creature2, 12, 10);
+    index.addCreature(creature3, 40, 25);
+    BOOST_CHECK_EQUAL(index.getNbCreatures(), 3u);
+
+    std::vector<Creature*> creatures;
+    index.fillCreaturesInSquare(11, 10, 1, creatures);
+    BOOST_CHECK(creatures == std::vector<Creature*>({creature1, creature2}));
+
+    // The creatures outside the square should not be returned even if they are in a cell
+    // touched by the square
+    creatures.clear();
+    index.fillCreaturesInSquare(9, 10, 1, creatures);
+    BOOST_CHECK(creatures == std::vector<Creature*>({creature1}));
+
+    // Squares crossing the map border
+    creatures.clear();
+    index.fillCreaturesInSquare(49, 29, 10, creatures);
+    BOOST_CHECK(creatures == std::vector<Creature*>({creature3}));
+
+    creatures.clear();
+    index.fillCreaturesInSquare(0, 0, 5, creatures);
+    BOOST_CHECK(creatures.empty());
+
+    // Moving a creature
+    index.removeCreature(creature1, 10, 10);
+    index.addCreature(creature1, 39, 24);
+    creatures.clear();
+    index.fillCreaturesInSquare(40, 25, 2, creatures);
+    BOOST_CHECK(creatures == std::vector<Creature*>({creature1, creature3}));
+    creatures.clear();
+    index.fillCreaturesInSquare(11, 10, 1, creatures);
+    BOOST_CHECK(creatures == std::vector<Creature*>({creature2}));
+
+    index.removeCreature(creature2, 12, 10);
+    creatures.clear();
+    index.fillCreaturesInSquare(11, 10, 5, creatures);
+    BOOST_CHECK(creatures.empty());
+    BOOST_CHECK_EQUAL(index.getNbCreatures(), 2u);
+
+    index.setMapSize(10, 10);
+    BOOST_CHECK_EQUAL(index.getNbCreatures(), 0u);
+}
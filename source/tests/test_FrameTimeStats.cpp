@@ -0,0 +1,71 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/FrameTimeStats.h"
+
+#define BOOST_TEST_MODULE FrameTimeStats
+#include "BoostTestTargetConfig.h"
+
+BOOST_AUTO_TEST_CASE(test_FrameTimeStatsEmpty)
+{
+    FrameTimeStats stats;
+    BOOST_CHECK_EQUAL(stats.getNbFrames(), 0);
+    BOOST_CHECK_EQUAL(stats.computeFrameTimes().mMax, 0);
+    BOOST_CHECK_EQUAL(stats.computeNetworkTimes().mMax, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_FrameTimeStatsPercentiles)
+{
+    FrameTimeStats stats;
+    // Frames from 1 to 100 us, the network time is 10 times less
+    for(uint64_t i = 1; i <= 100; ++i)
+        BOOST_CHECK(!stats.addFrame(i, i / 10));
+
+    BOOST_CHECK_EQUAL(stats.getNbFrames(), 100);
+    FrameTimeStats::Percentiles frame = stats.computeFrameTimes();
+    BOOST_CHECK_EQUAL(frame.mAverage, 50);
+    BOOST_CHECK_EQUAL(frame.mMedian, 51);
+    BOOST_CHECK_EQUAL(frame.mPercentile95, 96);
+    BOOST_CHECK_EQUAL(frame.mPercentile99, 100);
+    BOOST_CHECK_EQUAL(frame.mMax, 100);
+    BOOST_CHECK_EQUAL(stats.computeNetworkTimes().mMax, 10);
+
+    stats.reset();
+    BOOST_CHECK_EQUAL(stats.getNbFrames(), 0);
+    BOOST_CHECK_EQUAL(stats.computeFrameTimes().mMax, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_FrameTimeStatsRollingWindow)
+{
+    FrameTimeStats stats;
+    uint32_t nbReports = 0;
+    // A spike in the first window is forgotten once the window rolled over it
+    for(uint32_t i = 0; i < 3 * FrameTimeStats::NB_FRAMES_HISTORY; ++i)
+    {
+        if(stats.addFrame(i == 0 ? 100000 : 16000, 0))
+            ++nbReports;
+
+        if(i == FrameTimeStats::NB_FRAMES_HISTORY - 1)
+            BOOST_CHECK_EQUAL(stats.computeFrameTimes().mMax, 100000);
+    }
+
+    BOOST_CHECK_EQUAL(nbReports, 3);
+    BOOST_CHECK_EQUAL(stats.getNbFrames(), FrameTimeStats::NB_FRAMES_HISTORY);
+    FrameTimeStats::Percentiles frame = stats.computeFrameTimes();
+    BOOST_CHECK_EQUAL(frame.mMax, 16000);
+    BOOST_CHECK_EQUAL(frame.mPercentile99, 16000);
+}
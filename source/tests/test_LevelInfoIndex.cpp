@@ -0,0 +1,180 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE LevelInfoIndex
+#include "BoostTestTargetConfig.h"
+
+#include "gamemap/LevelInfoIndex.h"
+#include "utils/LogManager.h"
+#include "utils/LogSinkConsole.h"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+//! \brief Levels are read by this function instead of MapHandler::getMapInfo. The level is
+//! valid if its first line is "valid" and the name is the second line
+struct LevelReader
+{
+    LevelReader() :
+        mNbReads(0)
+    {}
+
+    bool operator()(const std::string& fileName, LevelInfo& levelInfo)
+    {
+        ++mNbReads;
+        std::ifstream is(fileName);
+        std::string line;
+        std::getline(is, line);
+        if(line != "valid")
+            return false;
+
+        std::getline(is, levelInfo.mLevelName);
+        levelInfo.mLevelDescription = "Description of\n" + levelInfo.mLevelName + "\twith\\special chars";
+        return true;
+    }
+
+    uint32_t mNbReads;
+};
+
+class TestFolder
+{
+public:
+    TestFolder() :
+        mPath(boost::filesystem::canonical(boost::filesystem::current_path()) / "test_LevelInfoIndex")
+    {
+        boost::filesystem::remove_all(mPath);
+        boost::filesystem::create_directory(mPath);
+    }
+
+    ~TestFolder()
+    {
+        boost::filesystem::remove_all(mPath);
+    }
+
+    std::string writeLevel(const std::string& name, const std::string& content)
+    {
+        std::string fileName = (mPath / name).string();
+        std::ofstream os(fileName);
+        os << content;
+        return fileName;
+    }
+
+    std::string getPath(const std::string& name) const
+    { return (mPath / name).string(); }
+
+    boost::filesystem::path mPath;
+};
+
+BOOST_AUTO_TEST_CASE(test_LevelInfoIndexCache)
+{
+    LogManager logMgr;
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+
+    TestFolder folder;
+    std::string level1 = folder.writeLevel("level1.level", "valid\nLevel 1\n");
+    std::string level2 = folder.writeLevel("level2.level", "invalid\n");
+    std::string indexFile = folder.getPath("index");
+
+    LevelReader reader;
+    {
+        LevelInfoIndex index(indexFile, std::ref(reader));
+        LevelInfo info;
+        BOOST_CHECK(index.getLevelInfo(level1, info));
+        BOOST_CHECK(info.mLevelName == "Level 1");
+        BOOST_CHECK(!index.getLevelInfo(level2, info));
+        BOOST_CHECK(reader.mNbReads == 2);
+
+        // Unchanged levels are not read again, even invalid ones
+        LevelInfo info2;
+        BOOST_CHECK(index.getLevelInfo(level1, info2));
+        BOOST_CHECK(info2.mLevelName == "Level 1");
+        BOOST_CHECK(info2.mLevelDescription == info.mLevelDescription);
+        BOOST_CHECK(!index.getLevelInfo(level2, info2));
+        BOOST_CHECK(reader.mNbReads == 2);
+
+        // A changed level is read again
+        folder.writeLevel("level1.level", "valid\nLevel 1 changed\n");
+        BOOST_CHECK(index.getLevelInfo(level1, info));
+        BOOST_CHECK(info.mLevelName == "Level 1 changed");
+        BOOST_CHECK(reader.mNbReads == 3);
+
+        // Missing files are invalid
+        BOOST_CHECK(!index.getLevelInfo(folder.getPath("missing.level"), info));
+    }
+
+    // The index is saved when destroyed and loaded by the next one
+    BOOST_REQUIRE(boost::filesystem::exists(indexFile));
+    reader.mNbReads = 0;
+    {
+        LevelInfoIndex index(indexFile, std::ref(reader));
+        LevelInfo info;
+        BOOST_CHECK(index.getLevelInfo(level1, info));
+        BOOST_CHECK(info.mLevelName == "Level 1 changed");
+        BOOST_CHECK(info.mLevelDescription == "Description of\nLevel 1 changed\twith\\special chars");
+        BOOST_CHECK(!index.getLevelInfo(level2, info));
+        BOOST_CHECK(reader.mNbReads == 0);
+    }
+
+    // An index with another format is ignored
+    {
+        std::ofstream os(indexFile);
+        os << "ODLevelInfoIndex\t0\n";
+    }
+    {
+        LevelInfoIndex index(indexFile, std::ref(reader));
+        LevelInfo info;
+        BOOST_CHECK(index.getLevelInfo(level1, info));
+        BOOST_CHECK(reader.mNbReads == 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_LevelInfoIndexRefresh)
+{
+    LogManager logMgr;
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+
+    TestFolder folder;
+    std::vector<std::string> levels;
+    for(int i = 0; i < 50; ++i)
+    {
+        std::string name = "level" + std::to_string(i);
+        levels.push_back(folder.writeLevel(name + ".level", "valid\n" + name + "\n"));
+    }
+    folder.writeLevel("notALevel.txt", "valid\nnotALevel\n");
+    std::string indexFile = folder.getPath("index");
+
+    LevelReader reader;
+    LevelInfoIndex index(indexFile, std::ref(reader));
+    index.refreshAsync({ folder.mPath.string(), folder.getPath("missingFolder") }, ".level");
+
+    // The menus can use the index while it is refreshed
+    LevelInfo info;
+    BOOST_CHECK(index.getLevelInfo(levels[10], info));
+    BOOST_CHECK(info.mLevelName == "level10");
+
+    index.waitRefresh();
+    BOOST_CHECK(boost::filesystem::exists(indexFile));
+    uint32_t nbReads = index.getNbLevelsRead();
+    BOOST_CHECK(nbReads >= 50);
+    for(const std::string& level : levels)
+        BOOST_CHECK(index.getLevelInfo(level, info));
+
+    BOOST_CHECK(index.getNbLevelsRead() == nbReads);
+}
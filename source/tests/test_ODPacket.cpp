@@ -53,4 +53,19 @@ BOOST_AUTO_TEST_CASE(test_ODPacket)
         BOOST_CHECK(inInt == outInt);
 
     }
+    //Test variable length integers
+    {
+        ODPacket packet;
+        const uint32_t inValues[] = { 0, 1, 127, 128, 300, 16384, 0xFFFFFFFF };
+        for(uint32_t inValue : inValues)
+            packet.writeVarUInt32(inValue);
+        for(uint32_t inValue : inValues)
+        {
+            uint32_t outValue = 0;
+            BOOST_CHECK(packet.readVarUInt32(outValue));
+            BOOST_CHECK_EQUAL(outValue, inValue);
+        }
+        uint32_t outValue;
+        BOOST_CHECK(!packet.readVarUInt32(outValue));
+    }
 }
@@ -0,0 +1,87 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE ODSocketServer
+#include "BoostTestTargetConfig.h"
+
+#include "network/ODSocketServer.h"
+#include "utils/LogManager.h"
+#include "utils/LogSinkConsole.h"
+
+#include <SFML/System.hpp>
+
+#include <memory>
+#include <vector>
+
+//! \brief Server keeping the clients it is notified about so that doTask sees them at each loop
+class TestSocketServer : public ODSocketServer
+{
+public:
+    TestSocketServer() :
+        mNbClientNotifications(0)
+    {}
+
+    ~TestSocketServer()
+    {
+        for(ODSocketClient* client : mSockClients)
+            delete client;
+        mSockClients.clear();
+    }
+
+    void addClient(ODSocketClient* client)
+    { mSockClients.push_back(client); }
+
+    void runTask(int timeoutMs)
+    { doTask(timeoutMs); }
+
+    uint32_t mNbClientNotifications;
+
+protected:
+    ODSocketClient* notifyNewConnection(sf::TcpListener&) override
+    { return nullptr; }
+
+    bool notifyClientMessage(ODSocketClient*) override
+    {
+        ++mNbClientNotifications;
+        return true;
+    }
+
+    void serverThread() override
+    {}
+};
+
+BOOST_AUTO_TEST_CASE(test_DoTaskWithSendFailedClient)
+{
+    LogManager logMgr;
+    logMgr.addSink(std::unique_ptr<LogSink>(new LogSinkConsole()));
+
+    // The client is not connected so the flush fails. It does not send anything either
+    ODSocketClient* client = new ODSocketClient;
+    client->setBufferedSend(true);
+    client->queueFramedData(std::make_shared<std::vector<char>>(16, 0));
+    client->flushSend();
+    BOOST_REQUIRE(client->isSendFailed());
+
+    TestSocketServer server;
+    server.addClient(client);
+
+    // doTask should still return after the given time
+    sf::Clock clock;
+    server.runTask(50);
+    BOOST_CHECK(clock.getElapsedTime().asMilliseconds() < 1000);
+    BOOST_CHECK(server.mNbClientNotifications > 0);
+}
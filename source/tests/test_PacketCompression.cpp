@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "network/PacketCompression.h"
+
+#define BOOST_TEST_MODULE PacketCompression
+#include "BoostTestTargetConfig.h"
+
+namespace
+{
+    bool roundTrip(const std::string& data, const std::string& dictionary, std::size_t& compressedSize)
+    {
+        std::vector<char> compressed;
+        compressedSize = PacketCompression::compress(data.data(), data.size(), dictionary, compressed);
+        std::vector<char> decompressed;
+        if(!PacketCompression::decompress(compressed.data(), compressed.size(), dictionary, data.size(), decompressed))
+            return false;
+
+        return std::string(decompressed.begin(), decompressed.end()) == data;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_PacketCompression)
+{
+    std::size_t compressedSize;
+    BOOST_CHECK(roundTrip(std::string(), std::string(), compressedSize));
+    BOOST_CHECK(roundTrip("abc", std::string(), compressedSize));
+
+    // Repeated data should be much smaller
+    std::string repeated;
+    for(int i = 0; i < 200; ++i)
+        repeated += "Kobold.mesh" + std::string(1, static_cast<char>(i % 3));
+    BOOST_CHECK(roundTrip(repeated, std::string(), compressedSize));
+    BOOST_CHECK(compressedSize < repeated.size() / 4);
+
+    // Data found in the dictionary should be smaller with it
+    std::string dictionary = "DwarfDragon.meshTroll.mesh";
+    std::string data = "Dragon.mesh and Troll.mesh";
+    std::size_t compressedSizeNoDictionary;
+    BOOST_CHECK(roundTrip(data, std::string(), compressedSizeNoDictionary));
+    BOOST_CHECK(roundTrip(data, dictionary, compressedSize));
+    BOOST_CHECK(compressedSize < compressedSizeNoDictionary);
+
+    // Data compressed with a dictionary cannot be decompressed without (the size would be wrong)
+    std::vector<char> compressed;
+    PacketCompression::compress(data.data(), data.size(), dictionary, compressed);
+    std::vector<char> decompressed;
+    BOOST_CHECK(!PacketCompression::decompress(compressed.data(), compressed.size(), std::string(), data.size(), decompressed));
+
+    // Wrong size
+    BOOST_CHECK(!PacketCompression::decompress(compressed.data(), compressed.size(), dictionary, data.size() + 1, decompressed));
+}
+
+BOOST_AUTO_TEST_CASE(test_PacketCompressionCompressor)
+{
+    // A compressor reused for several packets should give the same result as a new one
+    std::string dictionary = "DwarfDragon.meshTroll.mesh";
+    PacketCompression::Compressor compressor(dictionary);
+    std::vector<std::string> packets = { "Dragon.mesh and Troll.mesh", "Troll.mesh Troll.mesh Dwarf",
+        std::string(300, 'a'), "Dragon.mesh and Troll.mesh" };
+    for(const std::string& data : packets)
+    {
+        std::vector<char> expected;
+        PacketCompression::compress(data.data(), data.size(), dictionary, expected);
+        std::vector<char> compressed;
+        compressor.compress(data.data(), data.size(), compressed);
+        BOOST_CHECK(compressed == expected);
+    }
+
+    // Changing the dictionary
+    compressor.setDictionary(std::string());
+    std::vector<char> expected;
+    PacketCompression::compress(packets[0].data(), packets[0].size(), std::string(), expected);
+    std::vector<char> compressed;
+    compressor.compress(packets[0].data(), packets[0].size(), compressed);
+    BOOST_CHECK(compressed == expected);
+    std::vector<char> decompressed;
+    BOOST_CHECK(PacketCompression::decompress(compressed.data(), compressed.size(), std::string(), packets[0].size(), decompressed));
+    BOOST_CHECK(std::string(decompressed.begin(), decompressed.end()) == packets[0]);
+}
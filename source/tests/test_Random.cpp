@@ -20,8 +20,172 @@
 #define BOOST_TEST_MODULE Random
 #include "BoostTestTargetConfig.h"
 
+#include <cmath>
+#include <thread>
+#include <vector>
+
 BOOST_AUTO_TEST_CASE(test_Random)
 {
     Random::initialize();
     BOOST_CHECK (Random::Int(1, 2 ) <= 2);
 }
+
+BOOST_AUTO_TEST_CASE(test_RandomSeed)
+{
+    // The same seed should give the same sequence
+    Random::initialize(42);
+    int first = Random::Int(0, 1000);
+    double second = Random::Double(0.0, 1.0);
+    Random::initialize(42);
+    BOOST_CHECK_EQUAL(Random::Int(0, 1000), first);
+    BOOST_CHECK_EQUAL(Random::Double(0.0, 1.0), second);
+}
+
+BOOST_AUTO_TEST_CASE(test_RandomBounds)
+{
+    Random::initialize(7);
+    bool minReached = false;
+    bool maxReached = false;
+    for(int i = 0; i < 10000; ++i)
+    {
+        int value = Random::Int(3, -2);
+        BOOST_REQUIRE(value >= -2 && value <= 3);
+        minReached |= (value == -2);
+        maxReached |= (value == 3);
+
+        unsigned int valueU = Random::Uint(10, 12);
+        BOOST_REQUIRE(valueU >= 10 && valueU <= 12);
+
+        double valueD = Random::Double(-1.0, 1.0);
+        BOOST_REQUIRE(valueD >= -1.0 && valueD < 1.0);
+    }
+    BOOST_CHECK(minReached);
+    BOOST_CHECK(maxReached);
+
+    // Full ranges
+    Random::Int(INT32_MIN, INT32_MAX);
+    Random::Uint(0, UINT32_MAX);
+    BOOST_CHECK_EQUAL(Random::Int(5, 5), 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_RandomDistribution)
+{
+    // Chi-square test on 64 buckets. With 63 degrees of freedom, a correct generator is
+    // above 100 less than 0.2% of the time. The seed is fixed so the test is reproducible
+    Random::initialize(1234);
+    const int nbBuckets = 64;
+    const int nbValues = 640000;
+    std::vector<int> buckets(nbBuckets, 0);
+    double sum = 0.0;
+    double sumGaussian = 0.0;
+    double sumSquaresGaussian = 0.0;
+    for(int i = 0; i < nbValues; ++i)
+    {
+        ++buckets[Random::Int(0, nbBuckets - 1)];
+        sum += Random::Double(0.0, 1.0);
+        double gaussian = Random::gaussianRandomDouble();
+        sumGaussian += gaussian;
+        sumSquaresGaussian += gaussian * gaussian;
+    }
+
+    double expected = static_cast<double>(nbValues) / nbBuckets;
+    double chiSquare = 0.0;
+    for(int count : buckets)
+        chiSquare += (count - expected) * (count - expected) / expected;
+
+    BOOST_CHECK_LT(chiSquare, 100.0);
+    BOOST_CHECK_CLOSE(sum / nbValues, 0.5, 0.5);
+    BOOST_CHECK_SMALL(sumGaussian / nbValues, 0.01);
+    BOOST_CHECK_CLOSE(sumSquaresGaussian / nbValues, 1.0, 1.0);
+
+    // The high bits should not be biased like the ones of the old LCG
+    RandomStream stream(1234, RandomStreamContext::thread, 0);
+    std::vector<int> bits(64, 0);
+    for(int i = 0; i < 100000; ++i)
+    {
+        uint64_t value = stream.next();
+        for(int bit = 0; bit < 64; ++bit)
+            bits[bit] += static_cast<int>((value >> bit) & 1);
+    }
+    for(int count : bits)
+        BOOST_CHECK(std::abs(count - 50000) < 1000);
+}
+
+BOOST_AUTO_TEST_CASE(test_RandomStreams)
+{
+    // Streams only depend on the seed, the context and the id
+    RandomStream stream1(42, RandomStreamContext::entity, 3);
+    RandomStream stream2(42, RandomStreamContext::entity, 3);
+    RandomStream stream3(42, RandomStreamContext::entity, 4);
+    RandomStream stream4(42, RandomStreamContext::ai, 3);
+    RandomStream stream5(43, RandomStreamContext::entity, 3);
+    for(int i = 0; i < 100; ++i)
+    {
+        uint64_t value = stream1.next();
+        BOOST_CHECK_EQUAL(value, stream2.next());
+        BOOST_CHECK(value != stream3.next());
+        BOOST_CHECK(value != stream4.next());
+        BOOST_CHECK(value != stream5.next());
+    }
+    BOOST_CHECK_EQUAL(stream1.getCounter(), 100u);
+
+    // The values drawn in a scope come from its stream and do not change the thread stream
+    Random::initialize(42);
+    int threadFirst = Random::Int(0, 1000000);
+    int threadSecond = Random::Int(0, 1000000);
+
+    Random::initialize(42);
+    RandomStream entityStream;
+    RandomStream aiStream;
+    BOOST_CHECK_EQUAL(Random::Int(0, 1000000), threadFirst);
+    int entityFirst;
+    {
+        Random::StreamScope scope(entityStream, RandomStreamContext::entity, 3);
+        BOOST_CHECK(entityStream.isSeeded());
+        entityFirst = Random::Int(0, 1000000);
+        {
+            Random::StreamScope scopeAi(aiStream, RandomStreamContext::ai, 1);
+            Random::Int(0, 1000000);
+        }
+        BOOST_CHECK_EQUAL(entityStream.getCounter(), 1u);
+        BOOST_CHECK_EQUAL(aiStream.getCounter(), 1u);
+    }
+    BOOST_CHECK_EQUAL(Random::Int(0, 1000000), threadSecond);
+
+    RandomStream expected = Random::createStream(RandomStreamContext::entity, 3);
+    BOOST_CHECK_EQUAL(entityFirst, static_cast<int>(expected.nextBounded(1000001)));
+}
+
+BOOST_AUTO_TEST_CASE(test_RandomThreads)
+{
+    // Entities processed in other threads draw the same values as if they were processed
+    // in the calling thread
+    Random::initialize(99);
+    const uint32_t nbEntities = 8;
+    std::vector<RandomStream> streams(nbEntities);
+    std::vector<std::vector<int>> expected(nbEntities);
+    for(uint32_t id = 0; id < nbEntities; ++id)
+    {
+        Random::StreamScope scope(streams[id], RandomStreamContext::entity, id);
+        for(int i = 0; i < 1000; ++i)
+            expected[id].push_back(Random::Int(0, 100));
+    }
+
+    std::vector<RandomStream> threadStreams(nbEntities);
+    std::vector<std::vector<int>> values(nbEntities);
+    std::vector<std::thread> threads;
+    for(uint32_t id = 0; id < nbEntities; ++id)
+    {
+        threads.push_back(std::thread([&, id]()
+        {
+            Random::StreamScope scope(threadStreams[id], RandomStreamContext::entity, id);
+            for(int i = 0; i < 1000; ++i)
+                values[id].push_back(Random::Int(0, 100));
+        }));
+    }
+    for(std::thread& thread : threads)
+        thread.join();
+
+    for(uint32_t id = 0; id < nbEntities; ++id)
+        BOOST_CHECK(values[id] == expected[id]);
+}
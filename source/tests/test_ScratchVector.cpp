@@ -0,0 +1,46 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ScratchVector.h"
+
+#define BOOST_TEST_MODULE ScratchVector
+#include "BoostTestTargetConfig.h"
+
+BOOST_AUTO_TEST_CASE(test_ScratchVector)
+{
+    const int* data;
+    {
+        ScratchVector<int> vector;
+        BOOST_CHECK(vector->empty());
+        for(int i = 0; i < 100; ++i)
+            vector->push_back(i);
+        data = vector->data();
+    }
+
+    // The vector should be given back cleared with its memory
+    {
+        ScratchVector<int> vector;
+        BOOST_CHECK(vector->empty());
+        BOOST_CHECK(vector->capacity() >= 100);
+        BOOST_CHECK_EQUAL(vector->data(), data);
+
+        // A vector used at the same time should be another one
+        ScratchVector<int> vector2;
+        BOOST_CHECK(vector2->empty());
+        BOOST_CHECK(&(*vector2) != &(*vector));
+    }
+}
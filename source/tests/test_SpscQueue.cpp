@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/SpscQueue.h"
+
+#define BOOST_TEST_MODULE SpscQueue
+#include "BoostTestTargetConfig.h"
+
+BOOST_AUTO_TEST_CASE(test_SpscQueue)
+{
+    SpscQueue<int> queue(3);
+    int value = 0;
+    BOOST_CHECK(queue.empty());
+    BOOST_CHECK(!queue.pop(value));
+
+    // The queue should keep the order and refuse values when full
+    for(int i = 1; i <= 3; ++i)
+        BOOST_CHECK(queue.push(i));
+    value = 4;
+    BOOST_CHECK(!queue.push(value));
+    BOOST_CHECK_EQUAL(value, 4);
+
+    BOOST_CHECK(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, 1);
+    value = 4;
+    BOOST_CHECK(queue.push(value));
+
+    // Wrapping around
+    for(int i = 2; i <= 4; ++i)
+    {
+        BOOST_CHECK(queue.pop(value));
+        BOOST_CHECK_EQUAL(value, i);
+    }
+    BOOST_CHECK(queue.empty());
+
+    value = 5;
+    BOOST_CHECK(queue.push(value));
+    queue.clear();
+    BOOST_CHECK(queue.empty());
+}
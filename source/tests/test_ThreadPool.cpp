@@ -0,0 +1,53 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ThreadPool.h"
+
+#define BOOST_TEST_MODULE ThreadPool
+#include "BoostTestTargetConfig.h"
+
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_ThreadPool)
+{
+    for(uint32_t nbThreads = 1; nbThreads <= 4; ++nbThreads)
+    {
+        ThreadPool pool(nbThreads);
+        BOOST_CHECK_EQUAL(pool.getNbThreads(), nbThreads);
+
+        // Every item should be processed exactly once, whatever the number of items and
+        // even if the pool is used several times in a row
+        for(uint32_t nbItems : {0u, 1u, 3u, 1000u})
+        {
+            for(uint32_t run = 0; run < 10; ++run)
+            {
+                std::vector<uint32_t> counts(nbItems, 0);
+                pool.parallelFor(nbItems, [&counts](uint32_t index)
+                {
+                    ++counts[index];
+                });
+
+                for(uint32_t count : counts)
+                    BOOST_CHECK_EQUAL(count, 1u);
+            }
+        }
+    }
+
+    // 0 means one thread per core
+    ThreadPool pool(0);
+    BOOST_CHECK(pool.getNbThreads() >= 1);
+}
@@ -0,0 +1,148 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "game/TileStatePlanes.h"
+
+#define BOOST_TEST_MODULE TileStatePlanes
+#include "BoostTestTargetConfig.h"
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(test_TileStatePlanes)
+{
+    // The planes only store the pointers so we can use fake buildings
+    Building* building1 = reinterpret_cast<Building*>(1);
+    Building* building2 = reinterpret_cast<Building*>(2);
+
+    // 13 * 11 tiles so that the last word is not full
+    TileStatePlanes planes;
+    planes.resize(13, 11);
+    BOOST_CHECK(planes.isInMap(12, 10));
+    BOOST_CHECK(!planes.isInMap(13, 0));
+    BOOST_CHECK(!planes.isInMap(0, -1));
+
+    uint32_t index = planes.getIndex(7, 3);
+    BOOST_CHECK_EQUAL(planes.getX(index), 7);
+    BOOST_CHECK_EQUAL(planes.getY(index), 3);
+    BOOST_CHECK_EQUAL(planes.getSeatIdOwner(index), -1);
+    BOOST_CHECK(planes.getTileVisual(index) == static_cast<TileVisual>(0));
+    BOOST_CHECK(planes.getBuilding(index) == nullptr);
+
+    planes.setTileVisual(index, static_cast<TileVisual>(5));
+    planes.setSeatIdOwner(index, 12);
+    planes.setSeatIdOwner(planes.getIndex(7, 4), 3);
+    planes.setMarkedForDigging(index, true);
+    planes.setBuilding(index, building1);
+    planes.setBuilding(planes.getIndex(0, 0), building2);
+    BOOST_CHECK(planes.getTileVisual(index) == static_cast<TileVisual>(5));
+    BOOST_CHECK_EQUAL(planes.getSeatIdOwner(index), 12);
+    BOOST_CHECK_EQUAL(planes.getSeatIdOwner(planes.getIndex(7, 4)), 3);
+    BOOST_CHECK(planes.isMarkedForDigging(index));
+    BOOST_CHECK(!planes.isMarkedForDigging(planes.getIndex(7, 4)));
+    BOOST_CHECK(planes.getBuilding(index) == building1);
+    BOOST_CHECK(planes.getBuilding(planes.getIndex(0, 0)) == building2);
+
+    planes.setSeatIdOwner(index, -1);
+    planes.setBuilding(index, nullptr);
+    BOOST_CHECK_EQUAL(planes.getSeatIdOwner(index), -1);
+    BOOST_CHECK(planes.getBuilding(index) == nullptr);
+
+    // Resizing resets everything
+    planes.resize(13, 11);
+    BOOST_CHECK(planes.getBuilding(planes.getIndex(0, 0)) == nullptr);
+    BOOST_CHECK_EQUAL(planes.getSeatIdOwner(planes.getIndex(7, 4)), -1);
+}
+
+BOOST_AUTO_TEST_CASE(test_TileStatePlanesVisionChanges)
+{
+    // We compare the vision changes with the ones computed on a simple vector of bools
+    const int mapSizeX = 37;
+    const int mapSizeY = 29;
+    const uint32_t nbTiles = mapSizeX * mapSizeY;
+    TileStatePlanes planes;
+    planes.resize(mapSizeX, mapSizeY);
+    std::vector<bool> visionCurrent(nbTiles, false);
+    std::vector<bool> visionLast(nbTiles, false);
+
+    std::srand(42);
+    for(int turn = 0; turn < 50; ++turn)
+    {
+        // Every few turns, the vision is recomputed from scratch
+        if((turn % 10) == 0)
+        {
+            planes.clearVisionCurrent();
+            visionCurrent.assign(nbTiles, false);
+        }
+
+        for(int i = 0; i < 100; ++i)
+        {
+            uint32_t index = planes.getIndex(std::rand() % mapSizeX, std::rand() % mapSizeY);
+            bool vision = (std::rand() % 2) == 0;
+            planes.setVisionCurrent(index, vision);
+            visionCurrent[index] = vision;
+        }
+
+        uint32_t nbVision = 0;
+        std::vector<uint32_t> expectedCurrent;
+        std::vector<std::pair<uint32_t, bool>> expectedChanges;
+        for(uint32_t index = 0; index < nbTiles; ++index)
+        {
+            BOOST_CHECK_EQUAL(planes.hasVisionCurrent(index), visionCurrent[index]);
+            if(visionCurrent[index])
+            {
+                ++nbVision;
+                expectedCurrent.push_back(index);
+            }
+
+            if(visionCurrent[index] != visionLast[index])
+                expectedChanges.push_back(std::make_pair(index, static_cast<bool>(visionCurrent[index])));
+        }
+        BOOST_CHECK_EQUAL(planes.countVisionCurrent(), nbVision);
+
+        std::vector<uint32_t> current;
+        planes.forEachVisionCurrent([&](uint32_t index)
+        {
+            current.push_back(index);
+        });
+        BOOST_CHECK(current == expectedCurrent);
+
+        uint32_t nbGained;
+        uint32_t nbLost;
+        planes.countVisionChanges(nbGained, nbLost);
+        BOOST_CHECK_EQUAL(nbGained + nbLost, expectedChanges.size());
+
+        std::vector<std::pair<uint32_t, bool>> changes;
+        uint32_t nbGainedApplied = 0;
+        planes.applyVisionChanges([&](uint32_t index, bool hasVision)
+        {
+            changes.push_back(std::make_pair(index, hasVision));
+            if(hasVision)
+                ++nbGainedApplied;
+        });
+        BOOST_CHECK(changes == expectedChanges);
+        BOOST_CHECK_EQUAL(nbGainedApplied, nbGained);
+        visionLast = visionCurrent;
+
+        // Once applied, there should be no change left
+        planes.countVisionChanges(nbGained, nbLost);
+        BOOST_CHECK_EQUAL(nbGained + nbLost, 0u);
+        for(uint32_t index = 0; index < nbTiles; ++index)
+            BOOST_CHECK_EQUAL(planes.hasVisionLast(index), visionLast[index]);
+    }
+}
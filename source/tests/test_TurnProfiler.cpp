@@ -0,0 +1,137 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/TurnProfiler.h"
+
+#define BOOST_TEST_MODULE TurnProfiler
+#include "BoostTestTargetConfig.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+static void doWork(uint32_t durationUs)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(durationUs));
+}
+
+static void doTurn(uint32_t nbCallsChild)
+{
+    OD_PROFILE_SCOPE("turn");
+    doWork(100);
+    for(uint32_t i = 0; i < nbCallsChild; ++i)
+    {
+        OD_PROFILE_SCOPE("child");
+        doWork(100);
+    }
+    {
+        OD_PROFILE_SCOPE("other");
+        OD_PROFILE_SCOPE("child");
+        doWork(100);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnProfilerDisabled)
+{
+    BOOST_CHECK(!TurnProfiler::isEnabled());
+    doTurn(2);
+    TurnProfiler::endTurn();
+    BOOST_CHECK_EQUAL(TurnProfiler::getNbTurns(), 0);
+    BOOST_CHECK(TurnProfiler::computeStats().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnProfilerSections)
+{
+    TurnProfiler::setEnabled(true);
+    for(uint32_t turn = 0; turn < 10; ++turn)
+    {
+        doTurn(2);
+        TurnProfiler::endTurn();
+    }
+    // A turn where nothing was done is not counted
+    TurnProfiler::endTurn();
+    BOOST_CHECK_EQUAL(TurnProfiler::getNbTurns(), 10);
+
+    // Each section is followed by its children
+    std::vector<TurnProfiler::SectionStats> stats = TurnProfiler::computeStats();
+    BOOST_REQUIRE_EQUAL(stats.size(), 4);
+    BOOST_CHECK_EQUAL(stats[0].mName, "turn");
+    BOOST_CHECK_EQUAL(stats[0].mDepth, 0);
+    BOOST_CHECK_EQUAL(stats[1].mName, "child");
+    BOOST_CHECK_EQUAL(stats[1].mDepth, 1);
+    BOOST_CHECK_CLOSE(stats[1].mCallsPerTurn, 2.0, 0.001);
+    BOOST_CHECK_EQUAL(stats[2].mName, "other");
+    BOOST_CHECK_EQUAL(stats[3].mName, "child");
+    BOOST_CHECK_EQUAL(stats[3].mDepth, 2);
+    BOOST_CHECK_CLOSE(stats[3].mCallsPerTurn, 1.0, 0.001);
+
+    // The parent includes the time of its children
+    BOOST_CHECK(stats[0].mAverage >= 400);
+    BOOST_CHECK(stats[0].mAverage >= stats[1].mAverage + stats[2].mAverage);
+    BOOST_CHECK(stats[1].mAverage >= 200);
+    BOOST_CHECK(stats[1].mMedian <= stats[1].mPercentile95);
+    BOOST_CHECK(stats[1].mPercentile95 <= stats[1].mMax);
+
+    std::string text = TurnProfiler::getStatsText();
+    BOOST_CHECK(text.find("\n    child") != std::string::npos);
+
+    // Every turn should be in the histogram
+    std::string histogram = TurnProfiler::getHistogramText("child");
+    uint32_t nbTurns = 0;
+    for(std::size_t pos = histogram.find(" us: "); pos != std::string::npos; pos = histogram.find(" us: ", pos + 1))
+        nbTurns += std::stoul(histogram.substr(pos + 5));
+
+    BOOST_CHECK_EQUAL(nbTurns, 10);
+    BOOST_CHECK(TurnProfiler::getHistogramText("unknown").find("No section") == 0);
+
+    TurnProfiler::reset();
+    BOOST_CHECK_EQUAL(TurnProfiler::getNbTurns(), 0);
+    TurnProfiler::setEnabled(false);
+}
+
+BOOST_AUTO_TEST_CASE(test_TurnProfilerTrace)
+{
+    const std::string filename = "test_TurnProfilerTrace.json";
+    TurnProfiler::startTrace(filename, 2);
+    BOOST_CHECK(TurnProfiler::isEnabled());
+    BOOST_CHECK(TurnProfiler::isTracing());
+    for(uint32_t turn = 0; turn < 3; ++turn)
+    {
+        doTurn(1);
+        TurnProfiler::endTurn();
+    }
+    BOOST_CHECK(!TurnProfiler::isTracing());
+    TurnProfiler::setEnabled(false);
+
+    std::ifstream file(filename.c_str());
+    BOOST_REQUIRE(file.is_open());
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string trace = content.str();
+    BOOST_CHECK(trace.find("{\"traceEvents\":[") == 0);
+    // 2 turns with 4 sections each
+    uint32_t nbEvents = 0;
+    for(std::size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos; pos = trace.find("\"ph\":\"X\"", pos + 1))
+        ++nbEvents;
+
+    BOOST_CHECK_EQUAL(nbEvents, 8);
+    BOOST_CHECK(trace.find("\"name\":\"other\"") != std::string::npos);
+    file.close();
+    std::remove(filename.c_str());
+}
@@ -249,6 +249,9 @@ void Trap::activate(Tile* tile)
     trapTileData->setNbShootsBeforeDeactivation(mNbShootsBeforeDeactivation);
     trapTileData->setReloadTime(0);
 
+    // Some traps (like doors) block vision depending on their state
+    getGameMap()->tilePermitsVisionChanged(tile);
+
     BuildingObject* entity = getBuildingObjectFromTile(tile);
     if (entity == nullptr)
         return;
@@ -264,6 +267,8 @@ void Trap::deactivate(Tile* tile)
     TrapTileData* trapTileData = static_cast<TrapTileData*>(mTileData[tile]);
     trapTileData->setActivated(false);
 
+    getGameMap()->tilePermitsVisionChanged(tile);
+
     BuildingObject* entity = getBuildingObjectFromTile(tile);
     if (entity == nullptr)
         return;
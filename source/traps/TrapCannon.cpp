@@ -47,7 +47,7 @@ class TrapCannonFactory : public TrapFactory
     { return TrapCannonNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("CannonCostPerTile"); }
+    { return ConfigManager::getSingleton().getTrapConfigInt32(TrapConfigParam::cannonCostPerTile); }
 
     const std::string& getMeshName() const override
     {
@@ -118,11 +118,11 @@ TrapCannon::TrapCannon(GameMap* gameMap) :
     Trap(gameMap),
     mRange(0)
 {
-    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32("CannonReloadTurns");
-    mRange = ConfigManager::getSingleton().getTrapConfigUInt32("CannonRange");
-    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble("CannonDamagePerHitMin");
-    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble("CannonDamagePerHitMax");
-    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32("CannonNbShootsBeforeDeactivation");
+    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::cannonReloadTurns);
+    mRange = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::cannonRange);
+    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfigParam::cannonDamagePerHitMin);
+    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfigParam::cannonDamagePerHitMax);
+    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::cannonNbShootsBeforeDeactivation);
     setMeshName("");
 }
 
@@ -149,7 +149,7 @@ bool TrapCannon::shoot(Tile* tile)
     direction = direction - position;
     direction.normalise();
     MissileOneHit* missile = new MissileOneHit(getGameMap(), getSeat(), getName(), "Cannonball",
-        "", direction, ConfigManager::getSingleton().getTrapConfigDouble("CannonSpeed"),
+        "", direction, ConfigManager::getSingleton().getTrapConfigDouble(TrapConfigParam::cannonSpeed),
         Random::Double(mMinDamage, mMaxDamage), 0.0, 0.0, nullptr, false, false, true);
     missile->addToGameMap();
     missile->createMesh();
@@ -171,15 +171,15 @@ TrapEntity* TrapCannon::getTrapEntity(Tile* tile)
 
 double TrapCannon::getPhysicalDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonPhyDef");
+    return ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::cannonPhyDef);
 }
 
 double TrapCannon::getMagicalDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonMagDef");
+    return ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::cannonMagDef);
 }
 
 double TrapCannon::getElementDefense() const
 {
-    return ConfigManager::getSingleton().getTrapConfigUInt32("CannonEleDef");
+    return ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::cannonEleDef);
 }
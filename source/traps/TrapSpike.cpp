@@ -45,7 +45,7 @@ class TrapSpikeFactory : public TrapFactory
     { return TrapSpikeNameDisplay; }
 
     int getCostPerTile() const override
-    { return ConfigManager::getSingleton().getTrapConfigInt32("SpikeCostPerTile"); }
+    { return ConfigManager::getSingleton().getTrapConfigInt32(TrapConfigParam::spikeCostPerTile); }
 
     const std::string& getMeshName() const override
     {
@@ -113,10 +113,10 @@ static TrapRegister reg(new TrapSpikeFactory);
 TrapSpike::TrapSpike(GameMap* gameMap) :
     Trap(gameMap)
 {
-    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32("SpikeReloadTurns");
-    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble("SpikeDamagePerHitMin");
-    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble("SpikeDamagePerHitMax");
-    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32("SpikeNbShootsBeforeDeactivation");
+    mReloadTime = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::spikeReloadTurns);
+    mMinDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfigParam::spikeDamagePerHitMin);
+    mMaxDamage = ConfigManager::getSingleton().getTrapConfigDouble(TrapConfigParam::spikeDamagePerHitMax);
+    mNbShootsBeforeDeactivation = ConfigManager::getSingleton().getTrapConfigUInt32(TrapConfigParam::spikeNbShootsBeforeDeactivation);
     setMeshName("");
 }
 
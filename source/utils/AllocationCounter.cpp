@@ -0,0 +1,83 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/AllocationCounter.h"
+
+#ifdef OD_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> nbAllocations(0);
+
+// The other forms of operator new and delete (arrays, nothrow) call these ones
+void* operator new(std::size_t size)
+{
+    nbAllocations.fetch_add(1, std::memory_order_relaxed);
+    if(size == 0)
+        size = 1;
+
+    while(true)
+    {
+        void* ptr = std::malloc(size);
+        if(ptr != nullptr)
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+        if(handler == nullptr)
+            throw std::bad_alloc();
+
+        handler();
+    }
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+bool AllocationCounter::isEnabled()
+{
+    return true;
+}
+
+uint64_t AllocationCounter::getNbAllocations()
+{
+    return nbAllocations.load(std::memory_order_relaxed);
+}
+
+#else // OD_COUNT_ALLOCATIONS
+
+bool AllocationCounter::isEnabled()
+{
+    return false;
+}
+
+uint64_t AllocationCounter::getNbAllocations()
+{
+    return 0;
+}
+
+#endif // OD_COUNT_ALLOCATIONS
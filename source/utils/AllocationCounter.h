@@ -0,0 +1,35 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+//! \brief Counts the calls to the global operator new. The count is only available when
+//! the game is built with OD_COUNT_ALLOCATIONS (cmake option of the same name). Otherwise,
+//! the global operator new is not replaced and the count is always 0
+namespace AllocationCounter
+{
+    //! \brief Returns true if the allocations are counted
+    bool isEnabled();
+
+    //! \brief Number of allocations done since the program started (by every thread)
+    uint64_t getNbAllocations();
+}
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,166 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCKPOOL_H
+#define BLOCKPOOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+/*! \brief Per thread free lists of small memory blocks.
+ *
+ * Objects created and destroyed very often (like the creature actions) can get their
+ * memory from here by overriding their class operator new and operator delete. Freed
+ * blocks are not given back to the system but kept in a free list according to their
+ * size, so once enough objects of each size have been allocated, creating a new one
+ * is just popping a block from the list.
+ * Blocks bigger than MAX_BLOCK_SIZE are allocated normally.
+ * When a thread exits, its free blocks are given to a shared list where the other
+ * threads take them when their own list is empty.
+ *
+ * \code
+ * static void* operator new(std::size_t size)
+ * { return BlockPool::allocate(size); }
+ * static void operator delete(void* ptr, std::size_t size)
+ * { BlockPool::release(ptr, size); }
+ * \endcode
+ */
+class BlockPool
+{
+public:
+    //! \brief Block sizes are rounded up to a multiple of this
+    static const std::size_t BLOCK_GRANULARITY = 16;
+    static const std::size_t MAX_BLOCK_SIZE = 256;
+
+    static void* allocate(std::size_t size)
+    {
+        if(size > MAX_BLOCK_SIZE)
+            return ::operator new(size);
+
+        std::size_t sizeClass = getSizeClass(size);
+        FreeBlock*& freeList = getFreeLists()[sizeClass];
+        if(freeList == nullptr)
+        {
+            registerThreadExit();
+            freeList = takeOrphanBlocks(sizeClass);
+            if(freeList == nullptr)
+                return ::operator new(roundSize(size));
+        }
+
+        FreeBlock* block = freeList;
+        freeList = block->mNext;
+        return block;
+    }
+
+    //! \brief Gives back a block. size must be the same as the one given to allocate
+    static void release(void* ptr, std::size_t size)
+    {
+        if(ptr == nullptr)
+            return;
+
+        if(size > MAX_BLOCK_SIZE)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        FreeBlock*& freeList = getFreeLists()[getSizeClass(size)];
+        if(freeList == nullptr)
+            registerThreadExit();
+
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->mNext = freeList;
+        freeList = block;
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* mNext;
+    };
+
+    static const std::size_t NB_SIZE_CLASSES = MAX_BLOCK_SIZE / BLOCK_GRANULARITY;
+
+    //! \brief Gives the free blocks of the thread to the orphan lists when it exits
+    struct ThreadExitGuard
+    {
+        ~ThreadExitGuard()
+        {
+            FreeBlock** freeLists = getFreeLists();
+            std::lock_guard<std::mutex> lock(getOrphanMutex());
+            FreeBlock** orphanLists = getOrphanLists();
+            for(std::size_t sizeClass = 0; sizeClass < NB_SIZE_CLASSES; ++sizeClass)
+            {
+                while(freeLists[sizeClass] != nullptr)
+                {
+                    FreeBlock* block = freeLists[sizeClass];
+                    freeLists[sizeClass] = block->mNext;
+                    block->mNext = orphanLists[sizeClass];
+                    orphanLists[sizeClass] = block;
+                }
+            }
+        }
+    };
+
+    static std::size_t getSizeClass(std::size_t size)
+    { return (size == 0) ? 0 : (size - 1) / BLOCK_GRANULARITY; }
+
+    static std::size_t roundSize(std::size_t size)
+    { return (getSizeClass(size) + 1) * BLOCK_GRANULARITY; }
+
+    //! \brief The free lists are plain pointers so that they are never destroyed. That
+    //! way, objects released while the program exits are still handled correctly. The
+    //! memory kept is bounded by the peak number of living objects
+    static FreeBlock** getFreeLists()
+    {
+        static thread_local FreeBlock* freeLists[NB_SIZE_CLASSES] = {};
+        return freeLists;
+    }
+
+    //! \brief Called when a free list of the thread is empty (so not on every allocation). It
+    //! constructs the guard of the thread on the first call
+    static void registerThreadExit()
+    {
+        static thread_local ThreadExitGuard guard;
+        (void)guard;
+    }
+
+    //! \brief Blocks freed by the threads that exited
+    static FreeBlock** getOrphanLists()
+    {
+        static FreeBlock* orphanLists[NB_SIZE_CLASSES] = {};
+        return orphanLists;
+    }
+
+    static std::mutex& getOrphanMutex()
+    {
+        static std::mutex orphanMutex;
+        return orphanMutex;
+    }
+
+    //! \brief Takes every orphan block of the given size class
+    static FreeBlock* takeOrphanBlocks(std::size_t sizeClass)
+    {
+        std::lock_guard<std::mutex> lock(getOrphanMutex());
+        FreeBlock* blocks = getOrphanLists()[sizeClass];
+        getOrphanLists()[sizeClass] = nullptr;
+        return blocks;
+    }
+};
+
+#endif // BLOCKPOOL_H
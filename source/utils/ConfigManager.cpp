@@ -44,6 +44,9 @@ ConfigManager::ConfigManager(const std::string& configPath, const std::string& u
         const std::string& soundPath) :
     mNetworkPort(0),
     mClientConnectionTimeout(5000),
+    mMaxClientTurnLag(3),
+    mSensingThreads(0),
+    mAutosaveTurns(0),
     mBaseSpawnPoint(10),
     mCreatureDeathCounter(10),
     mMaxCreaturesPerSeatAbsolute(30),
@@ -130,6 +133,8 @@ ConfigManager::ConfigManager(const std::string& configPath, const std::string& u
         exit(1);
     }
 
+    buildPacketDictionary();
+
     // Reserve space in any case.
     mUserConfig.resize(Config::Ctg::TOTAL);
 
@@ -139,6 +144,33 @@ ConfigManager::ConfigManager(const std::string& configPath, const std::string& u
     loadKeeperVoices(soundPath);
 }
 
+void ConfigManager::buildPacketDictionary()
+{
+    // Strings are sent with their size as a big endian uint32 (see sf::Packet) so we
+    // put them the same way in the dictionary
+    auto addString = [this](const std::string& str)
+    {
+        uint32_t size = static_cast<uint32_t>(str.size());
+        mPacketDictionary.push_back(static_cast<char>((size >> 24) & 0xFF));
+        mPacketDictionary.push_back(static_cast<char>((size >> 16) & 0xFF));
+        mPacketDictionary.push_back(static_cast<char>((size >> 8) & 0xFF));
+        mPacketDictionary.push_back(static_cast<char>(size & 0xFF));
+        mPacketDictionary += str;
+    };
+
+    mPacketDictionary.clear();
+    for(const std::pair<const std::string, CreatureDefinition*>& p : mCreatureDefs)
+    {
+        addString(p.second->getClassName());
+        addString(p.second->getMeshName());
+    }
+    for(const Weapon* weapon : mWeapons)
+    {
+        addString(weapon->getName());
+        addString(weapon->getMeshName());
+    }
+}
+
 ConfigManager::~ConfigManager()
 {
     for(auto pair : mCreatureDefs)
@@ -451,6 +483,27 @@ bool ConfigManager::loadGlobalGameConfig(std::stringstream& configFile)
             // Not mandatory
         }
 
+        if(nextParam == "MaxClientTurnLag")
+        {
+            configFile >> nextParam;
+            mMaxClientTurnLag = Helper::toUInt32(nextParam);
+            // Not mandatory
+        }
+
+        if(nextParam == "SensingThreads")
+        {
+            configFile >> nextParam;
+            mSensingThreads = Helper::toUInt32(nextParam);
+            // Not mandatory
+        }
+
+        if(nextParam == "AutosaveTurns")
+        {
+            configFile >> nextParam;
+            mAutosaveTurns = Helper::toUInt32(nextParam);
+            // Not mandatory
+        }
+
         if(nextParam == "CreatureDeathCounter")
         {
             configFile >> nextParam;
@@ -917,6 +970,54 @@ bool ConfigManager::loadFactions(const std::string& fileName)
     return true;
 }
 
+template<typename ParamType>
+bool ConfigManager::loadConfigParams(std::stringstream& defFile, const std::string& endTag, uint32_t nbParams,
+    std::string (*paramToString)(ParamType), std::vector<ConfigParamValue>& values)
+{
+    std::map<std::string, uint32_t> paramIndexes;
+    for(uint32_t i = 0; i < nbParams; ++i)
+        paramIndexes[paramToString(static_cast<ParamType>(i))] = i;
+
+    values.assign(nbParams, ConfigParamValue());
+    boost::dynamic_bitset<> paramsOk(nbParams);
+    std::string nextParam;
+    while(defFile.good())
+    {
+        if(!(defFile >> nextParam))
+            break;
+
+        if (nextParam == endTag)
+            break;
+
+        auto it = paramIndexes.find(nextParam);
+        if(it == paramIndexes.end())
+        {
+            OD_LOG_ERR("Unknown parameter param=" + nextParam);
+            return false;
+        }
+
+        // We parse the value in every type now so that the getters do not have to
+        ConfigParamValue& value = values[it->second];
+        defFile >> value.mString;
+        value.mUInt32 = Helper::toUInt32(value.mString);
+        value.mInt32 = Helper::toInt(value.mString);
+        value.mDouble = Helper::toDouble(value.mString);
+        paramsOk.set(it->second);
+    }
+
+    if(!paramsOk.all())
+    {
+        for(uint32_t i = 0; i < nbParams; ++i)
+        {
+            if(!paramsOk.test(i))
+                OD_LOG_ERR("Missing parameter param=" + paramToString(static_cast<ParamType>(i)));
+        }
+        return false;
+    }
+
+    return true;
+}
+
 bool ConfigManager::loadRooms(const std::string& fileName)
 {
     OD_LOG_INF("Load Rooms file: " + fileName);
@@ -936,18 +1037,8 @@ bool ConfigManager::loadRooms(const std::string& fileName)
         return false;
     }
 
-    while(defFile.good())
-    {
-        if(!(defFile >> nextParam))
-            break;
-
-        if (nextParam == "[/Rooms]")
-            break;
-
-        defFile >> mRoomsConfig[nextParam];
-    }
-
-    return true;
+    return loadConfigParams(defFile, "[/Rooms]", static_cast<uint32_t>(RoomConfigParam::nbRoomConfigParams),
+        &ConfigManager::roomConfigParamToString, mRoomsConfig);
 }
 
 bool ConfigManager::loadTraps(const std::string& fileName)
@@ -969,18 +1060,8 @@ bool ConfigManager::loadTraps(const std::string& fileName)
         return false;
     }
 
-    while(defFile.good())
-    {
-        if(!(defFile >> nextParam))
-            break;
-
-        if (nextParam == "[/Traps]")
-            break;
-
-        defFile >> mTrapsConfig[nextParam];
-    }
-
-    return true;
+    return loadConfigParams(defFile, "[/Traps]", static_cast<uint32_t>(TrapConfigParam::nbTrapConfigParams),
+        &ConfigManager::trapConfigParamToString, mTrapsConfig);
 }
 
 bool ConfigManager::loadSpellConfig(const std::string& fileName)
@@ -1002,18 +1083,8 @@ bool ConfigManager::loadSpellConfig(const std::string& fileName)
         return false;
     }
 
-    while(defFile.good())
-    {
-        if(!(defFile >> nextParam))
-            break;
-
-        if (nextParam == "[/Spells]")
-            break;
-
-        defFile >> mSpellConfig[nextParam];
-    }
-
-    return true;
+    return loadConfigParams(defFile, "[/Spells]", static_cast<uint32_t>(SpellConfigParam::nbSpellConfigParams),
+        &ConfigManager::spellConfigParamToString, mSpellConfig);
 }
 
 bool ConfigManager::loadSkills(const std::string& fileName)
@@ -1372,148 +1443,264 @@ const std::string ConfigManager::getUserValue(Config::Ctg category,
     return it->second;
 }
 
-const std::string& ConfigManager::getRoomConfigString(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getRoomConfigUInt32(const std::string& param) const
+std::string ConfigManager::roomConfigParamToString(RoomConfigParam param)
 {
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getRoomConfigInt32(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getRoomConfigDouble(const std::string& param) const
-{
-    auto it = mRoomsConfig.find(param);
-    if(it == mRoomsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
-const std::string& ConfigManager::getTrapConfigString(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getTrapConfigUInt32(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toUInt32(it->second);
-}
-
-int32_t ConfigManager::getTrapConfigInt32(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
-    }
-
-    return Helper::toInt(it->second);
-}
-
-double ConfigManager::getTrapConfigDouble(const std::string& param) const
-{
-    auto it = mTrapsConfig.find(param);
-    if(it == mTrapsConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
-    }
-
-    return Helper::toDouble(it->second);
-}
-
-const std::string& ConfigManager::getSpellConfigString(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return EMPTY_STRING;
-    }
-
-    return it->second;
-}
-
-uint32_t ConfigManager::getSpellConfigUInt32(const std::string& param) const
-{
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
+    switch(param)
+    {
+        case RoomConfigParam::hatcheryCostPerTile:
+            return "HatcheryCostPerTile";
+        case RoomConfigParam::hatcheryHungerPerChicken:
+            return "HatcheryHungerPerChicken";
+        case RoomConfigParam::hatcheryHpRecoveredPerChicken:
+            return "HatcheryHpRecoveredPerChicken";
+        case RoomConfigParam::hatcheryChickenSpawnRate:
+            return "HatcheryChickenSpawnRate";
+        case RoomConfigParam::hatcheryCooldownChickenMin:
+            return "HatcheryCooldownChickenMin";
+        case RoomConfigParam::hatcheryCooldownChickenMax:
+            return "HatcheryCooldownChickenMax";
+        case RoomConfigParam::trainHallCostPerTile:
+            return "TrainHallCostPerTile";
+        case RoomConfigParam::trainHallXpPerAttack:
+            return "TrainHallXpPerAttack";
+        case RoomConfigParam::trainHallWakefulnessPerAttack:
+            return "TrainHallWakefulnessPerAttack";
+        case RoomConfigParam::trainHallCooldownHitMin:
+            return "TrainHallCooldownHitMin";
+        case RoomConfigParam::trainHallCooldownHitMax:
+            return "TrainHallCooldownHitMax";
+        case RoomConfigParam::trainHallBonusWallActiveSpot:
+            return "TrainHallBonusWallActiveSpot";
+        case RoomConfigParam::trainHallMaxTrainingLevel:
+            return "TrainHallMaxTrainingLevel";
+        case RoomConfigParam::cryptCostPerTile:
+            return "CryptCostPerTile";
+        case RoomConfigParam::cryptRotNbTurns:
+            return "CryptRotNbTurns";
+        case RoomConfigParam::cryptBonusWallActiveSpot:
+            return "CryptBonusWallActiveSpot";
+        case RoomConfigParam::cryptPointsForSpawn:
+            return "CryptPointsForSpawn";
+        case RoomConfigParam::cryptSpawnClass:
+            return "CryptSpawnClass";
+        case RoomConfigParam::workshopCostPerTile:
+            return "WorkshopCostPerTile";
+        case RoomConfigParam::workshopPointsPerWork:
+            return "WorkshopPointsPerWork";
+        case RoomConfigParam::workshopWakefulnessPerWork:
+            return "WorkshopWakefulnessPerWork";
+        case RoomConfigParam::workshopCooldownWorkMin:
+            return "WorkshopCooldownWorkMin";
+        case RoomConfigParam::workshopCooldownWorkMax:
+            return "WorkshopCooldownWorkMax";
+        case RoomConfigParam::treasuryCostPerTile:
+            return "TreasuryCostPerTile";
+        case RoomConfigParam::dormitoryCostPerTile:
+            return "DormitoryCostPerTile";
+        case RoomConfigParam::libraryCostPerTile:
+            return "LibraryCostPerTile";
+        case RoomConfigParam::libraryPointsPerWork:
+            return "LibraryPointsPerWork";
+        case RoomConfigParam::libraryWakefulnessPerWork:
+            return "LibraryWakefulnessPerWork";
+        case RoomConfigParam::libraryCooldownWorkMin:
+            return "LibraryCooldownWorkMin";
+        case RoomConfigParam::libraryCooldownWorkMax:
+            return "LibraryCooldownWorkMax";
+        case RoomConfigParam::librarySkillPointsBook:
+            return "LibrarySkillPointsBook";
+        case RoomConfigParam::portalCooldownSpawnMin:
+            return "PortalCooldownSpawnMin";
+        case RoomConfigParam::portalCooldownSpawnMax:
+            return "PortalCooldownSpawnMax";
+        case RoomConfigParam::prisonCostPerTile:
+            return "PrisonCostPerTile";
+        case RoomConfigParam::prisonDamagePerTurn:
+            return "PrisonDamagePerTurn";
+        case RoomConfigParam::prisonSpawnClass:
+            return "PrisonSpawnClass";
+        case RoomConfigParam::woodenBridgeCostPerTile:
+            return "WoodenBridgeCostPerTile";
+        case RoomConfigParam::stoneBridgeCostPerTile:
+            return "StoneBridgeCostPerTile";
+        case RoomConfigParam::arenaCostPerTile:
+            return "ArenaCostPerTile";
+        case RoomConfigParam::arenaMaxTrainingLevel:
+            return "ArenaMaxTrainingLevel";
+        case RoomConfigParam::casinoCostPerTile:
+            return "CasinoCostPerTile";
+        case RoomConfigParam::casinoWakefulnessPerWork:
+            return "CasinoWakefulnessPerWork";
+        case RoomConfigParam::casinoCooldownWorkMin:
+            return "CasinoCooldownWorkMin";
+        case RoomConfigParam::casinoCooldownWorkMax:
+            return "CasinoCooldownWorkMax";
+        case RoomConfigParam::casinoBet:
+            return "CasinoBet";
+        case RoomConfigParam::casinoFee:
+            return "CasinoFee";
+        case RoomConfigParam::tortureCostPerTile:
+            return "TortureCostPerTile";
+        case RoomConfigParam::tortureRallyPercent:
+            return "TortureRallyPercent";
+        case RoomConfigParam::tortureSessionLengthMin:
+            return "TortureSessionLengthMin";
+        case RoomConfigParam::tortureSessionLengthMax:
+            return "TortureSessionLengthMax";
+        case RoomConfigParam::tortureDamagePerTurn:
+            return "TortureDamagePerTurn";
+        default:
+            break;
     }
-
-    return Helper::toUInt32(it->second);
+    return "unknown param=" + Helper::toString(static_cast<uint32_t>(param));
 }
 
-int32_t ConfigManager::getSpellConfigInt32(const std::string& param) const
+std::string ConfigManager::trapConfigParamToString(TrapConfigParam param)
 {
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0;
+    switch(param)
+    {
+        case TrapConfigParam::boulderCostPerTile:
+            return "BoulderCostPerTile";
+        case TrapConfigParam::boulderWorkshopPointsPerTile:
+            return "BoulderWorkshopPointsPerTile";
+        case TrapConfigParam::boulderReloadTurns:
+            return "BoulderReloadTurns";
+        case TrapConfigParam::boulderSpeed:
+            return "BoulderSpeed";
+        case TrapConfigParam::boulderDamagePerHitMin:
+            return "BoulderDamagePerHitMin";
+        case TrapConfigParam::boulderDamagePerHitMax:
+            return "BoulderDamagePerHitMax";
+        case TrapConfigParam::boulderNbShootsBeforeDeactivation:
+            return "BoulderNbShootsBeforeDeactivation";
+        case TrapConfigParam::cannonCostPerTile:
+            return "CannonCostPerTile";
+        case TrapConfigParam::cannonPhyDef:
+            return "CannonPhyDef";
+        case TrapConfigParam::cannonMagDef:
+            return "CannonMagDef";
+        case TrapConfigParam::cannonEleDef:
+            return "CannonEleDef";
+        case TrapConfigParam::cannonWorkshopPointsPerTile:
+            return "CannonWorkshopPointsPerTile";
+        case TrapConfigParam::cannonRange:
+            return "CannonRange";
+        case TrapConfigParam::cannonSpeed:
+            return "CannonSpeed";
+        case TrapConfigParam::cannonReloadTurns:
+            return "CannonReloadTurns";
+        case TrapConfigParam::cannonDamagePerHitMin:
+            return "CannonDamagePerHitMin";
+        case TrapConfigParam::cannonDamagePerHitMax:
+            return "CannonDamagePerHitMax";
+        case TrapConfigParam::cannonNbShootsBeforeDeactivation:
+            return "CannonNbShootsBeforeDeactivation";
+        case TrapConfigParam::spikeCostPerTile:
+            return "SpikeCostPerTile";
+        case TrapConfigParam::spikeWorkshopPointsPerTile:
+            return "SpikeWorkshopPointsPerTile";
+        case TrapConfigParam::spikeReloadTurns:
+            return "SpikeReloadTurns";
+        case TrapConfigParam::spikeDamagePerHitMin:
+            return "SpikeDamagePerHitMin";
+        case TrapConfigParam::spikeDamagePerHitMax:
+            return "SpikeDamagePerHitMax";
+        case TrapConfigParam::spikeNbShootsBeforeDeactivation:
+            return "SpikeNbShootsBeforeDeactivation";
+        case TrapConfigParam::woodenDoorCostPerTile:
+            return "WoodenDoorCostPerTile";
+        case TrapConfigParam::woodenDoorPointsPerTile:
+            return "WoodenDoorPointsPerTile";
+        default:
+            break;
     }
-
-    return Helper::toInt(it->second);
+    return "unknown param=" + Helper::toString(static_cast<uint32_t>(param));
 }
 
-double ConfigManager::getSpellConfigDouble(const std::string& param) const
+std::string ConfigManager::spellConfigParamToString(SpellConfigParam param)
 {
-    auto it = mSpellConfig.find(param);
-    if(it == mSpellConfig.end())
-    {
-        OD_LOG_ERR("Unknown parameter param=" + param);
-        return 0.0;
+    switch(param)
+    {
+        case SpellConfigParam::summonWorkerNbFree:
+            return "SummonWorkerNbFree";
+        case SpellConfigParam::summonWorkerBasePrice:
+            return "SummonWorkerBasePrice";
+        case SpellConfigParam::summonWorkerCooldown:
+            return "SummonWorkerCooldown";
+        case SpellConfigParam::callToWarPrice:
+            return "CallToWarPrice";
+        case SpellConfigParam::callToWarNbTurnsMax:
+            return "CallToWarNbTurnsMax";
+        case SpellConfigParam::callToWarCooldown:
+            return "CallToWarCooldown";
+        case SpellConfigParam::creatureExplosionPrice:
+            return "CreatureExplosionPrice";
+        case SpellConfigParam::creatureExplosionDuration:
+            return "CreatureExplosionDuration";
+        case SpellConfigParam::creatureExplosionValue:
+            return "CreatureExplosionValue";
+        case SpellConfigParam::creatureExplosionCooldown:
+            return "CreatureExplosionCooldown";
+        case SpellConfigParam::creatureHastePrice:
+            return "CreatureHastePrice";
+        case SpellConfigParam::creatureHasteDuration:
+            return "CreatureHasteDuration";
+        case SpellConfigParam::creatureHasteValue:
+            return "CreatureHasteValue";
+        case SpellConfigParam::creatureHasteCooldown:
+            return "CreatureHasteCooldown";
+        case SpellConfigParam::creatureDefensePrice:
+            return "CreatureDefensePrice";
+        case SpellConfigParam::creatureDefenseDuration:
+            return "CreatureDefenseDuration";
+        case SpellConfigParam::creatureDefenseValue:
+            return "CreatureDefenseValue";
+        case SpellConfigParam::creatureDefenseCooldown:
+            return "CreatureDefenseCooldown";
+        case SpellConfigParam::creatureHealPrice:
+            return "CreatureHealPrice";
+        case SpellConfigParam::creatureHealDuration:
+            return "CreatureHealDuration";
+        case SpellConfigParam::creatureHealValue:
+            return "CreatureHealValue";
+        case SpellConfigParam::creatureHealCooldown:
+            return "CreatureHealCooldown";
+        case SpellConfigParam::creatureSlowPrice:
+            return "CreatureSlowPrice";
+        case SpellConfigParam::creatureSlowDuration:
+            return "CreatureSlowDuration";
+        case SpellConfigParam::creatureSlowValue:
+            return "CreatureSlowValue";
+        case SpellConfigParam::creatureSlowCooldown:
+            return "CreatureSlowCooldown";
+        case SpellConfigParam::creatureStrengthPrice:
+            return "CreatureStrengthPrice";
+        case SpellConfigParam::creatureStrengthDuration:
+            return "CreatureStrengthDuration";
+        case SpellConfigParam::creatureStrengthValue:
+            return "CreatureStrengthValue";
+        case SpellConfigParam::creatureStrengthCooldown:
+            return "CreatureStrengthCooldown";
+        case SpellConfigParam::creatureWeakPrice:
+            return "CreatureWeakPrice";
+        case SpellConfigParam::creatureWeakDuration:
+            return "CreatureWeakDuration";
+        case SpellConfigParam::creatureWeakValue:
+            return "CreatureWeakValue";
+        case SpellConfigParam::creatureWeakCooldown:
+            return "CreatureWeakCooldown";
+        case SpellConfigParam::eyeEvilPrice:
+            return "EyeEvilPrice";
+        case SpellConfigParam::eyeEvilRadiusTiles:
+            return "EyeEvilRadiusTiles";
+        case SpellConfigParam::eyeEvilNbTurns:
+            return "EyeEvilNbTurns";
+        case SpellConfigParam::eyeEvilCooldown:
+            return "EyeEvilCooldown";
+        default:
+            break;
     }
-
-    return Helper::toDouble(it->second);
+    return "unknown param=" + Helper::toString(static_cast<uint32_t>(param));
 }
 
 int32_t ConfigManager::getSkillPoints(const std::string& res) const
@@ -32,6 +32,139 @@ class TileSetValue;
 
 enum class TileVisual;
 
+//! \brief Parameters of the rooms configuration file (see config/rooms.cfg)
+enum class RoomConfigParam
+{
+    hatcheryCostPerTile,
+    hatcheryHungerPerChicken,
+    hatcheryHpRecoveredPerChicken,
+    hatcheryChickenSpawnRate,
+    hatcheryCooldownChickenMin,
+    hatcheryCooldownChickenMax,
+    trainHallCostPerTile,
+    trainHallXpPerAttack,
+    trainHallWakefulnessPerAttack,
+    trainHallCooldownHitMin,
+    trainHallCooldownHitMax,
+    trainHallBonusWallActiveSpot,
+    trainHallMaxTrainingLevel,
+    cryptCostPerTile,
+    cryptRotNbTurns,
+    cryptBonusWallActiveSpot,
+    cryptPointsForSpawn,
+    cryptSpawnClass,
+    workshopCostPerTile,
+    workshopPointsPerWork,
+    workshopWakefulnessPerWork,
+    workshopCooldownWorkMin,
+    workshopCooldownWorkMax,
+    treasuryCostPerTile,
+    dormitoryCostPerTile,
+    libraryCostPerTile,
+    libraryPointsPerWork,
+    libraryWakefulnessPerWork,
+    libraryCooldownWorkMin,
+    libraryCooldownWorkMax,
+    librarySkillPointsBook,
+    portalCooldownSpawnMin,
+    portalCooldownSpawnMax,
+    prisonCostPerTile,
+    prisonDamagePerTurn,
+    prisonSpawnClass,
+    woodenBridgeCostPerTile,
+    stoneBridgeCostPerTile,
+    arenaCostPerTile,
+    arenaMaxTrainingLevel,
+    casinoCostPerTile,
+    casinoWakefulnessPerWork,
+    casinoCooldownWorkMin,
+    casinoCooldownWorkMax,
+    casinoBet,
+    casinoFee,
+    tortureCostPerTile,
+    tortureRallyPercent,
+    tortureSessionLengthMin,
+    tortureSessionLengthMax,
+    tortureDamagePerTurn,
+    nbRoomConfigParams    // Must be the last in this enum
+};
+
+//! \brief Parameters of the traps configuration file (see config/traps.cfg)
+enum class TrapConfigParam
+{
+    boulderCostPerTile,
+    boulderWorkshopPointsPerTile,
+    boulderReloadTurns,
+    boulderSpeed,
+    boulderDamagePerHitMin,
+    boulderDamagePerHitMax,
+    boulderNbShootsBeforeDeactivation,
+    cannonCostPerTile,
+    cannonPhyDef,
+    cannonMagDef,
+    cannonEleDef,
+    cannonWorkshopPointsPerTile,
+    cannonRange,
+    cannonSpeed,
+    cannonReloadTurns,
+    cannonDamagePerHitMin,
+    cannonDamagePerHitMax,
+    cannonNbShootsBeforeDeactivation,
+    spikeCostPerTile,
+    spikeWorkshopPointsPerTile,
+    spikeReloadTurns,
+    spikeDamagePerHitMin,
+    spikeDamagePerHitMax,
+    spikeNbShootsBeforeDeactivation,
+    woodenDoorCostPerTile,
+    woodenDoorPointsPerTile,
+    nbTrapConfigParams    // Must be the last in this enum
+};
+
+//! \brief Parameters of the spells configuration file (see config/spells.cfg)
+enum class SpellConfigParam
+{
+    summonWorkerNbFree,
+    summonWorkerBasePrice,
+    summonWorkerCooldown,
+    callToWarPrice,
+    callToWarNbTurnsMax,
+    callToWarCooldown,
+    creatureExplosionPrice,
+    creatureExplosionDuration,
+    creatureExplosionValue,
+    creatureExplosionCooldown,
+    creatureHastePrice,
+    creatureHasteDuration,
+    creatureHasteValue,
+    creatureHasteCooldown,
+    creatureDefensePrice,
+    creatureDefenseDuration,
+    creatureDefenseValue,
+    creatureDefenseCooldown,
+    creatureHealPrice,
+    creatureHealDuration,
+    creatureHealValue,
+    creatureHealCooldown,
+    creatureSlowPrice,
+    creatureSlowDuration,
+    creatureSlowValue,
+    creatureSlowCooldown,
+    creatureStrengthPrice,
+    creatureStrengthDuration,
+    creatureStrengthValue,
+    creatureStrengthCooldown,
+    creatureWeakPrice,
+    creatureWeakDuration,
+    creatureWeakValue,
+    creatureWeakCooldown,
+    eyeEvilPrice,
+    eyeEvilRadiusTiles,
+    eyeEvilNbTurns,
+    eyeEvilCooldown,
+    nbSpellConfigParams    // Must be the last in this enum
+};
+
 namespace Config
 {
 //! \brief Config options names
@@ -62,6 +195,7 @@ const std::string NICKNAME = "Nickname";
 const std::string KEEPERVOICE = "KeeperVoice";
 const std::string MINIMAP_TYPE = "MinimapType";
 const std::string LIGHT_FACTOR = "LightFactor";
+const std::string NETWORK_COMPRESSION = "NetworkCompression";
 }
 
 //! \brief This class is used to manage global configuration such as network configuration, global creature stats, ...
@@ -130,6 +264,23 @@ public:
     inline uint32_t getClientConnectionTimeout() const
     { return mClientConnectionTimeout; }
 
+    //! \brief Number of turns a client can be late on the server before the server waits for it
+    inline uint32_t getMaxClientTurnLag() const
+    { return mMaxClientTurnLag; }
+
+    //! \brief Number of threads used by the server for the creatures sensing. 0 means one per core
+    inline uint32_t getSensingThreads() const
+    { return mSensingThreads; }
+
+    //! \brief Overrides the number of sensing threads read from global.cfg (used by the simulation
+    //! to compare the sensing time with different numbers of threads)
+    inline void setSensingThreads(uint32_t sensingThreads)
+    { mSensingThreads = sensingThreads; }
+
+    //! \brief Number of turns between 2 autosaves of a game by the server. 0 means no autosave
+    inline uint32_t getAutosaveTurns() const
+    { return mAutosaveTurns; }
+
     inline uint32_t getBaseSpawnPoint() const
     { return mBaseSpawnPoint; }
 
@@ -174,23 +325,45 @@ public:
     inline const std::vector<std::string>& getFactions() const
     { return mFactions; }
 
-    //! Rooms configuration
-    const std::string& getRoomConfigString(const std::string& param) const;
-    uint32_t getRoomConfigUInt32(const std::string& param) const;
-    int32_t getRoomConfigInt32(const std::string& param) const;
-    double getRoomConfigDouble(const std::string& param) const;
+    //! Rooms configuration. The parameters are parsed when the configuration is loaded
+    inline const std::string& getRoomConfigString(RoomConfigParam param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mString; }
+    inline uint32_t getRoomConfigUInt32(RoomConfigParam param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mUInt32; }
+    inline int32_t getRoomConfigInt32(RoomConfigParam param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mInt32; }
+    inline double getRoomConfigDouble(RoomConfigParam param) const
+    { return mRoomsConfig[static_cast<uint32_t>(param)].mDouble; }
 
     //! Traps configuration
-    const std::string& getTrapConfigString(const std::string& param) const;
-    uint32_t getTrapConfigUInt32(const std::string& param) const;
-    int32_t getTrapConfigInt32(const std::string& param) const;
-    double getTrapConfigDouble(const std::string& param) const;
+    inline const std::string& getTrapConfigString(TrapConfigParam param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mString; }
+    inline uint32_t getTrapConfigUInt32(TrapConfigParam param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mUInt32; }
+    inline int32_t getTrapConfigInt32(TrapConfigParam param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mInt32; }
+    inline double getTrapConfigDouble(TrapConfigParam param) const
+    { return mTrapsConfig[static_cast<uint32_t>(param)].mDouble; }
 
     //! Spells configuration
-    const std::string& getSpellConfigString(const std::string& param) const;
-    uint32_t getSpellConfigUInt32(const std::string& param) const;
-    int32_t getSpellConfigInt32(const std::string& param) const;
-    double getSpellConfigDouble(const std::string& param) const;
+    inline const std::string& getSpellConfigString(SpellConfigParam param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mString; }
+    inline uint32_t getSpellConfigUInt32(SpellConfigParam param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mUInt32; }
+    inline int32_t getSpellConfigInt32(SpellConfigParam param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mInt32; }
+    inline double getSpellConfigDouble(SpellConfigParam param) const
+    { return mSpellConfig[static_cast<uint32_t>(param)].mDouble; }
+
+    //! \brief Names of the parameters in the rooms/traps/spells configuration files
+    static std::string roomConfigParamToString(RoomConfigParam param);
+    static std::string trapConfigParamToString(TrapConfigParam param);
+    static std::string spellConfigParamToString(SpellConfigParam param);
+
+    //! \brief Dictionary used to compress the network packets. Made of the names often sent
+    //! (creature classes, meshes, weapons) as they are serialized in a packet
+    inline const std::string& getPacketDictionary() const
+    { return mPacketDictionary; }
 
     int32_t getSkillPoints(const std::string& res) const;
 
@@ -262,8 +435,24 @@ private:
     bool loadTilesets(const std::string& fileName);
     bool loadTilesetValues(std::istream& defFile, TileVisual tileVisual, std::vector<TileSetValue>& tileValues);
 
+    //! \brief Value of a rooms/traps/spells configuration parameter parsed in every supported type
+    struct ConfigParamValue
+    {
+        std::string mString;
+        uint32_t mUInt32 = 0;
+        int32_t mInt32 = 0;
+        double mDouble = 0.0;
+    };
+
+    //! \brief Reads the parameters in defFile until endTag and parses them in values (indexed by
+    //! ParamType). Returns false if an unknown parameter is found or if a parameter is missing
+    template<typename ParamType>
+    bool loadConfigParams(std::stringstream& defFile, const std::string& endTag, uint32_t nbParams,
+        std::string (*paramToString)(ParamType), std::vector<ConfigParamValue>& values);
+
     //! \brief Loads the user configuration values, and use default ones if it cannot do it.
     void loadUserConfig(const std::string& fileName);
+    void buildPacketDictionary();
 
     void loadKeeperVoices(const std::string& soundPath);
 
@@ -274,6 +463,8 @@ private:
                                     bool triggerError = true) const;
 
     std::map<std::string, Ogre::ColourValue> mSeatColors;
+    std::string mPacketDictionary;
+
     std::map<std::string, CreatureDefinition*> mCreatureDefs;
     std::vector<const Weapon*> mWeapons;
     std::string mFilenameCreatureDefinition;
@@ -288,6 +479,9 @@ private:
     std::string mFilenameUserCfg;
     uint32_t mNetworkPort;
     uint32_t mClientConnectionTimeout;
+    uint32_t mMaxClientTurnLag;
+    uint32_t mSensingThreads;
+    uint32_t mAutosaveTurns;
     uint32_t mBaseSpawnPoint;
     uint32_t mCreatureDeathCounter;
     uint32_t mMaxCreaturesPerSeatAbsolute;
@@ -317,9 +511,9 @@ private:
     std::map<const std::string, std::string> mFactionDefaultWorkerClass;
 
     std::vector<std::string> mFactions;
-    std::map<const std::string, std::string> mRoomsConfig;
-    std::map<const std::string, std::string> mTrapsConfig;
-    std::map<const std::string, std::string> mSpellConfig;
+    std::vector<ConfigParamValue> mRoomsConfig;
+    std::vector<ConfigParamValue> mTrapsConfig;
+    std::vector<ConfigParamValue> mSpellConfig;
     std::map<const std::string, int32_t> mSkillPoints;
 
     //! \brief Default definition for the editor. At map loading, it will spawn a creature from
@@ -0,0 +1,97 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/FrameTimeStats.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+const uint32_t FrameTimeStats::NB_FRAMES_HISTORY;
+
+FrameTimeStats::FrameTimeStats() :
+    mFrameTimes(NB_FRAMES_HISTORY, 0),
+    mNetworkTimes(NB_FRAMES_HISTORY, 0),
+    mNbFrames(0),
+    mNextFrameIndex(0),
+    mNbFramesSinceReport(0)
+{
+}
+
+bool FrameTimeStats::addFrame(uint64_t frameTime, uint64_t networkTime)
+{
+    mFrameTimes[mNextFrameIndex] = frameTime;
+    mNetworkTimes[mNextFrameIndex] = networkTime;
+    mNextFrameIndex = (mNextFrameIndex + 1) % NB_FRAMES_HISTORY;
+    mNbFrames = std::min(mNbFrames + 1, NB_FRAMES_HISTORY);
+
+    ++mNbFramesSinceReport;
+    if(mNbFramesSinceReport < NB_FRAMES_HISTORY)
+        return false;
+
+    mNbFramesSinceReport = 0;
+    return true;
+}
+
+void FrameTimeStats::reset()
+{
+    mNbFrames = 0;
+    mNextFrameIndex = 0;
+    mNbFramesSinceReport = 0;
+}
+
+FrameTimeStats::Percentiles FrameTimeStats::computePercentiles(const std::vector<uint64_t>& times) const
+{
+    Percentiles percentiles;
+    if(mNbFrames == 0)
+        return percentiles;
+
+    // Until the window is full, the frames are at the beginning of the vector
+    std::vector<uint64_t> sorted(times.begin(), times.begin() + mNbFrames);
+    std::sort(sorted.begin(), sorted.end());
+    uint64_t total = 0;
+    for(uint64_t time : sorted)
+        total += time;
+
+    percentiles.mAverage = total / sorted.size();
+    percentiles.mMedian = sorted[sorted.size() / 2];
+    percentiles.mPercentile95 = sorted[(sorted.size() * 95) / 100];
+    percentiles.mPercentile99 = sorted[(sorted.size() * 99) / 100];
+    percentiles.mMax = sorted.back();
+    return percentiles;
+}
+
+std::string FrameTimeStats::getStatsText() const
+{
+    std::stringstream ss;
+    ss << "Frame times over the last " << mNbFrames << " frames (times in us)";
+    ss << "\n" << std::left << std::setw(12) << "" << std::right
+        << std::setw(9) << "avg" << std::setw(9) << "p50" << std::setw(9) << "p95"
+        << std::setw(9) << "p99" << std::setw(9) << "max";
+    const std::pair<const char*, Percentiles> rows[] = {
+        { "frame", computeFrameTimes() },
+        { "network", computeNetworkTimes() }
+    };
+    for(const std::pair<const char*, Percentiles>& row : rows)
+    {
+        ss << "\n" << std::left << std::setw(12) << row.first << std::right
+            << std::setw(9) << row.second.mAverage << std::setw(9) << row.second.mMedian
+            << std::setw(9) << row.second.mPercentile95 << std::setw(9) << row.second.mPercentile99
+            << std::setw(9) << row.second.mMax;
+    }
+    return ss.str();
+}
@@ -0,0 +1,79 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMETIMESTATS_H
+#define FRAMETIMESTATS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*! \brief Rolling window of the frame times of the render thread.
+ *
+ * For each frame, the time since the previous one and the time spent processing the
+ * network messages are kept for the last NB_FRAMES_HISTORY frames. The percentiles are
+ * computed from this window. It is only used from the render thread so it is not locked.
+ */
+class FrameTimeStats
+{
+public:
+    //! \brief Number of frames used to compute the statistics
+    static const uint32_t NB_FRAMES_HISTORY = 1024;
+
+    //! \brief Percentiles of a time over the rolling window (in microseconds)
+    struct Percentiles
+    {
+        uint64_t mAverage = 0;
+        uint64_t mMedian = 0;
+        uint64_t mPercentile95 = 0;
+        uint64_t mPercentile99 = 0;
+        uint64_t mMax = 0;
+    };
+
+    FrameTimeStats();
+
+    //! \brief Adds a frame to the rolling window. Returns true each time NB_FRAMES_HISTORY
+    //! frames were added since the last time it did (to log the statistics periodically)
+    bool addFrame(uint64_t frameTime, uint64_t networkTime);
+
+    //! \brief Clears the rolling window
+    void reset();
+
+    inline uint32_t getNbFrames() const
+    { return mNbFrames; }
+
+    inline Percentiles computeFrameTimes() const
+    { return computePercentiles(mFrameTimes); }
+
+    inline Percentiles computeNetworkTimes() const
+    { return computePercentiles(mNetworkTimes); }
+
+    //! \brief Table with the frame and network time percentiles
+    std::string getStatsText() const;
+
+private:
+    Percentiles computePercentiles(const std::vector<uint64_t>& times) const;
+
+    std::vector<uint64_t> mFrameTimes;
+    std::vector<uint64_t> mNetworkTimes;
+    //! \brief Number of frames in the rolling window and index where the next one will be saved
+    uint32_t mNbFrames;
+    uint32_t mNextFrameIndex;
+    uint32_t mNbFramesSinceReport;
+};
+
+#endif // FRAMETIMESTATS_H
@@ -0,0 +1,142 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/MappedFile.h"
+
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+    mData(nullptr),
+    mSize(0),
+    mIsMapped(false)
+#ifdef _WIN32
+    ,
+    mFileHandle(nullptr),
+    mMappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& fileName)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size;
+        if(GetFileSizeEx(file, &size) && (size.QuadPart > 0))
+        {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(mapping != nullptr)
+            {
+                void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if(data != nullptr)
+                {
+                    mData = static_cast<const char*>(data);
+                    mSize = static_cast<std::size_t>(size.QuadPart);
+                    mIsMapped = true;
+                    mFileHandle = file;
+                    mMappingHandle = mapping;
+                    return true;
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if(fd >= 0)
+    {
+        struct stat fileStat;
+        if((fstat(fd, &fileStat) == 0) && (fileStat.st_size > 0))
+        {
+            void* data = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED)
+            {
+                // The mapping stays valid after the file is closed
+                ::close(fd);
+                mData = static_cast<const char*>(data);
+                mSize = static_cast<std::size_t>(fileStat.st_size);
+                mIsMapped = true;
+                return true;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    // We could not map the file (or it is empty). We try to read it
+    std::ifstream file(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!file.good())
+        return false;
+
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    if(size < 0)
+        return false;
+
+    file.seekg(0, std::ios::beg);
+    mBuffer.resize(static_cast<std::size_t>(size));
+    if(!mBuffer.empty() && !file.read(mBuffer.data(), size))
+    {
+        mBuffer.clear();
+        return false;
+    }
+
+    mData = mBuffer.data();
+    mSize = mBuffer.size();
+    return true;
+}
+
+void MappedFile::close()
+{
+    if(mIsMapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(static_cast<HANDLE>(mMappingHandle));
+        CloseHandle(static_cast<HANDLE>(mFileHandle));
+        mMappingHandle = nullptr;
+        mFileHandle = nullptr;
+#else
+        munmap(const_cast<char*>(mData), mSize);
+#endif
+    }
+
+    mBuffer.clear();
+    mData = nullptr;
+    mSize = 0;
+    mIsMapped = false;
+}
@@ -0,0 +1,63 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*! \brief Read only view of a whole file mapped in memory.
+ *
+ * The file is mapped with mmap (or MapViewOfFile on Windows) so that only the pages
+ * actually used are read from the disk. If mapping fails (unsupported filesystem for
+ * example), the file is read into memory instead.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //! \brief Maps the given file. Returns false if it could not be opened
+    bool open(const std::string& fileName);
+
+    void close();
+
+    inline const char* getData() const
+    { return mData; }
+
+    inline std::size_t getSize() const
+    { return mSize; }
+
+private:
+    const char* mData;
+    std::size_t mSize;
+    //! \brief True if mData is a mapping, false if it points to mBuffer
+    bool mIsMapped;
+    std::vector<char> mBuffer;
+#ifdef _WIN32
+    void* mFileHandle;
+    void* mMappingHandle;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -24,52 +24,111 @@
 #include "utils/Helper.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
-#include <ctime>
 
-unsigned long myRandomSeed;
-const unsigned long MAX = 32768;
+//! \brief Seed of the match. Every stream is derived from it
+static std::atomic<uint64_t> matchSeed(0);
 
-static unsigned long randgen()
+//! \brief Id of the next thread stream. 0 is used by the thread running the game
+static std::atomic<uint32_t> nextThreadStreamId(1);
+
+//! \brief Default stream of the thread
+static thread_local RandomStream threadStream;
+
+//! \brief Stream used by the thread (set by StreamScope). If nullptr, threadStream is used
+static thread_local RandomStream* currentStream = nullptr;
+
+static RandomStream& getCurrentStream()
 {
-    myRandomSeed = myRandomSeed * 1103515245 + 12345;
-    //TODO: What is the purpose of the cast?
-    unsigned long returnVal = static_cast<unsigned int>(myRandomSeed / 65536) % MAX;
+    if(currentStream != nullptr)
+        return *currentStream;
+
+    if(!threadStream.isSeeded())
+        threadStream = Random::createStream(RandomStreamContext::thread, nextThreadStreamId.fetch_add(1));
+
+    return threadStream;
+}
+
+RandomStream::RandomStream(uint64_t seed, RandomStreamContext context, uint32_t id) :
+    mKey(mix(mix(seed + GOLDEN_GAMMA) ^ ((static_cast<uint64_t>(context) << 32) | id))),
+    mCounter(0),
+    mIsSeeded(true)
+{
+}
+
+uint64_t RandomStream::nextBounded(uint64_t range)
+{
+    if(range == 0)
+        return next();
+
+    if(range <= 0xFFFFFFFFULL)
+    {
+        // Multiply-shift on 32 bits (Lemire). The division is only needed when the value may
+        // have to be rejected
+        uint32_t range32 = static_cast<uint32_t>(range);
+        uint64_t product = (next() >> 32) * range32;
+        if(static_cast<uint32_t>(product) < range32)
+        {
+            uint32_t threshold = (0 - range32) % range32;
+            while(static_cast<uint32_t>(product) < threshold)
+                product = (next() >> 32) * range32;
+        }
+        return product >> 32;
+    }
 
-    return returnVal;
+    // We reject the values that would make the lowest results more likely
+    uint64_t threshold = (0 - range) % range;
+    while(true)
+    {
+        uint64_t value = next();
+        if(value >= threshold)
+            return value % range;
+    }
 }
 
-//! \brief uniformly distributed number [0;1)
-static double uniform()
+namespace Random
+{
+
+void initialize()
 {
-    return randgen() * 1.0 / static_cast<double>(MAX);
+    initialize(static_cast<unsigned long>(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
 }
 
-//! \brief uniformly distributed number [lo;hi)
-static double uniform(double lo, double hi)
+void initialize(unsigned long seed)
 {
-    return uniform() * (hi - lo) + lo;
+    matchSeed = seed;
+    resetThreadStream();
 }
 
-//! \brief random integer [lo;hi]
-static int randint(int lo, int hi)
+uint64_t getSeed()
 {
-    return static_cast<int>(uniform() * (hi - lo + 1) + lo);
+    return matchSeed;
 }
 
-//! \brief random unsigned integer [lo;hi]
-static unsigned int randuint(unsigned int lo, unsigned int hi)
+void resetThreadStream()
 {
-    return static_cast<unsigned int>(uniform() * (hi - lo + 1) + lo);
+    threadStream = createStream(RandomStreamContext::thread, 0);
 }
 
+RandomStream createStream(RandomStreamContext context, uint32_t id)
+{
+    return RandomStream(matchSeed, context, id);
+}
 
-namespace Random
+StreamScope::StreamScope(RandomStream& stream, RandomStreamContext context, uint32_t id) :
+    mPreviousStream(currentStream)
 {
+    if(!stream.isSeeded())
+        stream = createStream(context, id);
 
-void initialize()
+    currentStream = &stream;
+}
+
+StreamScope::~StreamScope()
 {
-    myRandomSeed = static_cast<unsigned long>(std::time(0));
+    currentStream = mPreviousStream;
 }
 
 double Double(double min, double max)
@@ -79,7 +138,7 @@ double Double(double min, double max)
         std::swap(min, max);
     }
 
-    return uniform(min, max);
+    return getCurrentStream().nextDouble() * (max - min) + min;
 }
 
 int Int(int min, int max)
@@ -89,7 +148,8 @@ int Int(int min, int max)
         std::swap(min, max);
     }
 
-    return randint(min, max);
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - static_cast<int64_t>(min)) + 1;
+    return static_cast<int>(static_cast<int64_t>(min) + static_cast<int64_t>(getCurrentStream().nextBounded(range)));
 }
 
 unsigned int Uint(unsigned int min, unsigned int max)
@@ -99,12 +159,17 @@ unsigned int Uint(unsigned int min, unsigned int max)
         std::swap(min, max);
     }
 
-    return randuint(min, max);
+    uint64_t range = static_cast<uint64_t>(max - min) + 1;
+    return min + static_cast<unsigned int>(getCurrentStream().nextBounded(range));
 }
 
 double gaussianRandomDouble()
 {
-    return std::sqrt(-2.0 * log(Double(0.0, 1.0))) * cos(2.0 * PI * Double(0.0, 1.0));
+    // 1 - u is in (0;1] so that log does not get 0
+    RandomStream& stream = getCurrentStream();
+    double u1 = 1.0 - stream.nextDouble();
+    double u2 = stream.nextDouble();
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * PI * u2);
 }
 
 } // namespace Random
@@ -23,11 +23,109 @@
 #ifndef RANDOM_H_
 #define RANDOM_H_
 
+#include <cstdint>
+
+//! \brief Kind of object owning a random stream. Together with the object id, it identifies the stream
+enum class RandomStreamContext
+{
+    thread,
+    entity,
+    ai
+};
+
+/*! \brief Counter based random number generator (SplitMix64). The n-th number of a stream only
+ * depends on the stream key and n so that streams can be created for any object without
+ * sharing a state between them.
+ */
+class RandomStream
+{
+public:
+    //! \brief Creates a stream that is not seeded yet (see Random::StreamScope)
+    constexpr RandomStream() :
+        mKey(0),
+        mCounter(0),
+        mIsSeeded(false)
+    {}
+
+    RandomStream(uint64_t seed, RandomStreamContext context, uint32_t id);
+
+    inline bool isSeeded() const
+    { return mIsSeeded; }
+
+    //! \brief Number of values generated by this stream
+    inline uint64_t getCounter() const
+    { return mCounter; }
+
+    //! \brief Returns the next 64 bits value of the stream
+    inline uint64_t next()
+    { return mix(mKey + (++mCounter) * GOLDEN_GAMMA); }
+
+    //! \brief Returns a uniformly distributed number in [0;1) with 53 random bits
+    inline double nextDouble()
+    { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    //! \brief Returns a uniformly distributed number in [0;range). If range is 0, returns a value
+    //! in the full 64 bits range
+    uint64_t nextBounded(uint64_t range);
+
+    //! \brief SplitMix64 finalizer
+    static inline uint64_t mix(uint64_t z)
+    {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+private:
+    uint64_t mKey;
+    uint64_t mCounter;
+    bool mIsSeeded;
+};
+
+/*! \brief Random numbers are taken from the stream of the current thread. By default, each thread
+ * uses its own stream. During the turn, the entities and the AIs are processed in a
+ * StreamScope using their own stream so that what they draw only depends on the match
+ * seed and on what they did before. That keeps the turns reproducible from the seed and
+ * the inputs whatever the order or the thread they are processed in.
+ */
 namespace Random
 {
-    //! \brief initializes the semaphore and seeds the generator
+    //! \brief seeds the generator with a time based match seed
     void initialize();
 
+    //! \brief seeds the generator with the given match seed to get reproducible sequences.
+    //! The stream of the calling thread is reset
+    void initialize(unsigned long seed);
+
+    //! \brief Returns the match seed
+    uint64_t getSeed();
+
+    //! \brief Resets the stream of the calling thread to the first thread stream of the match
+    //! seed. Should be called by the thread running the game
+    void resetThreadStream();
+
+    //! \brief Creates the stream of the given object from the match seed
+    RandomStream createStream(RandomStreamContext context, uint32_t id);
+
+    /*! \brief Makes the given stream the current one for the calling thread until the scope
+     *  is destroyed. If the stream is not seeded yet, it is created from the match seed,
+     *  the context and the id. Scopes can be nested.
+     */
+    class StreamScope
+    {
+    public:
+        StreamScope(RandomStream& stream, RandomStreamContext context, uint32_t id);
+        ~StreamScope();
+
+    private:
+        StreamScope(const StreamScope&) = delete;
+        StreamScope& operator=(const StreamScope&) = delete;
+
+        RandomStream* mPreviousStream;
+    };
+
     /*! \brief generate a random double
      *
      *  \param min, max One or both can be negative
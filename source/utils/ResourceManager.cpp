@@ -86,6 +86,10 @@ const std::string ResourceManager::RESOURCEGROUPSOUND = "Sound";
  */
 ResourceManager::ResourceManager(boost::program_options::variables_map& options) :
         mServerMode(false),
+        mSimulationMode(false),
+        mSimulationNbTurns(1000),
+        mSimulationSeed(0),
+        mSimulationSensingThreads(-1),
         mForcedNetworkPort(-1),
         mLogLevel(LogMessageLevel::NORMAL),
         mGameDataPath("./"),
@@ -434,6 +438,45 @@ void ResourceManager::setupUserDataFolders(boost::program_options::variables_map
         }
     }
 
+    // The simulation level is given by its path to allow any level file (official, custom or saved game)
+    itOption = options.find("simulate");
+    if(itOption != options.end())
+    {
+        mSimulationMode = true;
+        boost::filesystem::path level(itOption->second.as<std::string>());
+        if(!boost::filesystem::exists(level))
+        {
+            std::cerr << "Wanted level not found: " << level.string() <<  std::endl;
+            exit(1);
+        }
+        mSimulationLevel = level.string();
+
+        auto it2 = options.find("simulateturns");
+        if(it2 != options.end())
+            mSimulationNbTurns = it2->second.as<uint32_t>();
+
+        it2 = options.find("simulateseed");
+        if(it2 != options.end())
+            mSimulationSeed = it2->second.as<uint32_t>();
+
+        it2 = options.find("simulatethreads");
+        if(it2 != options.end())
+            mSimulationSensingThreads = static_cast<int32_t>(it2->second.as<uint32_t>());
+    }
+
+    itOption = options.find("convertlevel");
+    if(itOption != options.end())
+    {
+        auto it2 = options.find("convertlevelto");
+        if(it2 == options.end())
+        {
+            std::cerr << "convertlevel option needs convertlevelto to be set" << std::endl;
+            exit(1);
+        }
+        mConvertLevelInput = itOption->second.as<std::string>();
+        mConvertLevelOutput = it2->second.as<std::string>();
+    }
+
     itOption = options.find("port");
     if(itOption != options.end())
         mForcedNetworkPort = itOption->second.as<int32_t>();
@@ -602,6 +645,12 @@ void ResourceManager::buildCommandOptions(boost::program_options::options_descri
         ("mscreator", boost::program_options::value<std::string>(), "Sets the creator for this map to connect to the master server. server/servercustom/serversave option needs to be on")
         ("port", boost::program_options::value<int32_t>(), "Sets the port used. Note that the port is used for both single and multi player")
         ("loglevel", boost::program_options::value<int32_t>(), "Sets the log level (between 0=Trivial and 3=Critical)")
+        ("simulate", boost::program_options::value<std::string>(), "Runs the given level file without network nor rendering, every seat being played by a Keeper AI, and reports the turns timings")
+        ("simulateturns", boost::program_options::value<uint32_t>(), "Sets the number of turns computed by the simulate option (default 1000)")
+        ("simulateseed", boost::program_options::value<uint32_t>(), "Sets the random seed used by the simulate option (default 0)")
+        ("simulatethreads", boost::program_options::value<uint32_t>(), "Sets the number of threads computing the creatures sensing in the simulate option (default from global.cfg, 0 means one per core)")
+        ("convertlevel", boost::program_options::value<std::string>(), "Converts the given level file from the text format to the binary format or the other way around and exits")
+        ("convertlevelto", boost::program_options::value<std::string>(), "Sets the output file of the convertlevel option")
     ;
 }
 
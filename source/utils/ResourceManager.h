@@ -148,6 +148,31 @@ public:
     inline int32_t getForcedNetworkPort() const
     { return mForcedNetworkPort; }
 
+    inline bool isSimulationMode() const
+    { return mSimulationMode; }
+
+    inline const std::string& getSimulationLevel() const
+    { return mSimulationLevel; }
+
+    inline uint32_t getSimulationNbTurns() const
+    { return mSimulationNbTurns; }
+
+    inline uint32_t getSimulationSeed() const
+    { return mSimulationSeed; }
+
+    //! \brief Number of sensing threads used by the simulation. -1 if the one from global.cfg should be used
+    inline int32_t getSimulationSensingThreads() const
+    { return mSimulationSensingThreads; }
+
+    inline bool isLevelConversionMode() const
+    { return !mConvertLevelInput.empty(); }
+
+    inline const std::string& getConvertLevelInput() const
+    { return mConvertLevelInput; }
+
+    inline const std::string& getConvertLevelOutput() const
+    { return mConvertLevelOutput; }
+
     inline LogMessageLevel getLogLevel() const
     { return mLogLevel; }
 
@@ -157,6 +182,17 @@ private:
     std::string mServerModeLevel;
     std::string mServerModeCreator;
 
+    //! \brief used when the executable is launched in simulation mode
+    bool mSimulationMode;
+    std::string mSimulationLevel;
+    uint32_t mSimulationNbTurns;
+    uint32_t mSimulationSeed;
+    int32_t mSimulationSensingThreads;
+
+    //! \brief used when the executable is launched to convert a level between the text and binary formats
+    std::string mConvertLevelInput;
+    std::string mConvertLevelOutput;
+
     //! \brief used when the network port is forced
     int32_t mForcedNetworkPort;
 
@@ -0,0 +1,98 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCRATCHVECTOR_H
+#define SCRATCHVECTOR_H
+
+#include <memory>
+#include <vector>
+
+/*! \brief Temporary vector borrowed from a per thread pool.
+ *
+ * Functions computed at every turn often need temporary lists. Allocating a new std::vector
+ * each time makes a lot of allocations. A ScratchVector takes an empty vector from a pool
+ * when it is constructed and gives it back (cleared but with its capacity kept) when it is
+ * destroyed. After a few turns, the vectors are big enough and no more allocation is done.
+ * The pool is per thread so ScratchVectors can be used by code running in parallel.
+ *
+ * \code
+ * ScratchVector<Tile*> tiles;
+ * gameMap->circularRegion(x, y, radius, *tiles);
+ * \endcode
+ */
+template<typename T>
+class ScratchVector
+{
+public:
+    ScratchVector() :
+        mVector(acquire())
+    {}
+
+    ~ScratchVector()
+    {
+        release(std::move(mVector));
+    }
+
+    ScratchVector(const ScratchVector&) = delete;
+    ScratchVector& operator=(const ScratchVector&) = delete;
+
+    inline std::vector<T>& operator*()
+    { return *mVector; }
+
+    inline std::vector<T>* operator->()
+    { return mVector.get(); }
+
+    inline const std::vector<T>& operator*() const
+    { return *mVector; }
+
+    inline const std::vector<T>* operator->() const
+    { return mVector.get(); }
+
+private:
+    //! \brief Vectors bigger than that are freed instead of being kept in the pool
+    static const size_t MAX_KEPT_CAPACITY = 4096;
+
+    std::unique_ptr<std::vector<T>> mVector;
+
+    static std::vector<std::unique_ptr<std::vector<T>>>& getPool()
+    {
+        static thread_local std::vector<std::unique_ptr<std::vector<T>>> pool;
+        return pool;
+    }
+
+    static std::unique_ptr<std::vector<T>> acquire()
+    {
+        std::vector<std::unique_ptr<std::vector<T>>>& pool = getPool();
+        if(pool.empty())
+            return std::unique_ptr<std::vector<T>>(new std::vector<T>());
+
+        std::unique_ptr<std::vector<T>> vector = std::move(pool.back());
+        pool.pop_back();
+        return vector;
+    }
+
+    static void release(std::unique_ptr<std::vector<T>> vector)
+    {
+        if(vector->capacity() > MAX_KEPT_CAPACITY)
+            return;
+
+        vector->clear();
+        getPool().push_back(std::move(vector));
+    }
+};
+
+#endif // SCRATCHVECTOR_H
@@ -0,0 +1,99 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*! \brief Bounded lock-free queue for exactly 1 producer thread and 1 consumer thread.
+ *
+ * The slots are allocated once. The producer only writes mTail and the consumer only writes
+ * mHead so no lock is needed: the release store of an index publishes the slot it refers to
+ * and the acquire load on the other side makes it visible.
+ * One slot is always kept empty to tell a full queue from an empty one.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(std::size_t capacity) :
+        mSlots(capacity + 1),
+        mHead(0),
+        mTail(0)
+    {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    //! \brief Producer side. Moves the given value in the queue. Returns false (and
+    //! leaves value untouched) if the queue is full.
+    bool push(T& value)
+    {
+        std::size_t tail = mTail.load(std::memory_order_relaxed);
+        std::size_t next = increment(tail);
+        if(next == mHead.load(std::memory_order_acquire))
+            return false;
+
+        mSlots[tail] = std::move(value);
+        mTail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    //! \brief Consumer side. Moves the oldest value to the given one. Returns false
+    //! if the queue is empty.
+    bool pop(T& value)
+    {
+        std::size_t head = mHead.load(std::memory_order_relaxed);
+        if(head == mTail.load(std::memory_order_acquire))
+            return false;
+
+        value = std::move(mSlots[head]);
+        mHead.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+    //! \brief Can be called from the consumer only
+    bool empty() const
+    {
+        return mHead.load(std::memory_order_relaxed) == mTail.load(std::memory_order_acquire);
+    }
+
+    //! \brief Drops every pending value. Must not be called while the producer is running
+    void clear()
+    {
+        T value;
+        while(pop(value))
+            ;
+    }
+
+private:
+    std::size_t increment(std::size_t index) const
+    {
+        ++index;
+        return (index == mSlots.size()) ? 0 : index;
+    }
+
+    std::vector<T> mSlots;
+    std::atomic<std::size_t> mHead;
+    std::atomic<std::size_t> mTail;
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,134 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t nbThreads) :
+    mNbThreads(nbThreads),
+    mGeneration(0),
+    mNbWorkersBusy(0),
+    mStopping(false),
+    mFunc(nullptr)
+{
+    if(mNbThreads == 0)
+        mNbThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    mRanges.reset(new Range[mNbThreads]);
+    for(uint32_t i = 0; i < mNbThreads; ++i)
+    {
+        mRanges[i].mNext = 0;
+        mRanges[i].mEnd = 0;
+    }
+
+    // The calling thread uses the first range
+    for(uint32_t i = 1; i < mNbThreads; ++i)
+        mThreads.emplace_back(&ThreadPool::workerThread, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWorkAvailable.notify_all();
+    for(std::thread& thread : mThreads)
+        thread.join();
+}
+
+void ThreadPool::parallelFor(uint32_t nbItems, const std::function<void(uint32_t)>& func)
+{
+    if(nbItems == 0)
+        return;
+
+    // Not worth waking up the threads
+    if(mThreads.empty() || (nbItems == 1))
+    {
+        for(uint32_t i = 0; i < nbItems; ++i)
+            func(i);
+        return;
+    }
+
+    uint32_t begin = 0;
+    for(uint32_t i = 0; i < mNbThreads; ++i)
+    {
+        uint32_t end = static_cast<uint32_t>((static_cast<uint64_t>(nbItems) * (i + 1)) / mNbThreads);
+        mRanges[i].mNext.store(begin, std::memory_order_relaxed);
+        mRanges[i].mEnd = end;
+        begin = end;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFunc = &func;
+        mNbWorkersBusy = static_cast<uint32_t>(mThreads.size());
+        ++mGeneration;
+    }
+    mWorkAvailable.notify_all();
+
+    processItems(0);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWorkDone.wait(lock, [this] { return mNbWorkersBusy == 0; });
+    mFunc = nullptr;
+}
+
+void ThreadPool::workerThread(uint32_t rangeIndex)
+{
+    uint64_t generationDone = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkAvailable.wait(lock, [this, generationDone] { return mStopping || (mGeneration != generationDone); });
+            if(mStopping)
+                return;
+
+            generationDone = mGeneration;
+        }
+
+        processItems(rangeIndex);
+
+        bool isLastWorker;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mNbWorkersBusy;
+            isLastWorker = (mNbWorkersBusy == 0);
+        }
+        if(isLastWorker)
+            mWorkDone.notify_one();
+    }
+}
+
+void ThreadPool::processItems(uint32_t rangeIndex)
+{
+    const std::function<void(uint32_t)>& func = *mFunc;
+    for(uint32_t i = 0; i < mNbThreads; ++i)
+    {
+        Range& range = mRanges[(rangeIndex + i) % mNbThreads];
+        while(true)
+        {
+            uint32_t index = range.mNext.fetch_add(1, std::memory_order_relaxed);
+            if(index >= range.mEnd)
+                break;
+
+            func(index);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*! \brief Pool of worker threads used to run loops over independent items in parallel.
+ *
+ * parallelFor splits the items in one contiguous range per thread (the calling thread
+ * takes part). When a thread is done with its range, it steals the remaining items from
+ * the other ranges. Each item is processed exactly once, so as long as the function only
+ * writes data owned by its item, the result does not depend on the number of threads.
+ */
+class ThreadPool
+{
+public:
+    //! \brief Creates a pool with nbThreads threads, including the calling one. If nbThreads
+    //! is 0, one thread per hardware core is used
+    explicit ThreadPool(uint32_t nbThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //! \brief Number of threads working on parallelFor, including the calling one
+    inline uint32_t getNbThreads() const
+    { return mNbThreads; }
+
+    //! \brief Calls func(index) for every index in [0, nbItems) and returns when all
+    //! the calls are done. Must not be called from func
+    void parallelFor(uint32_t nbItems, const std::function<void(uint32_t)>& func);
+
+private:
+    //! \brief Items to process by one thread. Other threads steal from the same counter
+    struct Range
+    {
+        std::atomic<uint32_t> mNext;
+        uint32_t mEnd;
+    };
+
+    void workerThread(uint32_t rangeIndex);
+
+    //! \brief Processes the range of the given thread then steals from the others
+    void processItems(uint32_t rangeIndex);
+
+    uint32_t mNbThreads;
+    std::vector<std::thread> mThreads;
+    std::unique_ptr<Range[]> mRanges;
+
+    std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mWorkDone;
+    //! \brief Incremented each time parallelFor gives work to the threads
+    uint64_t mGeneration;
+    uint32_t mNbWorkersBusy;
+    bool mStopping;
+    const std::function<void(uint32_t)>* mFunc;
+};
+
+#endif // THREADPOOL_H
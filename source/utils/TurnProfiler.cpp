@@ -0,0 +1,406 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/TurnProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace
+{
+//! \brief A section of the profiler. The same name gives different nodes under different parents
+struct Node
+{
+    const char* mName;
+    uint32_t mParent;
+    uint32_t mDepth;
+    std::vector<uint32_t> mChildren;
+    //! \brief Time spent and calls during the current turn
+    uint64_t mTurnTime;
+    uint32_t mTurnCalls;
+    //! \brief Rolling window of the time spent and of the calls during the previous turns
+    std::vector<uint64_t> mTurnTimes;
+    std::vector<uint32_t> mTurnsCalls;
+};
+
+struct TraceEvent
+{
+    uint32_t mNode;
+    uint32_t mThread;
+    int64_t mStart;
+    int64_t mDuration;
+};
+
+//! \brief Nodes without parent are children of ROOT_NODE
+const uint32_t ROOT_NODE = 0;
+
+struct ProfilerData
+{
+    ProfilerData() :
+        mEpoch(std::chrono::steady_clock::now()),
+        mTurnRecorded(false),
+        mNbTurns(0),
+        mNextTurnIndex(0),
+        mNbTraceTurnsLeft(0)
+    {
+        Node root;
+        root.mName = "";
+        root.mParent = ROOT_NODE;
+        root.mDepth = 0;
+        root.mTurnTime = 0;
+        root.mTurnCalls = 0;
+        mNodes.push_back(root);
+    }
+
+    std::mutex mMutex;
+    std::chrono::steady_clock::time_point mEpoch;
+    std::vector<Node> mNodes;
+    //! \brief Set when a section ended since the last endTurn
+    bool mTurnRecorded;
+    //! \brief Number of turns in the rolling window and index where the next one will be saved
+    uint32_t mNbTurns;
+    uint32_t mNextTurnIndex;
+
+    std::string mTraceFilename;
+    uint32_t mNbTraceTurnsLeft;
+    std::vector<TraceEvent> mTraceEvents;
+};
+
+ProfilerData& getData()
+{
+    static ProfilerData data;
+    return data;
+}
+
+//! \brief Current section of the calling thread
+thread_local uint32_t currentNode = ROOT_NODE;
+
+//! \brief Small id of the calling thread for the traces
+uint32_t getThreadId()
+{
+    static std::atomic<uint32_t> nextThreadId(0);
+    static thread_local uint32_t threadId = nextThreadId.fetch_add(1);
+    return threadId;
+}
+
+int64_t getTime(const ProfilerData& data)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - data.mEpoch).count();
+}
+
+uint32_t findOrAddNode(ProfilerData& data, uint32_t parent, const char* name)
+{
+    for(uint32_t child : data.mNodes[parent].mChildren)
+    {
+        const char* childName = data.mNodes[child].mName;
+        if((childName == name) || (std::strcmp(childName, name) == 0))
+            return child;
+    }
+
+    Node node;
+    node.mName = name;
+    node.mParent = parent;
+    node.mDepth = (parent == ROOT_NODE) ? 0 : data.mNodes[parent].mDepth + 1;
+    node.mTurnTime = 0;
+    node.mTurnCalls = 0;
+    node.mTurnTimes.assign(TurnProfiler::NB_TURNS_HISTORY, 0);
+    node.mTurnsCalls.assign(TurnProfiler::NB_TURNS_HISTORY, 0);
+    uint32_t index = static_cast<uint32_t>(data.mNodes.size());
+    data.mNodes.push_back(node);
+    data.mNodes[parent].mChildren.push_back(index);
+    return index;
+}
+
+//! \brief Returns the turn times of the given node that are in the rolling window
+std::vector<uint64_t> getWindowTimes(const ProfilerData& data, const Node& node)
+{
+    return std::vector<uint64_t>(node.mTurnTimes.begin(), node.mTurnTimes.begin() + data.mNbTurns);
+}
+
+void computeNodeStats(const ProfilerData& data, uint32_t nodeIndex, std::vector<TurnProfiler::SectionStats>& stats)
+{
+    const Node& node = data.mNodes[nodeIndex];
+    TurnProfiler::SectionStats section;
+    section.mName = node.mName;
+    section.mDepth = node.mDepth;
+    if(data.mNbTurns > 0)
+    {
+        std::vector<uint64_t> times = getWindowTimes(data, node);
+        std::sort(times.begin(), times.end());
+        uint64_t total = 0;
+        for(uint64_t time : times)
+            total += time;
+
+        uint64_t nbCalls = 0;
+        for(uint32_t i = 0; i < data.mNbTurns; ++i)
+            nbCalls += node.mTurnsCalls[i];
+
+        section.mAverage = total / data.mNbTurns;
+        section.mMedian = times[times.size() / 2];
+        section.mPercentile95 = times[(times.size() * 95) / 100];
+        section.mMax = times.back();
+        section.mCallsPerTurn = static_cast<double>(nbCalls) / static_cast<double>(data.mNbTurns);
+    }
+    stats.push_back(section);
+
+    for(uint32_t child : node.mChildren)
+        computeNodeStats(data, child, stats);
+}
+
+void writeTrace(const std::string& filename, const std::vector<const char*>& names, const std::vector<TraceEvent>& events)
+{
+    std::ofstream file(filename.c_str());
+    if(!file.is_open())
+        return;
+
+    file << "{\"traceEvents\":[";
+    bool first = true;
+    for(const TraceEvent& event : events)
+    {
+        if(!first)
+            file << ",";
+        first = false;
+
+        // The section names are identifiers so they do not need to be escaped
+        file << "\n{\"name\":\"" << names[event.mNode] << "\",\"cat\":\"turn\",\"ph\":\"X\""
+            << ",\"ts\":" << event.mStart << ",\"dur\":" << event.mDuration
+            << ",\"pid\":1,\"tid\":" << event.mThread << "}";
+    }
+    file << "\n]}\n";
+}
+}
+
+const uint32_t TurnProfiler::NB_TURNS_HISTORY;
+const uint32_t TurnProfiler::MAX_TRACE_EVENTS;
+
+std::atomic<bool> TurnProfiler::sEnabled(false);
+
+void TurnProfiler::Scope::begin(const char* name)
+{
+    ProfilerData& data = getData();
+    {
+        std::lock_guard<std::mutex> lock(data.mMutex);
+        mParent = currentNode;
+        mNode = findOrAddNode(data, mParent, name);
+    }
+    currentNode = mNode;
+    mStart = getTime(data);
+}
+
+void TurnProfiler::Scope::end()
+{
+    ProfilerData& data = getData();
+    int64_t duration = getTime(data) - mStart;
+    currentNode = mParent;
+
+    std::lock_guard<std::mutex> lock(data.mMutex);
+    Node& node = data.mNodes[mNode];
+    node.mTurnTime += static_cast<uint64_t>(duration);
+    ++node.mTurnCalls;
+    data.mTurnRecorded = true;
+
+    if((data.mNbTraceTurnsLeft > 0) && (data.mTraceEvents.size() < MAX_TRACE_EVENTS))
+    {
+        TraceEvent event;
+        event.mNode = mNode;
+        event.mThread = getThreadId();
+        event.mStart = mStart;
+        event.mDuration = duration;
+        data.mTraceEvents.push_back(event);
+    }
+}
+
+void TurnProfiler::setEnabled(bool enabled)
+{
+    sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TurnProfiler::endTurn()
+{
+    if(!isEnabled())
+        return;
+
+    ProfilerData& data = getData();
+    std::string traceFilename;
+    std::vector<TraceEvent> traceEvents;
+    std::vector<const char*> names;
+    {
+        std::lock_guard<std::mutex> lock(data.mMutex);
+        if(!data.mTurnRecorded)
+            return;
+
+        data.mTurnRecorded = false;
+        for(Node& node : data.mNodes)
+        {
+            if(node.mTurnTimes.empty())
+                continue;
+
+            node.mTurnTimes[data.mNextTurnIndex] = node.mTurnTime;
+            node.mTurnsCalls[data.mNextTurnIndex] = node.mTurnCalls;
+            node.mTurnTime = 0;
+            node.mTurnCalls = 0;
+        }
+        data.mNextTurnIndex = (data.mNextTurnIndex + 1) % NB_TURNS_HISTORY;
+        data.mNbTurns = std::min(data.mNbTurns + 1, NB_TURNS_HISTORY);
+
+        if(data.mNbTraceTurnsLeft > 0)
+        {
+            --data.mNbTraceTurnsLeft;
+            if(data.mNbTraceTurnsLeft == 0)
+            {
+                std::swap(traceFilename, data.mTraceFilename);
+                std::swap(traceEvents, data.mTraceEvents);
+                for(const Node& node : data.mNodes)
+                    names.push_back(node.mName);
+            }
+        }
+    }
+
+    // The file is written without holding the lock
+    if(!traceFilename.empty())
+        writeTrace(traceFilename, names, traceEvents);
+}
+
+void TurnProfiler::reset()
+{
+    ProfilerData& data = getData();
+    std::lock_guard<std::mutex> lock(data.mMutex);
+    for(Node& node : data.mNodes)
+    {
+        node.mTurnTime = 0;
+        node.mTurnCalls = 0;
+        std::fill(node.mTurnTimes.begin(), node.mTurnTimes.end(), 0);
+        std::fill(node.mTurnsCalls.begin(), node.mTurnsCalls.end(), 0);
+    }
+    data.mTurnRecorded = false;
+    data.mNbTurns = 0;
+    data.mNextTurnIndex = 0;
+}
+
+uint32_t TurnProfiler::getNbTurns()
+{
+    ProfilerData& data = getData();
+    std::lock_guard<std::mutex> lock(data.mMutex);
+    return data.mNbTurns;
+}
+
+std::vector<TurnProfiler::SectionStats> TurnProfiler::computeStats()
+{
+    ProfilerData& data = getData();
+    std::lock_guard<std::mutex> lock(data.mMutex);
+    std::vector<SectionStats> stats;
+    for(uint32_t child : data.mNodes[ROOT_NODE].mChildren)
+        computeNodeStats(data, child, stats);
+
+    return stats;
+}
+
+std::string TurnProfiler::getStatsText()
+{
+    std::vector<SectionStats> stats = computeStats();
+    std::stringstream ss;
+    ss << "Turn profiler " << (isEnabled() ? "enabled" : "disabled") << ", "
+        << getNbTurns() << " turns (times in us)";
+    ss << "\n" << std::left << std::setw(36) << "section" << std::right
+        << std::setw(9) << "avg" << std::setw(9) << "p50" << std::setw(9) << "p95"
+        << std::setw(9) << "max" << std::setw(10) << "calls";
+    for(const SectionStats& section : stats)
+    {
+        std::string name = std::string(2 * section.mDepth, ' ') + section.mName;
+        ss << "\n" << std::left << std::setw(36) << name << std::right
+            << std::setw(9) << section.mAverage << std::setw(9) << section.mMedian
+            << std::setw(9) << section.mPercentile95 << std::setw(9) << section.mMax
+            << std::setw(10) << std::fixed << std::setprecision(1) << section.mCallsPerTurn;
+    }
+    return ss.str();
+}
+
+std::string TurnProfiler::getHistogramText(const std::string& name)
+{
+    ProfilerData& data = getData();
+    std::lock_guard<std::mutex> lock(data.mMutex);
+
+    // Every section with this name is counted
+    std::vector<uint64_t> times(data.mNbTurns, 0);
+    bool found = false;
+    for(const Node& node : data.mNodes)
+    {
+        if(node.mTurnTimes.empty() || (name != node.mName))
+            continue;
+
+        found = true;
+        for(uint32_t i = 0; i < data.mNbTurns; ++i)
+            times[i] += node.mTurnTimes[i];
+    }
+
+    if(!found)
+        return "No section named " + name;
+
+    // Bucket i counts the turns where the time spent was in [2^(i-1), 2^i[
+    std::vector<uint32_t> buckets;
+    for(uint64_t time : times)
+    {
+        uint32_t bucket = 0;
+        while(time > 0)
+        {
+            ++bucket;
+            time >>= 1;
+        }
+        if(bucket >= buckets.size())
+            buckets.resize(bucket + 1, 0);
+
+        ++buckets[bucket];
+    }
+
+    std::stringstream ss;
+    ss << "Time spent in " << name << " during the last " << data.mNbTurns << " turns:";
+    for(uint32_t i = 0; i < buckets.size(); ++i)
+    {
+        if(buckets[i] == 0)
+            continue;
+
+        uint64_t bucketMin = (i == 0) ? 0 : (1ull << (i - 1));
+        uint64_t bucketMax = (1ull << i) - 1;
+        ss << "\n" << std::setw(9) << bucketMin << " - " << std::setw(9) << bucketMax << " us: " << buckets[i];
+    }
+    return ss.str();
+}
+
+void TurnProfiler::startTrace(const std::string& filename, uint32_t nbTurns)
+{
+    ProfilerData& data = getData();
+    {
+        std::lock_guard<std::mutex> lock(data.mMutex);
+        data.mTraceFilename = filename;
+        data.mNbTraceTurnsLeft = nbTurns;
+        data.mTraceEvents.clear();
+    }
+    setEnabled(true);
+}
+
+bool TurnProfiler::isTracing()
+{
+    ProfilerData& data = getData();
+    std::lock_guard<std::mutex> lock(data.mMutex);
+    return data.mNbTraceTurnsLeft > 0;
+}
@@ -0,0 +1,132 @@
+/*!
+ *  Copyright (C) 2011-2016  OpenDungeons Team
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TURNPROFILER_H
+#define TURNPROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! \brief Times the enclosing scope as a section of the turn profiler. The name must be a
+//! string that stays valid while the program runs (a string literal for example)
+#define OD_PROFILE_SCOPE(_name)                   OD_PROFILE_SCOPE_IMPL(_name, __LINE__)
+#define OD_PROFILE_SCOPE_IMPL(_name, _line)       OD_PROFILE_SCOPE_IMPL2(_name, _line)
+#define OD_PROFILE_SCOPE_IMPL2(_name, _line)      TurnProfiler::Scope odProfileScope##_line(_name)
+
+/*! \brief Hierarchical timers of the server turns.
+ *
+ * Each OD_PROFILE_SCOPE is a section. Sections opened while another one is running are
+ * its children, so the same name can appear under several parents (for example the floodfill
+ * when it is called by a creature digging or by a room being built). At the end of each
+ * turn, the time spent in each section is added to a rolling window of the last
+ * NB_TURNS_HISTORY turns from which the statistics and the histograms are computed.
+ * The sections can also be recorded as a Chrome trace (chrome://tracing) for a given number
+ * of turns to see where a spike comes from.
+ *
+ * When disabled, a scope only reads an atomic flag so the profiler can be left in the code
+ * of the game and enabled with the "profiler" console command.
+ */
+class TurnProfiler
+{
+public:
+    //! \brief Number of turns used to compute the statistics
+    static const uint32_t NB_TURNS_HISTORY = 256;
+    //! \brief Maximum number of events kept for a trace. Next ones are ignored
+    static const uint32_t MAX_TRACE_EVENTS = 1000000;
+
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name) :
+            mNode(INVALID_NODE)
+        {
+            if(isEnabled())
+                begin(name);
+        }
+
+        ~Scope()
+        {
+            if(mNode != INVALID_NODE)
+                end();
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        static const uint32_t INVALID_NODE = 0xFFFFFFFF;
+
+        void begin(const char* name);
+        void end();
+
+        uint32_t mNode;
+        uint32_t mParent;
+        int64_t mStart;
+    };
+
+    //! \brief Statistics of a section over the rolling window (times in microseconds)
+    struct SectionStats
+    {
+        std::string mName;
+        //! \brief 0 for the root sections
+        uint32_t mDepth = 0;
+        uint64_t mAverage = 0;
+        uint64_t mMedian = 0;
+        uint64_t mPercentile95 = 0;
+        uint64_t mMax = 0;
+        double mCallsPerTurn = 0.0;
+    };
+
+    static inline bool isEnabled()
+    { return sEnabled.load(std::memory_order_relaxed); }
+
+    static void setEnabled(bool enabled);
+
+    //! \brief Adds the time spent in each section since the last call to the rolling window. Turns
+    //! where no section was run (the server waiting for the clients for example) are ignored
+    static void endTurn();
+
+    //! \brief Clears the rolling window
+    static void reset();
+
+    //! \brief Number of turns in the rolling window
+    static uint32_t getNbTurns();
+
+    //! \brief Statistics of every section, each one followed by its children
+    static std::vector<SectionStats> computeStats();
+
+    //! \brief Table with the statistics of every section
+    static std::string getStatsText();
+
+    //! \brief Histogram (with buckets doubling in size) of the time spent during each turn of the
+    //! rolling window by the sections with the given name
+    static std::string getHistogramText(const std::string& name);
+
+    //! \brief Enables the profiler and records the sections during the next nbTurns turns. Then,
+    //! they are written in the given file with the Chrome trace format
+    static void startTrace(const std::string& filename, uint32_t nbTurns);
+
+    //! \brief Returns true while a trace is being recorded
+    static bool isTracing();
+
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+#endif // TURNPROFILER_H